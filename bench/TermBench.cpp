@@ -0,0 +1,670 @@
+// bench/TermBench.cpp
+//
+// Purpose:
+//   pq-ssh-termbench: measures how fast bytes get from "the remote side" onto
+//   the screen, without a network, so terminal regressions show up as numbers.
+//
+// Sinks (--sink):
+//   qterm  CpunkTermWidget on a local pty. The benchmark re-executes itself as
+//          the pty child (--emit) and writes the stream to the pty slave: the
+//          same path OpenSSH output takes in a real session.
+//   view   TerminalView fed through ShellOutputBuffer + ShellOutputPump, with
+//          a producer thread that behaves like SshShellWorker (ring writes,
+//          empty->non-empty notification, pause when full, resume on drain).
+//
+// Streams (--stream):
+//   cat     80-column printable text lines (large `cat`)
+//   yes     "y\n" repeated (`yes`)
+//   htop    full-screen frames with 256-colour SGR and cursor addressing
+//   replay  a recorded VT stream (--file), e.g. from `script -q -c htop out.log`,
+//           replayed in a loop
+//
+// Reported:
+//   - throughput (MB/s) from first byte to the end of the stream
+//   - frame intervals (time between paints) and UI stalls (lateness of a
+//     2 ms heartbeat timer), p50/p95/p99/max
+//   - keystroke-to-paint latency: key event -> echo -> first paint showing it
+//     (qterm: echo by the pty line discipline; view: echo through the ring)
+//
+// Needs a display; QT_QPA_PLATFORM=offscreen works for unattended runs.
+// Built only with -DPQSSH_BUILD_BENCH=ON.
+
+#include "CpunkTermWidget.h"
+#include "TerminalView.h"
+#include "ShellOutputBuffer.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QKeyEvent>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextCursor>
+#include <QThread>
+#include <QTimer>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+#include <unistd.h>
+
+namespace {
+
+constexpr int kChunkBytes = 64 * 1024;
+constexpr int kHeartbeatMs = 2;
+
+struct Options
+{
+    QString sink = QStringLiteral("qterm");
+    QString stream = QStringLiteral("cat");
+    QString file;
+    qint64  bytes = 64LL * 1024 * 1024;
+    int     keys = 50;
+    int     timeoutSec = 300;
+    bool    json = false;
+};
+
+// ------------------------------------------------------------
+// StreamSource: deterministic synthetic / replayed VT data
+// ------------------------------------------------------------
+class StreamSource
+{
+public:
+    StreamSource(const QString& kind, const QByteArray& replay)
+        : m_kind(kind), m_replay(replay) {}
+
+    QByteArray next()
+    {
+        ++m_seq;
+        if (m_kind == QLatin1String("yes"))
+            return QByteArray("y\n").repeated(kChunkBytes / 2);
+        if (m_kind == QLatin1String("htop"))
+            return htopFrames();
+        if (m_kind == QLatin1String("replay"))
+            return replaySlice();
+        return catLines();
+    }
+
+private:
+    QByteArray catLines()
+    {
+        QByteArray out;
+        out.reserve(kChunkBytes + 80);
+        quint64 line = m_seq * 1000;
+        while (out.size() < kChunkBytes) {
+            for (int i = 0; i < 79; ++i)
+                out.append(char(' ' + int((line * 7 + quint64(i)) % 95)));
+            out.append('\n');
+            ++line;
+        }
+        return out;
+    }
+
+    QByteArray htopFrames()
+    {
+        QByteArray out;
+        out.reserve(kChunkBytes + 16 * 1024);
+        int frame = int(m_seq);
+        while (out.size() < kChunkBytes) {
+            out.append("\x1b[H");
+            for (int row = 1; row <= 40; ++row) {
+                out.append(QByteArray("\x1b[") + QByteArray::number(row) + ";1H");
+                for (int cell = 0; cell < 15; ++cell) {
+                    const int fg = (frame + row * 3 + cell) % 256;
+                    const int bg = (frame * 5 + row + cell * 7) % 256;
+                    out.append(QByteArray("\x1b[38;5;") + QByteArray::number(fg)
+                               + "m\x1b[48;5;" + QByteArray::number(bg) + "m");
+                    out.append(QByteArray::number((frame * 131 + row * 17 + cell) % 100000)
+                                   .rightJustified(8, ' '));
+                }
+                out.append("\x1b[0m\x1b[K");
+            }
+            ++frame;
+        }
+        return out;
+    }
+
+    QByteArray replaySlice()
+    {
+        if (m_replay.isEmpty())
+            return catLines();
+        QByteArray out;
+        while (out.size() < kChunkBytes) {
+            const int n = qMin(kChunkBytes - out.size(), m_replay.size() - m_replayPos);
+            out.append(m_replay.constData() + m_replayPos, n);
+            m_replayPos = (m_replayPos + n) % m_replay.size();
+        }
+        return out;
+    }
+
+    QString    m_kind;
+    QByteArray m_replay;
+    int        m_replayPos = 0;
+    quint64    m_seq = 0;
+};
+
+// ------------------------------------------------------------
+// Samples: millisecond samples with percentiles
+// ------------------------------------------------------------
+struct Samples
+{
+    QVector<double> ms;
+
+    void add(double v) { ms.push_back(v); }
+    int  count() const { return ms.size(); }
+
+    double pct(double p) const
+    {
+        if (ms.isEmpty()) return 0.0;
+        QVector<double> s = ms;
+        std::sort(s.begin(), s.end());
+        const int idx = qBound(0, int(std::ceil(p / 100.0 * s.size())) - 1, s.size() - 1);
+        return s[idx];
+    }
+
+    double max() const
+    {
+        return ms.isEmpty() ? 0.0 : *std::max_element(ms.begin(), ms.end());
+    }
+
+    QJsonObject toJson() const
+    {
+        QJsonObject o;
+        o["n"] = count();
+        o["p50"] = pct(50);
+        o["p95"] = pct(95);
+        o["p99"] = pct(99);
+        o["max"] = max();
+        return o;
+    }
+};
+
+struct Result
+{
+    qint64  bytes = 0;
+    double  seconds = 0.0;
+    Samples frames;
+    Samples stalls;
+    Samples keys;
+    bool    timedOut = false;
+};
+
+// ------------------------------------------------------------
+// PaintProbe: timestamps paint events of a widget tree
+// ------------------------------------------------------------
+class PaintProbe : public QObject
+{
+public:
+    PaintProbe(QWidget* root, const QElapsedTimer* clock)
+        : m_clock(clock)
+    {
+        root->installEventFilter(this);
+        for (QWidget* w : root->findChildren<QWidget*>())
+            w->installEventFilter(this);
+    }
+
+    bool recording = false;
+    Samples intervals;
+    std::function<void(qint64)> onPaint;
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* e) override
+    {
+        if (e->type() == QEvent::Paint) {
+            const qint64 now = m_clock->nsecsElapsed();
+            // Several child widgets paint in the same pass: count it once.
+            if (now - m_last > 500000) {
+                if (recording && m_last > 0)
+                    intervals.add(double(now - m_last) / 1e6);
+                m_last = now;
+                if (onPaint) onPaint(now);
+            }
+        }
+        return QObject::eventFilter(obj, e);
+    }
+
+private:
+    const QElapsedTimer* m_clock;
+    qint64 m_last = 0;
+};
+
+// ------------------------------------------------------------
+// StallProbe: lateness of a 2 ms heartbeat = UI thread blocked
+// ------------------------------------------------------------
+class StallProbe : public QObject
+{
+public:
+    explicit StallProbe(const QElapsedTimer* clock)
+        : m_clock(clock)
+    {
+        m_timer.setTimerType(Qt::PreciseTimer);
+        m_timer.setInterval(kHeartbeatMs);
+        QObject::connect(&m_timer, &QTimer::timeout, this, [this]() {
+            const qint64 now = m_clock->nsecsElapsed();
+            if (m_last > 0)
+                stalls.add(qMax(0.0, double(now - m_last) / 1e6 - kHeartbeatMs));
+            m_last = now;
+        });
+    }
+
+    void start() { m_last = 0; m_timer.start(); }
+    void stop()  { m_timer.stop(); }
+
+    Samples stalls;
+
+private:
+    const QElapsedTimer* m_clock;
+    QTimer m_timer;
+    qint64 m_last = 0;
+};
+
+void settle(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+QByteArray loadReplay(const Options& o, QString* err)
+{
+    if (o.stream != QLatin1String("replay"))
+        return {};
+    QFile f(o.file);
+    if (o.file.isEmpty() || !f.open(QIODevice::ReadOnly)) {
+        if (err) *err = QString("cannot read replay file '%1'").arg(o.file);
+        return {};
+    }
+    return f.readAll();
+}
+
+// ------------------------------------------------------------
+// --emit: pty child for the qterm sink
+// ------------------------------------------------------------
+int runEmitter(const Options& o)
+{
+    QString err;
+    const QByteArray replay = loadReplay(o, &err);
+    if (!err.isEmpty()) {
+        std::fprintf(stderr, "%s\n", qPrintable(err));
+        return 2;
+    }
+
+    StreamSource src(o.stream, replay);
+    qint64 left = o.bytes;
+    while (left > 0) {
+        QByteArray chunk = src.next();
+        if (chunk.size() > left) chunk.truncate(int(left));
+
+        const char* p = chunk.constData();
+        qint64 n = chunk.size();
+        while (n > 0) {
+            const ssize_t rc = ::write(STDOUT_FILENO, p, size_t(n));
+            if (rc <= 0) return 1;
+            p += rc;
+            n -= rc;
+        }
+        left -= chunk.size();
+    }
+    return 0;
+}
+
+QWidget* terminalDisplayOf(QWidget* term)
+{
+    for (QWidget* w : term->findChildren<QWidget*>()) {
+        if (w->inherits("Konsole::TerminalDisplay"))
+            return w;
+    }
+    return term;
+}
+
+// Sends one printable key, waits for echo + paint; returns false on timeout.
+bool measureKey(QWidget* target, const QElapsedTimer& clock, int k,
+                qint64* sentNs, bool* echoSeen, bool* done, QChar* expect)
+{
+    const QChar ch = QChar('a' + (k % 26));
+    *expect = ch;
+    *echoSeen = false;
+    *done = false;
+
+    QEventLoop loop;
+    QTimer guard;
+    guard.setSingleShot(true);
+    QObject::connect(&guard, &QTimer::timeout, &loop, &QEventLoop::quit);
+    QTimer poll;
+    QObject::connect(&poll, &QTimer::timeout, &loop, [&]() { if (*done) loop.quit(); });
+    poll.start(0);
+    guard.start(1000);
+
+    *sentNs = clock.nsecsElapsed();
+    QKeyEvent press(QEvent::KeyPress, Qt::Key_A + (k % 26), Qt::NoModifier, QString(ch));
+    QKeyEvent release(QEvent::KeyRelease, Qt::Key_A + (k % 26), Qt::NoModifier, QString(ch));
+    QCoreApplication::sendEvent(target, &press);
+    QCoreApplication::sendEvent(target, &release);
+
+    if (!*done)
+        loop.exec();
+    return *done;
+}
+
+// ------------------------------------------------------------
+// qterm sink
+// ------------------------------------------------------------
+bool runQterm(const Options& o, Result* r, QString* err)
+{
+    QElapsedTimer clock;
+    clock.start();
+
+    // Throughput + frames
+    {
+        CpunkTermWidget term(2000);
+        term.resize(1000, 700);
+        term.show();
+        settle(200);
+
+        QStringList args{ "--emit", "--stream", o.stream, "--bytes", QString::number(o.bytes) };
+        if (!o.file.isEmpty()) args << "--file" << o.file;
+        term.setShellProgram(QCoreApplication::applicationFilePath());
+        term.setArgs(args);
+
+        PaintProbe paints(&term, &clock);
+        StallProbe stalls(&clock);
+
+        QEventLoop loop;
+        QTimer guard;
+        guard.setSingleShot(true);
+        QObject::connect(&guard, &QTimer::timeout, &loop, [&]() { r->timedOut = true; loop.quit(); });
+        QObject::connect(&term, &QTermWidget::finished, &loop, &QEventLoop::quit);
+
+        paints.recording = true;
+        stalls.start();
+        guard.start(o.timeoutSec * 1000);
+
+        const qint64 t0 = clock.nsecsElapsed();
+        term.startShellProgram();
+        loop.exec();
+        const qint64 t1 = clock.nsecsElapsed();
+
+        settle(50);   // final repaint
+        stalls.stop();
+        paints.recording = false;
+
+        r->bytes   = o.bytes;
+        r->seconds = double(t1 - t0) / 1e9;
+        r->frames  = paints.intervals;
+        r->stalls  = stalls.stalls;
+    }
+
+    // Keystroke -> paint, echoed by the pty line discipline (cat reads, tty echoes)
+    if (o.keys > 0) {
+        CpunkTermWidget term(2000);
+        term.resize(1000, 700);
+        term.show();
+        term.setShellProgram(QStringLiteral("/bin/cat"));
+        term.startShellProgram();
+        settle(300);
+
+        QWidget* display = terminalDisplayOf(&term);
+        display->setFocus();
+
+        qint64 sentNs = 0;
+        bool echoSeen = false, done = false;
+        QChar expect;
+
+        QObject::connect(&term, &QTermWidget::receivedData, &term, [&](const QString& text) {
+            if (!done && text.contains(expect)) echoSeen = true;
+        });
+
+        PaintProbe paints(display, &clock);
+        paints.onPaint = [&](qint64 now) {
+            if (echoSeen && !done) {
+                r->keys.add(double(now - sentNs) / 1e6);
+                done = true;
+            }
+        };
+
+        for (int k = 0; k < o.keys; ++k) {
+            measureKey(display, clock, k, &sentNs, &echoSeen, &done, &expect);
+            settle(10);
+        }
+    }
+
+    Q_UNUSED(err);
+    return true;
+}
+
+// ------------------------------------------------------------
+// view sink (ShellOutputBuffer + ShellOutputPump + TerminalView)
+// ------------------------------------------------------------
+bool runView(const Options& o, Result* r, QString* err)
+{
+    const QByteArray replay = loadReplay(o, err);
+    if (err && !err->isEmpty())
+        return false;
+
+    QElapsedTimer clock;
+    clock.start();
+
+    TerminalView view;
+    view.setMaximumBlockCount(2000);
+    view.resize(1000, 700);
+    view.show();
+    settle(200);
+
+    ShellOutputBuffer ring;
+    QMutex drainMutex;
+    QWaitCondition drained;
+
+    ShellOutputPump pump(&ring, [&]() {
+        QMutexLocker lock(&drainMutex);
+        drained.wakeAll();
+    });
+
+    // Producer-side write with the worker's contract.
+    auto produce = [&](const char* p, int len, const std::atomic<bool>& stop) {
+        int off = 0;
+        while (off < len && !stop.load()) {
+            bool wasEmpty = false;
+            const int n = ring.write(p + off, len - off, &wasEmpty);
+            if (n > 0 && wasEmpty)
+                QMetaObject::invokeMethod(&pump, [&pump]() { pump.scheduleFrame(); },
+                                          Qt::QueuedConnection);
+            off += n;
+            if (off < len) {
+                QMutexLocker lock(&drainMutex);
+                if (ring.freeSpace() == 0)
+                    drained.wait(&drainMutex, 50);
+            }
+        }
+    };
+
+    qint64 consumed = 0;
+    QEventLoop loop;
+    bool waitingKey = false, echoSeen = false, done = false;
+    QChar expect;
+
+    QObject::connect(&pump, &ShellOutputPump::outputReady, &view, [&](const QByteArray& data) {
+        consumed += data.size();
+        QTextCursor c(view.document());
+        c.movePosition(QTextCursor::End);
+        c.insertText(QString::fromUtf8(data));
+        if (waitingKey && !done && data.contains(char(expect.toLatin1())))
+            echoSeen = true;
+        if (!waitingKey && consumed >= o.bytes)
+            loop.quit();
+    });
+
+    // Throughput + frames
+    {
+        PaintProbe paints(&view, &clock);
+        StallProbe stalls(&clock);
+
+        std::atomic<bool> stop{ false };
+        QThread* producer = QThread::create([&]() {
+            StreamSource src(o.stream, replay);
+            qint64 left = o.bytes;
+            while (left > 0 && !stop.load()) {
+                QByteArray chunk = src.next();
+                if (chunk.size() > left) chunk.truncate(int(left));
+                produce(chunk.constData(), chunk.size(), stop);
+                left -= chunk.size();
+            }
+        });
+
+        QTimer guard;
+        guard.setSingleShot(true);
+        QObject::connect(&guard, &QTimer::timeout, &loop, [&]() { r->timedOut = true; loop.quit(); });
+
+        paints.recording = true;
+        stalls.start();
+        guard.start(o.timeoutSec * 1000);
+
+        const qint64 t0 = clock.nsecsElapsed();
+        producer->start();
+        loop.exec();
+        const qint64 t1 = clock.nsecsElapsed();
+
+        stop.store(true);
+        {
+            QMutexLocker lock(&drainMutex);
+            drained.wakeAll();
+        }
+        producer->wait();
+        delete producer;
+
+        settle(50);
+        stalls.stop();
+        paints.recording = false;
+
+        r->bytes   = consumed;
+        r->seconds = double(t1 - t0) / 1e9;
+        r->frames  = paints.intervals;
+        r->stalls  = stalls.stalls;
+    }
+
+    // Keystroke -> paint, echoed through the ring like remote output
+    if (o.keys > 0) {
+        waitingKey = true;
+        std::atomic<bool> never{ false };
+        QObject::connect(&view, &TerminalView::bytesTyped, &view, [&](const QByteArray& data) {
+            produce(data.constData(), data.size(), never);
+        });
+
+        qint64 sentNs = 0;
+        PaintProbe paints(&view, &clock);
+        paints.onPaint = [&](qint64 now) {
+            if (echoSeen && !done) {
+                r->keys.add(double(now - sentNs) / 1e6);
+                done = true;
+            }
+        };
+
+        view.setFocus();
+        for (int k = 0; k < o.keys; ++k) {
+            measureKey(&view, clock, k, &sentNs, &echoSeen, &done, &expect);
+            settle(10);
+        }
+    }
+
+    return true;
+}
+
+void report(const Options& o, const Result& r)
+{
+    const double mbps = r.seconds > 0 ? double(r.bytes) / (1024.0 * 1024.0) / r.seconds : 0.0;
+
+    if (o.json) {
+        QJsonObject j;
+        j["sink"] = o.sink;
+        j["stream"] = o.stream;
+        j["bytes"] = double(r.bytes);
+        j["seconds"] = r.seconds;
+        j["mbPerSec"] = mbps;
+        j["timedOut"] = r.timedOut;
+        j["frameIntervalMs"] = r.frames.toJson();
+        j["uiStallMs"] = r.stalls.toJson();
+        j["keyToPaintMs"] = r.keys.toJson();
+        std::printf("%s\n", QJsonDocument(j).toJson(QJsonDocument::Compact).constData());
+        return;
+    }
+
+    auto line = [](const char* what, const Samples& s) {
+        std::printf("[BENCH] %-18s n=%-6d p50=%7.2f p95=%7.2f p99=%7.2f max=%7.2f ms\n",
+                    what, s.count(), s.pct(50), s.pct(95), s.pct(99), s.max());
+    };
+
+    std::printf("[BENCH] sink=%s stream=%s bytes=%lld time=%.3fs throughput=%.1f MB/s%s\n",
+                qPrintable(o.sink), qPrintable(o.stream), static_cast<long long>(r.bytes),
+                r.seconds, mbps, r.timedOut ? " (TIMED OUT)" : "");
+    line("frame interval", r.frames);
+    line("ui stall", r.stalls);
+    line("key->paint", r.keys);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // --emit runs as the pty child: no GUI.
+    bool emitMode = false;
+    for (int i = 1; i < argc; ++i)
+        if (qstrcmp(argv[i], "--emit") == 0) emitMode = true;
+
+    QScopedPointer<QCoreApplication> app(emitMode ? new QCoreApplication(argc, argv)
+                                                  : new QApplication(argc, argv));
+    QCoreApplication::setApplicationName(QStringLiteral("pq-ssh-termbench"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("pq-ssh terminal throughput / latency benchmark"));
+    parser.addHelpOption();
+    parser.addOptions({
+        { "sink",    "qterm (CpunkTermWidget on a local pty) or view (TerminalView via output ring).", "sink", "qterm" },
+        { "stream",  "cat, yes, htop or replay.", "stream", "cat" },
+        { "file",    "Recorded VT stream for --stream replay.", "path" },
+        { "bytes",   "Bytes to stream (default 64 MiB).", "n", QString::number(64LL * 1024 * 1024) },
+        { "keys",    "Keystrokes for the latency test (0 = skip).", "n", "50" },
+        { "timeout", "Give up after this many seconds.", "sec", "300" },
+        { "json",    "Print one JSON object instead of text." },
+        { "emit",    "Internal: write the stream to stdout (pty child)." },
+    });
+    parser.process(*app);
+
+    Options o;
+    o.sink       = parser.value("sink");
+    o.stream     = parser.value("stream");
+    o.file       = parser.value("file");
+    o.bytes      = qMax<qint64>(1, parser.value("bytes").toLongLong());
+    o.keys       = qMax(0, parser.value("keys").toInt());
+    o.timeoutSec = qMax(1, parser.value("timeout").toInt());
+    o.json       = parser.isSet("json");
+
+    if (emitMode)
+        return runEmitter(o);
+
+    Result r;
+    QString err;
+    bool ok = false;
+    if (o.stream == QLatin1String("replay") && !QFile::exists(o.file))
+        err = QString("--stream replay needs --file (got '%1')").arg(o.file);
+    else if (o.sink == QLatin1String("view"))
+        ok = runView(o, &r, &err);
+    else if (o.sink == QLatin1String("qterm"))
+        ok = runQterm(o, &r, &err);
+    else
+        err = QString("unknown sink '%1'").arg(o.sink);
+
+    if (!ok || !err.isEmpty()) {
+        std::fprintf(stderr, "[BENCH] %s\n", qPrintable(err));
+        return 2;
+    }
+
+    report(o, r);
+    return r.timedOut ? 1 : 0;
+}
@@ -1,5 +1,6 @@
 #include "FilesTab.h"
 #include "RemoteDropTable.h"
+#include "WorkScheduler.h"
 
 #include <QLabel>
 #include <QPushButton>
@@ -22,6 +23,7 @@
 #include <QDropEvent>
 #include <QtConcurrent/QtConcurrent>
 #include <QFutureWatcher>
+#include <QSharedPointer>
 #include <QMenu>
 #include <QAction>
 #include <QEvent>
@@ -512,6 +514,34 @@ void FilesTab::onSshDisconnected()
     if (m_remoteTable)
         m_remoteTable->setRowCount(0);
     setRemoteCwd("~");
+
+    // An explicit disconnect abandons any transfer waiting for the link.
+    m_pendingTransfer = nullptr;
+    m_pendingTitle.clear();
+}
+
+// -----------------------------------------------------------------------------
+// onSshReconnected()
+// -----------------------------------------------------------------------------
+// Called after an automatic reconnect. Unlike onSshConnected() we keep the
+// current remote directory, then resume the interrupted transfer (if any).
+// -----------------------------------------------------------------------------
+void FilesTab::onSshReconnected()
+{
+    if (!m_ssh || !m_ssh->isConnected()) return;
+
+    if (m_pendingTransfer) {
+        const auto fn = m_pendingTransfer;
+        const QString title = m_pendingTitle;
+        m_pendingTransfer = nullptr;
+        m_pendingTitle.clear();
+
+        qInfo().noquote() << QString("[FILES][TRANSFER] resuming after reconnect: %1").arg(title);
+        runTransfer(title, fn);
+        return;
+    }
+
+    refreshRemote();
 }
 
 // -----------------------------------------------------------------------------
@@ -714,8 +744,8 @@ void FilesTab::onTransferProgress(quint64 done, quint64 total)
 // -----------------------------------------------------------------------------
 // runTransfer()
 // -----------------------------------------------------------------------------
-// Run a potentially long transfer task in a background thread (QtConcurrent),
-// show a modal progress dialog, and allow cancellation.
+// Run a potentially long transfer task in a background thread (interactive
+// lane of WorkScheduler), show a modal progress dialog, and allow cancellation.
 //
 // Cancellation model:
 //   - Progress dialog Cancel triggers SshClient::requestCancelTransfer()
@@ -724,6 +754,7 @@ void FilesTab::onTransferProgress(quint64 done, quint64 total)
 // On completion:
 //   - show error message if failed
 //   - refresh remote listing if succeeded
+//   - if the link dropped, keep fn for onSshReconnected() instead of failing
 // -----------------------------------------------------------------------------
 void FilesTab::runTransfer(const QString& title,
                            const std::function<bool(QString *err)> &fn)
@@ -751,7 +782,7 @@ void FilesTab::runTransfer(const QString& title,
 
     auto *watcher = new QFutureWatcher<TransferResult>(this);
 
-    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, title, fn]() {
         const TransferResult r = watcher->result();
         watcher->deleteLater();
 
@@ -761,6 +792,17 @@ void FilesTab::runTransfer(const QString& title,
             m_progressDlg = nullptr;
         }
 
+        if (!r.ok && m_ssh && m_ssh->isLinkLost()) {
+            // Developer log (do NOT translate)
+            qWarning().noquote()
+                << QString("[FILES][TRANSFER] link lost, will resume after reconnect: %1").arg(r.err.trimmed());
+
+            m_pendingTitle = title;
+            m_pendingTransfer = fn;
+            emit transferInterrupted();
+            return;
+        }
+
         if (!r.ok) {
             const QString msg = r.err.trimmed().isEmpty()
                 ? tr("Transfer failed or cancelled.")
@@ -782,7 +824,8 @@ void FilesTab::runTransfer(const QString& title,
         }
     });
 
-    watcher->setFuture(QtConcurrent::run([fn]() -> TransferResult {
+    watcher->setFuture(WorkScheduler::instance()->run(WorkScheduler::Lane::Interactive,
+                                                      [fn]() -> TransferResult {
         TransferResult r;
         QString err;
         r.ok = fn(&err);
@@ -903,8 +946,12 @@ void FilesTab::startUploadPaths(const QStringList& paths)
     for (const auto& t : tasks)
         dirs.insert(QFileInfo(t.remotePath).path());
 
+    // Progress survives a re-run after reconnect (finished files are skipped).
+    auto nextTask       = QSharedPointer<int>::create(0);
+    auto completedBytes = QSharedPointer<quint64>::create(0);
+
     runTransfer(tr("Uploading %1 item(s)…").arg(tasks.size()),
-                [this, tasks, totalBytes, dirs](QString *err) -> bool {
+                [this, tasks, totalBytes, dirs, nextTask, completedBytes](QString *err) -> bool {
 
         qInfo().noquote() << QString("[XFER][UPLOAD] batch start files=%1 total=%2 dirs=%3")
                              .arg(tasks.size())
@@ -930,9 +977,8 @@ void FilesTab::startUploadPaths(const QStringList& paths)
         }
 
         // 2) upload sequentially + aggregated progress
-        quint64 completedBytes = 0;
-
-        for (const auto& t : tasks) {
+        for (int i = *nextTask; i < tasks.size(); ++i) {
+            const auto& t = tasks[i];
             quint64 lastFileDone = 0;
             QString e;
 
@@ -943,7 +989,7 @@ void FilesTab::startUploadPaths(const QStringList& paths)
                 t.localPath,
                 t.remotePath,
                 &e,
-                [this, &completedBytes, &lastFileDone, totalBytes](quint64 fileDone, quint64 /*fileTotal*/) {
+                [this, completedBytes, &lastFileDone, totalBytes](quint64 fileDone, quint64 /*fileTotal*/) {
 
                     // Convert per-file progress into total batch progress
                     const quint64 delta = (fileDone >= lastFileDone) ? (fileDone - lastFileDone) : 0;
@@ -951,7 +997,7 @@ void FilesTab::startUploadPaths(const QStringList& paths)
 
                     QMetaObject::invokeMethod(this, "onTransferProgress",
                         Qt::QueuedConnection,
-                        Q_ARG(quint64, completedBytes + delta),
+                        Q_ARG(quint64, *completedBytes + delta),
                         Q_ARG(quint64, totalBytes));
                 });
 
@@ -966,7 +1012,7 @@ void FilesTab::startUploadPaths(const QStringList& paths)
                 return false;
             }
 
-            completedBytes += t.size;
+            *completedBytes += t.size;
 
             // Integrity check (currently always on; later can be gated by settings)
             {
@@ -982,6 +1028,8 @@ void FilesTab::startUploadPaths(const QStringList& paths)
                 }
                 qInfo().noquote() << QString("[XFER][UPLOAD] verify OK %1").arg(t.remotePath);
             }
+
+            *nextTask = i + 1;
         }
 
         qInfo().noquote() << QString("[XFER][UPLOAD] batch OK files=%1 total=%2")
@@ -1130,16 +1178,18 @@ void FilesTab::startDownloadPaths(const QStringList& remotePaths, const QString&
                          .arg(rem.size())
                          .arg(prettySize(totalBytes));
 
+    // Progress survives a re-run after reconnect (finished files are skipped).
+    auto nextFile       = QSharedPointer<int>::create(0);
+    auto completedBytes = QSharedPointer<quint64>::create(0);
+
     runTransfer(tr("Downloading %1 file(s)…").arg(rem.size()),
-                [this, rem, loc, sizes, totalBytes](QString *err) -> bool {
+                [this, rem, loc, sizes, totalBytes, nextFile, completedBytes](QString *err) -> bool {
 
         qInfo().noquote() << QString("[XFER][DOWNLOAD] batch start files=%1 total=%2")
                              .arg(rem.size())
                              .arg(prettySize(totalBytes));
 
-        quint64 completedBytes = 0;
-
-        for (int i = 0; i < rem.size(); ++i) {
+        for (int i = *nextFile; i < rem.size(); ++i) {
             quint64 last = 0;
 
             qInfo().noquote() << QString("[XFER][DOWNLOAD] start %1 -> %2 (%3)")
@@ -1150,7 +1200,7 @@ void FilesTab::startDownloadPaths(const QStringList& remotePaths, const QString&
                 rem[i],
                 loc[i],
                 &e,
-                [this, &completedBytes, &last, totalBytes](quint64 d, quint64 /*t*/) {
+                [this, completedBytes, &last, totalBytes](quint64 d, quint64 /*t*/) {
 
                     // Convert per-file progress into total batch progress
                     const quint64 delta = (d >= last) ? (d - last) : 0;
@@ -1158,7 +1208,7 @@ void FilesTab::startDownloadPaths(const QStringList& remotePaths, const QString&
 
                     QMetaObject::invokeMethod(this, "onTransferProgress",
                         Qt::QueuedConnection,
-                        Q_ARG(quint64, completedBytes + delta),
+                        Q_ARG(quint64, *completedBytes + delta),
                         Q_ARG(quint64, totalBytes));
                 });
 
@@ -1169,7 +1219,7 @@ void FilesTab::startDownloadPaths(const QStringList& remotePaths, const QString&
                 return false;
             }
 
-            completedBytes += sizes[i];
+            *completedBytes += sizes[i];
 
             // Integrity check (currently always on; later can be gated by settings)
             {
@@ -1185,6 +1235,8 @@ void FilesTab::startDownloadPaths(const QStringList& remotePaths, const QString&
                 }
                 qInfo().noquote() << QString("[XFER][DOWNLOAD] verify OK %1").arg(loc[i]);
             }
+
+            *nextFile = i + 1;
         }
 
         qInfo().noquote() << QString("[XFER][DOWNLOAD] batch OK files=%1 total=%2")
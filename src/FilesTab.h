@@ -32,6 +32,14 @@ public slots:
     void onSshConnected();
     void onSshDisconnected();
 
+    // Session came back after a dropped link (SshLinkMonitor): keep the current
+    // remote directory and resume an interrupted transfer, if any.
+    void onSshReconnected();
+
+signals:
+    // A transfer failed because the link dropped; it is kept for onSshReconnected().
+    void transferInterrupted();
+
 protected:
     bool eventFilter(QObject *obj, QEvent *event) override;
 
@@ -104,4 +112,10 @@ private:
     RemoteDropTable *m_remoteTable = nullptr;
 
     QProgressDialog *m_progressDlg = nullptr;
+
+    // Transfer interrupted by a dropped link, re-run after reconnect.
+    // Upload/download jobs remember finished files, and SshClient resumes the
+    // partially transferred one from its .pqssh.part file.
+    QString m_pendingTitle;
+    std::function<bool(QString *err)> m_pendingTransfer;
 };
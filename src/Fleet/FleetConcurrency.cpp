@@ -0,0 +1,214 @@
+// FleetConcurrency.cpp
+#include "FleetConcurrency.h"
+#include "FleetRetry.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QStringList>
+
+#include <climits>
+#include <cmath>
+
+namespace {
+constexpr double kEwmaWeight = 0.2;
+
+void ewma(double* avg, double* base, double x)
+{
+    *avg = (*avg < 0) ? x : (1.0 - kEwmaWeight) * *avg + kEwmaWeight * x;
+    if (*base < 0 || *avg < *base) *base = *avg;
+}
+}
+
+FleetConcurrency::FleetConcurrency(QObject* parent)
+    : QObject(parent)
+{
+}
+
+QString FleetConcurrency::normalizeGroup(const QString& group)
+{
+    const QString g = group.trimmed().toLower();
+    return g.isEmpty() ? QStringLiteral("ungrouped") : g;
+}
+
+bool FleetConcurrency::parseGroupCaps(const QString& spec, QHash<QString, int>* out, QString* err)
+{
+    if (err) err->clear();
+    if (out) out->clear();
+
+    const QStringList parts = spec.split(QRegularExpression("[,;]"), Qt::SkipEmptyParts);
+    for (const QString& part : parts) {
+        const QString item = part.trimmed();
+        if (item.isEmpty()) continue;
+
+        const int eq = item.lastIndexOf('=');
+        bool ok = false;
+        const int cap = (eq > 0) ? item.mid(eq + 1).trimmed().toInt(&ok) : 0;
+        if (!ok || cap < 1) {
+            if (err) {
+                *err = QCoreApplication::translate("FleetExecutor",
+                                                   "Invalid group cap \"%1\" (expected group=N).").arg(item);
+            }
+            return false;
+        }
+
+        const QString name = item.left(eq).trimmed();
+        if (out) out->insert(name == QLatin1String("*") ? name : normalizeGroup(name), cap);
+    }
+    return true;
+}
+
+FleetConcurrency::Outcome FleetConcurrency::classify(const FleetTargetResult& r)
+{
+    if (r.connectMs >= 0)
+        return Outcome::Connected;   // got in: judge the load by latency
+    if (r.state == FleetTargetState::Canceled)
+        return Outcome::Neutral;
+
+    // Same cause classification as the retry policy.
+    bool overload = false;
+    FleetRetryPolicy::classifyCause(r.cause, &overload);
+    return overload ? Outcome::Overload : Outcome::Neutral;
+}
+
+void FleetConcurrency::reset(const Options& opt)
+{
+    QMutexLocker lock(&m_mutex);
+    m_opt = opt;
+    m_opt.maxLimit = qMax(kMinLimit, opt.maxLimit);
+    m_inFlight = 0;
+    m_groupInFlight.clear();
+    m_denied = false;
+
+    m_limit = qMin<double>(kInitialLimit, m_opt.maxLimit);
+    m_slowStart = true;
+    m_connectEwma = m_connectBase = -1;
+    m_execEwma = m_execBase = -1;
+    m_sinceDecrease.invalidate();
+}
+
+int FleetConcurrency::capFor(const QString& group) const
+{
+    auto it = m_opt.groupCaps.constFind(group);
+    if (it != m_opt.groupCaps.constEnd()) return it.value();
+    return m_opt.groupCaps.value(QStringLiteral("*"), INT_MAX);
+}
+
+int FleetConcurrency::currentLimitLocked() const
+{
+    if (!m_opt.adaptive) return m_opt.maxLimit;
+    return qBound(kMinLimit, int(std::floor(m_limit)), m_opt.maxLimit);
+}
+
+int FleetConcurrency::limit() const
+{
+    QMutexLocker lock(&m_mutex);
+    return currentLimitLocked();
+}
+
+int FleetConcurrency::inFlight() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_inFlight;
+}
+
+// ------------------------------------------------------------
+// tryAcquire() / release()
+// ------------------------------------------------------------
+bool FleetConcurrency::tryAcquire(const QString& group)
+{
+    QMutexLocker lock(&m_mutex);
+    const QString g = normalizeGroup(group);
+
+    if (m_inFlight >= currentLimitLocked() || m_groupInFlight.value(g) >= capFor(g)) {
+        m_denied = true;
+        return false;
+    }
+
+    ++m_inFlight;
+    ++m_groupInFlight[g];
+    return true;
+}
+
+void FleetConcurrency::release(const FleetTargetResult& r)
+{
+    const Outcome o = classify(r);
+
+    bool notify = false;
+    int oldLimit = 0, newLimit = 0;
+    QString why;
+    {
+        QMutexLocker lock(&m_mutex);
+        const QString g = normalizeGroup(r.group);
+        m_inFlight = qMax(0, m_inFlight - 1);
+        int& n = m_groupInFlight[g];
+        n = qMax(0, n - 1);
+
+        oldLimit = currentLimitLocked();
+        if (m_opt.adaptive)
+            adaptLocked(o, r, &why);
+        newLimit = currentLimitLocked();
+
+        notify = m_denied;
+        m_denied = false;
+    }
+
+    if (newLimit != oldLimit) {
+        if (!why.isEmpty()) {
+            qInfo().noquote() << QString("[FLEET] concurrency %1 -> %2 (%3)")
+                                     .arg(oldLimit).arg(newLimit).arg(why);
+        }
+        emit limitChanged(newLimit, why);
+    }
+    if (notify)
+        emit capacityAvailable();
+}
+
+// ------------------------------------------------------------
+// adaptLocked(): AIMD step for one finished target
+// ------------------------------------------------------------
+void FleetConcurrency::adaptLocked(Outcome o, const FleetTargetResult& r, QString* why)
+{
+    auto decrease = [this, why](const QString& reason) {
+        // One back-off per burst: targets that were already running when
+        // the limit was cut report the same congestion.
+        if (m_sinceDecrease.isValid() && m_sinceDecrease.elapsed() < kDecreaseHoldMs)
+            return;
+        m_limit = qMax<double>(kMinLimit, m_limit / 2.0);
+        m_slowStart = false;
+        m_sinceDecrease.start();
+        *why = reason;
+    };
+
+    if (o == Outcome::Neutral)
+        return;
+
+    if (o == Outcome::Overload) {
+        decrease(r.error.section('\n', 0, 0).left(120));
+        return;
+    }
+
+    // Connected: track latency.
+    ewma(&m_connectEwma, &m_connectBase, double(r.connectMs));
+    if (r.exitStatus >= 0)
+        ewma(&m_execEwma, &m_execBase, double(qMax<qint64>(0, r.durationMs - r.connectMs)));
+
+    // A floor for the baseline so LAN-fast connects (a few ms) don't turn
+    // ordinary jitter into back-offs.
+    const double connectBase = qMax(m_connectBase, 50.0);
+    const double execBase = qMax(m_execBase, 50.0);
+
+    if (m_connectEwma > connectBase * kBackoffFactor) {
+        decrease(QStringLiteral("connect latency %1 ms, baseline %2 ms")
+                     .arg(qRound(m_connectEwma)).arg(qRound(m_connectBase)));
+        return;
+    }
+    if (m_connectEwma > connectBase * kHoldFactor ||
+        (m_execEwma >= 0 && m_execEwma > execBase * kHoldFactor))
+        return;
+
+    if (m_limit >= m_opt.maxLimit)
+        return;
+    m_limit += m_slowStart ? 1.0 : 1.0 / m_limit;
+}
@@ -0,0 +1,97 @@
+// FleetConcurrency.h
+//
+// Purpose:
+//   Admission control for fleet targets, shared by the thread path and the
+//   event engine: a target starts only when a slot is free overall and in
+//   its profile group.
+//
+//   Fixed mode: the limit is the job's concurrency.
+//   Adaptive mode (AIMD, like TCP congestion control):
+//     - start at kInitialLimit; every target that connects while connect
+//       and exec latencies stay near their best (EWMA vs. baseline) adds one
+//       slot (slow start) until the first back-off, then one slot per
+//       `limit` such targets (additive increase)
+//     - timeouts, refused/reset connections and auth throttling before the
+//       command ran, or connect latency above kBackoffFactor x baseline,
+//       halve the limit (multiplicative decrease), at most once per
+//       kDecreaseHoldMs so one burst of failures counts once
+//     - latency above kHoldFactor x baseline stops the increase
+//   The job's concurrency is the ceiling in both modes.
+//
+//   Group caps (fleet/groupCaps, "dmz=10, ldap=20, *=50") bound the targets
+//   of one profile group running at once, e.g. hosts behind one bastion.
+//
+// Threading:
+//   All methods are thread-safe (event-loop threads release slots).
+//   capacityAvailable() is emitted on the releasing thread.
+
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+
+#include "FleetTypes.h"
+
+class FleetConcurrency : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int    kInitialLimit = 8;
+    static constexpr int    kMinLimit = 1;
+    static constexpr double kHoldFactor = 2.0;
+    static constexpr double kBackoffFactor = 4.0;
+    static constexpr int    kDecreaseHoldMs = 2000;
+
+    struct Options {
+        int  maxLimit = 4;
+        bool adaptive = false;
+        QHash<QString, int> groupCaps;   // normalized group -> cap ("*" = any other)
+    };
+
+    enum class Outcome { Connected, Overload, Neutral };
+
+    explicit FleetConcurrency(QObject* parent = nullptr);
+
+    // "dmz=10, ldap=20, *=50"; false (and err) on a malformed entry.
+    static bool parseGroupCaps(const QString& spec, QHash<QString, int>* out, QString* err = nullptr);
+    static QString normalizeGroup(const QString& group);
+
+    // How a finished target reflects on the remote side's load.
+    static Outcome classify(const FleetTargetResult& r);
+
+    void reset(const Options& opt);
+
+    // Take a slot for a target of this group (false = not now).
+    bool tryAcquire(const QString& group);
+    // Give the slot back and adapt the limit to the target's outcome.
+    void release(const FleetTargetResult& r);
+
+    int limit() const;
+    int inFlight() const;
+
+signals:
+    void capacityAvailable();
+    // why: empty on increase, the back-off reason on decrease.
+    void limitChanged(int limit, const QString& why);
+
+private:
+    int  capFor(const QString& group) const;     // m_mutex held
+    int  currentLimitLocked() const;
+    void adaptLocked(Outcome o, const FleetTargetResult& r, QString* why);
+
+    mutable QMutex m_mutex;
+    Options m_opt;
+
+    int m_inFlight = 0;
+    QHash<QString, int> m_groupInFlight;
+    bool m_denied = false;        // someone waits for a slot
+
+    // AIMD state
+    double m_limit = kInitialLimit;
+    bool   m_slowStart = true;
+    double m_connectEwma = -1, m_connectBase = -1;
+    double m_execEwma = -1, m_execBase = -1;
+    QElapsedTimer m_sinceDecrease;
+};
@@ -0,0 +1,694 @@
+// FleetEventEngine.cpp
+//
+// See header. Each loop thread owns its sessions outright (libssh sessions
+// are never shared between threads); the only shared state is the target
+// queue and the cancel flag.
+
+#include "FleetEventEngine.h"
+#include "FleetOutputDigest.h"
+#include "../SshSessionSetup.h"
+#include "../SshTcpConnect.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QThread>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+
+#include <libssh/libssh.h>
+#include <libssh/callbacks.h>
+
+#include <cerrno>
+#include <climits>
+#include <memory>
+#include <vector>
+
+#include <poll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+constexpr int kPollMs = 20;          // poll() timeout
+constexpr int kTickMs = 200;         // step every session at least this often
+constexpr int kExitStatusGraceMs = 2000;
+constexpr int kReadChunk = 16 * 1024;
+constexpr int kResolverThreads = 8;  // concurrent getaddrinfo() calls
+
+inline QString T(const char* s)
+{
+    return QCoreApplication::translate("FleetExecutor", s);
+}
+
+QString sessionError(ssh_session s)
+{
+    const char* e = s ? ssh_get_error(s) : nullptr;
+    return (e && *e) ? QString::fromLocal8Bit(e) : T("Unknown error");
+}
+}
+
+// One getaddrinfo() on the resolver pool. Shared with the session, which may
+// be gone (failed, canceled) before the lookup returns.
+struct ResolveJob {
+    QVector<SshTcpConnect::Address> addrs;
+    QString error;
+    SshTcpConnect::Failure why;
+    qint64 queuedMs = 0;                 // on the session clock
+    qint64 finishedMs = 0;
+    QAtomicInteger<int> done { 0 };      // release: the fields above are set
+};
+
+enum class Phase { Resolve, TcpConnect, Connect, Auth, OpenChannel, Exec, Collect, Done };
+
+struct FleetEventEngine::Session {
+    int profileIndex = -1;
+    SshProfile profile;
+
+    ssh_session ssh = nullptr;
+    ssh_channel ch = nullptr;
+    ssh_callbacks_struct cb {};   // must outlive ssh (libssh keeps a pointer)
+    Phase phase = Phase::TcpConnect;
+
+    // Same auth strategy and cache as SshClient
+    std::unique_ptr<SshSessionSetup::Authenticator> auth;
+
+    // Name lookup in progress (Resolve)
+    std::shared_ptr<ResolveJob> resolve;
+
+    // TCP connect in progress (until handed to libssh with SSH_OPTIONS_FD)
+    QVector<SshTcpConnect::Address> addrs;
+    int addrIndex = 0;
+    int tcpFd = -1;
+    qint64 phaseStartMs = 0;     // on clock: start of the current phase
+
+    QElapsedTimer clock;
+    qint64 deadlineMs = 0;       // on clock
+    qint64 eofAtMs = -1;
+    qint64 lastStepMs = 0;
+
+    std::unique_ptr<SshExecCapture> capture;
+    std::unique_ptr<FleetOutputDigest> digest;
+    FleetTargetResult r;
+    QString reason;
+    bool admitted = false;       // holds an admission slot
+
+    ~Session()
+    {
+        if (tcpFd >= 0)
+            ::close(tcpFd);
+        if (ch) {
+            ssh_channel_close(ch);
+            ssh_channel_free(ch);
+        }
+        if (ssh) {
+            ssh_disconnect(ssh);
+            ssh_free(ssh);
+        }
+    }
+};
+
+FleetEventEngine::FleetEventEngine(QObject* parent)
+    : QObject(parent)
+{
+    m_resolvers.setMaxThreadCount(kResolverThreads);
+}
+
+FleetEventEngine::~FleetEventEngine()
+{
+    m_cancel.storeRelease(1);
+    for (QThread* t : m_loops) {
+        t->wait();
+        delete t;
+    }
+}
+
+int FleetEventEngine::ensureFileLimit(int needed)
+{
+    struct rlimit rl {};
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0)
+        return -1;
+
+    if (rl.rlim_cur != RLIM_INFINITY && rl.rlim_cur < rlim_t(needed)) {
+        const rlim_t want = (rl.rlim_max == RLIM_INFINITY) ? rlim_t(needed)
+                                                           : qMin(rl.rlim_max, rlim_t(needed));
+        struct rlimit raised = rl;
+        raised.rlim_cur = want;
+        if (setrlimit(RLIMIT_NOFILE, &raised) == 0) {
+            qInfo().noquote() << QString("[FLEET] open file limit raised %1 -> %2")
+                                     .arg(qulonglong(rl.rlim_cur)).arg(qulonglong(want));
+            rl = raised;
+        }
+    }
+    return (rl.rlim_cur == RLIM_INFINITY) ? needed : int(qMin<rlim_t>(rl.rlim_cur, INT_MAX));
+}
+
+// ------------------------------------------------------------
+// start() / cancel()
+// ------------------------------------------------------------
+void FleetEventEngine::start(const QVector<Target>& targets, const Options& opt)
+{
+    if (isRunning()) return;
+
+    for (QThread* t : m_loops) {
+        t->wait();
+        delete t;
+    }
+    m_loops.clear();
+
+    m_opt = opt;
+    m_cancel.storeRelease(0);
+    {
+        QMutexLocker lock(&m_queueMutex);
+        m_queue = targets;
+        m_queueCursor = 0;
+    }
+
+    if (targets.isEmpty()) {
+        emit finished();
+        return;
+    }
+
+    // One socket per session plus headroom for the rest of the app.
+    const int limit = ensureFileLimit(opt.maxInFlight + 256);
+    int inFlight = qMax(1, qMin(opt.maxInFlight, targets.size()));
+    if (limit > 0)
+        inFlight = qMax(1, qMin(inFlight, limit - 256));
+
+    int loops = opt.loopThreads;
+    if (loops <= 0) {
+        loops = QSettings().value("fleet/eventThreads",
+                                  qBound(1, QThread::idealThreadCount() / 2, 4)).toInt();
+    }
+    loops = qBound(1, loops, qMax(1, inFlight));
+    const int perLoop = (inFlight + loops - 1) / loops;
+
+    qInfo().noquote() << QString("[FLEET] event engine: %1 targets, %2 in flight on %3 loop thread(s)")
+                             .arg(targets.size()).arg(inFlight).arg(loops);
+
+    m_loopsRunning = loops;
+    for (int i = 0; i < loops; ++i) {
+        QThread* t = QThread::create([this, perLoop]() {
+            runLoop(perLoop);
+            QMetaObject::invokeMethod(this, [this]() {
+                if (--m_loopsRunning == 0)
+                    emit finished();
+            }, Qt::QueuedConnection);
+        });
+        t->setObjectName(QString("fleet-loop-%1").arg(i));
+        m_loops.push_back(t);
+        t->start();
+    }
+}
+
+void FleetEventEngine::cancel()
+{
+    m_cancel.storeRelease(1);
+}
+
+FleetEventEngine::Take FleetEventEngine::takeNext(Target* out, bool* admitted)
+{
+    QMutexLocker lock(&m_queueMutex);
+    if (m_queueCursor >= m_queue.size()) return Take::Drained;
+
+    *admitted = false;
+    FleetConcurrency* adm = m_opt.admission;
+    if (!adm || m_cancel.loadAcquire() != 0) {
+        // Canceled targets only report; they take no slot.
+        *out = m_queue[m_queueCursor++];
+        return Take::Taken;
+    }
+
+    // First target whose group has room; skipped ones keep their order.
+    for (int i = m_queueCursor; i < m_queue.size(); ++i) {
+        if (!adm->tryAcquire(m_queue[i].profile.group)) {
+            if (adm->inFlight() >= adm->limit()) break;   // global limit: nobody fits
+            continue;
+        }
+        *admitted = true;
+        *out = m_queue[i];
+        for (int j = i; j > m_queueCursor; --j)
+            m_queue[j] = std::move(m_queue[j - 1]);
+        ++m_queueCursor;
+        return Take::Taken;
+    }
+    return Take::Wait;
+}
+
+void FleetEventEngine::report(Session& s)
+{
+    s.r.durationMs = s.clock.elapsed();
+    if (s.capture) {
+        s.r.stdoutText  = s.capture->out().text();
+        s.r.stderrText  = s.capture->err().text();
+        s.r.stdoutBytes = s.capture->out().totalBytes();
+        s.r.stderrBytes = s.capture->err().totalBytes();
+        s.r.outputTruncated = s.capture->out().isTruncated() || s.capture->err().isTruncated();
+        s.r.stdoutSpillPath = s.capture->out().keepSpill();
+        s.r.stderrSpillPath = s.capture->err().keepSpill();
+    }
+    if (s.digest && s.r.exitStatus >= 0) {
+        s.digest->finish();
+        s.r.stdoutDigest      = s.digest->exact();
+        s.r.stdoutShapeDigest = s.digest->similar();
+    }
+
+    // Free the slot before the result is queued to the owner, so the next
+    // target can start right away.
+    if (s.admitted && m_opt.admission) {
+        m_opt.admission->release(s.r);
+        s.admitted = false;
+    }
+
+    const FleetResultPtr r = makeFleetResult(std::move(s.r));
+    const QString reason = s.reason;
+    QMetaObject::invokeMethod(this, [this, r, reason]() {
+        emit targetFinished(r, reason);
+    }, Qt::QueuedConnection);
+}
+
+void FleetEventEngine::fail(Session& s, const QString& reason, const QString& error,
+                            FleetFailCause cause)
+{
+    s.r.state = (reason == QLatin1String("canceled")) ? FleetTargetState::Canceled
+                                                      : FleetTargetState::Failed;
+    s.r.error = error;
+    s.r.cause = cause;
+    s.reason = reason;
+    s.phase = Phase::Done;
+}
+
+// ------------------------------------------------------------
+// runLoop()
+// ------------------------------------------------------------
+void FleetEventEngine::runLoop(int perLoopCap)
+{
+    std::vector<std::unique_ptr<Session>> live;
+    std::vector<pollfd> pfds;
+    std::vector<Session*> polled;
+    QElapsedTimer clock;
+    clock.start();
+
+    bool queueDrained = false;
+    bool cancelSeen = false;
+
+    for (;;) {
+        const bool canceled = m_cancel.loadAcquire() != 0;
+
+        // Admit new targets up to this loop's share (and the admission limit).
+        while (!queueDrained && (int)live.size() < perLoopCap) {
+            Target t;
+            bool admitted = false;
+            const Take take = takeNext(&t, &admitted);
+            if (take == Take::Drained) { queueDrained = true; break; }
+            if (take == Take::Wait) break;
+
+            auto s = std::make_unique<Session>();
+            s->admitted = admitted;
+            s->profileIndex = t.profileIndex;
+            s->profile = t.profile;
+            s->clock.start();
+            s->r.profileIndex = t.profileIndex;
+            s->r.profileName  = t.profile.name;
+            s->r.group        = t.profile.group;
+            s->r.user         = t.profile.user;
+            s->r.host         = t.profile.host;
+            s->r.port         = (t.profile.port > 0) ? t.profile.port : 22;
+
+            if (canceled) {
+                fail(*s, QStringLiteral("canceled"), T("Canceled"), {FleetFailPhase::Canceled, 0});
+            } else {
+                QMetaObject::invokeMethod(this, [this, idx = t.profileIndex]() {
+                    emit targetStarted(idx);
+                }, Qt::QueuedConnection);
+                if (begin(*s)) {
+                    s->lastStepMs = clock.elapsed();
+                    while (step(*s, s->clock.elapsed())) {}
+                }
+            }
+            live.push_back(std::move(s));
+        }
+
+        if (canceled && !cancelSeen) {
+            cancelSeen = true;
+            for (auto& s : live) {
+                if (s->phase != Phase::Done)
+                    fail(*s, QStringLiteral("canceled"), T("Canceled"), {FleetFailPhase::Canceled, 0});
+            }
+        }
+
+        // Finished sessions report and release their socket.
+        for (auto it = live.begin(); it != live.end();) {
+            if ((*it)->phase == Phase::Done) {
+                report(**it);
+                it = live.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (live.empty()) {
+            if (queueDrained) break;
+            QThread::msleep(kPollMs);   // waiting for a slot held by another loop
+            continue;
+        }
+
+        // Wait for socket activity.
+        pfds.clear();
+        polled.clear();
+        for (auto& s : live) {
+            if (s->phase == Phase::TcpConnect) {
+                if (s->tcpFd < 0) continue;
+                pollfd p {};
+                p.fd = s->tcpFd;
+                p.events = POLLOUT;   // writable = connect finished
+                pfds.push_back(p);
+                polled.push_back(s.get());
+                continue;
+            }
+            const socket_t fd = s->ssh ? ssh_get_fd(s->ssh) : SSH_INVALID_SOCKET;
+            if (fd == SSH_INVALID_SOCKET) continue;
+            pollfd p {};
+            p.fd = fd;
+            p.events = POLLIN;
+            if (ssh_get_poll_flags(s->ssh) & SSH_WRITE_PENDING)
+                p.events |= POLLOUT;
+            pfds.push_back(p);
+            polled.push_back(s.get());
+        }
+        if (!pfds.empty())
+            ::poll(pfds.data(), nfds_t(pfds.size()), kPollMs);
+        else
+            QThread::msleep(kPollMs);
+
+        // Step sessions with socket events, then any due for a tick/timeout.
+        const qint64 now = clock.elapsed();
+        for (size_t i = 0; i < pfds.size(); ++i) {
+            if (pfds[i].revents) {
+                Session* s = polled[i];
+                s->lastStepMs = now;
+                while (step(*s, s->clock.elapsed())) {}
+            }
+        }
+        for (auto& s : live) {
+            if (s->phase == Phase::Done) continue;
+            const qint64 t = s->clock.elapsed();
+            // Lookups have no socket to poll: check them every round.
+            if (s->phase == Phase::Resolve || now - s->lastStepMs >= kTickMs || t >= s->deadlineMs) {
+                s->lastStepMs = now;
+                while (step(*s, t)) {}
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// begin(): session setup; false when the target failed already
+// ------------------------------------------------------------
+bool FleetEventEngine::begin(Session& s)
+{
+    const SshProfile& p = s.profile;
+    s.deadlineMs = m_opt.connectTimeoutMs;
+
+    const QString host = p.host.trimmed();
+    const QString user = p.user.trimmed();
+    if (user.isEmpty() || host.isEmpty()) {
+        fail(s, QStringLiteral("empty_user_or_host"), T("Empty user/host"),
+             {FleetFailPhase::Config, 0});
+        return false;
+    }
+    if (m_opt.command.trimmed().isEmpty()) {
+        fail(s, QStringLiteral("empty_command"), T("Empty command/service"),
+             {FleetFailPhase::Config, 0});
+        return false;
+    }
+
+    s.ssh = ssh_new();
+    if (!s.ssh) {
+        fail(s, QStringLiteral("connect_failed"), T("ssh_new() failed."),
+             {FleetFailPhase::Config, 0});
+        return false;
+    }
+
+    const int port = s.r.port;
+    const QByteArray h = host.toUtf8();
+    const QByteArray u = user.toUtf8();
+    ssh_options_set(s.ssh, SSH_OPTIONS_HOST, h.constData());
+    ssh_options_set(s.ssh, SSH_OPTIONS_USER, u.constData());
+    ssh_options_set(s.ssh, SSH_OPTIONS_PORT, &port);
+
+    if (!p.keyFile.trimmed().isEmpty()) {
+        const QByteArray k = QFile::encodeName(p.keyFile.trimmed());
+        ssh_options_set(s.ssh, SSH_OPTIONS_IDENTITY, k.constData());
+    }
+
+    // Same algorithm preferences and passphrase callback as SshClient. Fleet
+    // jobs have no passphrase provider (no prompt from worker threads), on
+    // either path, so encrypted keys must come from the agent.
+    SshSessionSetup::applyAlgorithms(s.ssh, false);
+    SshSessionSetup::installPassphraseCallback(s.ssh, &s.cb, nullptr);
+
+    // ~/.ssh/config decides where to connect (Hostname, Port); a proxy there
+    // leaves the whole connect to ssh_connect().
+    QString connectHost = host;
+    int connectPort = port;
+    const bool direct = SshTcpConnect::configuredTarget(s.ssh, &connectHost, &connectPort);
+
+    ssh_set_blocking(s.ssh, 0);
+
+    // Resolve on the resolver pool, then a non-blocking TCP connect;
+    // ssh_connect() then only does the key exchange.
+    if (direct) {
+        auto job = std::make_shared<ResolveJob>();
+        const QElapsedTimer clock = s.clock;
+        job->queuedMs = clock.elapsed();
+        QtConcurrent::run(&m_resolvers, [job, clock, connectHost, connectPort]() {
+            SshTcpConnect::resolve(connectHost, connectPort, &job->addrs, &job->error, &job->why);
+            job->finishedMs = clock.elapsed();
+            job->done.storeRelease(1);
+        });
+        s.resolve = std::move(job);
+    }
+
+    QString safeHost = host;
+    safeHost.replace(QRegularExpression("[^A-Za-z0-9._-]"), "_");
+    SshExecStream::Limits out = m_opt.outLimits;
+    SshExecStream::Limits err = m_opt.errLimits;
+    out.spillPrefix = QString("%1-%2-stdout-").arg(s.profileIndex).arg(safeHost);
+    err.spillPrefix = QString("%1-%2-stderr-").arg(s.profileIndex).arg(safeHost);
+    s.capture = std::make_unique<SshExecCapture>(out, err);
+    s.digest = std::make_unique<FleetOutputDigest>(p.host, p.name);
+
+    s.phase = direct ? Phase::Resolve : Phase::Connect;
+    s.phaseStartMs = s.clock.elapsed();
+    return true;
+}
+
+// ------------------------------------------------------------
+// step(): advance one session as far as it goes without blocking
+// ------------------------------------------------------------
+bool FleetEventEngine::step(Session& s, qint64 nowMs)
+{
+    if (s.phase == Phase::Done) return false;
+
+    if (nowMs >= s.deadlineMs) {
+        if (s.phase == Phase::Collect) {
+            fail(s, QStringLiteral("timeout"),
+                 QCoreApplication::translate("FleetExecutor", "Timeout after %1 ms")
+                     .arg(m_opt.commandTimeoutMs),
+                 {FleetFailPhase::Timeout, 0});
+        } else {
+            fail(s, QStringLiteral("connect_failed"),
+                 QCoreApplication::translate("FleetExecutor", "Connect timed out after %1 ms")
+                     .arg(m_opt.connectTimeoutMs),
+                 {FleetFailPhase::Connect, ETIMEDOUT});
+        }
+        return false;
+    }
+
+    switch (s.phase) {
+    case Phase::Resolve: {
+        if (!s.resolve->done.loadAcquire()) return false;
+        const std::shared_ptr<ResolveJob> job = std::move(s.resolve);
+        s.r.dnsMs = job->finishedMs - job->queuedMs;   // includes waiting for a resolver
+        if (job->addrs.isEmpty()) {
+            fail(s, QStringLiteral("connect_failed"),
+                 QCoreApplication::translate("SshClient", "ssh_connect failed: %1").arg(job->error),
+                 {FleetFailPhase::Resolve, job->why.code});
+            return false;
+        }
+        s.addrs = job->addrs;
+        s.phaseStartMs = nowMs;
+        s.phase = Phase::TcpConnect;
+        return true;
+    }
+
+    case Phase::TcpConnect: {
+        QString terr;
+        SshTcpConnect::Failure why;
+        if (s.tcpFd < 0) {
+            // Next address (IPv6 and IPv4 in resolver order).
+            while (s.tcpFd < 0 && s.addrIndex < s.addrs.size())
+                s.tcpFd = SshTcpConnect::startConnect(s.addrs[s.addrIndex++], &terr, &why);
+            if (s.tcpFd < 0) {
+                fail(s, QStringLiteral("connect_failed"),
+                     QCoreApplication::translate("SshClient", "ssh_connect failed: %1").arg(terr),
+                     {FleetFailPhase::Connect, why.code});
+                return false;
+            }
+        }
+
+        // Stays non-blocking: the session is, and a stalled peer must not
+        // block send() on a loop thread.
+        const int rc = SshTcpConnect::pollConnect(s.tcpFd, 0, &terr, true, &why);
+        if (rc == 0) return false;
+        if (rc < 0) {
+            s.tcpFd = -1;   // closed by pollConnect()
+            if (s.addrIndex < s.addrs.size()) return true;
+            fail(s, QStringLiteral("connect_failed"),
+                 QCoreApplication::translate("SshClient", "ssh_connect failed: %1").arg(terr),
+                 {FleetFailPhase::Connect, why.code});
+            return false;
+        }
+
+        socket_t fd = s.tcpFd;
+        if (ssh_options_set(s.ssh, SSH_OPTIONS_FD, &fd) != SSH_OK) {
+            fail(s, QStringLiteral("connect_failed"), sessionError(s.ssh),
+                 {FleetFailPhase::Config, 0});
+            return false;
+        }
+        s.tcpFd = -1;   // owned by the session now
+        s.r.tcpMs = nowMs - s.phaseStartMs;
+        s.phaseStartMs = nowMs;
+        s.phase = Phase::Connect;
+        return true;
+    }
+
+    case Phase::Connect: {
+        const int rc = ssh_connect(s.ssh);
+        if (rc == SSH_AGAIN) return false;
+        if (rc != SSH_OK) {
+            fail(s, QStringLiteral("connect_failed"),
+                 QCoreApplication::translate("SshClient", "ssh_connect failed: %1")
+                     .arg(sessionError(s.ssh)),
+                 {FleetFailPhase::Kex, ssh_get_error_code(s.ssh)});
+            return false;
+        }
+        s.r.kexMs = nowMs - s.phaseStartMs;
+        s.phaseStartMs = nowMs;
+        s.phase = Phase::Auth;
+        return true;
+    }
+
+    case Phase::Auth: {
+        if (!s.auth) {
+            s.auth = std::make_unique<SshSessionSetup::Authenticator>(
+                s.ssh, SshSessionSetup::authProfileKey(s.profile),
+                QString("user='%1' host='%2'").arg(s.r.user, s.r.host), &s.cb);
+        }
+        const int rc = s.auth->step();
+        if (rc == SSH_AUTH_AGAIN) return false;
+        s.auth.reset();
+        if (rc != SSH_AUTH_SUCCESS) {
+            fail(s, QStringLiteral("auth_failed"),
+                 QCoreApplication::translate("SshClient", "Public-key auth failed: %1")
+                     .arg(sessionError(s.ssh)),
+                 {FleetFailPhase::Auth, ssh_get_error_code(s.ssh)});
+            return false;
+        }
+        s.r.connectMs = s.clock.elapsed();
+        s.r.authMs = nowMs - s.phaseStartMs;
+        s.phaseStartMs = nowMs;
+        s.phase = Phase::OpenChannel;
+        return true;
+    }
+
+    case Phase::OpenChannel: {
+        if (!s.ch) s.ch = ssh_channel_new(s.ssh);
+        if (!s.ch) {
+            fail(s, QStringLiteral("exec_failed"), sessionError(s.ssh), {FleetFailPhase::Exec, 0});
+            return false;
+        }
+        const int rc = ssh_channel_open_session(s.ch);
+        if (rc == SSH_AGAIN) return false;
+        if (rc != SSH_OK) {
+            fail(s, QStringLiteral("exec_failed"), sessionError(s.ssh), {FleetFailPhase::Exec, 0});
+            return false;
+        }
+        s.phase = Phase::Exec;
+        return true;
+    }
+
+    case Phase::Exec: {
+        const QByteArray cmd = m_opt.command.toUtf8();
+        const int rc = ssh_channel_request_exec(s.ch, cmd.constData());
+        if (rc == SSH_AGAIN) return false;
+        if (rc != SSH_OK) {
+            fail(s, QStringLiteral("exec_failed"), sessionError(s.ssh), {FleetFailPhase::Exec, 0});
+            return false;
+        }
+        s.r.channelMs = nowMs - s.phaseStartMs;
+        s.phaseStartMs = nowMs;
+        s.phase = Phase::Collect;
+        s.deadlineMs = nowMs + m_opt.commandTimeoutMs;
+        return true;
+    }
+
+    case Phase::Collect: {
+        char buf[kReadChunk];
+        for (int isStderr = 0; isStderr < 2; ++isStderr) {
+            for (;;) {
+                const int n = ssh_channel_read_nonblocking(s.ch, buf, sizeof(buf), isStderr);
+                if (n > 0) {
+                    (isStderr ? s.capture->err() : s.capture->out()).append(buf, n);
+                    if (!isStderr) s.digest->addData(buf, n);
+                    continue;
+                }
+                if (n == SSH_ERROR) {
+                    fail(s, QStringLiteral("exec_failed"), sessionError(s.ssh), {FleetFailPhase::Exec, 0});
+                    return false;
+                }
+                break;   // 0 = nothing buffered, SSH_EOF = stream done
+            }
+        }
+
+        if (!ssh_channel_is_eof(s.ch) && !ssh_channel_is_closed(s.ch))
+            return false;
+
+        // Exit status usually arrives with EOF; give it a moment otherwise.
+        if (s.eofAtMs < 0) s.eofAtMs = nowMs;
+        const int status = ssh_channel_get_exit_status(s.ch);
+        if (status < 0 && !ssh_channel_is_closed(s.ch) &&
+            nowMs - s.eofAtMs < kExitStatusGraceMs)
+            return false;
+
+        s.r.exitStatus = status;
+        s.r.execMs = nowMs - s.phaseStartMs;
+        if (status == 0) {
+            s.r.state = FleetTargetState::Ok;
+            s.reason = QStringLiteral("ok");
+        } else {
+            // Same wording as SshClient::execCapture().
+            const QString e = s.capture->err().text().trimmed();
+            s.r.state = FleetTargetState::Failed;
+            s.r.cause.phase = FleetFailPhase::Exec;
+            if (status < 0)
+                s.r.error = T("Command failed");
+            else if (e.isEmpty())
+                s.r.error = QCoreApplication::translate("SshClient", "Remote command failed (exit %1).").arg(status);
+            else
+                s.r.error = QCoreApplication::translate("SshClient", "Remote command failed (exit %1): %2")
+                                .arg(status).arg(e.left(2000));
+            s.reason = QStringLiteral("exec_failed");
+        }
+        s.phase = Phase::Done;
+        return false;
+    }
+
+    case Phase::Done:
+        break;
+    }
+    return false;
+}
@@ -0,0 +1,113 @@
+// FleetEventEngine.h
+//
+// Purpose:
+//   Run one command on hundreds or thousands of hosts from a few threads.
+//   A blocking SshClient needs one thread (and stack) per running target;
+//   here every target is a non-blocking libssh session driven as a small
+//   state machine
+//
+//       Resolve -> TcpConnect -> Connect (KEX) -> Auth -> OpenChannel
+//               -> Exec -> Collect -> done
+//
+//   and each event-loop thread multiplexes many of them with poll() over the
+//   session sockets (plus a slow tick, since libssh may hold buffered data).
+//
+// Limits:
+//   - setup and auth are SshClient's (SshSessionSetup: algorithms, auth
+//     method cache, agent, publickey_auto); like the thread path there is
+//     no passphrase prompt, so encrypted keys must be in the agent
+//   - name resolution (getaddrinfo) runs on a small resolver pool
+//     (8 threads); a loop only checks whether its lookups are done,
+//     so a slow resolver delays those targets and not the whole loop
+//   - targets behind jump hosts are not supported here (FleetExecutor runs
+//     them on the thread pool); a ProxyCommand from ~/.ssh/config is, but
+//     then ssh_connect() does DNS + TCP itself (untimed, see SshTcpConnect)
+//
+// Threading:
+//   start()/cancel() on the owner's thread. Signals are delivered on the
+//   owner's thread.
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicInteger>
+#include <QThreadPool>
+
+#include "FleetTypes.h"
+#include "FleetConcurrency.h"
+#include "../SshProfile.h"
+#include "../SshExecCapture.h"
+
+class QThread;
+
+class FleetEventEngine : public QObject
+{
+    Q_OBJECT
+public:
+    struct Target {
+        int profileIndex = -1;
+        SshProfile profile;
+    };
+
+    struct Options {
+        QString command;
+        int maxInFlight = 256;          // sessions open at once (all loops)
+        int loopThreads = 0;            // <= 0 = fleet/eventThreads or auto
+        int connectTimeoutMs = 15000;   // connect + auth
+        int commandTimeoutMs = 90000;   // exec + collect
+        SshExecStream::Limits outLimits; // spillPrefix is set per target
+        SshExecStream::Limits errLimits;
+        FleetConcurrency* admission = nullptr; // optional: global/group slots
+    };
+
+    explicit FleetEventEngine(QObject* parent = nullptr);
+    ~FleetEventEngine() override;
+
+    void start(const QVector<Target>& targets, const Options& opt);
+    void cancel();
+    bool isRunning() const { return m_loopsRunning > 0; }
+
+    // Per-process open file limit, raised to the hard limit if it is lower
+    // than needed (one socket per session). Returns the resulting soft limit.
+    static int ensureFileLimit(int needed);
+
+signals:
+    void targetStarted(int profileIndex);
+    // reason: audit key ("ok", "connect_failed", "auth_failed", "timeout",
+    // "exec_failed", "canceled", "empty_user_or_host", "empty_command")
+    void targetFinished(const FleetResultPtr& result, const QString& reason);
+    void finished();
+
+private:
+    struct Session;
+
+    enum class Take { Taken, Wait, Drained };
+
+    void runLoop(int perLoopCap);
+    // Next target that may start now (admission); Wait while all remaining
+    // targets are held back by the concurrency limit or their group cap.
+    Take takeNext(Target* out, bool* admitted);
+    void report(Session& s);
+
+    // Session setup; false when the target already failed.
+    bool begin(Session& s);
+    // One non-blocking step; true when the session moved on and should be
+    // stepped again right away.
+    bool step(Session& s, qint64 nowMs);
+    // reason: audit key; error: display text; cause: for retry / backoff.
+    void fail(Session& s, const QString& reason, const QString& error, FleetFailCause cause);
+
+    Options m_opt;
+
+    QMutex         m_queueMutex;
+    QVector<Target> m_queue;
+    int            m_queueCursor = 0;
+
+    QThreadPool         m_resolvers;   // blocking getaddrinfo() off the loops
+
+    QAtomicInteger<int> m_cancel { 0 };
+    QVector<QThread*>   m_loops;
+    int                 m_loopsRunning = 0;   // owner thread only
+};
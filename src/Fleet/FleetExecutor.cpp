@@ -1,10 +1,7 @@
 // FleetExecutor.cpp
 #include "FleetExecutor.h"
 
-#include <QtConcurrent/QtConcurrent>
-#include <QThreadPool>
 #include <QFutureWatcher>
-#include <QSharedPointer>
 #include <QUuid>
 #include <QDateTime>
 #include <QElapsedTimer>
@@ -12,8 +9,18 @@
 #include <QCryptographicHash>
 #include <QJsonObject>
 #include <QCoreApplication>
+#include <QStandardPaths>
+#include <QDir>
+#include <QRegularExpression>
+#include <QFileInfo>
+#include <QTimer>
 
 #include "../AuditLogger.h"
+#include "../SshExecCapture.h"
+#include "../WorkScheduler.h"
+#include "FleetHistoryStore.h"
+#include "FleetOutputDigest.h"
+#include "FleetPush.h"
 
 // =====================================================
 // Helpers
@@ -45,6 +52,8 @@ static QString actionToTitle(const FleetAction& a)
             return a.title.isEmpty() ? T("Check service") : a.title;
         case FleetActionType::RestartService:
             return a.title.isEmpty() ? T("Restart service") : a.title;
+        case FleetActionType::PushFile:
+            return a.title.isEmpty() ? T("Push file") : a.title;
     }
     return a.title;
 }
@@ -67,6 +76,11 @@ static QString buildCommand(const FleetAction& a)
         return QString("sudo systemctl restart %1 && systemctl is-active %1").arg(x);
     }
 
+    if (a.type == FleetActionType::PushFile) {
+        // No shell command: FleetPushJob does the transfer (see runOneTarget).
+        return QString();
+    }
+
     return x;
 }
 
@@ -106,6 +120,62 @@ static QJsonObject commandAuditFields(const QString& cmd, int timeoutMs, int mod
     return f;
 }
 
+// Connect phases measured by SshClient (see FleetTargetResult).
+static void applyConnectTimings(FleetTargetResult* r, const SshClient::ConnectTimings& t)
+{
+    r->dnsMs  = t.dnsMs;
+    r->tcpMs  = t.tcpMs;
+    r->kexMs  = t.kexMs;
+    r->authMs = t.authMs;
+}
+
+// SshClient's connect failure as the result's structured cause.
+static FleetFailCause connectCause(const SshClient::ConnectFailure& f)
+{
+    using Phase = SshClient::ConnectFailure::Phase;
+    FleetFailPhase phase = FleetFailPhase::Config;
+    switch (f.phase) {
+        case Phase::None:
+        case Phase::Config:  phase = FleetFailPhase::Config;  break;
+        case Phase::Resolve: phase = FleetFailPhase::Resolve; break;
+        case Phase::Connect: phase = FleetFailPhase::Connect; break;
+        case Phase::Tunnel:  phase = FleetFailPhase::Tunnel;  break;
+        case Phase::Kex:     phase = FleetFailPhase::Kex;     break;
+        case Phase::Auth:    phase = FleetFailPhase::Auth;    break;
+    }
+    return FleetFailCause{phase, f.code};
+}
+
+// Phase latencies for audit events; phases not reached are left out.
+static void addPhaseFields(QJsonObject* f, const FleetTargetResult& r)
+{
+    const struct { const char* key; qint64 ms; } phases[] = {
+        {"dnsMs", r.dnsMs}, {"tcpMs", r.tcpMs}, {"kexMs", r.kexMs},
+        {"authMs", r.authMs}, {"channelMs", r.channelMs}, {"execMs", r.execMs},
+    };
+    for (const auto& p : phases) {
+        if (p.ms >= 0) f->insert(QLatin1String(p.key), double(p.ms));
+    }
+}
+
+// Complete outputs that did not fit in memory, one directory per job.
+static QString fleetSpillRoot()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/fleet-output";
+}
+
+// Memory kept per target and stream; the rest is counted and spilled to disk.
+static SshExecStream::Limits fleetStreamLimits(const QString& jobId, const QString& prefix)
+{
+    SshExecStream::Limits l;
+    l.headBytes = 32 * 1024;
+    l.tailBytes = 32 * 1024;
+    l.spillToDisk = true;
+    l.spillDir = fleetSpillRoot() + "/" + jobId;
+    l.spillPrefix = prefix;
+    return l;
+}
+
 static void mergeJson(QJsonObject* dst, const QJsonObject& src)
 {
     if (!dst) return;
@@ -120,11 +190,45 @@ static void mergeJson(QJsonObject* dst, const QJsonObject& src)
 FleetExecutor::FleetExecutor(QObject* parent)
     : QObject(parent)
 {
+    const QString engine = QSettings().value("fleet/engine", "auto").toString();
+    if (engine == QLatin1String("threads"))        m_engineMode = Engine::Threads;
+    else if (engine == QLatin1String("eventloop")) m_engineMode = Engine::EventLoop;
+
+    m_store = new FleetResultStore(this);
+
+    m_adaptive = QSettings().value("fleet/adaptive", false).toBool();
+    setGroupCaps(QSettings().value("fleet/groupCaps").toString());
+
+    m_admission = new FleetConcurrency(this);
+    // Slots freed by the event engine (or another target) let held-back
+    // thread-path targets start.
+    connect(m_admission, &FleetConcurrency::capacityAvailable, this, [this]() {
+        if (m_running) startNextTargets();
+    }, Qt::QueuedConnection);
+    connect(m_admission, &FleetConcurrency::limitChanged,
+            this, &FleetExecutor::concurrencyChanged, Qt::QueuedConnection);
+
+    m_engine = new FleetEventEngine(this);
+    connect(m_engine, &FleetEventEngine::targetStarted, this, &FleetExecutor::onEngineTargetStarted);
+    connect(m_engine, &FleetEventEngine::targetFinished, this, &FleetExecutor::onEngineTargetFinished);
+    connect(m_engine, &FleetEventEngine::finished, this, [this]() {
+        m_engineActive = false;
+        finishJobIfDone();
+    });
 }
 
 void FleetExecutor::setMaxConcurrency(int n)
 {
-    m_maxConcurrency = qBound(1, n, 32);
+    m_maxConcurrency = qBound(1, n, kMaxConcurrency);
+}
+
+bool FleetExecutor::setGroupCaps(const QString& spec, QString* err)
+{
+    QHash<QString, int> caps;
+    if (!FleetConcurrency::parseGroupCaps(spec, &caps, err))
+        return false;
+    m_groupCaps = caps;
+    return true;
 }
 
 void FleetExecutor::clearWatchers()
@@ -141,6 +245,14 @@ void FleetExecutor::clearWatchers()
 void FleetExecutor::cancel()
 {
     m_cancelRequested.storeRelease(1);
+    if (m_engine) m_engine->cancel();
+
+    // Targets backing off for a retry are reported as canceled right away.
+    if (!m_retryWaiting.isEmpty()) {
+        m_queue += m_retryWaiting;
+        m_retryWaiting.clear();
+        startNextTargets();
+    }
 }
 
 void FleetExecutor::start(const QVector<SshProfile>& profiles,
@@ -163,138 +275,368 @@ void FleetExecutor::start(const QVector<SshProfile>& profiles,
     m_job.title = actionToTitle(action);
     m_job.profileIndexes = profileIndexes;
     m_job.action = action;
+    m_job.concurrency = m_maxConcurrency;
     m_job.startedAt = QDateTime::currentDateTime();
-    m_job.results.clear();
 
     m_total = profileIndexes.size();
     m_done  = 0;
+    m_attempts.clear();
+    m_retryWaiting.clear();
 
-    // Set global pool concurrency (QtConcurrent uses global pool by default)
-    QThreadPool::globalInstance()->setMaxThreadCount(m_maxConcurrency);
+    {
+        FleetConcurrency::Options ao;
+        ao.maxLimit = m_maxConcurrency;
+        ao.adaptive = m_adaptive;
+        ao.groupCaps = m_groupCaps;
+        m_admission->reset(ao);
+    }
+
+    // Every target is listed (queued) from the start.
+    {
+        QVector<FleetResultPtr> rows;
+        rows.reserve(profileIndexes.size());
+        for (int profileIndex : profileIndexes)
+            rows.push_back(makeFleetResult(placeholderResult(profileIndex)));
+        m_store->reset(rows);
+    }
+
+    // Spilled outputs of old jobs are only kept for a week.
+    SshExecCapture::purgeOldSpills(fleetSpillRoot(), 7);
+
+    const bool isPush = action.type == FleetActionType::PushFile;
+    const QString cmdText = isPush
+        ? QString("push %1 -> %2").arg(action.payload.trimmed(), action.remotePath.trimmed())
+        : buildCommand(action);
+
+    m_push.reset();
+    if (isPush) {
+        FleetPushJob::Options po;
+        po.remotePath = action.remotePath.trimmed();
+        po.mode = action.remoteMode;
+        po.relay = action.relay;
+        po.timeoutMs = (m_commandTimeoutMs > 0) ? m_commandTimeoutMs : (90 * 1000);
+        m_push = QSharedPointer<FleetPushJob>::create(action.payload.trimmed(), po);
+    }
+
+    FleetHistoryStore::instance()->recordJobStarted(m_job, cmdText, m_total);
 
     emit jobStarted(m_job);
+    emit concurrencyChanged(m_admission->limit(), QString());
+
+    const int timeoutMs = (m_commandTimeoutMs > 0) ? m_commandTimeoutMs : (90 * 1000);
+    const int cmdLogMode = qBound(0, QSettings().value("audit/commandLogMode", 1).toInt(), 2);
+    m_cmdAudit = commandAuditFields(cmdText, timeoutMs, cmdLogMode);
+    if (isPush) {
+        m_cmdAudit.insert("push_remote", action.remotePath.trimmed());
+        m_cmdAudit.insert("push_mode", QString::number(action.remoteMode, 8));
+        m_cmdAudit.insert("push_relay", action.relay);
+        if (cmdLogMode >= 1)
+            m_cmdAudit.insert("push_local", QFileInfo(action.payload.trimmed()).fileName());
+    }
+
+    // Event loop when asked for, or (auto) when more targets should run at
+    // once than threads are worth. Targets behind jump hosts and invalid
+    // indexes always take the thread path, and so do file pushes (SFTP).
+    const bool useEngine = !isPush &&
+        (m_engineMode == Engine::EventLoop ||
+         (m_engineMode == Engine::Auto && m_maxConcurrency > kMaxThreadTargets));
+
+    QVector<int> threadTargets;
+    QVector<FleetEventEngine::Target> engineTargets;
+    for (int profileIndex : profileIndexes) {
+        const bool valid = profileIndex >= 0 && profileIndex < m_profilesSnapshot.size();
+        if (useEngine && valid &&
+            parseProxyJump(m_profilesSnapshot[profileIndex].proxyJump).isEmpty()) {
+            FleetEventEngine::Target t;
+            t.profileIndex = profileIndex;
+            t.profile = m_profilesSnapshot[profileIndex];
+            engineTargets.push_back(t);
+        } else {
+            threadTargets.push_back(profileIndex);
+        }
+    }
+
+    // Work queue: m_threadConcurrency targets in flight; each one that
+    // finishes reports right away and its slot pulls the next target.
+    m_queue = threadTargets;
+    m_queueCursor = 0;
+    m_inFlight = 0;
+    m_threadConcurrency = qMin(m_maxConcurrency, kMaxThreadTargets);
+
+    m_engineActive = !engineTargets.isEmpty();
+    if (m_engineActive) {
+        FleetEventEngine::Options opt;
+        opt.command = buildCommand(action);
+        opt.maxInFlight = m_maxConcurrency;
+        opt.commandTimeoutMs = timeoutMs;
+        opt.outLimits = fleetStreamLimits(m_job.id, QString());
+        opt.errLimits = fleetStreamLimits(m_job.id, QString());
+        opt.admission = m_admission;
+        m_engine->start(engineTargets, opt);
+    }
+
+    startNextTargets();
+}
+
+// ------------------------------------------------------------
+// Event-loop path
+// ------------------------------------------------------------
+void FleetExecutor::onEngineTargetStarted(int profileIndex)
+{
+    if (profileIndex >= 0 && profileIndex < m_profilesSnapshot.size())
+        auditTargetStart(m_profilesSnapshot[profileIndex], profileIndex, m_job.action);
+    markRunning(profileIndex);
+}
+
+void FleetExecutor::onEngineTargetFinished(const FleetResultPtr& result, const QString& reason)
+{
+    // Engine runs first attempts only; retries go through the thread queue.
+    if (result->state == FleetTargetState::Failed) {
+        m_attempts[result->profileIndex] = 1;
+        if (maybeRetry(*result)) return;
+    }
+
+    const FleetTargetResult& r = *result;
+
+    // Same audit events as runOneTarget() (reason keys are not translated).
+    QJsonObject fields{
+        {"jobId", m_job.id},
+        {"profileIndex", r.profileIndex},
+        {"profileName", r.profileName},
+        {"durationMs", (int)r.durationMs},
+        {"engine", "eventloop"}
+    };
+    addPhaseFields(&fields, r);
+
+    if (reason == QLatin1String("ok")) {
+        AuditLogger::writeEvent("fleet.target.success", fields);
+    } else if (reason == QLatin1String("canceled")) {
+        fields.insert("reason", "cancel_requested");
+        AuditLogger::writeEvent("fleet.target.canceled", fields);
+    } else if (reason == QLatin1String("connect_failed") || reason == QLatin1String("auth_failed")) {
+        fields.insert("error", r.error.left(400));
+        AuditLogger::writeEvent("fleet.target.connect_failed", fields);
+    } else {
+        fields.insert("reason", reason);
+        fields.insert("error", r.error.left(400));
+        AuditLogger::writeEvent("fleet.target.failed", fields);
+    }
+
+    publishResult(result);
+}
 
-    // Nothing to do
-    if (profileIndexes.isEmpty()) {
+// ------------------------------------------------------------
+// Result publishing (both paths)
+// ------------------------------------------------------------
+void FleetExecutor::markRunning(int profileIndex)
+{
+    FleetTargetResult r = placeholderResult(profileIndex);
+    r.state = FleetTargetState::Running;
+    m_store->publish(makeFleetResult(std::move(r)));
+    emit targetStarted(profileIndex);
+}
+
+void FleetExecutor::publishResult(FleetTargetResult r)
+{
+    publishResult(makeFleetResult(std::move(r)));
+}
+
+void FleetExecutor::publishResult(const FleetResultPtr& r)
+{
+    m_store->publish(r);
+    FleetHistoryStore::instance()->recordTarget(m_job.id, r);
+    m_done++;
+    emit targetFinished(r->profileIndex, r);
+    emit jobProgress(m_done, m_total);
+}
+
+void FleetExecutor::finishJobIfDone()
+{
+    if (m_running && !m_engineActive && m_inFlight == 0 && m_queueCursor >= m_queue.size() &&
+        m_retryWaiting.isEmpty()) {
         m_running = false;
+        m_job.finishedAt = QDateTime::currentDateTime();
+        FleetHistoryStore::instance()->recordJobFinished(m_job.id, m_job.finishedAt);
         emit jobFinished(m_job);
-        return;
     }
+}
 
-    const int chunkSize = qMax(1, m_maxConcurrency);
+FleetTargetResult FleetExecutor::placeholderResult(int profileIndex) const
+{
+    FleetTargetResult r;
+    r.profileIndex = profileIndex;
 
-    auto cursor = QSharedPointer<int>::create(0);
-    auto startNextChunk = QSharedPointer<std::function<void()>>::create();
+    if (profileIndex >= 0 && profileIndex < m_profilesSnapshot.size()) {
+        const auto& p = m_profilesSnapshot[profileIndex];
+        r.profileName = p.name;
+        r.group = p.group;
+        r.user = p.user;
+        r.host = p.host;
+        r.port = (p.port > 0) ? p.port : 22;
+    }
+    return r;
+}
 
-    *startNextChunk = [this, cursor, startNextChunk, profileIndexes, chunkSize]() mutable {
+// ------------------------------------------------------------
+// startNextTargets()
+// ------------------------------------------------------------
+void FleetExecutor::startNextTargets()
+{
+    if (m_cancelRequested.loadAcquire() != 0) {
+        // Targets not started yet are reported as canceled right away;
+        // running ones finish (they check the flag between steps).
+        while (m_queueCursor < m_queue.size()) {
+            FleetTargetResult r = placeholderResult(m_queue[m_queueCursor++]);
+            r.state = FleetTargetState::Canceled;
+            r.error = T("Canceled");
+            r.cause.phase = FleetFailPhase::Canceled;
+            publishResult(std::move(r));
+        }
+    }
 
-        if (m_cancelRequested.loadAcquire() != 0) {
-            while (*cursor < profileIndexes.size()) {
-                const int profileIndex = profileIndexes[*cursor];
-                (*cursor)++;
+    int profileIndex = -1;
+    while (m_inFlight < m_threadConcurrency && takeNextTarget(&profileIndex)) {
+        if (profileIndex < 0 || profileIndex >= m_profilesSnapshot.size()) {
+            FleetTargetResult r = placeholderResult(profileIndex);
+            r.state = FleetTargetState::Failed;
+            r.error = T("Invalid profile index");
+            r.cause.phase = FleetFailPhase::Config;
+            publishResult(std::move(r));
+            continue;
+        }
 
-                FleetTargetResult r;
-                r.profileIndex = profileIndex;
+        auto *watcher = new QFutureWatcher<FleetTargetResult>(this);
+        m_watchers.push_back(watcher);
+        m_inFlight++;
 
-                if (profileIndex >= 0 && profileIndex < m_profilesSnapshot.size()) {
-                    const auto& p = m_profilesSnapshot[profileIndex];
-                    r.profileName = p.name;
-                    r.group = p.group;
-                    r.user = p.user;
-                    r.host = p.host;
-                    r.port = (p.port > 0) ? p.port : 22;
-                }
+        connect(watcher, &QFutureWatcher<FleetTargetResult>::finished,
+                this, [this, watcher]() {
+            m_inFlight--;
+            m_watchers.removeAll(watcher);
+            watcher->deleteLater();
 
-                r.state = FleetTargetState::Canceled;
-                r.error = T("Canceled");
-                m_job.results.push_back(r);
-                m_done++;
-                emit jobProgress(m_job, m_done, m_total);
+            FleetTargetResult r = watcher->future().result();
+            m_admission->release(r);
+            if (!maybeRetry(r)) {
+                if (r.attempts > 1 && r.state == FleetTargetState::Failed)
+                    r.error = T("%1 (after %2 attempts)").arg(r.error).arg(r.attempts);
+                publishResult(std::move(r));
             }
+            startNextTargets();
+        });
 
-            m_running = false;
-            emit jobFinished(m_job);
-            return;
-        }
+        markRunning(profileIndex);
+
+        const SshProfile p = m_profilesSnapshot[profileIndex];
+        const FleetAction action = m_job.action;
+        const int attempt = ++m_attempts[profileIndex];
+        // Fleet lane: own pool, yields to interactive work before each target.
+        watcher->setFuture(WorkScheduler::instance()->run(WorkScheduler::Lane::Fleet,
+                                                          [this, p, profileIndex, action, attempt]() {
+            FleetTargetResult r = runOneTarget(p, profileIndex, action);
+            r.attempts = attempt;
+            return r;
+        }));
+    }
+
+    finishJobIfDone();
+}
 
-        if (*cursor >= profileIndexes.size()) {
-            m_running = false;
-            emit jobFinished(m_job);
-            return;
+bool FleetExecutor::takeNextTarget(int* profileIndex)
+{
+    // First target whose group has room; skipped ones keep their order.
+    for (int i = m_queueCursor; i < m_queue.size(); ++i) {
+        const int idx = m_queue[i];
+        const bool valid = idx >= 0 && idx < m_profilesSnapshot.size();
+
+        // Invalid indexes fail right away and take no slot.
+        if (valid && !m_admission->tryAcquire(m_profilesSnapshot[idx].group)) {
+            if (m_admission->inFlight() >= m_admission->limit()) return false;
+            continue;
         }
 
-        QVector<int> chunk;
-        chunk.reserve(chunkSize);
+        for (int j = i; j > m_queueCursor; --j)
+            m_queue[j] = m_queue[j - 1];
+        m_queue[m_queueCursor++] = idx;
+        *profileIndex = idx;
+        return true;
+    }
+    return false;
+}
 
-        for (int i = 0; i < chunkSize && *cursor < profileIndexes.size(); ++i) {
-            chunk.push_back(profileIndexes[*cursor]);
-            (*cursor)++;
-        }
+// ------------------------------------------------------------
+// maybeRetry() / requeueRetry()
+// ------------------------------------------------------------
+bool FleetExecutor::maybeRetry(const FleetTargetResult& r)
+{
+    if (m_cancelRequested.loadAcquire() != 0)
+        return false;
 
-        using ChunkResult = QVector<FleetTargetResult>;
-        auto *watcher = new QFutureWatcher<ChunkResult>(this);
-        m_watchers.push_back(watcher);
+    int delayMs = 0;
+    if (!m_retry.shouldRetry(r, r.attempts, &delayMs))
+        return false;
 
-        QObject::connect(watcher, &QFutureWatcher<ChunkResult>::finished,
-                         this, [this, watcher, startNextChunk]() mutable {
+    const int maxAttempts = m_retry.options().maxAttempts;
+    const QString firstLine = r.error.section('\n', 0, 0).left(200);
 
-            const ChunkResult results = watcher->future().result();
+    qInfo().noquote() << QString("[FLEET] retry %1 (attempt %2/%3) in %4 ms: %5")
+                             .arg(r.host).arg(r.attempts + 1).arg(maxAttempts).arg(delayMs).arg(firstLine);
 
-            for (const auto& r : results) {
-                m_job.results.push_back(r);
-                m_done++;
-            }
-            emit jobProgress(m_job, m_done, m_total);
+    AuditLogger::writeEvent("fleet.target.retry", {
+        {"jobId", m_job.id},
+        {"profileIndex", r.profileIndex},
+        {"profileName", r.profileName},
+        {"attempt", r.attempts},
+        {"maxAttempts", maxAttempts},
+        {"delayMs", delayMs},
+        {"errorClass", FleetRetryPolicy::className(FleetRetryPolicy::classify(r))},
+        {"error", r.error.left(400)}
+    });
 
-            watcher->deleteLater();
+    // The row shows the wait; it is not a result yet (m_done unchanged).
+    FleetTargetResult row = placeholderResult(r.profileIndex);
+    row.attempts = r.attempts;
+    row.error = T("Retry %1/%2 in %3 ms: %4")
+                    .arg(r.attempts + 1).arg(maxAttempts).arg(delayMs).arg(firstLine);
+    m_store->publish(makeFleetResult(std::move(row)));
+    emit targetRetrying(r.profileIndex, r.attempts + 1, delayMs, firstLine);
+
+    m_retryWaiting.push_back(r.profileIndex);
+    QTimer::singleShot(delayMs, this, [this, idx = r.profileIndex, jobId = m_job.id]() {
+        requeueRetry(idx, jobId);
+    });
+    return true;
+}
 
-            (*startNextChunk)();
-        });
+void FleetExecutor::requeueRetry(int profileIndex, const QString& jobId)
+{
+    // Canceled (already reported) or a newer job started meanwhile.
+    if (jobId != m_job.id || !m_retryWaiting.removeOne(profileIndex))
+        return;
 
-        watcher->setFuture(QtConcurrent::run([this, chunk]() -> ChunkResult {
-            ChunkResult out;
-            out.reserve(chunk.size());
-
-            for (int profileIndex : chunk) {
-
-                if (m_cancelRequested.loadAcquire() != 0) {
-                    FleetTargetResult r;
-                    r.profileIndex = profileIndex;
-
-                    if (profileIndex >= 0 && profileIndex < m_profilesSnapshot.size()) {
-                        const auto& p = m_profilesSnapshot[profileIndex];
-                        r.profileName = p.name;
-                        r.group = p.group;
-                        r.user = p.user;
-                        r.host = p.host;
-                        r.port = (p.port > 0) ? p.port : 22;
-                    }
-
-                    r.state = FleetTargetState::Canceled;
-                    r.error = T("Canceled");
-                    out.push_back(r);
-                    continue;
-                }
-
-                if (profileIndex < 0 || profileIndex >= m_profilesSnapshot.size()) {
-                    FleetTargetResult r;
-                    r.profileIndex = profileIndex;
-                    r.state = FleetTargetState::Failed;
-                    r.error = T("Invalid profile index");
-                    out.push_back(r);
-                    continue;
-                }
-
-                out.push_back(runOneTarget(m_profilesSnapshot[profileIndex],
-                                           profileIndex,
-                                           m_job.action));
-            }
+    m_queue.push_back(profileIndex);
+    startNextTargets();
+}
 
-            return out;
-        }));
+// ---- Audit: target start ----
+void FleetExecutor::auditTargetStart(const SshProfile& p, int profileIndex, const FleetAction& action)
+{
+    QJsonObject fields{
+        {"jobId", m_job.id},
+        {"profileIndex", profileIndex},
+        {"profileName", p.name},
+        {"group", p.group},
+        {"user", p.user},
+        {"host", p.host},
+        {"port", (p.port > 0) ? p.port : 22},
+        {"actionType", (int)action.type},
+        {"actionTitle", actionToTitle(action)},
     };
-
-    (*startNextChunk)();
+    // Jump hosts: targets behind a bastion share one bastion session.
+    if (!parseProxyJump(p.proxyJump).isEmpty())
+        fields.insert("proxyJump", proxyJumpToString(parseProxyJump(p.proxyJump)));
+    mergeJson(&fields, m_cmdAudit);
+    AuditLogger::writeEvent("fleet.target.start", fields);
 }
 
 FleetTargetResult FleetExecutor::runOneTarget(const SshProfile& p,
@@ -313,31 +655,17 @@ FleetTargetResult FleetExecutor::runOneTarget(const SshProfile& p,
         (m_commandTimeoutMs > 0) ? m_commandTimeoutMs : (90 * 1000);
 
     const QString cmd = buildCommand(action);
+    const QSharedPointer<FleetPushJob> push = m_push;   // set for PushFile jobs
 
-    // NEW: 0=none, 1=safe, 2=full. Default = safe.
-    const int cmdLogMode = qBound(0, QSettings().value("audit/commandLogMode", 1).toInt(), 2);
-    const QJsonObject cmdMeta = commandAuditFields(cmd, timeoutMs, cmdLogMode);
+    // 0=none, 1=safe, 2=full (computed once per job in start()).
+    const QJsonObject cmdMeta = m_cmdAudit;
 
-    // ---- Audit: target start ----
-    {
-        QJsonObject fields{
-            {"jobId", m_job.id},
-            {"profileIndex", profileIndex},
-            {"profileName", p.name},
-            {"group", p.group},
-            {"user", p.user},
-            {"host", p.host},
-            {"port", r.port},
-            {"actionType", (int)action.type},
-            {"actionTitle", actionToTitle(action)},
-        };
-        mergeJson(&fields, cmdMeta);
-        AuditLogger::writeEvent("fleet.target.start", fields);
-    }
+    auditTargetStart(p, profileIndex, action);
 
     if (m_cancelRequested.loadAcquire() != 0) {
         r.state = FleetTargetState::Canceled;
         r.error = T("Canceled");
+        r.cause.phase = FleetFailPhase::Canceled;
 
         // keep audit reason keys stable (not translated)
         AuditLogger::writeEvent("fleet.target.canceled", {
@@ -353,6 +681,7 @@ FleetTargetResult FleetExecutor::runOneTarget(const SshProfile& p,
     if (p.user.trimmed().isEmpty() || p.host.trimmed().isEmpty()) {
         r.state = FleetTargetState::Failed;
         r.error = T("Empty user/host");
+        r.cause.phase = FleetFailPhase::Config;
 
         AuditLogger::writeEvent("fleet.target.failed", {
             {"jobId", m_job.id},
@@ -364,9 +693,10 @@ FleetTargetResult FleetExecutor::runOneTarget(const SshProfile& p,
         return r;
     }
 
-    if (cmd.trimmed().isEmpty()) {
+    if (!push && cmd.trimmed().isEmpty()) {
         r.state = FleetTargetState::Failed;
         r.error = T("Empty command/service");
+        r.cause.phase = FleetFailPhase::Config;
 
         AuditLogger::writeEvent("fleet.target.failed", {
             {"jobId", m_job.id},
@@ -384,33 +714,79 @@ FleetTargetResult FleetExecutor::runOneTarget(const SshProfile& p,
     SshClient client;
     QString err;
 
-    if (!client.connectProfile(p, &err)) {
+    const bool connected = client.connectProfile(p, &err);
+    applyConnectTimings(&r, client.lastConnectTimings());
+
+    if (!connected) {
         r.state = (m_cancelRequested.loadAcquire() != 0) ? FleetTargetState::Canceled : FleetTargetState::Failed;
         r.error = err;
+        r.cause = (r.state == FleetTargetState::Canceled)
+                    ? FleetFailCause{FleetFailPhase::Canceled, 0}
+                    : connectCause(client.lastConnectFailure());
         r.durationMs = t.elapsed();
 
-        AuditLogger::writeEvent("fleet.target.connect_failed", {
+        QJsonObject fields{
             {"jobId", m_job.id},
             {"profileIndex", profileIndex},
             {"profileName", p.name},
             {"durationMs", (int)r.durationMs},
             {"error", err.left(400)}
-        });
+        };
+        addPhaseFields(&fields, r);
+        AuditLogger::writeEvent("fleet.target.connect_failed", fields);
 
         return r;
     }
 
-    QString out, e;
-    const bool ok = client.exec(cmd, &out, &e, timeoutMs);
+    r.connectMs = t.elapsed();
+
+    if (push)
+        return runPush(client, p, profileIndex, push.data(), std::move(r), t);
+
+    // Bounded capture: head/tail in memory, complete output spilled to disk.
+    QString safeHost = p.host;
+    safeHost.replace(QRegularExpression("[^A-Za-z0-9._-]"), "_");
+    SshExecCapture capture(fleetStreamLimits(m_job.id, QString("%1-%2-stdout-").arg(profileIndex).arg(safeHost)),
+                           fleetStreamLimits(m_job.id, QString("%1-%2-stderr-").arg(profileIndex).arg(safeHost)));
+
+    SshClient::ExecOptions opt;
+    opt.timeoutMs = timeoutMs;
+    opt.maxOutputBytes = 0; // memory is bounded by the capture; disk by maxSpillBytes
+
+    // Fingerprint stdout while it streams (output grouping).
+    FleetOutputDigest digest(p.host, p.name);
+    opt.onOutput = [&digest](const QByteArray& chunk, bool isStderr) {
+        if (!isStderr) digest.addData(chunk.constData(), chunk.size());
+    };
+
+    SshClient::ExecResult xr;
+    QString e;
+    const bool ok = client.execCapture(cmd, &capture, &e, opt, &xr);
 
     client.disconnect();
 
-    r.durationMs = t.elapsed();
-    r.stdoutText = out;
-    r.stderrText = e;
+    r.durationMs  = t.elapsed();
+    r.stdoutText  = capture.out().text();
+    r.stderrText  = capture.err().text();
+    if (r.stderrText.isEmpty())
+        r.stderrText = e;   // exec error (timeout, channel failure), as stored before
+    r.exitStatus  = xr.exitStatus;
+    r.stdoutBytes = capture.out().totalBytes();
+    r.stderrBytes = capture.err().totalBytes();
+    r.outputTruncated = capture.out().isTruncated() || capture.err().isTruncated();
+    r.stdoutSpillPath = capture.out().keepSpill();
+    r.stderrSpillPath = capture.err().keepSpill();
+    r.channelMs   = xr.channelMs;
+    r.execMs      = (xr.channelMs >= 0) ? xr.elapsedMs : -1;
+
+    if (r.exitStatus >= 0) {
+        digest.finish();
+        r.stdoutDigest      = digest.exact();
+        r.stdoutShapeDigest = digest.similar();
+    }
 
-    const QString outPreview = out.trimmed().left(240);
-    const QString errPreview = e.trimmed().left(240);
+    const QString outPreview = r.stdoutText.trimmed().left(240);
+    const QString errPreview = r.stderrText.trimmed().left(240);
 
     {
         QJsonObject fields{
@@ -420,9 +796,13 @@ FleetTargetResult FleetExecutor::runOneTarget(const SshProfile& p,
             {"durationMs", (int)r.durationMs},
             {"timeoutMs", timeoutMs},
             {"ok", ok},
+            {"exitStatus", r.exitStatus},
+            {"stdoutBytes", double(r.stdoutBytes)},
+            {"stderrBytes", double(r.stderrBytes)},
             {"stdoutPreview", outPreview},
             {"stderrPreview", errPreview}
         };
+        addPhaseFields(&fields, r);
         mergeJson(&fields, cmdMeta);
         AuditLogger::writeEvent("fleet.target.exec_done", fields);
     }
@@ -430,6 +810,7 @@ FleetTargetResult FleetExecutor::runOneTarget(const SshProfile& p,
     if (m_cancelRequested.loadAcquire() != 0) {
         r.state = FleetTargetState::Canceled;
         r.error = T("Canceled");
+        r.cause.phase = FleetFailPhase::Canceled;
 
         AuditLogger::writeEvent("fleet.target.canceled", {
             {"jobId", m_job.id},
@@ -443,14 +824,13 @@ FleetTargetResult FleetExecutor::runOneTarget(const SshProfile& p,
 
     if (!ok) {
         const QString trimmed = e.trimmed();
-        const bool looksTimeout =
-            trimmed.contains("timed out", Qt::CaseInsensitive) ||
-            trimmed.contains("timeout", Qt::CaseInsensitive);
+        const bool timedOut = xr.timedOut;
 
         r.state = FleetTargetState::Failed;
-        r.error = looksTimeout
+        r.error = timedOut
                     ? Tms("Timeout after %1 ms", timeoutMs)
                     : (trimmed.isEmpty() ? T("Command failed") : trimmed);
+        r.cause.phase = timedOut ? FleetFailPhase::Timeout : FleetFailPhase::Exec;
 
         AuditLogger::writeEvent("fleet.target.failed", {
             {"jobId", m_job.id},
@@ -458,7 +838,7 @@ FleetTargetResult FleetExecutor::runOneTarget(const SshProfile& p,
             {"profileName", p.name},
             {"durationMs", (int)r.durationMs},
             {"timeoutMs", timeoutMs},
-            {"reason", looksTimeout ? "timeout" : "exec_failed"},
+            {"reason", timedOut ? "timeout" : "exec_failed"},
             {"error", r.error.left(400)}
         });
 
@@ -477,3 +857,60 @@ FleetTargetResult FleetExecutor::runOneTarget(const SshProfile& p,
 
     return r;
 }
+
+// ------------------------------------------------------------
+// runPush()
+// ------------------------------------------------------------
+FleetTargetResult FleetExecutor::runPush(SshClient& client, const SshProfile& p, int profileIndex,
+                                         FleetPushJob* push, FleetTargetResult r, const QElapsedTimer& t)
+{
+    const bool ok = push->pushTo(client, p, &r, m_cancelRequested);
+    client.disconnect();
+    r.durationMs = t.elapsed();
+    r.execMs = r.durationMs - r.connectMs;
+
+    if (m_cancelRequested.loadAcquire() != 0) {
+        r.state = FleetTargetState::Canceled;
+        r.error = T("Canceled");
+        r.cause.phase = FleetFailPhase::Canceled;
+
+        AuditLogger::writeEvent("fleet.target.canceled", {
+            {"jobId", m_job.id},
+            {"profileIndex", profileIndex},
+            {"profileName", p.name},
+            {"reason", "cancel_requested_during_push"}
+        });
+        return r;
+    }
+
+    if (!ok) {
+        r.state = FleetTargetState::Failed;
+        if (r.error.trimmed().isEmpty()) r.error = T("Push failed");
+        r.cause.phase = FleetFailPhase::Exec;
+
+        AuditLogger::writeEvent("fleet.target.failed", {
+            {"jobId", m_job.id},
+            {"profileIndex", profileIndex},
+            {"profileName", p.name},
+            {"durationMs", (int)r.durationMs},
+            {"reason", "push_failed"},
+            {"error", r.error.left(400)}
+        });
+        return r;
+    }
+
+    r.state = FleetTargetState::Ok;
+    r.stdoutBytes = r.stdoutText.toUtf8().size();
+
+    QJsonObject fields{
+        {"jobId", m_job.id},
+        {"profileIndex", profileIndex},
+        {"profileName", p.name},
+        {"durationMs", (int)r.durationMs},
+        {"bytes", double(push->source().size())},
+        {"sha256", QString::fromLatin1(push->source().sha256Hex())}
+    };
+    addPhaseFields(&fields, r);
+    AuditLogger::writeEvent("fleet.target.success", fields);
+    return r;
+}
@@ -7,20 +7,50 @@
 #include <QElapsedTimer>
 #include <QPointer>
 #include <QSpinBox>
+#include <QJsonObject>
+#include <QSharedPointer>
 
 #include "FleetTypes.h"
+#include "FleetEventEngine.h"
+#include "FleetResultStore.h"
+#include "FleetConcurrency.h"
+#include "FleetRetry.h"
 #include "../SshClient.h"
 #include "../ProfileStore.h" // for SshProfile
 
+class FleetPushJob;
+
 class FleetExecutor : public QObject
 {
     Q_OBJECT
 public:
     explicit FleetExecutor(QObject* parent = nullptr);
 
-    void setMaxConcurrency(int n);  // default 4
+    // Blocking SshClient per target on the fleet pool (at most kMaxThreadTargets
+    // at once), or many non-blocking sessions on a few event-loop threads.
+    enum class Engine { Auto, Threads, EventLoop };
+
+    static constexpr int kMaxThreadTargets = 32;
+    static constexpr int kMaxConcurrency   = 2000;
+
+    void setMaxConcurrency(int n);  // default 4, up to kMaxConcurrency
     int  maxConcurrency() const { return m_maxConcurrency; }
 
+    // Auto (default, setting fleet/engine): event loop above kMaxThreadTargets.
+    void setEngine(Engine e) { m_engineMode = e; }
+    Engine engine() const { return m_engineMode; }
+
+    // Adaptive concurrency (AIMD, see FleetConcurrency); the max concurrency
+    // is the ceiling. Group caps: "dmz=10, *=50" (fleet/groupCaps).
+    void setAdaptiveConcurrency(bool on) { m_adaptive = on; }
+    bool adaptiveConcurrency() const { return m_adaptive; }
+    bool setGroupCaps(const QString& spec, QString* err = nullptr);
+
+    // Retries of transient connect failures (see FleetRetryPolicy); default:
+    // no retry.
+    void setRetryPolicy(const FleetRetryPolicy::Options& opt) { m_retry = FleetRetryPolicy(opt); }
+    const FleetRetryPolicy& retryPolicy() const { return m_retry; }
+
     void setCommandTimeoutMs(int ms) { m_commandTimeoutMs = ms; } // ms <= 0 => default
     int  commandTimeoutMs() const { return m_commandTimeoutMs; }
 
@@ -33,25 +63,79 @@ public:
 
     void cancel();
 
-    signals:
-        void jobStarted(const FleetJob& job);
-    void jobProgress(const FleetJob& job, int done, int total);
+    // Results of the current (or last) job, one row per target.
+    FleetResultStore* resultStore() const { return m_store; }
+
+signals:
+    // Per-target deltas; full results are read from resultStore().
+    void jobStarted(const FleetJob& job);
+    void targetStarted(int profileIndex);
+    void targetFinished(int profileIndex, const FleetResultPtr& result);
+    void jobProgress(int done, int total);
     void jobFinished(const FleetJob& job);
+    // Current concurrency limit; why is the back-off reason on a decrease.
+    void concurrencyChanged(int limit, const QString& why);
+    // A target failed transiently and goes back into the queue after delayMs.
+    void targetRetrying(int profileIndex, int nextAttempt, int delayMs, const QString& error);
 
 private:
     FleetTargetResult runOneTarget(const SshProfile& p, int profileIndex, const FleetAction& action);
+    // PushFile after connect: transfer, verify, move into place.
+    FleetTargetResult runPush(SshClient& client, const SshProfile& p, int profileIndex,
+                              FleetPushJob* push, FleetTargetResult r, const QElapsedTimer& t);
+    FleetTargetResult placeholderResult(int profileIndex) const;
+    void auditTargetStart(const SshProfile& p, int profileIndex, const FleetAction& action);
+
+    void markRunning(int profileIndex);
+    void publishResult(FleetTargetResult r);
+    void publishResult(const FleetResultPtr& r);  // store, history, signals
+
+    void onEngineTargetStarted(int profileIndex);
+    void onEngineTargetFinished(const FleetResultPtr& r, const QString& reason);
+    void finishJobIfDone();
+
+    // Keep m_threadConcurrency targets in flight; finishes the job when the
+    // queue is drained and nothing is running.
+    void startNextTargets();
+    // Next queued target allowed to start (admission); false = none now.
+    bool takeNextTarget(int* profileIndex);
+
+    // Schedule another attempt for a failed target (both paths); false =
+    // final result, publish it.
+    bool maybeRetry(const FleetTargetResult& r);
+    void requeueRetry(int profileIndex, const QString& jobId);
 
     int m_commandTimeoutMs = 90 * 1000; // default 90s (can be overridden by UI)
     int m_maxConcurrency   = 4;
+    int m_threadConcurrency = 4;     // thread path share of this job
+    bool m_adaptive = false;
+    QHash<QString, int> m_groupCaps;
+    FleetConcurrency* m_admission = nullptr;  // shared by both paths
+    FleetRetryPolicy m_retry;
+    QHash<int, int> m_attempts;      // profile index -> tries started
+    QVector<int> m_retryWaiting;     // backing off before the next try
+    Engine m_engineMode = Engine::Auto;
 
     bool m_running = false;
     QAtomicInteger<int> m_cancelRequested { 0 };
 
     QVector<SshProfile> m_profilesSnapshot;
     FleetJob m_job;
+    FleetResultStore* m_store = nullptr;
+
+    // Target queue: profile indexes in order, next one to start, running now.
+    QVector<int> m_queue;
+    int m_queueCursor = 0;
+    int m_inFlight = 0;
+
+    // Event-loop path (targets without jump hosts when it is in use)
+    FleetEventEngine* m_engine = nullptr;
+    bool m_engineActive = false;
+    QJsonObject m_cmdAudit;          // command audit fields of this job
+    QSharedPointer<FleetPushJob> m_push;  // PushFile jobs: one source for all targets
 
-    // One watcher per chunk (simple concurrency without custom queue)
-    QVector<QPointer<QFutureWatcher<QVector<FleetTargetResult>>>> m_watchers;
+    // One watcher per running target
+    QVector<QPointer<QFutureWatcher<FleetTargetResult>>> m_watchers;
 
     int m_total = 0;
     int m_done  = 0;
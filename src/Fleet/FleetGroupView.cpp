@@ -0,0 +1,146 @@
+// FleetGroupView.cpp
+#include "FleetGroupView.h"
+
+#include <QHeaderView>
+
+namespace {
+enum Role {
+    ProfileIndexRole = Qt::UserRole,   // host rows
+    GroupSizeRole    = Qt::UserRole + 1
+};
+
+QString firstLines(const QString& text, int maxLines)
+{
+    const QStringList lines = text.left(4096).split('\n');
+    QStringList out;
+    for (const QString& l : lines) {
+        if (out.size() >= maxLines) { out << QStringLiteral("…"); break; }
+        out << l.trimmed();
+    }
+    while (!out.isEmpty() && out.last().isEmpty()) out.removeLast();
+    return out.join(QStringLiteral(" ⏎ "));
+}
+
+// Group rows sort by size (largest first), host rows by name.
+class GroupItem : public QTreeWidgetItem
+{
+public:
+    using QTreeWidgetItem::QTreeWidgetItem;
+    bool operator<(const QTreeWidgetItem& other) const override
+    {
+        const QVariant a = data(0, GroupSizeRole);
+        const QVariant b = other.data(0, GroupSizeRole);
+        const int col = treeWidget() ? treeWidget()->sortColumn() : 0;
+        if (col == 0 && a.isValid() && b.isValid())
+            return a.toInt() > b.toInt();
+        return QTreeWidgetItem::operator<(other);
+    }
+};
+}
+
+FleetGroupView::FleetGroupView(QWidget* parent)
+    : QTreeWidget(parent)
+{
+    setColumnCount(3);
+    setHeaderLabels({tr("Hosts"), tr("Result"), tr("Output")});
+    setUniformRowHeights(true);
+    setAlternatingRowColors(true);
+    header()->setStretchLastSection(true);
+    header()->setSectionResizeMode(0, QHeaderView::Interactive);
+    setColumnWidth(0, 260);
+    setColumnWidth(1, 120);
+    setSortingEnabled(true);
+    sortByColumn(0, Qt::AscendingOrder);
+
+    connect(this, &QTreeWidget::itemActivated, this, [this](QTreeWidgetItem* it) {
+        const QVariant v = it ? it->data(0, ProfileIndexRole) : QVariant();
+        if (v.isValid())
+            emit targetActivated(v.toInt());
+    });
+}
+
+QByteArray FleetGroupView::groupKey(const FleetTargetResult& r) const
+{
+    if (r.exitStatus >= 0 && !r.stdoutDigest.isEmpty()) {
+        return "x:" + QByteArray::number(r.exitStatus) + ':' +
+               (m_similar ? r.stdoutShapeDigest : r.stdoutDigest);
+    }
+    const QString why = r.error.section('\n', 0, 0).trimmed().left(200);
+    return "e:" + QByteArray::number(int(r.state)) + ':' + why.toUtf8();
+}
+
+void FleetGroupView::setSimilarMode(bool on)
+{
+    m_similar = on;
+}
+
+void FleetGroupView::clearGroups()
+{
+    clear();
+    m_groups.clear();
+}
+
+void FleetGroupView::rebuild(const QVector<FleetResultPtr>& results)
+{
+    // Sort once at the end instead of on every insert.
+    setUpdatesEnabled(false);
+    setSortingEnabled(false);
+    clearGroups();
+    for (const FleetResultPtr& r : results)
+        addResult(r);
+    setSortingEnabled(true);
+    setUpdatesEnabled(true);
+}
+
+void FleetGroupView::addResult(const FleetResultPtr& r)
+{
+    if (!r) return;
+    if (r->state == FleetTargetState::Queued || r->state == FleetTargetState::Running)
+        return;
+
+    const QByteArray key = groupKey(*r);
+    QTreeWidgetItem* group = m_groups.value(key);
+    if (!group) {
+        group = new GroupItem(this);
+        m_groups.insert(key, group);
+
+        QString result;
+        if (r->exitStatus >= 0)
+            result = tr("exit %1").arg(r->exitStatus);
+        else if (r->state == FleetTargetState::Canceled)
+            result = tr("canceled");
+        else
+            result = tr("failed");
+        group->setText(1, result);
+
+        // The first member's output stands for the group.
+        const QString shown = (r->exitStatus >= 0) ? r->stdoutText : r->error;
+        group->setText(2, firstLines(shown, 3));
+        group->setToolTip(2, shown.left(4096));
+    }
+
+    auto* host = new GroupItem(group);
+    host->setText(0, r->profileName.isEmpty() ? r->host : r->profileName);
+    host->setText(1, QString("%1@%2").arg(r->user, r->host));
+    host->setText(2, firstLines(r->exitStatus >= 0 ? r->stdoutText : r->error, 1));
+    host->setData(0, ProfileIndexRole, r->profileIndex);
+
+    updateGroupHeader(group);
+}
+
+void FleetGroupView::updateGroupHeader(QTreeWidgetItem* group)
+{
+    const int n = group->childCount();
+    group->setData(0, GroupSizeRole, n);
+
+    // Name a few hosts like dshbak does ("web01, web02, … (+38)").
+    QStringList names;
+    for (int i = 0; i < n && i < 3; ++i)
+        names << group->child(i)->text(0);
+    QString label = tr("%n host(s)", nullptr, n);
+    if (!names.isEmpty())
+        label += QStringLiteral(" — ") + names.join(QStringLiteral(", "));
+    if (n > names.size())
+        label += QStringLiteral(", … (+%1)").arg(n - names.size());
+    group->setText(0, label);
+}
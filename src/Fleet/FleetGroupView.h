@@ -0,0 +1,50 @@
+// FleetGroupView.h
+//
+// Purpose:
+//   dshbak-style view of fleet results: targets with the same outcome are
+//   one group ("412 hosts — exit 0") with the shared output shown once and
+//   the hosts listed under it. 800 identical `uname -r` rows become a few
+//   groups to read.
+//
+//   Group key:
+//     - command ran:    (exit status, stdout digest)
+//     - command didn't: (state, first line of the error)
+//   In similar mode the digest ignores host names and numbers
+//   (FleetOutputDigest::similar()).
+//
+//   Groups update live as targets finish (addResult()); the largest group
+//   is kept on top.
+
+#pragma once
+
+#include <QTreeWidget>
+#include <QHash>
+
+#include "FleetTypes.h"
+
+class FleetGroupView : public QTreeWidget
+{
+    Q_OBJECT
+public:
+    explicit FleetGroupView(QWidget* parent = nullptr);
+
+    void setSimilarMode(bool on);
+    bool similarMode() const { return m_similar; }
+
+    void clearGroups();
+    void addResult(const FleetResultPtr& r);
+    void rebuild(const QVector<FleetResultPtr>& results);
+
+    int groupCount() const { return m_groups.size(); }
+
+signals:
+    // A host row was activated.
+    void targetActivated(int profileIndex);
+
+private:
+    QByteArray groupKey(const FleetTargetResult& r) const;
+    void updateGroupHeader(QTreeWidgetItem* group);
+
+    bool m_similar = false;
+    QHash<QByteArray, QTreeWidgetItem*> m_groups;
+};
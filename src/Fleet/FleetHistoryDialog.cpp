@@ -0,0 +1,401 @@
+// FleetHistoryDialog.cpp
+#include "FleetHistoryDialog.h"
+
+#include <QComboBox>
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QIntValidator>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSet>
+#include <QSignalBlocker>
+#include <QSplitter>
+#include <QTabWidget>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "../WorkScheduler.h"
+
+namespace {
+constexpr int kMaxResults = 2000;
+
+QString timeText(qint64 ms)
+{
+    return ms > 0 ? QDateTime::fromMSecsSinceEpoch(ms).toString("yyyy-MM-dd HH:mm:ss") : QString();
+}
+
+QFont monoFont()
+{
+    QFont mono("Monospace");
+    mono.setStyleHint(QFont::TypeWriter);
+    return mono;
+}
+
+// Lines only in one of the two outputs, in output order ("-" older, "+" newer).
+QString lineChanges(const QString& older, const QString& newer)
+{
+    const QStringList a = older.split('\n');
+    const QStringList b = newer.split('\n');
+    QSet<QString> inA, inB;
+    for (const QString& l : a) inA.insert(l);
+    for (const QString& l : b) inB.insert(l);
+
+    QStringList out;
+    for (const QString& l : a)
+        if (!inB.contains(l)) out << "- " + l;
+    for (const QString& l : b)
+        if (!inA.contains(l)) out << "+ " + l;
+    return out.join('\n');
+}
+}
+
+FleetHistoryDialog::FleetHistoryDialog(QWidget* parent)
+    : QDialog(parent)
+{
+    setAttribute(Qt::WA_DeleteOnClose, true);
+    setWindowTitle(tr("Fleet job history"));
+    resize(1100, 720);
+
+    auto* root = new QVBoxLayout(this);
+
+    // Filters
+    auto* filters = new QHBoxLayout();
+    m_hostEdit = new QLineEdit(this);
+    m_hostEdit->setPlaceholderText(tr("Host"));
+    m_hostEdit->setClearButtonEnabled(true);
+
+    m_exitEdit = new QLineEdit(this);
+    m_exitEdit->setPlaceholderText(tr("Exit status"));
+    m_exitEdit->setValidator(new QIntValidator(-1, 255, m_exitEdit));
+    m_exitEdit->setMaximumWidth(90);
+
+    m_periodCombo = new QComboBox(this);
+    m_periodCombo->addItem(tr("Last 24 hours"), 24 * 3600);
+    m_periodCombo->addItem(tr("Last 7 days"), 7 * 24 * 3600);
+    m_periodCombo->addItem(tr("Last 30 days"), 30 * 24 * 3600);
+    m_periodCombo->addItem(tr("Last 90 days"), 90 * 24 * 3600);
+    m_periodCombo->addItem(tr("All time"), 0);
+    m_periodCombo->setCurrentIndex(2);
+
+    m_textEdit = new QLineEdit(this);
+    m_textEdit->setPlaceholderText(tr("Search output and errors…"));
+    m_textEdit->setClearButtonEnabled(true);
+
+    m_searchBtn = new QPushButton(tr("Search"), this);
+    m_searchBtn->setDefault(true);
+
+    filters->addWidget(m_hostEdit, 1);
+    filters->addWidget(m_exitEdit);
+    filters->addWidget(m_periodCombo);
+    filters->addWidget(m_textEdit, 2);
+    filters->addWidget(m_searchBtn);
+    root->addLayout(filters);
+
+    // Jobs | targets / output
+    auto* split = new QSplitter(Qt::Horizontal, this);
+
+    m_jobs = new QTreeWidget(split);
+    m_jobs->setColumnCount(3);
+    m_jobs->setHeaderLabels({tr("Started"), tr("Job"), tr("Targets")});
+    m_jobs->setRootIsDecorated(false);
+    m_jobs->setUniformRowHeights(true);
+    m_jobs->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+
+    auto* rightSplit = new QSplitter(Qt::Vertical, split);
+
+    m_entries = new QTreeWidget(rightSplit);
+    m_entries->setColumnCount(6);
+    m_entries->setHeaderLabels({tr("Finished"), tr("Host"), tr("Result"),
+                                tr("Duration"), tr("Output"), tr("Job")});
+    m_entries->setRootIsDecorated(false);
+    m_entries->setUniformRowHeights(true);
+    m_entries->setAlternatingRowColors(true);
+    m_entries->header()->setStretchLastSection(true);
+    m_entries->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+
+    auto* outPane = new QWidget(rightSplit);
+    auto* outL = new QVBoxLayout(outPane);
+    outL->setContentsMargins(0, 0, 0, 0);
+    m_output = new QPlainTextEdit(outPane);
+    m_output->setReadOnly(true);
+    m_output->setLineWrapMode(QPlainTextEdit::NoWrap);
+    m_output->setFont(monoFont());
+    m_compareBtn = new QPushButton(tr("Compare runs on this host…"), outPane);
+    m_compareBtn->setEnabled(false);
+    auto* outBar = new QHBoxLayout();
+    outBar->addStretch(1);
+    outBar->addWidget(m_compareBtn);
+    outL->addWidget(m_output, 1);
+    outL->addLayout(outBar);
+
+    rightSplit->setStretchFactor(0, 3);
+    rightSplit->setStretchFactor(1, 2);
+    split->setStretchFactor(0, 1);
+    split->setStretchFactor(1, 3);
+    split->setSizes({320, 780});
+    root->addWidget(split, 1);
+
+    m_status = new QLabel(this);
+    m_status->setStyleSheet("color:#888;");
+    root->addWidget(m_status);
+
+    connect(m_searchBtn, &QPushButton::clicked, this, &FleetHistoryDialog::runQuery);
+    connect(m_hostEdit, &QLineEdit::returnPressed, this, &FleetHistoryDialog::runQuery);
+    connect(m_exitEdit, &QLineEdit::returnPressed, this, &FleetHistoryDialog::runQuery);
+    connect(m_textEdit, &QLineEdit::returnPressed, this, &FleetHistoryDialog::runQuery);
+    connect(m_periodCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &FleetHistoryDialog::runQuery);
+    connect(m_jobs, &QTreeWidget::currentItemChanged, this, &FleetHistoryDialog::runQuery);
+    connect(m_entries, &QTreeWidget::currentItemChanged, this, &FleetHistoryDialog::onEntryChanged);
+    connect(m_entries, &QTreeWidget::itemActivated, this, &FleetHistoryDialog::onCompareClicked);
+    connect(m_compareBtn, &QPushButton::clicked, this, &FleetHistoryDialog::onCompareClicked);
+
+    connect(&m_jobsWatcher, &QFutureWatcher<QVector<FleetHistoryJob>>::finished, this, [this]() {
+        const QVector<FleetHistoryJob> jobs = m_jobsWatcher.result();
+
+        const QSignalBlocker block(m_jobs);
+        m_jobs->clear();
+        auto* all = new QTreeWidgetItem(m_jobs, {QString(), tr("All jobs"), QString()});
+        for (const FleetHistoryJob& j : jobs) {
+            auto* it = new QTreeWidgetItem(m_jobs, {timeText(j.startedMs),
+                                                    j.title.isEmpty() ? j.id : j.title,
+                                                    QString::number(j.targetCount)});
+            it->setData(0, Qt::UserRole, j.id);
+            it->setToolTip(1, j.command);
+        }
+        m_jobs->setCurrentItem(all);
+        runQuery();
+    });
+
+    connect(&m_queryWatcher, &QFutureWatcher<QVector<FleetHistoryEntry>>::finished, this, [this]() {
+        showEntries(m_queryWatcher.result());
+        if (m_queryPending) {
+            m_queryPending = false;
+            runQuery();
+        }
+    });
+
+    reloadJobs();
+}
+
+QString FleetHistoryDialog::stateText(const FleetHistoryEntry& e)
+{
+    if (e.exitStatus >= 0)
+        return tr("exit %1").arg(e.exitStatus);
+    switch (e.state) {
+    case FleetTargetState::Canceled: return tr("Canceled");
+    case FleetTargetState::Ok:       return tr("OK");
+    default:                         return tr("Failed");
+    }
+}
+
+// ------------------------------------------------------------
+// reloadJobs() / runQuery()
+// ------------------------------------------------------------
+void FleetHistoryDialog::reloadJobs()
+{
+    m_status->setText(tr("Loading history…"));
+    m_jobsWatcher.setFuture(WorkScheduler::instance()->run(WorkScheduler::Lane::Interactive, []() {
+        FleetHistoryStore* store = FleetHistoryStore::instance();
+        store->flush();   // include the job that just ran
+        return store->recentJobs();
+    }));
+}
+
+FleetHistoryQuery FleetHistoryDialog::currentQuery() const
+{
+    FleetHistoryQuery q;
+    if (QTreeWidgetItem* it = m_jobs->currentItem())
+        q.jobId = it->data(0, Qt::UserRole).toString();
+    q.host = m_hostEdit->text().trimmed();
+
+    bool ok = false;
+    const int exitStatus = m_exitEdit->text().trimmed().toInt(&ok);
+    if (ok) {
+        q.filterExit = true;
+        q.exitStatus = exitStatus;
+    }
+
+    const qint64 periodSec = m_periodCombo->currentData().toLongLong();
+    if (periodSec > 0)
+        q.fromMs = QDateTime::currentMSecsSinceEpoch() - periodSec * 1000;
+
+    q.text = m_textEdit->text().trimmed();
+    q.limit = kMaxResults;
+    return q;
+}
+
+void FleetHistoryDialog::runQuery()
+{
+    if (m_jobsWatcher.isRunning())
+        return;   // runs when the job list is in
+    if (m_queryWatcher.isRunning()) {
+        m_queryPending = true;
+        return;
+    }
+
+    const FleetHistoryQuery q = currentQuery();
+    m_status->setText(q.text.isEmpty() ? tr("Searching…") : tr("Searching stored output…"));
+
+    m_queryWatcher.setFuture(WorkScheduler::instance()->run(WorkScheduler::Lane::Interactive, [q]() {
+        return FleetHistoryStore::instance()->find(q);
+    }));
+}
+
+void FleetHistoryDialog::showEntries(const QVector<FleetHistoryEntry>& entries)
+{
+    m_results = entries;
+    m_output->clear();
+    m_compareBtn->setEnabled(false);
+
+    FleetHistoryStore* store = FleetHistoryStore::instance();
+    QHash<int, QString> jobTitles;
+
+    m_entries->setUpdatesEnabled(false);
+    m_entries->clear();
+    for (int i = 0; i < m_results.size(); ++i) {
+        const FleetHistoryEntry& e = m_results[i];
+        if (!jobTitles.contains(e.job)) {
+            const FleetHistoryJob j = store->jobAt(e.job);
+            jobTitles.insert(e.job, j.title.isEmpty() ? j.id : j.title);
+        }
+
+        auto* it = new QTreeWidgetItem(m_entries, {
+            timeText(e.finishedMs),
+            e.profileName.isEmpty() ? e.host : QString("%1 (%2)").arg(e.host, e.profileName),
+            stateText(e),
+            tr("%1 ms").arg(e.durationMs),
+            QString::number(e.stdoutBytes + e.stderrBytes),
+            jobTitles.value(e.job)});
+        it->setData(0, Qt::UserRole, i);
+        if (!e.error.isEmpty())
+            it->setToolTip(2, e.error);
+    }
+    m_entries->setUpdatesEnabled(true);
+
+    m_status->setText(m_results.size() >= kMaxResults
+                          ? tr("%1 targets (limit reached; narrow the filters)").arg(m_results.size())
+                          : tr("%1 targets").arg(m_results.size()));
+}
+
+void FleetHistoryDialog::onEntryChanged(QTreeWidgetItem* current)
+{
+    m_output->clear();
+    m_compareBtn->setEnabled(current != nullptr);
+    if (!current) return;
+
+    const FleetHistoryEntry& e = m_results.value(current->data(0, Qt::UserRole).toInt());
+
+    QString out, err, msg;
+    FleetHistoryStore::instance()->readOutput(e, &out, &err, &msg);
+
+    QString text;
+    if (!e.error.isEmpty()) text += tr("Error: %1").arg(e.error) + "\n\n";
+    if (!msg.isEmpty())     text += msg + "\n\n";
+    text += out;
+    if (!err.isEmpty())     text += "\n" + tr("--- stderr ---") + "\n" + err;
+    m_output->setPlainText(text);
+}
+
+void FleetHistoryDialog::onCompareClicked()
+{
+    QTreeWidgetItem* it = m_entries->currentItem();
+    if (!it) return;
+    showRuns(m_results.value(it->data(0, Qt::UserRole).toInt()));
+}
+
+// ------------------------------------------------------------
+// showRuns(): the same command on one host across jobs
+// ------------------------------------------------------------
+void FleetHistoryDialog::showRuns(const FleetHistoryEntry& e)
+{
+    FleetHistoryStore* store = FleetHistoryStore::instance();
+    const QVector<FleetHistoryEntry> runs = store->runsOnHost(e);
+    const FleetHistoryJob job = store->jobAt(e.job);
+
+    auto* dlg = new QDialog(this);
+    dlg->setAttribute(Qt::WA_DeleteOnClose, true);
+    dlg->setWindowTitle(tr("Runs on %1").arg(e.host));
+    dlg->resize(980, 640);
+
+    auto* v = new QVBoxLayout(dlg);
+    auto* head = new QLabel(tr("<b>%1</b> — %n run(s) of: <code>%2</code>", nullptr, runs.size())
+                                .arg(e.host.toHtmlEscaped(), job.command.left(300).toHtmlEscaped()), dlg);
+    head->setWordWrap(true);
+    v->addWidget(head);
+
+    auto* split = new QSplitter(Qt::Vertical, dlg);
+
+    auto* list = new QTreeWidget(split);
+    list->setColumnCount(4);
+    list->setHeaderLabels({tr("Finished"), tr("Result"), tr("Duration"), tr("Output vs previous run")});
+    list->setRootIsDecorated(false);
+    list->setUniformRowHeights(true);
+    list->header()->setStretchLastSection(true);
+    list->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+
+    // runs are newest first: run i is compared with run i + 1.
+    for (int i = 0; i < runs.size(); ++i) {
+        const FleetHistoryEntry& r = runs[i];
+        QString cmp;
+        if (i + 1 >= runs.size())
+            cmp = tr("first run");
+        else if (r.stdoutDigest.isEmpty() || runs[i + 1].stdoutDigest.isEmpty())
+            cmp = tr("—");
+        else
+            cmp = (r.stdoutDigest == runs[i + 1].stdoutDigest) ? tr("same") : tr("changed");
+
+        auto* it = new QTreeWidgetItem(list, {timeText(r.finishedMs), stateText(r),
+                                              tr("%1 ms").arg(r.durationMs), cmp});
+        it->setData(0, Qt::UserRole, i);
+        if (r.id == e.id) list->setCurrentItem(it);
+    }
+
+    auto* tabs = new QTabWidget(split);
+    auto* outView = new QPlainTextEdit(tabs);
+    auto* diffView = new QPlainTextEdit(tabs);
+    for (QPlainTextEdit* w : {outView, diffView}) {
+        w->setReadOnly(true);
+        w->setLineWrapMode(QPlainTextEdit::NoWrap);
+        w->setFont(monoFont());
+    }
+    tabs->addTab(outView, tr("Output"));
+    tabs->addTab(diffView, tr("Changes vs previous run"));
+
+    split->setStretchFactor(0, 1);
+    split->setStretchFactor(1, 2);
+    v->addWidget(split, 1);
+
+    auto show = [store, runs, outView, diffView](QTreeWidgetItem* cur) {
+        outView->clear();
+        diffView->clear();
+        if (!cur) return;
+        const int i = cur->data(0, Qt::UserRole).toInt();
+
+        QString out, err, msg;
+        if (!store->readOutput(runs[i], &out, &err, &msg)) {
+            outView->setPlainText(msg);
+            return;
+        }
+        outView->setPlainText(err.isEmpty() ? out : out + "\n--- stderr ---\n" + err);
+
+        if (i + 1 >= runs.size()) {
+            diffView->setPlainText(tr("No earlier run of this command on this host."));
+            return;
+        }
+        QString prevOut, prevErr;
+        if (!store->readOutput(runs[i + 1], &prevOut, &prevErr, &msg)) {
+            diffView->setPlainText(msg);
+            return;
+        }
+        const QString changes = lineChanges(prevOut, out);
+        diffView->setPlainText(changes.isEmpty() ? tr("No changes.") : changes);
+    };
+    connect(list, &QTreeWidget::currentItemChanged, dlg, show);
+    show(list->currentItem());
+
+    dlg->show();
+}
@@ -0,0 +1,63 @@
+// FleetHistoryDialog.h
+//
+// Purpose:
+//   Browse and search past fleet jobs (FleetHistoryStore): filter by job,
+//   host, exit status, period and text; show a target's stored output; and
+//   compare the runs of the same command on one host over time.
+//
+//   Queries run in the background (interactive lane); only a text search
+//   reads stored output.
+
+#pragma once
+
+#include <QDialog>
+#include <QFutureWatcher>
+#include <QVector>
+
+#include "FleetHistoryStore.h"
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QPlainTextEdit;
+class QPushButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+class FleetHistoryDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit FleetHistoryDialog(QWidget* parent = nullptr);
+
+private slots:
+    void reloadJobs();
+    void runQuery();
+    void onEntryChanged(QTreeWidgetItem* current);
+    void onCompareClicked();
+
+private:
+    FleetHistoryQuery currentQuery() const;
+    void showEntries(const QVector<FleetHistoryEntry>& entries);
+    void showRuns(const FleetHistoryEntry& e);
+
+    static QString stateText(const FleetHistoryEntry& e);
+
+    QLineEdit*   m_hostEdit = nullptr;
+    QLineEdit*   m_exitEdit = nullptr;
+    QComboBox*   m_periodCombo = nullptr;
+    QLineEdit*   m_textEdit = nullptr;
+    QPushButton* m_searchBtn = nullptr;
+
+    QTreeWidget*    m_jobs = nullptr;
+    QTreeWidget*    m_entries = nullptr;
+    QPlainTextEdit* m_output = nullptr;
+    QPushButton*    m_compareBtn = nullptr;
+    QLabel*         m_status = nullptr;
+
+    QVector<FleetHistoryEntry> m_results;
+
+    QFutureWatcher<QVector<FleetHistoryJob>>   m_jobsWatcher;
+    QFutureWatcher<QVector<FleetHistoryEntry>> m_queryWatcher;
+    bool m_queryPending = false;   // another query asked for while one runs
+};
@@ -0,0 +1,583 @@
+// FleetHistoryStore.cpp
+#include "FleetHistoryStore.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+
+namespace {
+constexpr quint32 kFrameMagic = 0x46485831;   // "FHX1"
+constexpr int     kFrameHeaderBytes = 4 + 1 + 4 + 2;
+constexpr int     kMaxErrorChars = 2000;
+constexpr int     kMaxScanWithText = 200000;  // candidates whose output may be read
+
+QString segmentName(int segment)
+{
+    return QString("out-%1.seg").arg(segment, 6, 10, QChar('0'));
+}
+
+int segmentNumber(const QString& fileName)
+{
+    // out-000012.seg -> 12
+    bool ok = false;
+    const int n = fileName.mid(4, 6).toInt(&ok);
+    return ok ? n : 0;
+}
+
+// Command text as audit/commandLogMode allows it on disk (the same policy as
+// the audit log): 0 = nothing, 1 = first word only ("head ..."), 2 = full.
+QString storedCommand(const QString& command)
+{
+    const int mode = qBound(0, QSettings().value("audit/commandLogMode", 1).toInt(), 2);
+    const QString trimmed = command.trimmed();
+    if (mode >= 2 || trimmed.isEmpty()) return trimmed;
+    if (mode <= 0) return QString();
+
+    const QString head = trimmed.section(' ', 0, 0).left(64);
+    return (head.size() < trimmed.size()) ? head + QStringLiteral(" ...") : head;
+}
+
+QDataStream& setup(QDataStream& ds)
+{
+    ds.setVersion(QDataStream::Qt_5_12);
+    return ds;
+}
+}
+
+// ------------------------------------------------------------
+// instance()
+// ------------------------------------------------------------
+FleetHistoryStore* FleetHistoryStore::instance()
+{
+    static FleetHistoryStore* s = new FleetHistoryStore();
+    return s;
+}
+
+FleetHistoryStore::FleetHistoryStore(QObject* parent)
+    : QObject(parent)
+{
+    m_writer.setMaxThreadCount(1);
+    m_writer.setExpiryTimeout(30 * 1000);
+
+    // Records still queued at exit would be lost or half written.
+    if (QCoreApplication* app = QCoreApplication::instance())
+        connect(app, &QCoreApplication::aboutToQuit, this, &FleetHistoryStore::flush);
+}
+
+QString FleetHistoryStore::historyDir()
+{
+    const QString root = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return QDir::cleanPath(root + "/fleet-history");
+}
+
+bool FleetHistoryStore::isEnabled() const
+{
+    return QSettings().value("fleet/historyEnabled", true).toBool();
+}
+
+QString FleetHistoryStore::segmentPath(int segment) const
+{
+    return QDir(historyDir()).filePath(segmentName(segment));
+}
+
+QString FleetHistoryStore::intern(const QString& s)
+{
+    auto it = m_strings.constFind(s);
+    if (it != m_strings.constEnd())
+        return it.value();
+    m_strings.insert(s, s);
+    return s;
+}
+
+// ------------------------------------------------------------
+// Recording
+// ------------------------------------------------------------
+void FleetHistoryStore::recordJobStarted(const FleetJob& job, const QString& command, int targetCount)
+{
+    if (!isEnabled()) return;
+
+    QByteArray payload;
+    {
+        QDataStream ds(&payload, QIODevice::WriteOnly);
+        // The hash is of the full text, so "same command" lookups work in
+        // every log mode.
+        setup(ds) << job.id << job.title << storedCommand(command)
+                  << QCryptographicHash::hash(command.toUtf8(), QCryptographicHash::Sha256).left(16)
+                  << qint32(job.action.type)
+                  << qint64(job.startedAt.toMSecsSinceEpoch())
+                  << qint32(targetCount);
+    }
+
+    QtConcurrent::run(&m_writer, [this, payload]() {
+        QMutexLocker lock(&m_mutex);
+        ensureLoadedLocked();
+        QString err;
+        if (appendRecordLocked(JobStarted, payload, &err))
+            applyRecordLocked(JobStarted, payload);
+        else
+            qWarning().noquote() << QString("[FLEET] history: %1").arg(err);
+    });
+}
+
+void FleetHistoryStore::recordTarget(const QString& jobId, const FleetResultPtr& r)
+{
+    if (!r || !isEnabled()) return;
+
+    const qint64 finishedMs = QDateTime::currentMSecsSinceEpoch();
+
+    QtConcurrent::run(&m_writer, [this, jobId, r, finishedMs]() {
+        // Compress outside the lock; queries keep running meanwhile.
+        QByteArray blob;
+        if (!r->stdoutText.isEmpty() || !r->stderrText.isEmpty()) {
+            QByteArray raw;
+            QDataStream ds(&raw, QIODevice::WriteOnly);
+            setup(ds) << r->stdoutText << r->stderrText;
+            blob = qCompress(raw, 6);
+        }
+
+        QMutexLocker lock(&m_mutex);
+        ensureLoadedLocked();
+
+        int segment = 0;
+        qint64 offset = 0;
+        QString err;
+        if (!blob.isEmpty() && !appendOutputLocked(blob, &segment, &offset, &err)) {
+            qWarning().noquote() << QString("[FLEET] history: %1").arg(err);
+            segment = 0;
+            offset = 0;
+        }
+        const int length = (segment > 0) ? blob.size() : 0;
+
+        QByteArray payload;
+        {
+            QDataStream ds(&payload, QIODevice::WriteOnly);
+            setup(ds) << jobId << r->profileName << r->user << r->host
+                      << qint32(r->state) << qint32(r->exitStatus)
+                      << qint64(finishedMs) << qint64(r->durationMs)
+                      << r->error.left(kMaxErrorChars)
+                      << qint64(r->stdoutBytes) << qint64(r->stderrBytes)
+                      << r->stdoutDigest
+                      << qint32(segment) << qint64(offset) << qint32(length);
+        }
+
+        if (appendRecordLocked(TargetFinished, payload, &err))
+            applyRecordLocked(TargetFinished, payload);
+        else
+            qWarning().noquote() << QString("[FLEET] history: %1").arg(err);
+    });
+}
+
+void FleetHistoryStore::recordJobFinished(const QString& jobId, const QDateTime& finishedAt)
+{
+    if (!isEnabled()) return;
+
+    QByteArray payload;
+    {
+        QDataStream ds(&payload, QIODevice::WriteOnly);
+        setup(ds) << jobId << qint64(finishedAt.toMSecsSinceEpoch());
+    }
+
+    QtConcurrent::run(&m_writer, [this, payload]() {
+        QMutexLocker lock(&m_mutex);
+        ensureLoadedLocked();
+        QString err;
+        if (appendRecordLocked(JobFinished, payload, &err))
+            applyRecordLocked(JobFinished, payload);
+        else
+            qWarning().noquote() << QString("[FLEET] history: %1").arg(err);
+    });
+}
+
+void FleetHistoryStore::flush()
+{
+    m_writer.waitForDone();
+}
+
+// ------------------------------------------------------------
+// Output segments
+// ------------------------------------------------------------
+bool FleetHistoryStore::appendOutputLocked(const QByteArray& blob, int* segment, qint64* offset, QString* err)
+{
+    if (err) err->clear();
+
+    if (m_segment == 0 || m_segmentSize >= kSegmentBytes) {
+        ++m_segment;
+        m_segmentSize = 0;
+        enforceRetentionLocked();
+    }
+
+    QDir().mkpath(historyDir());
+    QFile f(segmentPath(m_segment));
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        if (err) *err = tr("Cannot write %1: %2").arg(f.fileName(), f.errorString());
+        return false;
+    }
+
+    // The file size, not m_segmentSize, is the truth after a failed write.
+    const qint64 at = f.size();
+    if (f.write(blob) != blob.size()) {
+        if (err) *err = tr("Cannot write %1: %2").arg(f.fileName(), f.errorString());
+        m_segmentSize = f.size();
+        return false;
+    }
+
+    *segment = m_segment;
+    *offset = at;
+    m_segmentSize = at + blob.size();
+    return true;
+}
+
+void FleetHistoryStore::enforceRetentionLocked()
+{
+    const qint64 maxBytes =
+        qMax<qint64>(64, QSettings().value("fleet/historyMaxMB", 1024).toLongLong()) * 1024 * 1024;
+
+    QDir dir(historyDir());
+    QFileInfoList segs = dir.entryInfoList({"out-*.seg"}, QDir::Files, QDir::Name);
+
+    qint64 total = 0;
+    for (const QFileInfo& fi : segs)
+        total += fi.size();
+
+    // Oldest first; the segment being written is never removed.
+    for (const QFileInfo& fi : segs) {
+        if (total <= maxBytes) break;
+        if (segmentNumber(fi.fileName()) >= m_segment) break;
+        total -= fi.size();
+        QFile::remove(fi.absoluteFilePath());
+        qInfo().noquote() << QString("[FLEET] history: expired %1").arg(fi.fileName());
+    }
+}
+
+bool FleetHistoryStore::readOutput(const FleetHistoryEntry& e, QString* out, QString* err, QString* errMsg)
+{
+    if (out) out->clear();
+    if (err) err->clear();
+    if (errMsg) errMsg->clear();
+
+    if (e.segment <= 0 || e.length <= 0)
+        return true;   // nothing was printed
+
+    QFile f(segmentPath(e.segment));
+    if (!f.exists()) {
+        if (errMsg) *errMsg = tr("Output expired (history size limit).");
+        return false;
+    }
+    if (!f.open(QIODevice::ReadOnly) || !f.seek(e.offset)) {
+        if (errMsg) *errMsg = tr("Cannot read %1: %2").arg(f.fileName(), f.errorString());
+        return false;
+    }
+
+    const QByteArray raw = qUncompress(f.read(e.length));
+    if (raw.isEmpty()) {
+        if (errMsg) *errMsg = tr("Stored output is damaged.");
+        return false;
+    }
+
+    QDataStream ds(raw);
+    QString o, x;
+    setup(ds) >> o >> x;
+    if (out) *out = o;
+    if (err) *err = x;
+    return ds.status() == QDataStream::Ok;
+}
+
+// ------------------------------------------------------------
+// Index file
+// ------------------------------------------------------------
+bool FleetHistoryStore::appendRecordLocked(RecordKind kind, const QByteArray& payload, QString* err)
+{
+    if (err) err->clear();
+    QDir().mkpath(historyDir());
+
+    QByteArray frame;
+    frame.reserve(kFrameHeaderBytes + payload.size());
+    {
+        QDataStream ds(&frame, QIODevice::WriteOnly);
+        setup(ds) << kFrameMagic << quint8(kind) << quint32(payload.size())
+                  << quint16(qChecksum(payload.constData(), uint(payload.size())));
+    }
+    frame.append(payload);
+
+    QFile f(QDir(historyDir()).filePath("index.dat"));
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Append) || f.write(frame) != frame.size()) {
+        if (err) *err = tr("Cannot write %1: %2").arg(f.fileName(), f.errorString());
+        return false;
+    }
+    return true;
+}
+
+void FleetHistoryStore::ensureLoadedLocked()
+{
+    if (m_loaded) return;
+    m_loaded = true;
+
+    QDir dir(historyDir());
+
+    // Current segment = newest one on disk.
+    const QStringList segs = dir.entryList({"out-*.seg"}, QDir::Files, QDir::Name);
+    if (!segs.isEmpty()) {
+        m_segment = segmentNumber(segs.last());
+        m_segmentSize = QFileInfo(dir.filePath(segs.last())).size();
+    }
+
+    QFile f(dir.filePath("index.dat"));
+    if (!f.open(QIODevice::ReadWrite))
+        return;
+
+    QElapsedTimer t;
+    t.start();
+
+    qint64 goodPos = 0;
+    const qint64 fileSize = f.size();
+    while (goodPos + kFrameHeaderBytes <= fileSize) {
+        const QByteArray head = f.read(kFrameHeaderBytes);
+        QDataStream hs(head);
+        quint32 magic = 0, len = 0;
+        quint8 kind = 0;
+        quint16 crc = 0;
+        setup(hs) >> magic >> kind >> len >> crc;
+        if (hs.status() != QDataStream::Ok || magic != kFrameMagic ||
+            goodPos + kFrameHeaderBytes + len > fileSize)
+            break;
+
+        const QByteArray payload = f.read(len);
+        if (payload.size() != int(len) || qChecksum(payload.constData(), len) != crc)
+            break;
+
+        applyRecordLocked(RecordKind(kind), payload);
+        goodPos += kFrameHeaderBytes + len;
+    }
+
+    // A record cut short by a crash is dropped, so appends start clean.
+    if (goodPos < fileSize) {
+        qWarning().noquote() << QString("[FLEET] history: dropping %1 damaged bytes at the end of %2")
+                                    .arg(fileSize - goodPos).arg(f.fileName());
+        f.resize(goodPos);
+    }
+
+    qInfo().noquote() << QString("[FLEET] history: %1 jobs, %2 targets loaded in %3 ms")
+                             .arg(m_jobs.size()).arg(m_entries.size()).arg(t.elapsed());
+}
+
+void FleetHistoryStore::applyRecordLocked(RecordKind kind, const QByteArray& payload)
+{
+    QDataStream ds(payload);
+    setup(ds);
+
+    switch (kind) {
+    case JobStarted: {
+        FleetHistoryJob j;
+        qint32 type = 0, count = 0;
+        qint64 started = 0;
+        ds >> j.id >> j.title >> j.command >> j.commandHash >> type >> started >> count;
+        if (ds.status() != QDataStream::Ok || m_jobById.contains(j.id)) return;
+        j.actionType = type;
+        j.startedMs = started;
+        j.targetCount = count;
+        m_jobById.insert(j.id, m_jobs.size());
+        m_jobs.push_back(j);
+        return;
+    }
+    case JobFinished: {
+        QString id;
+        qint64 finished = 0;
+        ds >> id >> finished;
+        const int job = m_jobById.value(id, -1);
+        if (ds.status() == QDataStream::Ok && job >= 0)
+            m_jobs[job].finishedMs = finished;
+        return;
+    }
+    case TargetFinished: {
+        QString jobId;
+        FleetHistoryEntry e;
+        qint32 state = 0, exitStatus = -1, segment = 0, length = 0;
+        qint64 finished = 0, duration = 0, outBytes = 0, errBytes = 0, offset = 0;
+        ds >> jobId >> e.profileName >> e.user >> e.host >> state >> exitStatus
+           >> finished >> duration >> e.error >> outBytes >> errBytes >> e.stdoutDigest
+           >> segment >> offset >> length;
+        if (ds.status() != QDataStream::Ok) return;
+
+        e.job = m_jobById.value(jobId, -1);
+        if (e.job < 0) {
+            // Job record lost: keep the target under a stub job.
+            FleetHistoryJob j;
+            j.id = jobId;
+            j.startedMs = finished;
+            e.job = m_jobs.size();
+            m_jobById.insert(jobId, e.job);
+            m_jobs.push_back(j);
+        }
+        e.state = FleetTargetState(state);
+        e.exitStatus = exitStatus;
+        e.finishedMs = finished;
+        e.durationMs = duration;
+        e.stdoutBytes = outBytes;
+        e.stderrBytes = errBytes;
+        e.segment = segment;
+        e.offset = offset;
+        e.length = length;
+        addEntryLocked(std::move(e));
+        return;
+    }
+    }
+}
+
+int FleetHistoryStore::addEntryLocked(FleetHistoryEntry e)
+{
+    e.id = m_entries.size();
+    e.profileName = intern(e.profileName);
+    e.user = intern(e.user);
+    e.host = intern(e.host);
+
+    m_jobs[e.job].entries.push_back(e.id);
+    m_byHost[e.host.toLower()].push_back(e.id);
+    m_byExit[e.exitStatus].push_back(e.id);
+    m_entries.push_back(std::move(e));
+    return m_entries.size() - 1;
+}
+
+// ------------------------------------------------------------
+// Queries
+// ------------------------------------------------------------
+QVector<FleetHistoryJob> FleetHistoryStore::recentJobs(int limit)
+{
+    QMutexLocker lock(&m_mutex);
+    ensureLoadedLocked();
+
+    QVector<FleetHistoryJob> out;
+    for (int i = m_jobs.size() - 1; i >= 0 && out.size() < limit; --i) {
+        FleetHistoryJob j = m_jobs[i];
+        j.entries.clear();   // callers browse via find(jobId)
+        out.push_back(j);
+    }
+    return out;
+}
+
+FleetHistoryJob FleetHistoryStore::jobAt(int job)
+{
+    QMutexLocker lock(&m_mutex);
+    ensureLoadedLocked();
+
+    FleetHistoryJob j = m_jobs.value(job);
+    j.entries.clear();
+    return j;
+}
+
+bool FleetHistoryStore::matchesLocked(const FleetHistoryEntry& e, const FleetHistoryQuery& q) const
+{
+    if (q.filterExit && e.exitStatus != q.exitStatus) return false;
+    if (q.fromMs > 0 && e.finishedMs < q.fromMs) return false;
+    if (q.toMs > 0 && e.finishedMs > q.toMs) return false;
+    if (!q.host.isEmpty() && !e.host.contains(q.host, Qt::CaseInsensitive)) return false;
+    if (!q.jobId.isEmpty() && m_jobs[e.job].id != q.jobId) return false;
+    return true;
+}
+
+QVector<FleetHistoryEntry> FleetHistoryStore::find(const FleetHistoryQuery& q)
+{
+    const int limit = qMax(1, q.limit);
+    QVector<FleetHistoryEntry> candidates;
+
+    {
+        QMutexLocker lock(&m_mutex);
+        ensureLoadedLocked();
+
+        // Start from the narrowest index that applies.
+        const QVector<int>* list = nullptr;
+        QVector<int> hostList;
+        if (!q.jobId.isEmpty()) {
+            const int job = m_jobById.value(q.jobId, -1);
+            if (job < 0) return {};
+            list = &m_jobs[job].entries;
+        }
+        if (q.filterExit) {
+            const auto it = m_byExit.constFind(q.exitStatus);
+            if (it == m_byExit.constEnd()) return {};
+            if (!list || it->size() < list->size()) list = &it.value();
+        }
+        if (!q.host.isEmpty() && !list) {
+            // Host keys are few compared to entries.
+            for (auto it = m_byHost.constBegin(); it != m_byHost.constEnd(); ++it) {
+                if (it.key().contains(q.host, Qt::CaseInsensitive))
+                    hostList += it.value();
+            }
+            if (hostList.isEmpty()) return {};
+            std::sort(hostList.begin(), hostList.end());
+            list = &hostList;
+        }
+
+        auto scan = [&](auto entryAt, int n) {
+            // Entries are in finish order: skip past toMs with a binary search.
+            int hi = n;
+            if (q.toMs > 0) {
+                int lo = 0;
+                while (lo < hi) {
+                    const int mid = (lo + hi) / 2;
+                    if (m_entries[entryAt(mid)].finishedMs <= q.toMs) lo = mid + 1;
+                    else hi = mid;
+                }
+            }
+            const int maxCandidates = q.text.isEmpty() ? limit : kMaxScanWithText;
+            for (int i = hi - 1; i >= 0 && candidates.size() < maxCandidates; --i) {
+                const FleetHistoryEntry& e = m_entries[entryAt(i)];
+                if (q.fromMs > 0 && e.finishedMs < q.fromMs) break;
+                if (matchesLocked(e, q)) candidates.push_back(e);
+            }
+        };
+
+        if (list) {
+            scan([list](int i) { return list->at(i); }, list->size());
+        } else {
+            scan([](int i) { return i; }, m_entries.size());
+        }
+    }
+
+    if (q.text.isEmpty())
+        return candidates;
+
+    // Text: cheap fields first, stored output only when needed.
+    QVector<FleetHistoryEntry> out;
+    for (const FleetHistoryEntry& e : candidates) {
+        if (out.size() >= limit) break;
+        if (e.error.contains(q.text, Qt::CaseInsensitive)) {
+            out.push_back(e);
+            continue;
+        }
+        QString so, se;
+        if (readOutput(e, &so, &se) &&
+            (so.contains(q.text, Qt::CaseInsensitive) || se.contains(q.text, Qt::CaseInsensitive)))
+            out.push_back(e);
+    }
+    return out;
+}
+
+QVector<FleetHistoryEntry> FleetHistoryStore::runsOnHost(const FleetHistoryEntry& e)
+{
+    QMutexLocker lock(&m_mutex);
+    ensureLoadedLocked();
+
+    QVector<FleetHistoryEntry> out;
+    if (e.job < 0 || e.job >= m_jobs.size()) return out;
+
+    const QByteArray hash = m_jobs[e.job].commandHash;
+    const QVector<int> list = m_byHost.value(e.host.toLower());
+    for (int i = list.size() - 1; i >= 0; --i) {
+        const FleetHistoryEntry& x = m_entries[list[i]];
+        if (m_jobs[x.job].commandHash == hash)
+            out.push_back(x);
+    }
+    return out;
+}
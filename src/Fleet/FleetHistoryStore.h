@@ -0,0 +1,151 @@
+// FleetHistoryStore.h
+//
+// Purpose:
+//   Local history of fleet jobs, kept after FleetWindow closes: every job
+//   and the result of every target, including its output.
+//
+//   On disk (AppLocalDataLocation/fleet-history):
+//     - index.dat       append-only framed records (job started, target
+//                       finished, job finished); small, loaded into memory
+//     - out-NNNNNN.seg  append-only output segments; one compressed blob per
+//                       target, referenced from the index by (segment,
+//                       offset, length). Rolled at kSegmentBytes.
+//
+//   In memory the index is kept by job id, host, exit status and time
+//   (targets are appended in finish order, so time ranges are a binary
+//   search), so browsing months of runs does not touch the output segments.
+//   Only an output text search reads them, and only for the candidates that
+//   pass the other filters.
+//
+//   Retention: outputs are capped by fleet/historyMaxMB (default 1024); the
+//   oldest segments are deleted first. Their index entries stay (exit
+//   status, digest, timing) and report the output as expired.
+//   fleet/historyEnabled (default true) turns recording off.
+//   The command text follows audit/commandLogMode like the audit log
+//   (hash always; full text only in "Full" mode).
+//
+// Threading:
+//   record*() return at once; writes run in order on one writer thread.
+//   Pending writes are waited for on QCoreApplication::aboutToQuit.
+//   Queries and readOutput() are thread-safe (one mutex; output reads use
+//   their own file handle).
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
+#include <QVector>
+
+#include "FleetTypes.h"
+
+struct FleetHistoryJob {
+    QString    id;
+    QString    title;
+    QString    command;          // as audit/commandLogMode allows: full, head or empty
+    QByteArray commandHash;      // identical commands compare across runs (full text)
+    int        actionType = 0;
+    qint64     startedMs = 0;
+    qint64     finishedMs = 0;   // 0 = never finished (app closed mid-job)
+    int        targetCount = 0;
+
+    QVector<int> entries;        // indexes into the target entries
+};
+
+struct FleetHistoryEntry {
+    int     id = -1;             // position in the history (stable)
+    int     job = -1;            // index of its FleetHistoryJob
+    QString profileName;
+    QString user;
+    QString host;
+
+    FleetTargetState state = FleetTargetState::Failed;
+    int     exitStatus = -1;
+    qint64  finishedMs = 0;
+    qint64  durationMs = 0;
+    QString error;
+
+    qint64     stdoutBytes = 0;
+    qint64     stderrBytes = 0;
+    QByteArray stdoutDigest;
+
+    // Output blob location (segment 0 = no output stored)
+    int    segment = 0;
+    qint64 offset = 0;
+    int    length = 0;
+};
+
+struct FleetHistoryQuery {
+    QString jobId;               // empty = any job
+    QString host;                // substring of the host name
+    bool    filterExit = false;
+    int     exitStatus = 0;
+    qint64  fromMs = 0;          // 0 = no lower bound
+    qint64  toMs = 0;            // 0 = no upper bound
+    QString text;                // searched in error, then in stdout/stderr
+    int     limit = 1000;
+};
+
+class FleetHistoryStore : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr qint64 kSegmentBytes = 64ll * 1024 * 1024;
+
+    static FleetHistoryStore* instance();
+    static QString historyDir();
+
+    bool isEnabled() const;
+
+    // Recording (UI thread; the write happens on the writer thread).
+    void recordJobStarted(const FleetJob& job, const QString& command, int targetCount);
+    void recordTarget(const QString& jobId, const FleetResultPtr& r);
+    void recordJobFinished(const QString& jobId, const QDateTime& finishedAt);
+
+    // Wait until everything recorded so far is on disk and indexed.
+    void flush();
+
+    // Jobs, newest first.
+    QVector<FleetHistoryJob> recentJobs(int limit = 500);
+    FleetHistoryJob jobAt(int job);
+
+    // Matching targets, newest first.
+    QVector<FleetHistoryEntry> find(const FleetHistoryQuery& q);
+
+    // Every run of e's command on e's host, newest first (e included).
+    QVector<FleetHistoryEntry> runsOnHost(const FleetHistoryEntry& e);
+
+    bool readOutput(const FleetHistoryEntry& e, QString* out, QString* err, QString* errMsg = nullptr);
+
+private:
+    explicit FleetHistoryStore(QObject* parent = nullptr);
+
+    enum RecordKind : quint8 { JobStarted = 1, TargetFinished = 2, JobFinished = 3 };
+
+    // All *Locked(): m_mutex held.
+    void ensureLoadedLocked();
+    bool appendRecordLocked(RecordKind kind, const QByteArray& payload, QString* err);
+    void applyRecordLocked(RecordKind kind, const QByteArray& payload);
+    int  addEntryLocked(FleetHistoryEntry e);
+    bool appendOutputLocked(const QByteArray& blob, int* segment, qint64* offset, QString* err);
+    void enforceRetentionLocked();
+    QString segmentPath(int segment) const;
+    QString intern(const QString& s);
+    bool matchesLocked(const FleetHistoryEntry& e, const FleetHistoryQuery& q) const;
+
+    QMutex      m_mutex;
+    QThreadPool m_writer;         // one thread: records stay in order
+    bool        m_loaded = false;
+
+    QVector<FleetHistoryJob>   m_jobs;
+    QVector<FleetHistoryEntry> m_entries;   // finish order
+
+    QHash<QString, int>          m_jobById;
+    QHash<QString, QVector<int>> m_byHost;  // lower-case host -> entries
+    QHash<int, QVector<int>>     m_byExit;  // exit status -> entries
+    QHash<QString, QString>      m_strings; // interned host/user/profile names
+
+    int    m_segment = 0;          // segment being appended to
+    qint64 m_segmentSize = 0;
+};
@@ -0,0 +1,134 @@
+// FleetLatencyStats.cpp
+#include "FleetLatencyStats.h"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr int kMinSamplesForDiagnosis = 5;
+
+inline QString T(const char* s)
+{
+    return QCoreApplication::translate("FleetExecutor", s);
+}
+}
+
+QString FleetLatencyStats::phaseName(int phase)
+{
+    switch (phase) {
+        case Dns:     return QStringLiteral("dns");
+        case Tcp:     return QStringLiteral("tcp");
+        case Kex:     return QStringLiteral("kex");
+        case Auth:    return QStringLiteral("auth");
+        case Channel: return QStringLiteral("channel");
+        case Exec:    return QStringLiteral("exec");
+        case Total:   return QStringLiteral("total");
+    }
+    return QString();
+}
+
+qint64 FleetLatencyStats::phaseValue(const FleetTargetResult& r, int phase)
+{
+    switch (phase) {
+        case Dns:     return r.dnsMs;
+        case Tcp:     return r.tcpMs;
+        case Kex:     return r.kexMs;
+        case Auth:    return r.authMs;
+        case Channel: return r.channelMs;
+        case Exec:    return r.execMs;
+        case Total:
+            // Targets that never started (canceled in the queue, invalid
+            // index) have no duration and say nothing about latency.
+            return r.durationMs > 0 ? r.durationMs : -1;
+    }
+    return -1;
+}
+
+int FleetLatencyStats::bucketOf(qint64 ms)
+{
+    if (ms < 1) return 0;
+    int b = 1;
+    while (b < kBuckets - 1 && ms >= (qint64(1) << b)) ++b;
+    return b;
+}
+
+qint64 FleetLatencyStats::bucketLowerMs(int bucket)
+{
+    return bucket <= 0 ? 0 : (qint64(1) << (bucket - 1));
+}
+
+void FleetLatencyStats::clear()
+{
+    for (int p = 0; p < PhaseCount; ++p) {
+        m_samples[p].clear();
+        m_sorted[p] = true;
+        m_hist[p] = QVector<int>(kBuckets, 0);
+    }
+}
+
+void FleetLatencyStats::add(const FleetTargetResult& r)
+{
+    for (int p = 0; p < PhaseCount; ++p) {
+        const qint64 v = phaseValue(r, p);
+        if (v < 0) continue;
+        if (m_hist[p].size() != kBuckets) m_hist[p] = QVector<int>(kBuckets, 0);
+        m_samples[p].push_back(v);
+        m_sorted[p] = false;
+        ++m_hist[p][bucketOf(v)];
+    }
+}
+
+void FleetLatencyStats::sortIfNeeded(int phase) const
+{
+    if (m_sorted[phase]) return;
+    std::sort(m_samples[phase].begin(), m_samples[phase].end());
+    m_sorted[phase] = true;
+}
+
+qint64 FleetLatencyStats::percentile(int phase, double p) const
+{
+    const QVector<qint64>& v = m_samples[phase];
+    if (v.isEmpty()) return -1;
+    sortIfNeeded(phase);
+
+    // Nearest rank: the smallest sample with at least p% of samples <= it.
+    const int rank = int(std::ceil(qBound(0.0, p, 100.0) / 100.0 * v.size()));
+    return v[qBound(0, rank - 1, v.size() - 1)];
+}
+
+QString FleetLatencyStats::summaryLine(int phase) const
+{
+    if (count(phase) == 0)
+        return QString("%1 -").arg(phaseName(phase));
+    return QString("%1 p50/p90/p99 = %2/%3/%4 ms (%5)")
+        .arg(phaseName(phase))
+        .arg(percentile(phase, 50)).arg(percentile(phase, 90)).arg(percentile(phase, 99))
+        .arg(count(phase));
+}
+
+QString FleetLatencyStats::diagnosis() const
+{
+    if (count(Tcp) < kMinSamplesForDiagnosis)
+        return QString();
+
+    auto p90 = [this](int phase) -> qint64 { return qMax<qint64>(0, percentile(phase, 90)); };
+
+    const qint64 network = p90(Dns) + p90(Tcp);
+    const qint64 host = p90(Kex) + p90(Auth) + p90(Exec);
+    const qint64 sum = network + host;
+    if (sum <= 0)
+        return QString();
+
+    // The phase with the largest p90 names the bottleneck.
+    int worst = Dns;
+    for (int p = Tcp; p <= Exec; ++p)
+        if (p90(p) > p90(worst)) worst = p;
+
+    const int netPct = int(100 * network / sum);
+    const QString where = (worst == Dns || worst == Tcp) ? T("network") : T("hosts");
+    return T("p90: network %1%, hosts %2%; slowest phase %3 (%4 ms) -> look at the %5")
+        .arg(netPct).arg(100 - netPct)
+        .arg(phaseName(worst)).arg(p90(worst)).arg(where);
+}
@@ -0,0 +1,59 @@
+// FleetLatencyStats.h
+//
+// Purpose:
+//   Per-phase latency distribution of one fleet job (DNS, TCP, KEX, auth,
+//   channel, exec, total), fed with finished targets. Answers "is it the
+//   network or the hosts?": DNS/TCP slow across the board points at the
+//   network (or a resolver), KEX/auth/exec slow points at loaded hosts,
+//   LDAP/PAM, or the command itself.
+//
+//   - percentile(): nearest-rank over every sample (sorted lazily)
+//   - histogram(): log2 buckets, bucket 0 = under 1 ms, bucket i =
+//     [2^(i-1), 2^i) ms, the last bucket open-ended
+//
+// Threading:
+//   Not thread-safe; FleetWindow feeds it on the UI thread.
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+#include "FleetTypes.h"
+
+class FleetLatencyStats
+{
+public:
+    enum Phase { Dns, Tcp, Kex, Auth, Channel, Exec, Total, PhaseCount };
+    static constexpr int kBuckets = 18;   // last bucket: 65 s and up
+
+    static QString phaseName(int phase);
+    // The phase's time in r, or -1 when the target did not get that far.
+    static qint64 phaseValue(const FleetTargetResult& r, int phase);
+    static int bucketOf(qint64 ms);
+    static qint64 bucketLowerMs(int bucket);
+
+    FleetLatencyStats() { clear(); }
+
+    void clear();
+    void add(const FleetTargetResult& r);
+
+    int count(int phase) const { return m_samples[phase].size(); }
+    // p in [0, 100]; -1 when there are no samples.
+    qint64 percentile(int phase, double p) const;
+    qint64 max(int phase) const { return percentile(phase, 100.0); }
+    const QVector<int>& histogram(int phase) const { return m_hist[phase]; }
+
+    // One line, e.g. "tcp p50/p90/p99 = 12/40/310 ms (812)".
+    QString summaryLine(int phase) const;
+    // Where the time goes at p90: network (DNS + TCP) vs. hosts (KEX +
+    // auth + exec). Empty until enough samples.
+    QString diagnosis() const;
+
+private:
+    void sortIfNeeded(int phase) const;
+
+    mutable QVector<qint64> m_samples[PhaseCount];
+    mutable bool m_sorted[PhaseCount] = {};
+    QVector<int> m_hist[PhaseCount];
+};
@@ -0,0 +1,156 @@
+// FleetLatencyView.cpp
+#include "FleetLatencyView.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+
+#include <cmath>
+
+namespace {
+constexpr int kNameWidth = 64;
+constexpr int kTextWidth = 230;
+constexpr int kMargin = 6;
+
+// Rows shown, top to bottom (the phases in connection order, then total).
+const int kRows[] = {
+    FleetLatencyStats::Dns, FleetLatencyStats::Tcp, FleetLatencyStats::Kex,
+    FleetLatencyStats::Auth, FleetLatencyStats::Channel, FleetLatencyStats::Exec,
+    FleetLatencyStats::Total,
+};
+constexpr int kRowCount = int(sizeof(kRows) / sizeof(kRows[0]));
+
+// x offset of a latency on the log2 axis (same scale as the buckets).
+double axisPos(qint64 ms, double width)
+{
+    const double b = (ms < 1) ? 0.0 : std::log2(double(ms)) + 1.0;
+    return qBound(0.0, b / FleetLatencyStats::kBuckets, 1.0) * width;
+}
+}
+
+FleetLatencyView::FleetLatencyView(QWidget* parent)
+    : QWidget(parent)
+{
+    setMinimumHeight(120);
+}
+
+QSize FleetLatencyView::sizeHint() const
+{
+    const int rowH = fontMetrics().height() + 6;
+    return QSize(640, rowH * (kRowCount + 2) + 2 * kMargin);
+}
+
+void FleetLatencyView::clearStats()
+{
+    m_stats.clear();
+    update();
+}
+
+void FleetLatencyView::addResult(const FleetResultPtr& r)
+{
+    if (!r) return;
+    m_stats.add(*r);
+    update();
+}
+
+void FleetLatencyView::rebuild(const QVector<FleetResultPtr>& results)
+{
+    m_stats.clear();
+    for (const FleetResultPtr& r : results) {
+        if (r && r->state != FleetTargetState::Queued && r->state != FleetTargetState::Running)
+            m_stats.add(*r);
+    }
+    update();
+}
+
+// ------------------------------------------------------------
+// paintEvent()
+// ------------------------------------------------------------
+void FleetLatencyView::paintEvent(QPaintEvent*)
+{
+    QPainter p(this);
+    p.fillRect(rect(), palette().base());
+
+    const QFontMetrics fm = fontMetrics();
+    const int rowH = fm.height() + 6;
+    const QColor textColor = palette().color(QPalette::Text);
+    const QColor barColor = palette().color(QPalette::Highlight);
+    const QColor dimColor = palette().color(QPalette::Mid);
+
+    int y = kMargin;
+
+    // Verdict line
+    {
+        QString line = m_stats.diagnosis();
+        if (line.isEmpty()) {
+            line = m_stats.count(FleetLatencyStats::Total) == 0
+                       ? tr("No finished targets yet.")
+                       : tr("Not enough connected targets for a verdict yet.");
+        }
+        p.setPen(textColor);
+        p.drawText(QRect(kMargin, y, width() - 2 * kMargin, rowH),
+                   Qt::AlignLeft | Qt::AlignVCenter, fm.elidedText(line, Qt::ElideRight, width() - 2 * kMargin));
+        y += rowH;
+    }
+
+    const int histX = kMargin + kNameWidth;
+    const int histW = qMax(60, width() - histX - kTextWidth - 2 * kMargin);
+    const int textX = histX + histW + kMargin;
+
+    for (int i = 0; i < kRowCount; ++i) {
+        const int phase = kRows[i];
+        const QRect row(histX, y + 2, histW, rowH - 4);
+
+        p.setPen(textColor);
+        p.drawText(QRect(kMargin, y, kNameWidth, rowH), Qt::AlignLeft | Qt::AlignVCenter,
+                   FleetLatencyStats::phaseName(phase));
+
+        p.setPen(dimColor);
+        p.drawRect(row.adjusted(0, 0, -1, -1));
+
+        const QVector<int>& hist = m_stats.histogram(phase);
+        int peak = 0;
+        for (int c : hist) peak = qMax(peak, c);
+
+        if (peak > 0) {
+            const double bw = double(histW) / FleetLatencyStats::kBuckets;
+            for (int b = 0; b < hist.size(); ++b) {
+                if (hist[b] == 0) continue;
+                // sqrt scale: a handful of stragglers next to 1000 fast hosts
+                // stays visible.
+                const int h = qMax(1, int(std::sqrt(double(hist[b]) / peak) * (row.height() - 2)));
+                p.fillRect(QRectF(row.left() + b * bw + 1, row.bottom() - h, qMax(1.0, bw - 2), h), barColor);
+            }
+
+            p.setPen(QPen(textColor, 1, Qt::DashLine));
+            for (double pct : {50.0, 90.0, 99.0}) {
+                const double x = row.left() + axisPos(m_stats.percentile(phase, pct), histW);
+                p.drawLine(QPointF(x, row.top()), QPointF(x, row.bottom()));
+            }
+        }
+
+        p.setPen(textColor);
+        const QString txt = m_stats.count(phase) == 0
+            ? QStringLiteral("-")
+            : tr("p50 %1  p90 %2  p99 %3 ms  (%4)")
+                  .arg(m_stats.percentile(phase, 50))
+                  .arg(m_stats.percentile(phase, 90))
+                  .arg(m_stats.percentile(phase, 99))
+                  .arg(m_stats.count(phase));
+        p.drawText(QRect(textX, y, kTextWidth, rowH), Qt::AlignLeft | Qt::AlignVCenter,
+                   fm.elidedText(txt, Qt::ElideRight, kTextWidth));
+
+        y += rowH;
+    }
+
+    // Axis: decades on the log2 scale.
+    p.setPen(dimColor);
+    const struct { qint64 ms; const char* label; } ticks[] = {
+        {1, "1ms"}, {10, "10ms"}, {100, "100ms"}, {1000, "1s"}, {10000, "10s"},
+    };
+    for (const auto& t : ticks) {
+        const int x = histX + int(axisPos(t.ms, histW));
+        p.drawLine(x, y, x, y + 3);
+        p.drawText(QRect(x - 30, y + 3, 60, rowH - 3), Qt::AlignHCenter | Qt::AlignTop,
+                   QString::fromLatin1(t.label));
+    }
+}
@@ -0,0 +1,34 @@
+// FleetLatencyView.h
+//
+// Purpose:
+//   Latency histograms of the current fleet job, one row per phase (see
+//   FleetLatencyStats): a log-scale bar histogram with p50/p90/p99 marked,
+//   the percentiles as text, and a one-line "network vs. hosts" verdict on
+//   top. Follows the job live (addResult()).
+
+#pragma once
+
+#include <QWidget>
+
+#include "FleetLatencyStats.h"
+
+class FleetLatencyView : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit FleetLatencyView(QWidget* parent = nullptr);
+
+    void clearStats();
+    void addResult(const FleetResultPtr& r);
+    void rebuild(const QVector<FleetResultPtr>& results);
+
+    const FleetLatencyStats& stats() const { return m_stats; }
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent* e) override;
+
+private:
+    FleetLatencyStats m_stats;
+};
@@ -0,0 +1,110 @@
+// FleetOutputDigest.cpp
+#include "FleetOutputDigest.h"
+
+#include <algorithm>
+
+namespace {
+constexpr int kMaxLineBytes = 64 * 1024;   // longer lines are hashed in pieces
+
+// Digit runs -> '#'.
+QByteArray collapseDigits(const QByteArray& in)
+{
+    QByteArray out;
+    out.reserve(in.size());
+    bool inDigits = false;
+    for (char c : in) {
+        const bool d = (c >= '0' && c <= '9');
+        if (d) {
+            if (!inDigits) out.append('#');
+        } else {
+            out.append(c);
+        }
+        inDigits = d;
+    }
+    return out;
+}
+}
+
+FleetOutputDigest::FleetOutputDigest(const QString& host, const QString& profileName)
+    : m_exact(QCryptographicHash::Sha1)
+    , m_similar(QCryptographicHash::Sha1)
+{
+    auto addToken = [this](const QString& t) {
+        const QByteArray b = t.trimmed().toUtf8();
+        if (b.size() >= 2 && !m_hostTokens.contains(b))
+            m_hostTokens.push_back(b);
+    };
+
+    addToken(host);
+    addToken(host.section('.', 0, 0));   // short host name
+    addToken(profileName);
+
+    std::sort(m_hostTokens.begin(), m_hostTokens.end(),
+              [](const QByteArray& a, const QByteArray& b) { return a.size() > b.size(); });
+}
+
+void FleetOutputDigest::addData(const char* data, qint64 len)
+{
+    if (m_finished || len <= 0) return;
+
+    qint64 start = 0;
+    for (qint64 i = 0; i < len; ++i) {
+        if (data[i] != '\n') continue;
+        m_partial.append(data + start, int(i - start));
+        addLine(m_partial);
+        m_partial.clear();
+        start = i + 1;
+    }
+    m_partial.append(data + start, int(len - start));
+
+    if (m_partial.size() > kMaxLineBytes) {
+        addLine(m_partial);
+        m_partial.clear();
+    }
+}
+
+void FleetOutputDigest::addLine(QByteArray line)
+{
+    // Strip CR and trailing blanks.
+    int n = line.size();
+    while (n > 0 && (line[n - 1] == '\r' || line[n - 1] == ' ' || line[n - 1] == '\t'))
+        --n;
+    line.truncate(n);
+
+    // Empty lines only count when something follows them.
+    if (line.isEmpty()) {
+        ++m_pendingEmpty;
+        return;
+    }
+    for (; m_pendingEmpty > 0; --m_pendingEmpty)
+        hashLine(QByteArray());
+
+    hashLine(line);
+}
+
+void FleetOutputDigest::hashLine(const QByteArray& line)
+{
+    m_exact.addData(line);
+    m_exact.addData("\n", 1);
+
+    QByteArray shape = line;
+    for (const QByteArray& t : m_hostTokens)
+        shape.replace(t, QByteArrayLiteral("<host>"));
+    shape = collapseDigits(shape);
+
+    m_similar.addData(shape);
+    m_similar.addData("\n", 1);
+}
+
+void FleetOutputDigest::finish()
+{
+    if (m_finished) return;
+    if (!m_partial.isEmpty()) {
+        addLine(m_partial);
+        m_partial.clear();
+    }
+    m_finished = true;
+
+    m_exactHex   = m_exact.result().toHex().left(16);
+    m_similarHex = m_similar.result().toHex().left(16);
+}
@@ -0,0 +1,55 @@
+// FleetOutputDigest.h
+//
+// Purpose:
+//   Incremental fingerprint of one target's stdout, fed chunk by chunk as
+//   the output streams in (no second pass over the text, and the complete
+//   output is hashed even when only head/tail are kept in memory).
+//
+//   Two digests, both over lines with CR and trailing blanks stripped and
+//   trailing empty lines ignored:
+//     - exact:   the lines as they are
+//     - similar: the target's own host/profile names replaced by "<host>"
+//                and every digit run by "#", so "web01 up 3 days" and
+//                "web02 up 12 days" land in one group
+//
+//   FleetGroupView groups targets by (exit status, digest).
+//
+// Threading:
+//   One instance per target, used on that target's thread. Not thread-safe.
+
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QList>
+#include <QString>
+
+class FleetOutputDigest
+{
+public:
+    FleetOutputDigest(const QString& host, const QString& profileName);
+
+    void addData(const char* data, qint64 len);
+
+    // Flush the last partial line. Call once, after the last addData().
+    void finish();
+
+    // Hex, 16 chars. Valid after finish().
+    QByteArray exact() const { return m_exactHex; }
+    QByteArray similar() const { return m_similarHex; }
+
+private:
+    void addLine(QByteArray line);
+    void hashLine(const QByteArray& line);
+
+    QCryptographicHash m_exact;
+    QCryptographicHash m_similar;
+    QList<QByteArray>  m_hostTokens;   // longest first
+
+    QByteArray m_partial;
+    int        m_pendingEmpty = 0;     // empty lines not hashed yet
+    bool       m_finished = false;
+
+    QByteArray m_exactHex;
+    QByteArray m_similarHex;
+};
@@ -0,0 +1,346 @@
+// FleetPush.cpp
+#include "FleetPush.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QSettings>
+
+#include "../SshClient.h"
+
+static QString T(const char* s)
+{
+    return QCoreApplication::translate("FleetExecutor", s);
+}
+
+// Minimal POSIX shell quoting for the finalize / relay commands.
+static QString shQuote(const QString& s)
+{
+    QString out = s;
+    out.replace("'", "'\"'\"'");
+    return "'" + out + "'";
+}
+
+// ------------------------------------------------------------
+// FleetPushSource
+// ------------------------------------------------------------
+FleetPushSource::FleetPushSource(const QString& localPath)
+    : m_path(localPath)
+{
+}
+
+bool FleetPushSource::load(QString* err)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_loaded) {
+        if (err) *err = m_error;
+        return m_ok;
+    }
+    m_loaded = true;
+
+    QSettings s;
+    const qint64 maxBytes = qint64(qMax(1, s.value("fleet/pushMaxMB", 2048).toInt())) * 1024 * 1024;
+
+    QFile& f = m_file;
+    f.setFileName(m_path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        m_error = T("Cannot open local file: %1").arg(f.errorString());
+        if (err) *err = m_error;
+        return false;
+    }
+    if (f.size() > maxBytes) {
+        f.close();
+        m_error = T("Local file is larger than the push limit (%1 MB, fleet/pushMaxMB).")
+                      .arg(maxBytes / (1024 * 1024));
+        if (err) *err = m_error;
+        return false;
+    }
+
+    // Hash in one streaming pass; the chunks themselves are read again on
+    // demand (chunk()), so nothing here scales with the file size.
+    QCryptographicHash h(QCryptographicHash::Sha256);
+    while (!f.atEnd()) {
+        const QByteArray c = f.read(kChunkBytes);
+        if (c.isEmpty() && f.error() != QFileDevice::NoError) {
+            m_error = T("Read failed: %1").arg(f.errorString());
+            f.close();
+            if (err) *err = m_error;
+            return false;
+        }
+        h.addData(c);
+        m_size += c.size();
+    }
+
+    m_sha256Hex = h.result().toHex();
+    m_ok = true;
+
+    qInfo().noquote() << QString("[FLEET] push source %1: %2 bytes, %3 chunks, sha256 %4")
+                             .arg(m_path).arg(m_size).arg(chunkCount())
+                             .arg(QString::fromLatin1(m_sha256Hex));
+    return true;
+}
+
+QByteArray FleetPushSource::chunk(int index, QString* err)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_ok || index < 0 || index >= chunkCount()) {
+        if (err) *err = m_ok ? T("Read failed: chunk %1 out of range").arg(index) : m_error;
+        return QByteArray();
+    }
+    if (const QByteArray* c = m_cache.object(index))
+        return *c;
+
+    const qint64 off = qint64(index) * kChunkBytes;
+    const qint64 len = qMin<qint64>(kChunkBytes, m_size - off);
+    QByteArray c;
+    if (m_file.seek(off))
+        c = m_file.read(len);
+    if (c.size() != len) {
+        // Shorter than when it was hashed: finalize() would reject it anyway.
+        if (err) *err = m_file.error() != QFileDevice::NoError
+                            ? T("Read failed: %1").arg(m_file.errorString())
+                            : T("Local file changed during the push.");
+        return QByteArray();
+    }
+    m_cache.insert(index, new QByteArray(c));
+    return c;
+}
+
+// ------------------------------------------------------------
+// FleetPushJob
+// ------------------------------------------------------------
+FleetPushJob::FleetPushJob(const QString& localPath, const Options& opt)
+    : m_source(localPath),
+      m_opt(opt)
+{
+    QSettings s;
+    m_directSlots = qMax(1, s.value("fleet/pushDirectSlots", 4).toInt());
+
+    // Only the two checking modes; anything else (including "no") means yes.
+    const QString check = s.value("fleet/pushRelayHostKeyCheck", "yes").toString().trimmed().toLower();
+    m_relayHostKeyCheck = (check == QLatin1String("accept-new")) ? check : QStringLiteral("yes");
+}
+
+bool FleetPushJob::pushTo(SshClient& client, const SshProfile& target, FleetTargetResult* r,
+                          const QAtomicInteger<int>& cancel)
+{
+    QElapsedTimer t;
+    t.start();
+
+    QString err;
+    if (!m_source.load(&err)) {
+        r->error = err;
+        return false;
+    }
+
+    // 1) Bytes to <path>.pqssh.part: from a peer that already has the file,
+    //    or from here.
+    QString via = T("direct");
+    bool copied = false;
+
+    SshProfile relay;
+    if (m_opt.relay && m_directInFlight.loadAcquire() >= m_directSlots &&
+        relayEligible(target) && takeRelay(&relay)) {
+        QString re;
+        copied = pushViaRelay(relay, target, cancel, &re);
+        returnRelay(relay, copied);
+        if (copied) {
+            via = T("via %1").arg(relay.host);
+        } else {
+            qInfo().noquote() << QString("[FLEET] push relay %1 -> %2 failed, pushing directly: %3")
+                                     .arg(relay.host, target.host, re.section('\n', 0, 0));
+        }
+    }
+
+    if (!copied) {
+        m_directInFlight.fetchAndAddOrdered(1);
+        copied = pushDirect(client, cancel, &err);
+        m_directInFlight.fetchAndAddOrdered(-1);
+        if (!copied) {
+            r->error = err;
+            return false;
+        }
+    }
+
+    if (cancel.loadAcquire() != 0) {
+        r->error = T("Canceled");
+        return false;
+    }
+
+    // 2) Verify + atomic move.
+    QString summary;
+    if (!finalize(client, &summary, &err)) {
+        r->error = err;
+        r->stdoutText = summary;
+        return false;
+    }
+
+    r->exitStatus = 0;
+    r->stdoutText = T("%1 bytes -> %2 (%3, %4 ms)\nsha256 %5")
+                        .arg(m_source.size())
+                        .arg(m_opt.remotePath, via)
+                        .arg(t.elapsed())
+                        .arg(QString::fromLatin1(m_source.sha256Hex()));
+
+    // This host can now feed others.
+    if (m_opt.relay && relayEligible(target))
+        returnRelay(target, true);
+    return true;
+}
+
+// ------------------------------------------------------------
+// pushDirect()
+// ------------------------------------------------------------
+bool FleetPushJob::pushDirect(SshClient& client, const QAtomicInteger<int>& cancel, QString* err)
+{
+    // The client checks its own cancel flag between write requests.
+    auto progress = [&client, &cancel](quint64, quint64) {
+        if (cancel.loadAcquire() != 0) client.requestCancelTransfer();
+    };
+    auto read = [this](int index, QString* e) { return m_source.chunk(index, e); };
+    return client.writeRemoteChunks(m_source.chunkCount(), quint64(m_source.size()), read,
+                                    tempPath(), 0600, err, progress);
+}
+
+// ------------------------------------------------------------
+// pushViaRelay()
+// ------------------------------------------------------------
+// The relay runs scp to the peer with its own credentials (BatchMode: no
+// prompts) and its own known_hosts (fleet/pushRelayHostKeyCheck). The
+// peer's copy is hash-checked by finalize() like any other.
+bool FleetPushJob::pushViaRelay(const SshProfile& relay, const SshProfile& peer,
+                                const QAtomicInteger<int>& cancel, QString* err)
+{
+    if (cancel.loadAcquire() != 0) {
+        if (err) *err = T("Canceled");
+        return false;
+    }
+
+    SshClient rc;
+    if (!rc.connectProfile(relay, err))
+        return false;
+
+    const QString host = peer.host.contains(':') ? QString("[%1]").arg(peer.host) : peer.host;
+    const int port = (peer.port > 0) ? peer.port : 22;
+
+    // Legacy scp hands the remote path to the peer's shell: relayEligible()
+    // only lets plain paths through.
+    const QString cmd =
+        QString("scp -q -B -o StrictHostKeyChecking=%1 -o ConnectTimeout=10 -P %2 %3 %4")
+            .arg(m_relayHostKeyCheck)
+            .arg(port)
+            .arg(shQuote(m_opt.remotePath),
+                 shQuote(QString("%1@%2:%3").arg(peer.user, host, tempPath())));
+
+    SshClient::ExecOptions opt;
+    opt.timeoutMs = m_opt.timeoutMs;
+    opt.maxOutputBytes = 64 * 1024;
+
+    SshClient::ExecResult xr;
+    QString out;
+    const bool ok = rc.exec(cmd, &out, err, opt, &xr);
+    rc.disconnect();
+
+    if (!ok && err && err->trimmed().isEmpty())
+        *err = T("scp on relay exited with %1").arg(xr.exitStatus);
+    return ok;
+}
+
+// ------------------------------------------------------------
+// finalize()
+// ------------------------------------------------------------
+bool FleetPushJob::finalize(SshClient& client, QString* summary, QString* err)
+{
+    const QString tmp = shQuote(tempPath());
+    const QString dst = shQuote(m_opt.remotePath);
+    const QString mode = QString::number(m_opt.mode & 07777, 8);
+    const QString want = QString::fromLatin1(m_source.sha256Hex());
+
+    const QString script = QString(
+        "f=%1; d=%2\n"
+        "if command -v sha256sum >/dev/null 2>&1; then h=$(sha256sum \"$f\" | cut -c1-64)\n"
+        "elif command -v shasum >/dev/null 2>&1; then h=$(shasum -a 256 \"$f\" | cut -c1-64)\n"
+        "else echo NOHASH; exit 3; fi\n"
+        "if [ \"$h\" != \"%3\" ]; then rm -f \"$f\"; echo \"MISMATCH $h\"; exit 4; fi\n"
+        "chmod %4 \"$f\" && mv -f \"$f\" \"$d\" && echo \"OK $h\"\n")
+        .arg(tmp, dst, want, mode);
+
+    SshClient::ExecOptions opt;
+    opt.timeoutMs = m_opt.timeoutMs;
+    opt.maxOutputBytes = 64 * 1024;
+
+    SshClient::ExecResult xr;
+    QString out, e;
+    client.exec(script, &out, &e, opt, &xr);
+    if (summary) *summary = out.trimmed();
+
+    if (xr.exitStatus == 0)
+        return true;
+
+    if (xr.exitStatus == 4) {
+        if (err) *err = T("SHA-256 mismatch after transfer (expected %1, got %2)")
+                            .arg(want, out.trimmed().section(' ', 1, 1));
+        return false;
+    }
+
+    if (xr.exitStatus != 3) {
+        if (err) *err = e.trimmed().isEmpty() ? T("Finalize failed (exit %1)").arg(xr.exitStatus)
+                                              : e.trimmed();
+        return false;
+    }
+
+    // No hashing tool on the host: read the temp file back over SFTP.
+    const QByteArray got = client.sha256RemoteFile(tempPath(), &e).toHex();
+    if (got.isEmpty()) {
+        if (err) *err = e;
+        return false;
+    }
+    if (got != m_source.sha256Hex()) {
+        client.exec(QString("rm -f %1").arg(tmp), nullptr, nullptr, m_opt.timeoutMs);
+        if (err) *err = T("SHA-256 mismatch after transfer (expected %1, got %2)")
+                            .arg(want, QString::fromLatin1(got));
+        return false;
+    }
+
+    if (!client.exec(QString("chmod %1 %2 && mv -f %2 %3").arg(mode, tmp, dst), &out, &e, m_opt.timeoutMs)) {
+        if (err) *err = e.trimmed().isEmpty() ? T("Finalize failed") : e.trimmed();
+        return false;
+    }
+    if (summary) *summary = QString("OK %1").arg(QString::fromLatin1(got));
+    return true;
+}
+
+// ------------------------------------------------------------
+// Relay pool
+// ------------------------------------------------------------
+bool FleetPushJob::relayEligible(const SshProfile& peer) const
+{
+    // Peers behind a jump host are not reachable by name from other hosts;
+    // anything the relay's shell or scp could reinterpret stays direct.
+    static const QRegularExpression safe("^[A-Za-z0-9._/+-]+$");
+    static const QRegularExpression safeHost("^[A-Za-z0-9._:-]+$");
+    return peer.proxyJump.trimmed().isEmpty() &&
+           safe.match(m_opt.remotePath).hasMatch() &&
+           safe.match(peer.user).hasMatch() &&
+           safeHost.match(peer.host).hasMatch();
+}
+
+bool FleetPushJob::takeRelay(SshProfile* out)
+{
+    QMutexLocker lock(&m_relayMutex);
+    if (m_idleRelays.isEmpty()) return false;
+    *out = m_idleRelays.takeLast();
+    return true;
+}
+
+void FleetPushJob::returnRelay(const SshProfile& relay, bool keep)
+{
+    if (!keep) return;   // a relay that failed once (no trust, no scp) is not asked again
+    QMutexLocker lock(&m_relayMutex);
+    m_idleRelays.push_back(relay);
+}
@@ -0,0 +1,122 @@
+// FleetPush.h
+//
+// Purpose:
+//   Fleet "push file": one local file to the same remote path on many hosts.
+//
+//   - FleetPushSource hashes the file once (streaming), then serves it in
+//     1 MiB chunks read on demand: each target walks its own chunk index, and
+//     a small LRU cache (kCacheChunks, shared implicitly between targets)
+//     absorbs targets moving in step. Memory stays bounded whatever the file
+//     size (cap: fleet/pushMaxMB, default 2048, a sanity limit on transfers).
+//   - Per target (FleetPushJob::pushTo): pipelined SFTP write to
+//     <path>.pqssh.part, then one remote command that checks the SHA-256 of
+//     the temp file and only then chmods and mv's it into place (rename(2):
+//     readers see the old or the new file, never a partial one). Without
+//     sha256sum/shasum on the host the hash is read back over SFTP instead.
+//   - Relay (optional): hosts that already have the verified file forward it
+//     to peers with their own scp (BatchMode), so a slow uplink from here
+//     does not gate the rollout. The first fleet/pushDirectSlots (default 4)
+//     transfers always go direct; a failed relay falls back to a direct push.
+//     Needs host-to-host SSH trust; the peer's copy is verified the same way.
+//     The relay's scp checks the peer's host key against the relay's own
+//     known_hosts (fleet/pushRelayHostKeyCheck: "yes" by default, so an
+//     unknown peer fails the relay and gets a direct push; "accept-new"
+//     trusts first contact).
+//
+// Threading:
+//   One FleetPushJob per fleet job, shared by the target threads; all
+//   methods are thread-safe.
+
+#pragma once
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QCache>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include "FleetTypes.h"
+#include "../SshProfile.h"
+
+class SshClient;
+
+class FleetPushSource
+{
+public:
+    static constexpr int kChunkBytes = 1024 * 1024;
+    static constexpr int kCacheChunks = 8;
+
+    explicit FleetPushSource(const QString& localPath);
+
+    // Hash the file and open it for chunk() (first caller); later calls
+    // return the first result.
+    bool load(QString* err);
+
+    // Chunk index (0 .. chunkCount()-1), from the cache or the file; empty
+    // (and *err) when the read fails or the file shrank since load().
+    QByteArray chunk(int index, QString* err);
+
+    int    chunkCount() const { return int((m_size + kChunkBytes - 1) / kChunkBytes); }
+    qint64 size() const { return m_size; }
+    QByteArray sha256Hex() const { return m_sha256Hex; }
+    QString localPath() const { return m_path; }
+
+private:
+    QString m_path;
+
+    QMutex  m_mutex;
+    bool    m_loaded = false;
+    bool    m_ok = false;
+    QString m_error;
+
+    QFile   m_file;                       // open after a successful load()
+    QCache<int, QByteArray> m_cache { kCacheChunks };
+
+    qint64     m_size = 0;
+    QByteArray m_sha256Hex;
+};
+
+class FleetPushJob
+{
+public:
+    struct Options {
+        QString remotePath;
+        int  mode = 0644;
+        bool relay = false;
+        int  timeoutMs = 90000;   // relay copy / finalize command
+    };
+
+    FleetPushJob(const QString& localPath, const Options& opt);
+
+    FleetPushSource& source() { return m_source; }
+
+    // Push to one connected target. Fills r->stdoutText, exitStatus (0 on
+    // success) and r->error. cancel is polled between steps.
+    bool pushTo(SshClient& client, const SshProfile& target, FleetTargetResult* r,
+                const QAtomicInteger<int>& cancel);
+
+private:
+    QString tempPath() const { return m_opt.remotePath + ".pqssh.part"; }
+
+    bool pushDirect(SshClient& client, const QAtomicInteger<int>& cancel, QString* err);
+    bool pushViaRelay(const SshProfile& relay, const SshProfile& peer,
+                      const QAtomicInteger<int>& cancel, QString* err);
+
+    // Verify the temp file's hash on the host, then move it into place.
+    bool finalize(SshClient& client, QString* summary, QString* err);
+
+    bool relayEligible(const SshProfile& peer) const;
+    bool takeRelay(SshProfile* out);
+    void returnRelay(const SshProfile& relay, bool keep);
+
+    FleetPushSource m_source;
+    Options m_opt;
+    int m_directSlots = 4;
+    QString m_relayHostKeyCheck;          // scp StrictHostKeyChecking value
+
+    QAtomicInteger<int> m_directInFlight { 0 };
+    QMutex              m_relayMutex;
+    QVector<SshProfile> m_idleRelays;     // updated hosts not forwarding right now
+};
@@ -0,0 +1,115 @@
+// FleetResultModel.cpp
+#include "FleetResultModel.h"
+
+#include <QBrush>
+#include <QColor>
+
+static QString preview(const QString& s)
+{
+    // Only the first line-ish part is shown; avoid touching the whole output.
+    QString t = s.left(512);
+    t.replace("\r\n", "\n");
+    t.replace("\r", "\n");
+    t = t.trimmed();
+    if (t.size() > 120) t = t.left(120) + "…";
+    return t;
+}
+
+FleetResultModel::FleetResultModel(FleetResultStore* store, QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_store(store)
+{
+    if (!m_store) return;
+
+    connect(m_store, &FleetResultStore::storeAboutToReset, this, [this]() {
+        beginResetModel();
+    });
+    connect(m_store, &FleetResultStore::storeReset, this, [this]() {
+        endResetModel();
+    });
+    connect(m_store, &FleetResultStore::rowAboutToBeInserted, this, [this](int row) {
+        beginInsertRows(QModelIndex(), row, row);
+    });
+    connect(m_store, &FleetResultStore::rowInserted, this, [this](int) {
+        endInsertRows();
+    });
+    connect(m_store, &FleetResultStore::rowChanged, this, [this](int row) {
+        emit dataChanged(index(row, 0), index(row, ColCount - 1));
+    });
+}
+
+int FleetResultModel::rowCount(const QModelIndex& parent) const
+{
+    return (parent.isValid() || !m_store) ? 0 : m_store->size();
+}
+
+int FleetResultModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColCount;
+}
+
+FleetResultPtr FleetResultModel::resultAt(int row) const
+{
+    return m_store ? m_store->at(row) : FleetResultPtr();
+}
+
+QString FleetResultModel::stateText(FleetTargetState st)
+{
+    switch (st) {
+        case FleetTargetState::Queued:   return tr("QUEUED");
+        case FleetTargetState::Running:  return tr("RUNNING");
+        case FleetTargetState::Ok:       return tr("OK");
+        case FleetTargetState::Failed:   return tr("FAIL");
+        case FleetTargetState::Canceled: return tr("CANCELED");
+    }
+    return tr("UNKNOWN");
+}
+
+QVariant FleetResultModel::headerData(int section, Qt::Orientation o, int role) const
+{
+    if (o != Qt::Horizontal || role != Qt::DisplayRole) return {};
+    switch ((Col)section) {
+        case ProfileCol:  return tr("Profile");
+        case GroupCol:    return tr("Group");
+        case TargetCol:   return tr("Target");
+        case StatusCol:   return tr("Status");
+        case DurationCol: return tr("Duration");
+        case StdoutCol:   return tr("Stdout (preview)");
+        case ErrorCol:    return tr("Error (preview)");
+        default: return {};
+    }
+}
+
+QVariant FleetResultModel::data(const QModelIndex& idx, int role) const
+{
+    if (!idx.isValid()) return {};
+    const FleetResultPtr r = resultAt(idx.row());
+    if (!r) return {};
+
+    if (role == ProfileIndexRole)
+        return r->profileIndex;
+
+    if (role == Qt::DisplayRole) {
+        switch ((Col)idx.column()) {
+            case ProfileCol:  return r->profileName;
+            case GroupCol:    return r->group.trimmed().isEmpty() ? tr("Ungrouped") : r->group.trimmed();
+            case TargetCol:   return QString("%1@%2:%3").arg(r->user, r->host).arg(r->port);
+            case StatusCol:   return stateText(r->state);
+            case DurationCol: return (r->durationMs > 0) ? tr("%1 ms").arg(r->durationMs) : QString();
+            case StdoutCol:   return preview(r->stdoutText);
+            case ErrorCol:    return preview(!r->error.isEmpty() ? r->error : r->stderrText);
+            default: return {};
+        }
+    }
+
+    if (role == Qt::ForegroundRole && idx.column() == StatusCol) {
+        switch (r->state) {
+            case FleetTargetState::Ok:       return QBrush(QColor("#4caf50"));
+            case FleetTargetState::Failed:   return QBrush(QColor("#e57373"));
+            case FleetTargetState::Canceled: return QBrush(QColor("#888888"));
+            default: break;
+        }
+    }
+
+    return {};
+}
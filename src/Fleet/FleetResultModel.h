@@ -0,0 +1,37 @@
+// FleetResultModel.h
+//
+// Purpose:
+//   Table view of a FleetResultStore (one row per target). Follows the
+//   store's per-row signals, so a finished target repaints one row.
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QPointer>
+
+#include "FleetResultStore.h"
+
+class FleetResultModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Col { ProfileCol = 0, GroupCol, TargetCol, StatusCol, DurationCol,
+               StdoutCol, ErrorCol, ColCount };
+
+    // Qt::UserRole on any column: the row's profile index.
+    static constexpr int ProfileIndexRole = Qt::UserRole;
+
+    explicit FleetResultModel(FleetResultStore* store, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+    FleetResultPtr resultAt(int row) const;
+
+    static QString stateText(FleetTargetState st);
+
+private:
+    QPointer<FleetResultStore> m_store;
+};
@@ -0,0 +1,56 @@
+// FleetResultStore.cpp
+#include "FleetResultStore.h"
+
+FleetResultStore::FleetResultStore(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void FleetResultStore::count(const FleetResultPtr& r, int delta)
+{
+    if (!r) return;
+    switch (r->state) {
+        case FleetTargetState::Queued:   m_counts.queued   += delta; break;
+        case FleetTargetState::Running:  m_counts.running  += delta; break;
+        case FleetTargetState::Ok:       m_counts.ok       += delta; break;
+        case FleetTargetState::Failed:   m_counts.failed   += delta; break;
+        case FleetTargetState::Canceled: m_counts.canceled += delta; break;
+    }
+}
+
+void FleetResultStore::reset(const QVector<FleetResultPtr>& rows)
+{
+    emit storeAboutToReset();
+
+    m_rows = rows;
+    m_rowByProfile.clear();
+    m_counts = Counts{};
+
+    for (int i = 0; i < m_rows.size(); ++i) {
+        if (!m_rows[i]) continue;
+        m_rowByProfile.insert(m_rows[i]->profileIndex, i);
+        count(m_rows[i], +1);
+    }
+
+    emit storeReset();
+}
+
+void FleetResultStore::publish(const FleetResultPtr& r)
+{
+    if (!r) return;
+
+    const int row = rowOf(r->profileIndex);
+    if (row < 0) {
+        emit rowAboutToBeInserted(m_rows.size());
+        m_rows.push_back(r);
+        m_rowByProfile.insert(r->profileIndex, m_rows.size() - 1);
+        count(r, +1);
+        emit rowInserted(m_rows.size() - 1);
+        return;
+    }
+
+    count(m_rows[row], -1);
+    m_rows[row] = r;
+    count(r, +1);
+    emit rowChanged(row);
+}
@@ -0,0 +1,63 @@
+// FleetResultStore.h
+//
+// Purpose:
+//   The results of the current fleet job, one row per target in job order.
+//   Rows are FleetResultPtr (immutable, shared): a state change or a final
+//   result replaces the row's pointer, and listeners get the changed row only
+//   (rowChanged), so progress costs O(1) per target instead of re-walking and
+//   copying every result with its output.
+//
+// Threading:
+//   UI thread only (FleetExecutor publishes from its finished handlers).
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+
+#include "FleetTypes.h"
+
+class FleetResultStore : public QObject
+{
+    Q_OBJECT
+public:
+    struct Counts {
+        int queued = 0;
+        int running = 0;
+        int ok = 0;
+        int failed = 0;
+        int canceled = 0;
+
+        int done() const { return ok + failed + canceled; }
+    };
+
+    explicit FleetResultStore(QObject* parent = nullptr);
+
+    // New job: rows in the given order (normally all Queued).
+    void reset(const QVector<FleetResultPtr>& rows);
+
+    // Replace the row of r->profileIndex (appended if the target is unknown).
+    void publish(const FleetResultPtr& r);
+
+    int size() const { return m_rows.size(); }
+    FleetResultPtr at(int row) const { return m_rows.value(row); }
+    int rowOf(int profileIndex) const { return m_rowByProfile.value(profileIndex, -1); }
+    QVector<FleetResultPtr> rows() const { return m_rows; }
+
+    Counts counts() const { return m_counts; }
+
+signals:
+    void storeAboutToReset();
+    void storeReset();
+    void rowAboutToBeInserted(int row);
+    void rowInserted(int row);
+    void rowChanged(int row);
+
+private:
+    void count(const FleetResultPtr& r, int delta);
+
+    QVector<FleetResultPtr> m_rows;
+    QHash<int, int>         m_rowByProfile;
+    Counts                  m_counts;
+};
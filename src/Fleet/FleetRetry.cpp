@@ -0,0 +1,118 @@
+// FleetRetry.cpp
+#include "FleetRetry.h"
+
+#include <QRandomGenerator>
+#include <QSettings>
+
+#include <cerrno>
+#include <netdb.h>
+
+#include <libssh/libssh.h>
+
+FleetRetryPolicy::Options FleetRetryPolicy::fromSettings()
+{
+    QSettings s;
+    Options o;
+    o.maxAttempts = qBound(1, s.value("fleet/retryMaxAttempts", 1).toInt(), 10);
+    o.baseDelayMs = qBound(50, s.value("fleet/retryBaseMs", 1000).toInt(), 600000);
+    o.maxDelayMs = qBound(o.baseDelayMs, s.value("fleet/retryMaxMs", 30000).toInt(), 600000);
+    return o;
+}
+
+FleetRetryPolicy::ErrorClass FleetRetryPolicy::classify(const FleetTargetResult& r)
+{
+    if (r.state != FleetTargetState::Failed)
+        return ErrorClass::None;
+    return classifyCause(r.cause);
+}
+
+// Network blips, throttling and overloaded sshd / resolvers are transient.
+// overload: the remote side (sshd MaxStartups, a bastion, LDAP) is likely too
+// busy, as opposed to a network problem; FleetConcurrency backs off on those.
+FleetRetryPolicy::ErrorClass FleetRetryPolicy::classifyCause(const FleetFailCause& cause, bool* overload)
+{
+    if (overload) *overload = false;
+
+    auto transient = [overload](bool busy) {
+        if (overload) *overload = busy;
+        return ErrorClass::Transient;
+    };
+
+    switch (cause.phase) {
+        case FleetFailPhase::Resolve:
+            // EAI_AGAIN: the resolver did not answer; anything else (no such
+            // name, no address) fails the same way next time.
+            return cause.code == EAI_AGAIN ? transient(false) : ErrorClass::Permanent;
+
+        case FleetFailPhase::Connect:
+            switch (cause.code) {
+                case ETIMEDOUT:
+                case ECONNREFUSED:
+                case ECONNRESET:
+                case EAGAIN:
+                case EPIPE:
+                    return transient(true);
+                case ENETUNREACH:
+                case EHOSTUNREACH:
+                case ENETDOWN:
+                    return transient(false);
+                default:
+                    return ErrorClass::Permanent;
+            }
+
+        case FleetFailPhase::Kex:
+        case FleetFailPhase::Auth:
+            // SSH_FATAL: the connection broke (sshd MaxStartups drops us
+            // before or during the handshake). SSH_REQUEST_DENIED / no error:
+            // the server answered, with a no.
+            return cause.code == SSH_FATAL ? transient(true) : ErrorClass::Permanent;
+
+        case FleetFailPhase::Timeout:
+        case FleetFailPhase::Tunnel:
+            return transient(true);
+
+        case FleetFailPhase::None:
+        case FleetFailPhase::Config:
+        case FleetFailPhase::Exec:
+        case FleetFailPhase::Canceled:
+            break;
+    }
+    return ErrorClass::Permanent;
+}
+
+QString FleetRetryPolicy::className(ErrorClass c)
+{
+    switch (c) {
+        case ErrorClass::None:      return QStringLiteral("none");
+        case ErrorClass::Transient: return QStringLiteral("transient");
+        case ErrorClass::Permanent: return QStringLiteral("permanent");
+    }
+    return QString();
+}
+
+FleetRetryPolicy::FleetRetryPolicy(const Options& opt)
+    : m_opt(opt)
+{
+}
+
+bool FleetRetryPolicy::shouldRetry(const FleetTargetResult& r, int attempt, int* delayMs) const
+{
+    if (attempt >= m_opt.maxAttempts)
+        return false;
+    // Authenticated once = the command (or a push) may have started.
+    if (r.connectMs >= 0)
+        return false;
+    if (classify(r) != ErrorClass::Transient)
+        return false;
+
+    if (delayMs) *delayMs = backoffMs(attempt);
+    return true;
+}
+
+int FleetRetryPolicy::backoffMs(int attempt) const
+{
+    const int shift = qBound(0, attempt - 1, 20);
+    const qint64 exp = qMin<qint64>(qint64(m_opt.baseDelayMs) << shift, m_opt.maxDelayMs);
+    const int half = int(exp / 2);
+    return half + int(QRandomGenerator::global()->bounded(half + 1));
+}
@@ -0,0 +1,65 @@
+// FleetRetry.h
+//
+// Purpose:
+//   Retry policy for fleet targets that hit a transient failure (connection
+//   reset, sshd MaxStartups throttling, a DNS hiccup) instead of marking
+//   them Failed on the first try.
+//
+//   - classify(): transient vs. permanent, by the structured cause the
+//     failure site recorded (FleetFailCause: phase + errno / EAI_* / libssh
+//     code), never by the display text, which may be translated. Unknown
+//     causes count as permanent (no retry). classifyCause() also says which
+//     transient failures mean an overloaded remote side; FleetConcurrency
+//     backs off on those.
+//   - shouldRetry(): only transient errors, only while the target never got
+//     past connect + auth (connectMs < 0). Once a session was authenticated
+//     the command may have started; it is never run twice.
+//   - backoffMs(): exponential (base * 2^(attempt-1), capped at max) with
+//     "equal jitter" (half fixed, half random), so targets that failed
+//     together do not come back together.
+//
+//   FleetExecutor puts the target back into its work queue when the delay
+//   is over; nothing waits on a worker thread meanwhile.
+//
+// Settings:
+//   fleet/retryMaxAttempts (default 1 = no retry), fleet/retryBaseMs (1000),
+//   fleet/retryMaxMs (30000)
+
+#pragma once
+
+#include <QString>
+
+#include "FleetTypes.h"
+
+class FleetRetryPolicy
+{
+public:
+    enum class ErrorClass { None, Transient, Permanent };
+
+    struct Options {
+        int maxAttempts = 1;       // total tries per target (1 = no retry)
+        int baseDelayMs = 1000;
+        int maxDelayMs = 30000;
+    };
+
+    static Options fromSettings();
+
+    static ErrorClass classify(const FleetTargetResult& r);
+    // *overload is set for transient failures that point at an overloaded
+    // remote side (timeouts, refused/reset, sshd dropping us mid-handshake).
+    static ErrorClass classifyCause(const FleetFailCause& cause, bool* overload = nullptr);
+    static QString className(ErrorClass c);   // audit key: "none", "transient", "permanent"
+
+    explicit FleetRetryPolicy(const Options& opt = Options());
+
+    const Options& options() const { return m_opt; }
+    bool enabled() const { return m_opt.maxAttempts > 1; }
+
+    // attempt = tries made so far (1 after the first). True when r should be
+    // tried again; *delayMs gets the backoff.
+    bool shouldRetry(const FleetTargetResult& r, int attempt, int* delayMs) const;
+    int backoffMs(int attempt) const;
+
+private:
+    Options m_opt;
+};
@@ -3,17 +3,25 @@
 #include <QString>
 #include <QVector>
 #include <QDateTime>
+#include <QSharedPointer>
+#include <QMetaType>
 
 enum class FleetActionType {
     RunCommand,
     CheckService,
-    RestartService
+    RestartService,
+    PushFile
 };
 
 struct FleetAction {
     FleetActionType type = FleetActionType::RunCommand;
     QString title;     // e.g. "Restart nginx"
-    QString payload;   // e.g. command string OR service name
+    QString payload;   // e.g. command string OR service name OR local file (PushFile)
+
+    // PushFile only
+    QString remotePath;
+    int     remoteMode = 0644;
+    bool    relay = false;   // updated hosts forward the file to peers
 };
 
 enum class FleetTargetState {
@@ -24,6 +32,26 @@ enum class FleetTargetState {
     Canceled
 };
 
+// Where a target failed, recorded at the failure site (error is display
+// text and may be translated). FleetRetryPolicy classifies on this.
+enum class FleetFailPhase {
+    None,
+    Config,     // bad profile / command, session setup
+    Resolve,    // code = getaddrinfo() EAI_*
+    Connect,    // code = errno (ETIMEDOUT: our own connect timeout)
+    Tunnel,     // jump host chain
+    Kex,        // code = ssh_get_error_code()
+    Auth,       // code = ssh_get_error_code()
+    Timeout,    // target deadline ran out before the command finished
+    Exec,       // channel / command / transfer, after authentication
+    Canceled
+};
+
+struct FleetFailCause {
+    FleetFailPhase phase = FleetFailPhase::None;
+    int code = 0;
+};
+
 struct FleetTargetResult {
     int profileIndex = -1;
     QString profileName;
@@ -34,21 +62,57 @@ struct FleetTargetResult {
 
     FleetTargetState state = FleetTargetState::Queued;
     qint64 durationMs = 0;
+    qint64 connectMs = -1;       // connect + auth; -1 = never got that far
+    int    attempts = 1;         // tries so far (FleetRetryPolicy)
+
+    // Per-phase latency in ms (FleetLatencyStats); -1 = phase not reached or
+    // not measured (DNS behind a jump host).
+    qint64 dnsMs = -1;
+    qint64 tcpMs = -1;           // TCP connect (jump hosts: tunnel open)
+    qint64 kexMs = -1;           // banner + key exchange
+    qint64 authMs = -1;
+    qint64 channelMs = -1;       // channel open + exec request
+    qint64 execMs = -1;          // command start -> exit (push: transfer + verify)
 
+    // Bounded: head + tail of each stream (see SshExecCapture).
     QString stdoutText;
     QString stderrText;
     QString error;   // high-level failure reason
+    FleetFailCause cause;        // structured form of error (state == Failed)
+
+    int     exitStatus = -1;     // -1 = not run / no status received
+    qint64  stdoutBytes = 0;     // exact sizes, even when the text is truncated
+    qint64  stderrBytes = 0;
+    bool    outputTruncated = false;
+    QString stdoutSpillPath;     // complete output on disk (only when truncated)
+    QString stderrSpillPath;
+
+    // Fingerprints of the complete stdout (see FleetOutputDigest); empty
+    // when the command did not run.
+    QByteArray stdoutDigest;
+    QByteArray stdoutShapeDigest;
 };
 
+// A published result is never modified again: the store, the model and any
+// other reader share one copy (including the output text) instead of copying it.
+using FleetResultPtr = QSharedPointer<const FleetTargetResult>;
+
+inline FleetResultPtr makeFleetResult(FleetTargetResult r)
+{
+    return FleetResultPtr(new FleetTargetResult(std::move(r)));
+}
+
+Q_DECLARE_METATYPE(FleetResultPtr)
+
+// Job header. Per-target results live in FleetResultStore.
 struct FleetJob {
     QString id;
     QString title;
 
     QVector<int> profileIndexes; // indices into the profile list you passed to FleetWindow
     FleetAction action;
+    int concurrency = 0;         // targets run at the same time
 
     QDateTime startedAt;
     QDateTime finishedAt;
-
-    QVector<FleetTargetResult> results;
 };
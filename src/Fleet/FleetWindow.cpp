@@ -13,8 +13,12 @@
 #include <QFormLayout>
 #include <QDialogButtonBox>
 #include <QSettings>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QRegularExpression>
 
 #include "AuditLogger.h"
+#include "FleetHistoryDialog.h"
 
 static QString normalizedGroup(const QString& g)
 {
@@ -43,6 +47,17 @@ FleetWindow::FleetWindow(const QVector<SshProfile>& profiles, QWidget* parent)
     connect(m_exec, &FleetExecutor::jobStarted,  this, &FleetWindow::onJobStarted);
     connect(m_exec, &FleetExecutor::jobProgress, this, &FleetWindow::onJobProgress);
     connect(m_exec, &FleetExecutor::jobFinished, this, &FleetWindow::onJobFinished);
+    connect(m_exec, &FleetExecutor::concurrencyChanged, this, [this](int limit, const QString& why) {
+        m_currentLimit = limit;
+        if (!why.isEmpty())
+            appendLog(tr("Concurrency lowered to %1: %2").arg(limit).arg(why));
+    });
+    connect(m_exec, &FleetExecutor::targetRetrying, this,
+            [this](int profileIndex, int nextAttempt, int delayMs, const QString& error) {
+        const QString name = (profileIndex >= 0 && profileIndex < m_profiles.size())
+                                 ? m_profiles[profileIndex].name : QString::number(profileIndex);
+        appendLog(tr("Retry %1 (attempt %2) in %3 ms: %4").arg(name).arg(nextAttempt).arg(delayMs).arg(error));
+    });
 }
 
 FleetWindow::~FleetWindow() = default;
@@ -108,11 +123,26 @@ void FleetWindow::buildUi()
     m_actionCombo->addItem(tr("Run command"), (int)FleetActionType::RunCommand);
     m_actionCombo->addItem(tr("Check service (systemd)"), (int)FleetActionType::CheckService);
     m_actionCombo->addItem(tr("Restart service (systemd)"), (int)FleetActionType::RestartService);
+    m_actionCombo->addItem(tr("Push file"), (int)FleetActionType::PushFile);
 
     m_concurrencySpin = new QSpinBox(aTop);
-    m_concurrencySpin->setRange(1, 32);
+    m_concurrencySpin->setRange(1, FleetExecutor::kMaxConcurrency);
     m_concurrencySpin->setValue(4);
-    m_concurrencySpin->setToolTip(tr("Max parallel targets"));
+    m_concurrencySpin->setToolTip(tr("Max parallel targets (above %1, non-blocking sessions on a few threads)")
+                                      .arg(FleetExecutor::kMaxThreadTargets));
+
+    m_adaptiveCheck = new QCheckBox(tr("Adaptive"), aTop);
+    m_adaptiveCheck->setToolTip(tr("Start low and ramp up while hosts answer quickly; back off on\n"
+                                   "timeouts, refused connections or auth throttling.\n"
+                                   "The concurrency value is the ceiling."));
+    m_adaptiveCheck->setChecked(QSettings().value("fleet/adaptive", false).toBool());
+
+    m_groupCapsEdit = new QLineEdit(aTop);
+    m_groupCapsEdit->setPlaceholderText(tr("Group caps, e.g. dmz=10, *=50"));
+    m_groupCapsEdit->setToolTip(tr("Max targets of one profile group running at once\n"
+                                   "(e.g. hosts behind one bastion). * = every other group."));
+    m_groupCapsEdit->setText(QSettings().value("fleet/groupCaps").toString());
+    m_groupCapsEdit->setMaximumWidth(200);
 
     // NEW: Timeout (seconds)
     m_timeoutSpin = new QSpinBox(aTop);
@@ -121,6 +151,13 @@ void FleetWindow::buildUi()
     m_timeoutSpin->setSuffix(tr(" s"));
     m_timeoutSpin->setToolTip(tr("Per-target command timeout (seconds)."));
 
+    m_retrySpin = new QSpinBox(aTop);
+    m_retrySpin->setRange(0, 5);
+    m_retrySpin->setValue(qBound(0, QSettings().value("fleet/retryMaxAttempts", 1).toInt() - 1, 5));
+    m_retrySpin->setToolTip(tr("Extra tries for targets that fail to connect with a transient error\n"
+                               "(reset, refused, timeout, sshd throttling, DNS hiccup).\n"
+                               "Exponential backoff with jitter; a command that started is never re-run."));
+
     // NEW: Audit command logging mode (per-user setting)
     m_cmdAuditCombo = new QComboBox(aTop);
     m_cmdAuditCombo->addItem(tr("None"), 0);                 // log nothing about command
@@ -176,10 +213,15 @@ void FleetWindow::buildUi()
 
     aTopL->addWidget(new QLabel(tr("Concurrency:"), aTop));
     aTopL->addWidget(m_concurrencySpin);
+    aTopL->addWidget(m_adaptiveCheck);
+    aTopL->addWidget(m_groupCapsEdit);
 
     aTopL->addWidget(new QLabel(tr("Timeout:"), aTop));
     aTopL->addWidget(m_timeoutSpin);
 
+    aTopL->addWidget(new QLabel(tr("Retries:"), aTop));
+    aTopL->addWidget(m_retrySpin);
+
     aTopL->addWidget(new QLabel(tr("Audit cmd log:"), aTop));
     aTopL->addWidget(m_cmdAuditCombo);
 
@@ -237,6 +279,46 @@ void FleetWindow::buildUi()
         m_actionStack->addWidget(page);
     }
 
+    // Page 3: PushFile
+    {
+        auto* page = new QWidget(m_actionStack);
+        auto* l = new QFormLayout(page);
+        l->setContentsMargins(0, 0, 0, 0);
+
+        auto* localRow = new QWidget(page);
+        auto* localL = new QHBoxLayout(localRow);
+        localL->setContentsMargins(0, 0, 0, 0);
+        m_pushLocalEdit = new QLineEdit(localRow);
+        m_pushLocalEdit->setPlaceholderText(tr("Local file"));
+        auto* browseBtn = new QPushButton(tr("Browse…"), localRow);
+        localL->addWidget(m_pushLocalEdit, 1);
+        localL->addWidget(browseBtn);
+        connect(browseBtn, &QPushButton::clicked, this, [this]() {
+            const QString f = QFileDialog::getOpenFileName(this, tr("File to push"), m_pushLocalEdit->text());
+            if (!f.isEmpty()) m_pushLocalEdit->setText(f);
+        });
+
+        m_pushRemoteEdit = new QLineEdit(page);
+        m_pushRemoteEdit->setPlaceholderText(tr("e.g. /etc/myapp/config.yml"));
+
+        m_pushModeEdit = new QLineEdit(QStringLiteral("0644"), page);
+        m_pushModeEdit->setMaxLength(4);
+        m_pushModeEdit->setToolTip(tr("Octal permissions of the file on the targets."));
+
+        m_pushRelayCheck = new QCheckBox(tr("Let updated hosts forward the file to others (needs host-to-host SSH keys)"), page);
+        m_pushRelayCheck->setChecked(QSettings().value("fleet/pushRelay", false).toBool());
+        m_pushRelayCheck->setToolTip(tr("Hosts copy to their peers with scp, checking the peer's host key\n"
+                                        "against their own known_hosts (fleet/pushRelayHostKeyCheck = yes).\n"
+                                        "Peers they do not know yet get a direct push instead."));
+
+        l->addRow(tr("Local file:"), localRow);
+        l->addRow(tr("Remote path:"), m_pushRemoteEdit);
+        l->addRow(tr("Mode:"), m_pushModeEdit);
+        l->addRow(QString(), m_pushRelayCheck);
+
+        m_actionStack->addWidget(page);
+    }
+
     actionL->addWidget(aTop);
     actionL->addWidget(m_actionStack);
 
@@ -253,22 +335,20 @@ void FleetWindow::buildUi()
     m_statusLabel = new QLabel(tr("Ready."), runBar);
     m_statusLabel->setStyleSheet("color:#888;");
 
+    auto* historyBtn = new QPushButton(tr("History…"), runBar);
+    historyBtn->setToolTip(tr("Browse and search past fleet jobs"));
+
     runL->addWidget(m_runBtn);
     runL->addWidget(m_cancelBtn);
     runL->addWidget(m_statusLabel, 1);
-
-    // Results table
-    m_resultsTable = new QTableWidget(right);
-    m_resultsTable->setColumnCount(7);
-    m_resultsTable->setHorizontalHeaderLabels({
-        tr("Profile"),
-        tr("Group"),
-        tr("Target"),
-        tr("Status"),
-        tr("Duration"),
-        tr("Stdout (preview)"),
-        tr("Error (preview)")
-    });
+    runL->addWidget(historyBtn);
+
+    // Results table (model over the executor's result store)
+    m_resultsModel = new FleetResultModel(m_exec->resultStore(), this);
+    m_resultsTable = new QTableView(right);
+    m_resultsTable->setModel(m_resultsModel);
+    m_resultsTable->setWordWrap(false);
+    m_resultsTable->verticalHeader()->setDefaultSectionSize(22);
     m_resultsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     m_resultsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_resultsTable->setSelectionMode(QAbstractItemView::SingleSelection);
@@ -283,12 +363,45 @@ void FleetWindow::buildUi()
     m_log->setReadOnly(true);
     m_log->setPlaceholderText(tr("Fleet log…"));
 
+    // Grouped view (identical output collapsed into one row per group)
+    m_groupView = new FleetGroupView(right);
+
+    m_resultsStack = new QStackedWidget(right);
+    m_resultsStack->addWidget(m_resultsTable);
+    m_resultsStack->addWidget(m_groupView);
+
+    auto* viewBar = new QWidget(right);
+    auto* viewL = new QHBoxLayout(viewBar);
+    viewL->setContentsMargins(0, 0, 0, 0);
+    viewL->setSpacing(8);
+    m_groupCheck = new QCheckBox(tr("Group identical output"), viewBar);
+    m_similarCheck = new QCheckBox(tr("Treat host names and numbers as equal"), viewBar);
+    m_similarCheck->setEnabled(false);
+    m_latencyCheck = new QCheckBox(tr("Latency by phase"), viewBar);
+    m_latencyCheck->setToolTip(tr("Per-phase latency histograms (DNS, TCP, key exchange, auth, exec) across the job."));
+    viewL->addWidget(m_groupCheck);
+    viewL->addWidget(m_similarCheck);
+    viewL->addStretch(1);
+    viewL->addWidget(m_latencyCheck);
+
+    m_latencyView = new FleetLatencyView(right);
+    m_latencyView->setVisible(false);
+
+    auto* resultsPane = new QWidget(right);
+    auto* resultsL = new QVBoxLayout(resultsPane);
+    resultsL->setContentsMargins(0, 0, 0, 0);
+    resultsL->setSpacing(4);
+    resultsL->addWidget(viewBar, 0);
+    resultsL->addWidget(m_resultsStack, 1);
+
     auto* rightSplit = new QSplitter(Qt::Vertical, right);
     rightSplit->setChildrenCollapsible(false);
-    rightSplit->addWidget(m_resultsTable);
+    rightSplit->addWidget(resultsPane);
+    rightSplit->addWidget(m_latencyView);
     rightSplit->addWidget(m_log);
     rightSplit->setStretchFactor(0, 3);
     rightSplit->setStretchFactor(1, 1);
+    rightSplit->setStretchFactor(2, 1);
 
     rightL->addWidget(actionBox, 0);
     rightL->addWidget(runBar, 0);
@@ -310,7 +423,24 @@ void FleetWindow::buildUi()
     connect(m_actionCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &FleetWindow::onActionChanged);
     connect(m_runBtn, &QPushButton::clicked, this, &FleetWindow::onRunClicked);
     connect(m_cancelBtn, &QPushButton::clicked, this, &FleetWindow::onCancelClicked);
-    connect(m_resultsTable, &QTableWidget::cellDoubleClicked, this, &FleetWindow::onResultRowActivated);
+    connect(m_resultsTable, &QTableView::doubleClicked, this, &FleetWindow::onResultRowActivated);
+    connect(historyBtn, &QPushButton::clicked, this, [this]() {
+        auto* dlg = new FleetHistoryDialog(this);
+        dlg->show();
+    });
+    connect(m_groupView, &FleetGroupView::targetActivated, this, &FleetWindow::onGroupTargetActivated);
+    connect(m_groupCheck, &QCheckBox::toggled, this, &FleetWindow::onGroupingChanged);
+    connect(m_similarCheck, &QCheckBox::toggled, this, &FleetWindow::onGroupingChanged);
+
+    // Groups follow the job live; only finished targets are grouped.
+    connect(m_exec->resultStore(), &FleetResultStore::storeReset, m_groupView, &FleetGroupView::clearGroups);
+    connect(m_exec, &FleetExecutor::targetFinished, this, [this](int, const FleetResultPtr& r) {
+        if (m_resultsStack && m_resultsStack->currentWidget() == m_groupView)
+            m_groupView->addResult(r);
+        m_latencyView->addResult(r);
+    });
+    connect(m_exec->resultStore(), &FleetResultStore::storeReset, m_latencyView, &FleetLatencyView::clearStats);
+    connect(m_latencyCheck, &QCheckBox::toggled, m_latencyView, &QWidget::setVisible);
 
     onActionChanged(m_actionCombo->currentIndex());
 }
@@ -322,18 +452,6 @@ void FleetWindow::appendLog(const QString& line)
     m_log->appendPlainText(QString("[%1] %2").arg(ts, line));
 }
 
-QString FleetWindow::stateToText(FleetTargetState st) const
-{
-    switch (st) {
-        case FleetTargetState::Queued:   return tr("QUEUED");
-        case FleetTargetState::Running:  return tr("RUNNING");
-        case FleetTargetState::Ok:       return tr("OK");
-        case FleetTargetState::Failed:   return tr("FAIL");
-        case FleetTargetState::Canceled: return tr("CANCELED");
-    }
-    return tr("UNKNOWN");
-}
-
 void FleetWindow::rebuildTargetsList()
 {
     if (!m_targetsList) return;
@@ -437,70 +555,6 @@ QVector<int> FleetWindow::selectedProfileIndexes() const
     return out;
 }
 
-void FleetWindow::clearResults()
-{
-    m_rowByProfile.clear();
-    if (m_resultsTable) {
-        m_resultsTable->setRowCount(0);
-        m_resultsTable->clearContents();
-    }
-}
-
-void FleetWindow::upsertResultRow(const FleetTargetResult& r)
-{
-    if (!m_resultsTable) return;
-
-    int row = -1;
-    if (m_rowByProfile.contains(r.profileIndex)) {
-        row = m_rowByProfile.value(r.profileIndex);
-    } else {
-        row = m_resultsTable->rowCount();
-        m_resultsTable->insertRow(row);
-        m_rowByProfile.insert(r.profileIndex, row);
-    }
-
-    const QString target = QString("%1@%2:%3").arg(r.user, r.host).arg(r.port);
-    const QString dur = (r.durationMs > 0) ? tr("%1 ms").arg(r.durationMs) : QString();
-
-    auto preview = [](const QString& s) -> QString {
-        QString t = s;
-        t.replace("\r\n", "\n");
-        t.replace("\r", "\n");
-        t = t.trimmed();
-        if (t.size() > 120) t = t.left(120) + "…";
-        return t;
-    };
-
-    const QString outPrev = preview(r.stdoutText);
-    const QString errPrev = preview(!r.error.isEmpty() ? r.error : r.stderrText);
-
-    auto setCell = [this, row](int col, const QString& text) {
-        auto* it = m_resultsTable->item(row, col);
-        if (!it) {
-            it = new QTableWidgetItem();
-            m_resultsTable->setItem(row, col, it);
-        }
-        it->setText(text);
-    };
-
-    setCell(0, r.profileName);
-    setCell(1, normalizedGroup(r.group));
-    setCell(2, target);
-    setCell(3, stateToText(r.state));
-    setCell(4, dur);
-    setCell(5, outPrev);
-    setCell(6, errPrev);
-
-    // stash full detail in UserRole
-    auto* keyItem = m_resultsTable->item(row, 0);
-    if (keyItem) {
-        keyItem->setData(Qt::UserRole, r.profileIndex);
-        keyItem->setData(Qt::UserRole + 1, r.stdoutText);
-        keyItem->setData(Qt::UserRole + 2, r.stderrText);
-        keyItem->setData(Qt::UserRole + 3, r.error);
-    }
-}
-
 void FleetWindow::onActionChanged(int idx)
 {
     if (!m_actionCombo || !m_actionStack) return;
@@ -511,6 +565,8 @@ void FleetWindow::onActionChanged(int idx)
         m_actionStack->setCurrentIndex(0);
     } else if (t == FleetActionType::CheckService) {
         m_actionStack->setCurrentIndex(1);
+    } else if (t == FleetActionType::PushFile) {
+        m_actionStack->setCurrentIndex(3);
     } else {
         m_actionStack->setCurrentIndex(2);
     }
@@ -530,9 +586,30 @@ void FleetWindow::onRunClicked()
     const int conc = m_concurrencySpin ? m_concurrencySpin->value() : 4;
     m_exec->setMaxConcurrency(conc);
 
+    {
+        const QString caps = m_groupCapsEdit ? m_groupCapsEdit->text().trimmed() : QString();
+        QString capsErr;
+        if (!m_exec->setGroupCaps(caps, &capsErr)) {
+            QMessageBox::warning(this, tr("Fleet"), capsErr);
+            return;
+        }
+        const bool adaptive = m_adaptiveCheck && m_adaptiveCheck->isChecked();
+        m_exec->setAdaptiveConcurrency(adaptive);
+
+        QSettings st;
+        st.setValue("fleet/adaptive", adaptive);
+        st.setValue("fleet/groupCaps", caps);
+    }
+
     const int timeoutSec = m_timeoutSpin ? m_timeoutSpin->value() : 90;
     m_exec->setCommandTimeoutMs(timeoutSec * 1000);
 
+    {
+        const int retries = m_retrySpin ? m_retrySpin->value() : 0;
+        QSettings().setValue("fleet/retryMaxAttempts", retries + 1);
+        m_exec->setRetryPolicy(FleetRetryPolicy::fromSettings());
+    }
+
     // Command audit logging mode from settings:
     // 0=None, 1=Safe (head+hash), 2=Full (store full command string)
     QSettings s;
@@ -593,9 +670,32 @@ void FleetWindow::onRunClicked()
         );
         if (ans != QMessageBox::Yes)
             return;
-    }
+    } else if (action.type == FleetActionType::PushFile) {
+        action.payload    = m_pushLocalEdit ? m_pushLocalEdit->text().trimmed() : QString();
+        action.remotePath = m_pushRemoteEdit ? m_pushRemoteEdit->text().trimmed() : QString();
+        action.relay      = m_pushRelayCheck && m_pushRelayCheck->isChecked();
+        action.title      = tr("Push %1").arg(QFileInfo(action.payload).fileName());
+
+        const QFileInfo fi(action.payload);
+        if (!fi.isFile() || !fi.isReadable()) {
+            QMessageBox::warning(this, tr("Fleet"), tr("Local file does not exist or is not readable."));
+            return;
+        }
+        if (!action.remotePath.startsWith('/') || action.remotePath.endsWith('/')) {
+            QMessageBox::warning(this, tr("Fleet"), tr("Remote path must be an absolute file path."));
+            return;
+        }
 
-    clearResults();
+        bool modeOk = false;
+        const QString modeStr = m_pushModeEdit ? m_pushModeEdit->text().trimmed() : QString();
+        action.remoteMode = modeStr.toInt(&modeOk, 8);
+        if (!modeOk || !QRegularExpression("^[0-7]{3,4}$").match(modeStr).hasMatch()) {
+            QMessageBox::warning(this, tr("Fleet"), tr("Mode must be octal, e.g. 0644."));
+            return;
+        }
+
+        QSettings().setValue("fleet/pushRelay", action.relay);
+    }
 
     auto modeText = [this](int m) -> QString {
         switch (m) {
@@ -618,6 +718,7 @@ void FleetWindow::onRunClicked()
     f["targets"] = (int)targets.size();
     f["concurrency"] = conc;
     f["timeout_ms"] = timeoutSec * 1000;
+    f["max_attempts"] = m_exec->retryPolicy().options().maxAttempts;
     f["action"] = (int)action.type;
     f["cmd_log_mode"] = cmdLogMode;
 
@@ -646,35 +747,41 @@ void FleetWindow::onJobStarted(const FleetJob& job)
     appendLog(tr("JOB %1 started: %2").arg(job.id, job.title));
 }
 
-void FleetWindow::onJobProgress(const FleetJob& job, int done, int total)
+void FleetWindow::onJobProgress(int done, int total)
 {
-    // Update rows for any results we’ve received so far
-    // (job.results grows as chunks finish)
-    for (const auto& r : job.results)
-        upsertResultRow(r);
-
-    if (m_statusLabel)
+    // Rows update themselves (FleetResultModel follows the result store).
+    if (!m_statusLabel) return;
+    if (m_adaptiveCheck && m_adaptiveCheck->isChecked() && m_currentLimit > 0)
+        m_statusLabel->setText(tr("Progress: %1/%2 (concurrency %3)").arg(done).arg(total).arg(m_currentLimit));
+    else
         m_statusLabel->setText(tr("Progress: %1/%2").arg(done).arg(total));
 }
 
 void FleetWindow::onJobFinished(const FleetJob& job)
 {
-    for (const auto& r : job.results)
-        upsertResultRow(r);
-
-    int ok = 0, fail = 0, cancel = 0;
-    for (const auto& r : job.results) {
-        if (r.state == FleetTargetState::Ok) ok++;
-        else if (r.state == FleetTargetState::Canceled) cancel++;
-        else if (r.state == FleetTargetState::Failed) fail++;
-    }
+    Q_UNUSED(job);
+    const FleetResultStore::Counts c = m_exec->resultStore()->counts();
 
     const QString summary =
         tr("Finished: OK=%1  FAIL=%2  CANCELED=%3  (targets=%4)")
-            .arg(ok).arg(fail).arg(cancel).arg(job.results.size());
+            .arg(c.ok).arg(c.failed).arg(c.canceled).arg(m_exec->resultStore()->size());
 
     appendLog(summary);
 
+    // Per-phase latency of the job, plus where the time went.
+    {
+        const FleetLatencyStats& st = m_latencyView->stats();
+        if (st.count(FleetLatencyStats::Total) > 0) {
+            QStringList parts;
+            for (int ph = 0; ph < FleetLatencyStats::PhaseCount; ++ph) {
+                if (st.count(ph) > 0) parts << st.summaryLine(ph);
+            }
+            appendLog(tr("Latency: %1").arg(parts.join("; ")));
+            const QString verdict = st.diagnosis();
+            if (!verdict.isEmpty()) appendLog(tr("Latency: %1").arg(verdict));
+        }
+    }
+
     if (m_statusLabel)
         m_statusLabel->setText(summary);
 
@@ -682,17 +789,53 @@ void FleetWindow::onJobFinished(const FleetJob& job)
     if (m_cancelBtn) m_cancelBtn->setEnabled(false);
 }
 
-void FleetWindow::onResultRowActivated(int row, int /*col*/)
+void FleetWindow::onResultRowActivated(const QModelIndex& index)
 {
-    if (!m_resultsTable) return;
+    if (!m_resultsModel || !index.isValid()) return;
+
+    showResult(m_resultsModel->resultAt(index.row()));
+}
 
-    auto* it = m_resultsTable->item(row, 0);
-    if (!it) return;
+void FleetWindow::onGroupTargetActivated(int profileIndex)
+{
+    const FleetResultStore* store = m_exec->resultStore();
+    showResult(store->at(store->rowOf(profileIndex)));
+}
+
+void FleetWindow::onGroupingChanged()
+{
+    const bool grouped = m_groupCheck && m_groupCheck->isChecked();
+    if (m_similarCheck) m_similarCheck->setEnabled(grouped);
+    if (!m_resultsStack || !m_groupView) return;
+
+    if (grouped) {
+        m_groupView->setSimilarMode(m_similarCheck && m_similarCheck->isChecked());
+        m_groupView->rebuild(m_exec->resultStore()->rows());
+        m_resultsStack->setCurrentWidget(m_groupView);
+    } else {
+        m_resultsStack->setCurrentWidget(m_resultsTable);
+    }
+}
 
-    const int profileIndex = it->data(Qt::UserRole).toInt();
-    const QString out = it->data(Qt::UserRole + 1).toString();
-    const QString err = it->data(Qt::UserRole + 2).toString();
-    const QString hi  = it->data(Qt::UserRole + 3).toString();
+void FleetWindow::showResult(const FleetResultPtr& r)
+{
+    if (!r) return;
+
+    const int profileIndex = r->profileIndex;
+    const QString out = r->stdoutText;
+    const QString err = r->stderrText;
+    const QString hi  = r->error;
+
+    // Output sizes / where the complete output went when the view is truncated.
+    QString outputNote;
+    if (r->outputTruncated) {
+        outputNote = tr("Output truncated in view (stdout %1 bytes, stderr %2 bytes).")
+                         .arg(r->stdoutBytes).arg(r->stderrBytes);
+        if (!r->stdoutSpillPath.isEmpty())
+            outputNote += "\n" + tr("Full stdout: %1").arg(r->stdoutSpillPath);
+        if (!r->stderrSpillPath.isEmpty())
+            outputNote += "\n" + tr("Full stderr: %1").arg(r->stderrSpillPath);
+    }
 
     QString title = tr("Fleet result");
     if (profileIndex >= 0 && profileIndex < m_profiles.size())
@@ -715,6 +858,27 @@ void FleetWindow::onResultRowActivated(int row, int /*col*/)
     }
     v->addWidget(meta);
 
+    // Where this target's time went (phases it reached).
+    {
+        QStringList phases;
+        for (int ph = 0; ph < FleetLatencyStats::PhaseCount; ++ph) {
+            const qint64 ms = FleetLatencyStats::phaseValue(*r, ph);
+            if (ms >= 0) phases << QString("%1 %2 ms").arg(FleetLatencyStats::phaseName(ph)).arg(ms);
+        }
+        if (!phases.isEmpty()) {
+            auto* timing = new QLabel(phases.join(QStringLiteral("  ·  ")), dlg);
+            timing->setTextInteractionFlags(Qt::TextSelectableByMouse);
+            v->addWidget(timing);
+        }
+    }
+
+    if (!outputNote.isEmpty()) {
+        auto* note = new QLabel(outputNote, dlg);
+        note->setTextInteractionFlags(Qt::TextSelectableByMouse);
+        note->setWordWrap(true);
+        v->addWidget(note);
+    }
+
     auto* tabs = new QTabWidget(dlg);
 
     auto* outView = new QTextEdit(dlg);
@@ -10,12 +10,15 @@
 #include <QSpinBox>
 #include <QPushButton>
 #include <QLabel>
-#include <QTableWidget>
+#include <QTableView>
 #include <QPlainTextEdit>
 #include <QStackedWidget>
 #include <QCheckBox>
 
 #include "FleetExecutor.h"
+#include "FleetResultModel.h"
+#include "FleetGroupView.h"
+#include "FleetLatencyView.h"
 #include "../ProfileStore.h" // SshProfile
 class QComboBox;
 class FleetWindow : public QMainWindow
@@ -32,10 +35,12 @@ private slots:
     void onRunClicked();
     void onCancelClicked();
     void onActionChanged(int idx);
-    void onResultRowActivated(int row, int col);
+    void onResultRowActivated(const QModelIndex& index);
+    void onGroupTargetActivated(int profileIndex);
+    void onGroupingChanged();
 
     void onJobStarted(const FleetJob& job);
-    void onJobProgress(const FleetJob& job, int done, int total);
+    void onJobProgress(int done, int total);
     void onJobFinished(const FleetJob& job);
 
 private:
@@ -43,10 +48,8 @@ private:
     void rebuildTargetsList();
     QVector<int> selectedProfileIndexes() const;
 
-    void clearResults();
     void appendLog(const QString& line);
-    void upsertResultRow(const FleetTargetResult& r);
-    QString stateToText(FleetTargetState st) const;
+    void showResult(const FleetResultPtr& r);
 
 private:
     QVector<SshProfile> m_profiles;
@@ -64,22 +67,34 @@ private:
     QLineEdit* m_cmdEdit = nullptr;          // RunCommand
     QLineEdit* m_serviceEdit = nullptr;      // Check/Restart service
     QCheckBox* m_confirmDanger = nullptr;    // for restart
+    QLineEdit* m_pushLocalEdit = nullptr;    // PushFile
+    QLineEdit* m_pushRemoteEdit = nullptr;
+    QLineEdit* m_pushModeEdit = nullptr;
+    QCheckBox* m_pushRelayCheck = nullptr;
 
     QSpinBox*    m_concurrencySpin = nullptr;
+    QCheckBox*   m_adaptiveCheck = nullptr;
+    QLineEdit*   m_groupCapsEdit = nullptr;
+    int          m_currentLimit = 0;      // concurrency now (adaptive mode moves it)
 
     QPushButton* m_runBtn = nullptr;
     QPushButton* m_cancelBtn = nullptr;
 
     QLabel*       m_statusLabel = nullptr;
-    QTableWidget* m_resultsTable = nullptr;
+    QTableView*   m_resultsTable = nullptr;
+    FleetResultModel* m_resultsModel = nullptr;
+    FleetGroupView* m_groupView = nullptr;
+    QStackedWidget* m_resultsStack = nullptr;
+    QCheckBox*    m_groupCheck = nullptr;
+    QCheckBox*    m_similarCheck = nullptr;
+    QCheckBox*    m_latencyCheck = nullptr;
+    FleetLatencyView* m_latencyView = nullptr;  // per-phase histograms of the job
     QPlainTextEdit* m_log = nullptr;
 
     // Engine
     FleetExecutor* m_exec = nullptr;
 
-    // For table row mapping
-    // key: profileIndex -> row
-    QHash<int,int> m_rowByProfile;
     QSpinBox* m_timeoutSpin = nullptr;   // command timeout (seconds)
+    QSpinBox* m_retrySpin = nullptr;     // extra tries on transient connect errors
     QComboBox* m_cmdAuditCombo = nullptr;
 };
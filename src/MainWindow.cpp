@@ -5,6 +5,10 @@
 #include "FilesTab.h"
 #include "IdentityManagerDialog.h"
 #include "Audit/AuditLogViewerDialog.h"
+#include "PredictiveEcho.h"
+#include "ScrollbackBudget.h"
+#include "ScrollbackSearchDialog.h"
+#include "WorkScheduler.h"
 
 #include <QTextBrowser>
 #include <QInputDialog>
@@ -84,6 +88,10 @@
 #include "SshProfile.h"
 #include "ScheduledJobStore.h"
 #include "ScheduledJobsDialog.h"
+#include "SshPreconnectPool.h"
+#include "SshLinkMonitor.h"
+#include "SshJumpHost.h"
+#include "SshCipherTuner.h"
 //
 // ARCHITECTURE NOTES (MainWindow.cpp)
 //
@@ -102,7 +110,8 @@
 //   - key install confirmations and UI safety checks
 //
 // Guiding rule: keep blocking operations off the UI thread.
-// QtConcurrent + QFutureWatcher is used for libssh connects,
+// QtConcurrent + QFutureWatcher is used for libssh connects (interactive lane
+// of WorkScheduler, ahead of fleet work),
 // and QProcess is used for external `ssh` probing / terminal sessions.
 //
 
@@ -611,6 +620,10 @@ MainWindow::MainWindow(QWidget *parent)
             << "OS:" << QSysInfo::prettyProductName()
             << "Platform:" << QGuiApplication::platformName();
 
+    // Created before applySavedSettings(), which configures them from QSettings.
+    m_preconnect  = new SshPreconnectPool(this);
+    m_linkMonitor = new SshLinkMonitor(&m_ssh, this);
+
     // Global widget theme. Terminal colors are handled separately.
     applySavedSettings();
 
@@ -760,6 +773,8 @@ void MainWindow::startOpenSshKexProbe(const SshProfile& p)
          << "-o" << "ConnectionAttempts=1";
 
     if (p.port > 0) args << "-p" << QString::number(p.port);
+    if (!parseProxyJump(p.proxyJump).isEmpty())
+        args << "-J" << proxyJumpToString(parseProxyJump(p.proxyJump));
     args << (p.user + "@" + p.host) << "true";
 
     // capture QPointer, not raw pointer
@@ -832,7 +847,15 @@ void MainWindow::startOpenSshKexProbe(const SshProfile& p)
 /// Destroy the window and ensure libssh is disconnected.
 MainWindow::~MainWindow()
 {
+    if (m_preconnect) m_preconnect->clear();
+    if (m_linkMonitor) {
+        m_linkMonitor->stop();
+        m_linkMonitor->waitForFinished();
+    }
     m_ssh.disconnect();
+
+    // Shared bastion sessions (jump hosts) used by Files/Fleet.
+    SshJumpHost::shutdownAll();
 }
 
 // ========================
@@ -1007,6 +1030,21 @@ void MainWindow::setupUi()
     connect(m_profileList, &QListWidget::currentRowChanged,
             this, &MainWindow::onProfileSelectionChanged);
 
+    // Speculative pre-connect on hover (debounced so sweeping the mouse
+    // across the list does not open a connection per row).
+    m_profileList->setMouseTracking(true);
+    m_hoverWarmTimer = new QTimer(this);
+    m_hoverWarmTimer->setSingleShot(true);
+    m_hoverWarmTimer->setInterval(400);
+    connect(m_hoverWarmTimer, &QTimer::timeout, this, [this]() {
+        warmProfile(m_hoverProfileIndex);
+    });
+    connect(m_profileList, &QListWidget::itemEntered, this, [this](QListWidgetItem* it) {
+        if (!m_preconnect || !m_preconnect->isEnabled() || isGroupHeaderItem(it)) return;
+        m_hoverProfileIndex = it->data(Qt::UserRole).toInt();
+        m_hoverWarmTimer->start();
+    });
+
     connect(m_sendBtn, &QPushButton::clicked,
             this, &MainWindow::onSendInput);
 
@@ -1032,6 +1070,26 @@ void MainWindow::setupUi()
                     tr("SFTP negotiated KEX (libssh): %1").arg(raw)
                 );
             });
+
+    // Keepalive / dead-peer detection / auto-reconnect for the libssh session.
+    connect(m_linkMonitor, &SshLinkMonitor::linkLost, this, [this](const QString& reason) {
+        uiWarn(tr("[SFTP] Connection lost: %1").arg(reason));
+        logSessionInfo(QString("libssh link lost: %1").arg(reason));
+        if (m_statusLabel) m_statusLabel->setText(tr("SFTP connection lost."));
+    });
+    connect(m_linkMonitor, &SshLinkMonitor::reconnectScheduled, this, [this](int attempt, int delayMs) {
+        uiInfo(tr("[SFTP] Reconnecting in %1 s (attempt %2)…").arg(delayMs / 1000).arg(attempt));
+    });
+    connect(m_linkMonitor, &SshLinkMonitor::reconnectFailed, this, [this](int attempt, const QString& err) {
+        uiDebug(tr("[SFTP] Reconnect attempt %1 failed: %2").arg(attempt).arg(err));
+    });
+    connect(m_linkMonitor, &SshLinkMonitor::reconnected, this, [this]() {
+        uiInfo(tr("[SFTP] Reconnected"));
+        logSessionInfo("libssh reconnected");
+        if (m_statusLabel) m_statusLabel->setText(tr("SFTP reconnected."));
+        if (m_filesTab) m_filesTab->onSshReconnected();
+    });
+    connect(m_filesTab, &FilesTab::transferInterrupted, m_linkMonitor, &SshLinkMonitor::checkNow);
 }
 
 /// Create the application menus (File/Tools/Keys/View/Help) and wire actions.
@@ -1206,6 +1264,18 @@ void MainWindow::setupMenus()
     });
     viewMenu->addAction(auditViewerAct);
 
+    QAction *scrollbackSearchAct = new QAction(tr("Search all terminals…"), this);
+    scrollbackSearchAct->setToolTip(tr("Search the scrollback of every open terminal"));
+    scrollbackSearchAct->setShortcut(QKeySequence(QStringLiteral("Ctrl+Shift+F")));
+    connect(scrollbackSearchAct, &QAction::triggered, this, [this]() {
+        auto* dlg = new ScrollbackSearchDialog(this);
+        dlg->setAttribute(Qt::WA_DeleteOnClose, true);
+        dlg->show();
+        dlg->raise();
+        dlg->activateWindow();
+    });
+    viewMenu->addAction(scrollbackSearchAct);
+
     QAction *openAuditDirAct = new QAction(tr("Open audit log folder"), this);
     openAuditDirAct->setToolTip(tr("Open audit log directory"));
     connect(openAuditDirAct, &QAction::triggered, this, []() {
@@ -1542,6 +1612,19 @@ void MainWindow::onProfileSelectionChanged(int /*row*/)
 
     if (m_pqDebugCheck)
         m_pqDebugCheck->setChecked(p.pqDebug);
+
+    warmProfile(idx);
+}
+
+/// Speculatively pre-connect (DNS + TCP + KEX, no auth) the given profile
+/// when enabled in Settings and no libssh session is active yet.
+void MainWindow::warmProfile(int profileIndex)
+{
+    if (!m_preconnect || !m_preconnect->isEnabled()) return;
+    if (profileIndex < 0 || profileIndex >= m_profiles.size()) return;
+    if (m_ssh.isConnected()) return;
+
+    m_preconnect->warm(m_profiles[profileIndex]);
 }
 
 /// Main "Connect" handler:
@@ -1611,6 +1694,10 @@ void MainWindow::onConnectClicked()
         pqArgs << "-p" << QString::number(port);
     }
 
+    // Probe through the same bastions the session uses.
+    if (!parseProxyJump(p.proxyJump).isEmpty())
+        pqArgs << "-J" << proxyJumpToString(parseProxyJump(p.proxyJump));
+
     pqArgs << shownTarget << "true";
 
     uiDebug(tr("[PQ-PROBE] %1").arg(prettyCommandLine("ssh", pqArgs)));
@@ -1672,10 +1759,15 @@ void MainWindow::onConnectClicked()
                     const bool ok = res.first;
                     const QString err = res.second;
 
+                    // Where did connect latency go? (agent vs. key file vs. auto)
+                    uiDebug(tr("[SFTP] auth: %1").arg(m_ssh.lastAuthSummary()));
+
                     if (ok) {
                         uiInfo(tr("[SFTP] Ready (%1@%2:%3)").arg(p.user, p.host).arg(port));
                         logSessionInfo("libssh connected OK (SFTP ready)");
 
+                        if (m_linkMonitor) m_linkMonitor->start(p);
+
                         if (m_filesTab) {
                             m_filesTab->onSshConnected();
                         }
@@ -1691,8 +1783,25 @@ void MainWindow::onConnectClicked()
                     watcher->deleteLater();
                 });
 
-        watcher->setFuture(QtConcurrent::run([this, p]() -> QPair<bool, QString> {
+        // A previous session's keepalive/reconnect must not race the new connect.
+        if (m_linkMonitor) {
+            m_linkMonitor->stop();
+            m_linkMonitor->waitForFinished();
+        }
+
+        // Reuse a speculative transport (DNS/TCP/KEX already done) if one is warm.
+        const SshPreconnectPool::Claim warm =
+            m_preconnect ? m_preconnect->claim(p) : SshPreconnectPool::Claim();
+        if (warm)
+            logSessionInfo("Using speculative pre-connected transport");
+
+        watcher->setFuture(WorkScheduler::instance()->run(WorkScheduler::Lane::Interactive,
+                                                          [this, p, warm]() -> QPair<bool, QString> {
             QString e;
+            if (warm && SshPreconnectPool::adoptInto(warm, &m_ssh)) {
+                const bool ok = m_ssh.authenticate(&e);
+                return qMakePair(ok, e);
+            }
             const bool ok = m_ssh.connectProfile(p, &e);
             return qMakePair(ok, e);
         }));
@@ -1717,6 +1826,10 @@ void MainWindow::onProfileDoubleClicked()
 void MainWindow::onDisconnectClicked()
 {
     logSessionInfo("Disconnect clicked (user requested)");
+    if (m_linkMonitor) {
+        m_linkMonitor->stop();
+        m_linkMonitor->waitForFinished();
+    }
     m_ssh.disconnect();
     if (m_filesTab) m_filesTab->onSshDisconnected();
     if (m_connectBtn)    m_connectBtn->setEnabled(true);
@@ -1867,6 +1980,12 @@ CpunkTermWidget* MainWindow::createTerm(const SshProfile &p, QWidget *parent, co
 
     applyProfileToTerm(term, p);
 
+    // Speculative local echo (terminal/predictiveEcho); owned by term.
+    PredictiveEcho::attach(term);
+
+    // Global scrollback budget + compressed scrollback copy.
+    ScrollbackBudget::instance()->registerTerminal(term, qMax(0, p.historyLines));
+
     QStringList sshArgs;
     sshArgs << "-tt";
     if (p.pqDebug) sshArgs << "-vv";
@@ -1920,6 +2039,11 @@ CpunkTermWidget* MainWindow::createTerm(const SshProfile &p, QWidget *parent, co
     if (!extraSshArgs.isEmpty())
         sshArgs << extraSshArgs;
 
+    // Jump hosts (bastions)
+    const QVector<JumpHop> hops = parseProxyJump(p.proxyJump);
+    if (!hops.isEmpty())
+        sshArgs << "-J" << proxyJumpToString(hops);
+
     if (p.port > 0 && p.port != 22)
         sshArgs << "-p" << QString::number(p.port);
 
@@ -2285,6 +2409,17 @@ void MainWindow::applySavedSettings()
 
     const QString auditDir = s.value("audit/dirPath", "").toString().trimmed();
     AuditLogger::setAuditDirOverride(auditDir);
+
+    if (m_preconnect)
+        m_preconnect->setEnabled(s.value("ssh/speculativePreconnect", false).toBool());
+
+    if (m_linkMonitor) {
+        m_linkMonitor->setIntervalSec(s.value("ssh/keepaliveIntervalSec", 15).toInt());
+        m_linkMonitor->setAutoReconnect(s.value("ssh/autoReconnect", true).toBool());
+    }
+
+    // No-op when a benchmark for this CPU/OpenSSL/libssh is already cached.
+    SshCipherTuner::startBackgroundBenchmark();
 }
 
 /// Legacy modal settings dialog entry point (kept for compatibility).
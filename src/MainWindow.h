@@ -38,6 +38,9 @@ class IdentityManagerDialog;
 class SshConfigImportDialog;
 class SshConfigImportPlanDialog;
 class ScheduledJobsDialog;
+class SshPreconnectPool;
+class SshLinkMonitor;
+class QTimer;
 
 class MainWindow : public QMainWindow
 {
@@ -134,6 +137,15 @@ private:
     // Modules
     SshClient m_ssh;
 
+    // Speculative pre-connect (opt-in): warms DNS/TCP/KEX for the selected/hovered profile
+    SshPreconnectPool *m_preconnect     = nullptr;
+    QTimer            *m_hoverWarmTimer = nullptr;
+    int                m_hoverProfileIndex = -1;
+    void warmProfile(int profileIndex);
+
+    // Keepalive + auto-reconnect for m_ssh (SFTP/exec session).
+    SshLinkMonitor    *m_linkMonitor    = nullptr;
+
     QTabWidget *m_mainTabs = nullptr;
     FilesTab   *m_filesTab = nullptr;
 
@@ -0,0 +1,467 @@
+// PredictiveEcho.cpp
+//
+// See header for the overall idea. Implementation notes:
+//   - Predictions are an ordered list of operations (char, erase, left,
+//     right). Echo is matched strictly in order; the first byte that does not
+//     fit rolls everything back (the screen then simply shows the server).
+//   - Erase echo is "\b \b" or "\b\e[K" (readline, zsh line editor); the
+//     trailing bytes are tolerated after the "\b" that confirms the erase.
+//   - Only printable ASCII is predicted: the output arrives as bytes (Latin-1
+//     decoded by qtermwidget), and a UTF-8 echo would never match.
+//   - SGR / erase-in-line CSI sequences are ignored while matching (syntax
+//     highlighting shells emit them around every keystroke); any other
+//     cursor addressing is treated as a mismatch.
+
+#include "PredictiveEcho.h"
+#include "CpunkTermWidget.h"
+
+#include <QEvent>
+#include <QFontMetrics>
+#include <QKeyEvent>
+#include <QMap>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QSettings>
+#include <QStringList>
+#include <QWidget>
+#include <QDebug>
+
+namespace {
+
+constexpr int    kAdaptiveThresholdMs = 30;   // paint only above this echo RTT
+constexpr int    kMinExpireMs = 1000;         // echo considered missing after
+constexpr int    kMaxMisses = 3;              // mispredictions before suspending
+constexpr double kRttGain = 0.125;            // RFC 6298-style smoothing
+
+// Transparent child of the terminal display that paints the predictions.
+class PredictionOverlay : public QWidget
+{
+public:
+    PredictionOverlay(QWidget* display, PredictiveEcho* owner)
+        : QWidget(display), m_owner(owner)
+    {
+        setAttribute(Qt::WA_TransparentForMouseEvents);
+        setAttribute(Qt::WA_NoSystemBackground);
+        setAutoFillBackground(false);
+        setFocusPolicy(Qt::NoFocus);
+        setGeometry(display->rect());
+        raise();
+        show();
+    }
+
+protected:
+    void paintEvent(QPaintEvent*) override
+    {
+        if (!m_owner) return;
+        QPainter p(this);
+        m_owner->paintPredictions(p, this);
+    }
+
+private:
+    QPointer<PredictiveEcho> m_owner;
+};
+
+QWidget* findTerminalDisplay(QWidget* term)
+{
+    for (QWidget* w : term->findChildren<QWidget*>()) {
+        if (w->inherits("Konsole::TerminalDisplay"))
+            return w;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+// ------------------------------------------------------------
+// Setup
+// ------------------------------------------------------------
+PredictiveEcho::Mode PredictiveEcho::configuredMode()
+{
+    const QString v = QSettings().value("terminal/predictiveEcho", "adaptive").toString();
+    if (v == QLatin1String("off"))    return Mode::Off;
+    if (v == QLatin1String("always")) return Mode::Always;
+    return Mode::Adaptive;
+}
+
+PredictiveEcho* PredictiveEcho::attach(CpunkTermWidget* term)
+{
+    const Mode mode = configuredMode();
+    if (!term || mode == Mode::Off)
+        return nullptr;
+
+    auto* pe = new PredictiveEcho(term, mode);
+    if (!pe->m_display) {
+        qWarning().noquote() << "[ECHO] terminal display not found; predictive echo disabled";
+        delete pe;
+        return nullptr;
+    }
+    return pe;
+}
+
+PredictiveEcho::PredictiveEcho(CpunkTermWidget* term, Mode mode)
+    : QObject(term)
+    , m_term(term)
+    , m_mode(mode)
+{
+    m_clock.start();
+
+    m_display = term ? findTerminalDisplay(term) : nullptr;
+    if (!m_display)
+        return;
+
+    m_display->installEventFilter(this);
+    m_overlay = new PredictionOverlay(m_display, this);
+
+    connect(term, &QTermWidget::receivedData, this, &PredictiveEcho::onReceived);
+
+    m_expire.setInterval(100);
+    connect(&m_expire, &QTimer::timeout, this, &PredictiveEcho::onExpireCheck);
+}
+
+// ------------------------------------------------------------
+// State helpers
+// ------------------------------------------------------------
+bool PredictiveEcho::predicting() const
+{
+    return m_mode != Mode::Off && !m_altScreen && !m_suspended;
+}
+
+bool PredictiveEcho::shouldPaint() const
+{
+    if (!predicting() || !m_epochConfirmed || m_pending.isEmpty())
+        return false;
+    return m_mode == Mode::Always || m_srttMs >= kAdaptiveThresholdMs;
+}
+
+void PredictiveEcho::refresh()
+{
+    if (m_overlay) m_overlay->update();
+    if (m_pending.isEmpty()) m_expire.stop();
+}
+
+void PredictiveEcho::push(Op op, QChar ch)
+{
+    Prediction p;
+    p.op = op;
+    p.ch = ch;
+    p.sentMs = m_clock.elapsed();
+    m_pending.push_back(p);
+
+    if (!m_expire.isActive()) m_expire.start();
+    refresh();
+}
+
+void PredictiveEcho::confirmFront()
+{
+    if (m_pending.isEmpty()) return;
+
+    const Prediction p = m_pending.takeFirst();
+    const double sample = double(m_clock.elapsed() - p.sentMs);
+    m_srttMs = (m_srttMs <= 0.0) ? sample : (1.0 - kRttGain) * m_srttMs + kRttGain * sample;
+
+    m_misses = 0;
+    m_epochConfirmed = true;
+    refresh();
+}
+
+void PredictiveEcho::rollback(bool countAsMiss)
+{
+    m_pending.clear();
+    m_eraseEcho = 0;
+    m_lineTyped = 0;
+    m_leftOfEnd = 0;
+
+    if (countAsMiss && ++m_misses >= kMaxMisses) {
+        m_suspended = true;
+        qInfo().noquote() << "[ECHO] predictions keep missing; suspended until Enter";
+    }
+    refresh();
+}
+
+// Enter: new line, new epoch. Also lifts a suspension.
+void PredictiveEcho::newEpoch()
+{
+    m_pending.clear();
+    m_epochConfirmed = false;
+    m_eraseEcho = 0;
+    m_lineTyped = 0;
+    m_leftOfEnd = 0;
+    m_suspended = false;
+    m_misses = 0;
+    refresh();
+}
+
+// ------------------------------------------------------------
+// Input side
+// ------------------------------------------------------------
+bool PredictiveEcho::eventFilter(QObject* obj, QEvent* ev)
+{
+    if (obj == m_display) {
+        if (ev->type() == QEvent::KeyPress)
+            handleKey(static_cast<QKeyEvent*>(ev));
+        else if (ev->type() == QEvent::Resize && m_overlay)
+            m_overlay->setGeometry(m_display->rect());
+    }
+    return QObject::eventFilter(obj, ev);   // never swallow: the key still goes out
+}
+
+void PredictiveEcho::handleKey(QKeyEvent* ke)
+{
+    const int key = ke->key();
+
+    if (key == Qt::Key_Return || key == Qt::Key_Enter) {
+        newEpoch();
+        return;
+    }
+    if (!predicting())
+        return;
+
+    // Modifier-only presses change nothing.
+    if (key == Qt::Key_Shift || key == Qt::Key_Control || key == Qt::Key_Alt ||
+        key == Qt::Key_Meta || key == Qt::Key_AltGr)
+        return;
+
+    // Ctrl/Alt combinations are editing commands we do not model.
+    if (ke->modifiers() & (Qt::ControlModifier | Qt::AltModifier | Qt::MetaModifier)) {
+        rollback(false);
+        return;
+    }
+
+    switch (key) {
+    case Qt::Key_Backspace:
+        // Only at the end of text typed on this line (never into the prompt).
+        if (m_leftOfEnd == 0 && m_lineTyped > 0) {
+            --m_lineTyped;
+            push(Op::Erase);
+        } else {
+            rollback(false);
+        }
+        return;
+    case Qt::Key_Left:
+        if (m_leftOfEnd < m_lineTyped) {
+            ++m_leftOfEnd;
+            push(Op::Left);
+        } else {
+            rollback(false);
+        }
+        return;
+    case Qt::Key_Right:
+        if (m_leftOfEnd > 0) {
+            --m_leftOfEnd;
+            push(Op::Right);
+        } else {
+            rollback(false);
+        }
+        return;
+    default:
+        break;
+    }
+
+    // Printable ASCII only: receivedData() hands us the raw bytes Latin-1
+    // decoded, so the echo of a non-ASCII key (UTF-8, 2-4 bytes) could never
+    // match its prediction.
+    const QString text = ke->text();
+    if (text.size() != 1 || text.at(0).unicode() < 0x20 || text.at(0).unicode() > 0x7e) {
+        rollback(false);   // Tab, Up/Down, Home/End, F-keys, non-ASCII, ...
+        return;
+    }
+
+    // Stop at the right margin: line wrapping is left to the server.
+    if (m_term && m_display) {
+        const QRect cur = m_display->inputMethodQuery(Qt::ImMicroFocus).toRect();
+        const int cw = qMax(1, QFontMetrics(m_term->getTerminalFont()).horizontalAdvance(QLatin1Char('M')));
+        int col = cur.x() / cw;
+        for (const Prediction& p : m_pending)
+            col += (p.op == Op::Char || p.op == Op::Right) ? 1 : -1;
+        if (col + 1 >= m_term->screenColumnsCount()) {
+            rollback(false);
+            return;
+        }
+    }
+
+    ++m_lineTyped;
+    push(Op::Char, text.at(0));
+}
+
+// ------------------------------------------------------------
+// Output side
+// ------------------------------------------------------------
+void PredictiveEcho::onReceived(const QString& text)
+{
+    for (const QChar c : text) {
+        const ushort u = c.unicode();
+
+        switch (m_parse) {
+        case Parse::Text:
+            if (u == 0x1b) m_parse = Parse::Esc;
+            else feedOutputChar(c);
+            break;
+        case Parse::Esc:
+            if (c == QLatin1Char('[')) {
+                m_csi.clear();
+                m_parse = Parse::Csi;
+            } else if (c == QLatin1Char(']')) {
+                m_parse = Parse::Osc;
+            } else {
+                m_parse = Parse::Text;       // two-byte escape: ignore
+            }
+            break;
+        case Parse::Csi:
+            if (u >= 0x40 && u <= 0x7e) {
+                m_parse = Parse::Text;
+                onCsi(c, m_csi);
+            } else if (m_csi.size() < 64) {
+                m_csi += c;
+            }
+            break;
+        case Parse::Osc:                     // window title etc.
+            if (u == 0x07) m_parse = Parse::Text;
+            else if (u == 0x1b) m_parse = Parse::OscEsc;
+            break;
+        case Parse::OscEsc:
+            m_parse = Parse::Text;
+            break;
+        }
+    }
+}
+
+void PredictiveEcho::feedOutputChar(QChar c)
+{
+    const ushort u = c.unicode();
+
+    if (u == 0x07)                           // BEL
+        return;
+
+    if (u == 0x08) {                         // backspace
+        if (m_eraseEcho == 2) {              // closing "\b" of "\b \b"
+            m_eraseEcho = 0;
+            return;
+        }
+        m_eraseEcho = 0;
+        if (m_pending.isEmpty()) return;
+
+        const Op op = m_pending.front().op;
+        if (op == Op::Erase) {
+            confirmFront();
+            m_eraseEcho = 1;
+        } else if (op == Op::Left) {
+            confirmFront();
+        } else {
+            rollback(true);
+        }
+        return;
+    }
+
+    if (u < 0x20 || u == 0x7f) {             // CR, LF, other controls
+        m_eraseEcho = 0;
+        if (!m_pending.isEmpty()) rollback(true);
+        return;
+    }
+
+    if (m_eraseEcho == 1 && c == QLatin1Char(' ')) {
+        m_eraseEcho = 2;
+        return;
+    }
+    m_eraseEcho = 0;
+
+    if (m_pending.isEmpty())
+        return;
+
+    const Prediction& front = m_pending.front();
+    if ((front.op == Op::Char && front.ch == c) || front.op == Op::Right)
+        confirmFront();                      // Right: the char under the cursor is re-printed
+    else
+        rollback(true);
+}
+
+void PredictiveEcho::onCsi(QChar fin, const QString& params)
+{
+    // Alternate screen on/off: full-screen apps get no predictions.
+    if ((fin == QLatin1Char('h') || fin == QLatin1Char('l')) && params.startsWith(QLatin1Char('?'))) {
+        const QStringList modes = params.mid(1).split(QLatin1Char(';'));
+        if (modes.contains("1049") || modes.contains("1047") || modes.contains("47")) {
+            m_altScreen = (fin == QLatin1Char('h'));
+            if (m_altScreen) rollback(false);
+        }
+        return;
+    }
+
+    if (fin == QLatin1Char('K') || fin == QLatin1Char('P') || fin == QLatin1Char('m')) {
+        m_eraseEcho = 0;                     // "\b\e[K" erase echo, or colour
+        return;
+    }
+
+    m_eraseEcho = 0;
+    if (m_pending.isEmpty())
+        return;
+
+    const Op op = m_pending.front().op;
+    if ((op == Op::Left && fin == QLatin1Char('D')) || (op == Op::Right && fin == QLatin1Char('C')))
+        confirmFront();
+    else
+        rollback(true);
+}
+
+// Echo overdue: no echo (password prompt, raw mode) - stop until Enter.
+void PredictiveEcho::onExpireCheck()
+{
+    if (m_pending.isEmpty()) {
+        m_expire.stop();
+        return;
+    }
+
+    const qint64 limit = qMax<qint64>(kMinExpireMs, qint64(3.0 * m_srttMs));
+    if (m_clock.elapsed() - m_pending.front().sentMs > limit) {
+        m_suspended = true;
+        rollback(false);
+    }
+}
+
+// ------------------------------------------------------------
+// Painting
+// ------------------------------------------------------------
+void PredictiveEcho::paintPredictions(QPainter& p, QWidget* overlay)
+{
+    Q_UNUSED(overlay);
+    if (!shouldPaint() || !m_term || !m_display)
+        return;
+
+    const QRect cur = m_display->inputMethodQuery(Qt::ImMicroFocus).toRect();
+    QFont font = m_term->getTerminalFont();
+    const int cw = qMax(1, QFontMetrics(font).horizontalAdvance(QLatin1Char('M')));
+    const int ch = qMax(1, cur.height());
+
+    const QColor bg = m_display->palette().color(m_display->backgroundRole());
+    const QColor fg = (bg.lightness() < 128) ? QColor(230, 230, 230) : QColor(20, 20, 20);
+
+    // Replay the operations from the real cursor; later ones overwrite cells.
+    QMap<int, QChar> cells;
+    int col = 0;
+    bool moved = false;
+    for (const Prediction& pr : m_pending) {
+        switch (pr.op) {
+        case Op::Char:  cells[col] = pr.ch; ++col; break;
+        case Op::Erase: --col; cells[col] = QLatin1Char(' '); moved = true; break;
+        case Op::Left:  --col; moved = true; break;
+        case Op::Right: ++col; moved = true; break;
+        }
+    }
+
+    font.setUnderline(true);
+    p.setFont(font);
+
+    for (auto it = cells.constBegin(); it != cells.constEnd(); ++it) {
+        const QRect cell(cur.x() + it.key() * cw, cur.y(), cw, ch);
+        p.fillRect(cell, bg);
+        if (it.value() != QLatin1Char(' ')) {
+            p.setPen(fg);
+            p.drawText(cell, Qt::AlignLeft | Qt::AlignVCenter, QString(it.value()));
+        }
+    }
+
+    // Predicted cursor position after moves/erases.
+    if (moved) {
+        p.setPen(fg);
+        p.drawRect(QRect(cur.x() + col * cw, cur.y(), cw, ch).adjusted(0, 0, -1, -1));
+    }
+}
@@ -0,0 +1,120 @@
+// PredictiveEcho.h
+//
+// Purpose:
+//   Speculative local echo for CpunkTermWidget SSH sessions (in the spirit of
+//   mosh). On a 250 ms link every keystroke otherwise takes a round trip to
+//   show up; with predictions, typed characters and simple cursor movement
+//   appear immediately (underlined) and are replaced by the real echo when it
+//   arrives.
+//
+// How:
+//   - An event filter on the terminal display sees keys before qtermwidget
+//     sends them: printable characters, Backspace and Left/Right become
+//     pending predictions; everything else clears them.
+//   - QTermWidget::receivedData() is matched against the pending list:
+//     a matching echo confirms (and gives an RTT sample), anything else rolls
+//     all predictions back.
+//   - A transparent overlay on the display paints the predictions at the
+//     emulator cursor (Qt::ImMicroFocus of the display).
+//
+// When it stays out of the way:
+//   - alternate screen (vim, less, htop, ...): off until the app leaves it
+//   - repeated mispredictions or an echo that never comes (raw mode, echo
+//     off): suspended until the next Enter
+//   - per line ("epoch"), nothing is shown until one prediction of that line
+//     was confirmed by the server, so text typed at a password prompt is
+//     never painted
+//   - "adaptive" mode (default) only paints when the smoothed echo RTT is
+//     above ~30 ms; on a LAN the real echo is faster than a frame anyway
+//
+// Setting: terminal/predictiveEcho = "adaptive" (default) | "always" | "off"
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QTimer>
+
+class CpunkTermWidget;
+class QKeyEvent;
+class QPainter;
+class QWidget;
+
+class PredictiveEcho : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Mode { Off, Adaptive, Always };
+
+    static Mode configuredMode();
+
+    // Attach to term according to the setting; nullptr when off.
+    // The object is parented to term and dies with it.
+    static PredictiveEcho* attach(CpunkTermWidget* term);
+
+    PredictiveEcho(CpunkTermWidget* term, Mode mode);
+
+    Mode mode() const { return m_mode; }
+    int  smoothedRttMs() const { return int(m_srttMs); }
+
+    // Called by the overlay widget.
+    void paintPredictions(QPainter& p, QWidget* overlay);
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* ev) override;
+
+private slots:
+    void onReceived(const QString& text);
+    void onExpireCheck();
+
+private:
+    enum class Op { Char, Erase, Left, Right };
+
+    struct Prediction {
+        Op     op = Op::Char;
+        QChar  ch;
+        qint64 sentMs = 0;
+    };
+
+    void handleKey(QKeyEvent* ke);
+    void push(Op op, QChar ch = QChar());
+    void confirmFront();
+    void rollback(bool countAsMiss);
+    void newEpoch();
+    bool shouldPaint() const;
+    bool predicting() const;
+    void feedOutputChar(QChar c);
+    void onCsi(QChar fin, const QString& params);
+    void refresh();
+
+    QPointer<CpunkTermWidget> m_term;
+    QPointer<QWidget>         m_display;
+    QPointer<QWidget>         m_overlay;
+
+    Mode m_mode = Mode::Adaptive;
+
+    QVector<Prediction> m_pending;
+
+    // Line/epoch state
+    bool m_epochConfirmed = false;    // server echoed something on this line
+    int  m_lineTyped = 0;             // chars typed on this line (left of end)
+    int  m_leftOfEnd = 0;             // predicted Left moves not yet undone
+    int  m_eraseEcho = 0;             // 1 = saw "\b", 2 = saw "\b " (erase echo)
+
+    // Suspension
+    bool m_altScreen = false;
+    bool m_suspended = false;         // until next Enter
+    int  m_misses = 0;
+
+    // RTT
+    QElapsedTimer m_clock;
+    double        m_srttMs = 0.0;
+    QTimer        m_expire;
+
+    // Output escape parser
+    enum class Parse { Text, Esc, Csi, Osc, OscEsc };
+    Parse   m_parse = Parse::Text;
+    QString m_csi;
+};
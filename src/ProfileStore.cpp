@@ -388,6 +388,7 @@ bool ProfileStore::save(const QVector<SshProfile>& profiles, QString* err)
               "history_lines": 2000,
               "key_file": "...",             // optional
               "key_type": "auto",            // always stored
+              "proxy_jump": "user@bastion",  // optional (OpenSSH ProxyJump syntax)
 
               // NEW: Port forwarding
               "port_forwarding_enabled": false,
@@ -450,6 +451,10 @@ bool ProfileStore::save(const QVector<SshProfile>& profiles, QString* err)
                               ? QStringLiteral("auto")
                               : prof.keyType.trimmed();
 
+        // Jump hosts (store only if set)
+        if (!prof.proxyJump.trimmed().isEmpty())
+            obj["proxy_jump"] = prof.proxyJump.trimmed();
+
         // ---- NEW: Port forwarding ----
         obj["port_forwarding_enabled"] = prof.portForwardingEnabled;
 
@@ -581,6 +586,9 @@ QVector<SshProfile> ProfileStore::load(QString* err)
         if (p.keyType.isEmpty())
             p.keyType = "auto";
 
+        // Jump hosts
+        p.proxyJump = obj.value("proxy_jump").toString().trimmed();
+
         // ---- NEW: Port forwarding ----
         p.portForwardingEnabled = obj.value("port_forwarding_enabled").toBool(false);
 
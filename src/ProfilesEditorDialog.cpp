@@ -555,6 +555,14 @@ void ProfilesEditorDialog::buildUi()
     form->addRow(tr("Key type:"), m_keyTypeCombo);
     form->addRow(tr("Key file:"), keyRow);
 
+    // Jump hosts (OpenSSH ProxyJump syntax). Used by the terminal (ssh -J) and by
+    // libssh features (Files, Fleet, Scheduled Jobs) via tunnelled sessions.
+    m_proxyJumpEdit = new QLineEdit(detailsWidget);
+    m_proxyJumpEdit->setPlaceholderText(tr("e.g. admin@bastion.example.com:22 (optional)"));
+    m_proxyJumpEdit->setToolTip(tr("Comma-separated jump hosts: [user@]host[:port],...\n"
+                                   "Hops are connected in order; the last one reaches this host."));
+    form->addRow(tr("Jump hosts:"), m_proxyJumpEdit);
+
     // =========================
     // Advanced: Port forwarding (inside form)
     // =========================
@@ -935,6 +943,7 @@ void ProfilesEditorDialog::loadProfileToForm(int row)
     }
 
     if (m_keyFileEdit) m_keyFileEdit->setText(p.keyFile);
+    if (m_proxyJumpEdit) m_proxyJumpEdit->setText(p.proxyJump);
 
     // -------------------------
     // Hotkey macros (multi)
@@ -1032,6 +1041,9 @@ void ProfilesEditorDialog::syncFormToCurrent()
     if (p.keyType.isEmpty()) p.keyType = "auto";
     if (m_keyFileEdit) p.keyFile = m_keyFileEdit->text().trimmed();
 
+    // Jump hosts
+    if (m_proxyJumpEdit) p.proxyJump = m_proxyJumpEdit->text().trimmed();
+
     // Keep list label in sync (friendly display name).
     const QString shownName =
         p.name.trimmed().isEmpty()
@@ -1171,6 +1183,19 @@ bool ProfilesEditorDialog::validateProfiles(QString *errMsg) const
             }
         }
 
+        // ---- Jump hosts validation ----
+        const QString pj = p.proxyJump.trimmed();
+        if (!pj.isEmpty() && pj.compare("none", Qt::CaseInsensitive) != 0) {
+            const int hops = parseProxyJump(pj).size();
+            if (hops == 0 || hops != pj.split(',', Qt::SkipEmptyParts).size()) {
+                if (errMsg) {
+                    *errMsg = tr("Profile '%1': invalid jump hosts '%2' (expected [user@]host[:port],...).")
+                                  .arg(p.name.trimmed().isEmpty() ? p.host : p.name.trimmed(), pj);
+                }
+                return false;
+            }
+        }
+
         // ---- Port forwarding validation ----
         if (p.portForwardingEnabled) {
             QSet<QString> seen; // duplicates inside this profile
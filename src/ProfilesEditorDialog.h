@@ -135,6 +135,8 @@ private:
     QLineEdit *m_keyFileEdit  = nullptr;
     QPushButton *m_keyClearBtn = nullptr;
 
+    QLineEdit *m_proxyJumpEdit = nullptr;
+
     // Right: macros column (multi)
     QListWidget *m_macroList = nullptr;
     QPushButton *m_macroAddBtn = nullptr;
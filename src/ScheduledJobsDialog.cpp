@@ -1,5 +1,6 @@
 #include "ScheduledJobsDialog.h"
 #include "ScheduledJobStore.h"
+#include "SshExecCapture.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -27,23 +28,60 @@ static QString kindToText(const ScheduledJob& j)
                                                    : QObject::tr("Recurring");
 }
 
-static bool remoteHasCmd(SshClient* ssh, const QString& cmd, QString* detailsOut = nullptr)
+// All remote calls of this dialog are short probes/commands. Capture them
+// bounded so a chatty login shell (banners, a profile printing in a loop)
+// cannot grow memory; 16 KiB head + tail is plenty for what we parse.
+static bool execBounded(SshClient* ssh, const QString& cmd, QString* out, QString* err, int timeoutMs)
 {
-    if (!ssh) return false;
-    QString out, err;
+    if (out) out->clear();
+    if (!ssh) {
+        if (err) *err = QObject::tr("Not connected.");
+        return false;
+    }
 
-    // POSIX and fast
-    const QString q = QString("/bin/sh -lc 'command -v %1 >/dev/null 2>&1'").arg(cmd);
-    const bool ok = ssh->exec(q, &out, &err, 8000);
+    SshExecStream::Limits l;
+    l.headBytes = 16 * 1024;
+    l.tailBytes = 16 * 1024;
+    SshExecCapture capture(l, l);
 
-    if (detailsOut) {
-        *detailsOut += QString("%1=%2\n").arg(cmd, ok ? "yes" : "no");
-        if (!err.trimmed().isEmpty())
-            *detailsOut += QString("  %1 err: %2\n").arg(cmd, err.trimmed());
-    }
+    SshClient::ExecOptions opt;
+    opt.timeoutMs = timeoutMs;
+    opt.maxOutputBytes = 0;
+
+    const bool ok = ssh->execCapture(cmd, &capture, err, opt);
+    if (out) *out = capture.out().text();
     return ok;
 }
 
+// Several probes/steps in one round trip: one channel, one remote login shell
+// (same environment as the "/bin/sh -lc" single commands).
+static bool execBatchLogin(SshClient* ssh,
+                           const QStringList& cmds,
+                           QVector<SshClient::BatchResult>* results,
+                           QString* err,
+                           int timeoutMs,
+                           bool stopOnError = false)
+{
+    if (!ssh) {
+        if (err) *err = QObject::tr("Not connected.");
+        return false;
+    }
+
+    SshClient::BatchOptions opt;
+    opt.timeoutMs = timeoutMs;
+    opt.stopOnError = stopOnError;
+    opt.shell = QStringLiteral("/bin/sh -l -s");
+    return ssh->execBatch(cmds, results, err, opt);
+}
+
+// systemctl --user with an explicit user bus (non-interactive SSH has none).
+static QString systemctlUserCmd(const QString& args)
+{
+    return QString("XDG_RUNTIME_DIR=/run/user/$(id -u) "
+                   "DBUS_SESSION_BUS_ADDRESS=unix:path=/run/user/$(id -u)/bus "
+                   "systemctl --user %1").arg(args);
+}
+
 
 
 
@@ -113,7 +151,7 @@ bool ScheduledJobsDialog::installRemoteSystemdUser(const ScheduledJob& job, QStr
         ).arg(base, onCal);
 
     QString e;
-    if (!m_ssh->exec(QString("mkdir -p %1").arg(shQuote(userDir)), nullptr, &e, 8000)) {
+    if (!execBounded(m_ssh, QString("mkdir -p %1").arg(shQuote(userDir)), nullptr, &e, 8000)) {
         if (err) *err = e;
         return false;
     }
@@ -124,28 +162,32 @@ bool ScheduledJobsDialog::installRemoteSystemdUser(const ScheduledJob& job, QStr
     if (!m_ssh->writeRemoteTextFileAtomic(svcPath, serviceText, 0644, &e)) { if (err) *err = e; return false; }
     if (!m_ssh->writeRemoteTextFileAtomic(tmrPath, timerText, 0644, &e)) { if (err) *err = e; return false; }
 
-    // Determine uid
-    QString uidOut;
-    if (!m_ssh->exec("/bin/sh -lc 'id -u'", &uidOut, &e, 8000)) {
-        if (err) *err = e.isEmpty() ? tr("Could not determine remote uid.") : e;
+    // uid check + daemon-reload + enable: one round trip, stop at first failure.
+    QVector<SshClient::BatchResult> r;
+    if (!execBatchLogin(m_ssh,
+                        { "id -u",
+                          systemctlUserCmd("daemon-reload"),
+                          systemctlUserCmd(QString("enable --now %1.timer").arg(base)) },
+                        &r, &e, 12000, /*stopOnError*/true)) {
+        if (err) *err = e;
         return false;
     }
+
     bool okUid = false;
-    const int uid = uidOut.trimmed().toInt(&okUid);
-    if (!okUid || uid <= 0) {
-        if (err) *err = tr("Invalid remote uid output: %1").arg(uidOut.trimmed());
+    const int uid = r[0].stdoutText.trimmed().toInt(&okUid);
+    if (r[0].exitStatus != 0 || !okUid || uid <= 0) {
+        if (err) *err = r[0].exitStatus != 0
+            ? tr("Could not determine remote uid.")
+            : tr("Invalid remote uid output: %1").arg(r[0].stdoutText.trimmed());
         return false;
     }
-
-    // Use explicit env for user bus
-    const QString sysctlPrefix =
-        QString("/bin/sh -lc 'XDG_RUNTIME_DIR=/run/user/%1 "
-                "DBUS_SESSION_BUS_ADDRESS=unix:path=/run/user/%1/bus "
-                "systemctl --user ")
-            .arg(uid);
-
-    if (!m_ssh->exec(sysctlPrefix + "daemon-reload'", nullptr, &e, 8000)) { if (err) *err = e; return false; }
-    if (!m_ssh->exec(sysctlPrefix + QString("enable --now %1.timer'").arg(base), nullptr, &e, 8000)) { if (err) *err = e; return false; }
+    for (int i = 1; i < r.size(); ++i) {
+        if (r[i].exitStatus != 0) {
+            if (err) *err = tr("Remote command failed (exit %1): %2")
+                                .arg(r[i].exitStatus).arg(r[i].stderrText.trimmed());
+            return false;
+        }
+    }
 
     if (err) err->clear();
     return true;
@@ -206,7 +248,7 @@ bool ScheduledJobsDialog::installRemoteCron(const ScheduledJob& job, QString* er
             .arg(shQuote(markerComment),
                  shQuote(line));
 
-    if (!m_ssh->exec(remote, nullptr, &e, 12000)) {
+    if (!execBounded(m_ssh, remote, nullptr, &e, 12000)) {
         if (err) *err = e.isEmpty() ? tr("Failed to install cron job.") : e;
         return false;
     }
@@ -228,30 +270,49 @@ ScheduledJobsDialog::JobBackendCaps ScheduledJobsDialog::probeBackendCaps(QStrin
         return caps;
     }
 
-    // Check scheduler commands
-    const bool hasSystemctl = remoteHasCmd(m_ssh, "systemctl", &caps.details);
-    caps.cron = remoteHasCmd(m_ssh, "crontab",  &caps.details);
-    caps.at   = remoteHasCmd(m_ssh, "at",       &caps.details);
+    // All probes in one round trip (was one channel + login shell each).
+    const QStringList tools = { "systemctl", "crontab", "at" };
+    QStringList probes;
+    for (const QString& t : tools)
+        probes << QString("command -v %1 >/dev/null 2>&1").arg(t);
+    probes << "id -u"
+           << "test -S \"/run/user/$(id -u)/bus\"";  // systemd user timers need the user bus
+
+    QVector<SshClient::BatchResult> r;
+    QString e;
+    if (!execBatchLogin(m_ssh, probes, &r, &e, 8000)) {
+        caps.details += QString("probe failed: %1\n").arg(e.trimmed());
+        if (err) err->clear();
+        return caps;
+    }
+
+    auto has = [&](int i) -> bool {
+        const bool ok = r[i].exitStatus == 0;
+        caps.details += QString("%1=%2\n").arg(tools[i], ok ? "yes" : "no");
+        if (!r[i].stderrText.trimmed().isEmpty())
+            caps.details += QString("  %1 err: %2\n").arg(tools[i], r[i].stderrText.trimmed());
+        return ok;
+    };
+
+    const bool hasSystemctl = has(0);
+    caps.cron = has(1);
+    caps.at   = has(2);
 
-    // systemd user timers require /run/user/<uid>/bus to exist for this login
     caps.systemdUser = false;
     if (hasSystemctl) {
-        QString uidOut, e;
-        if (m_ssh->exec("/bin/sh -lc 'id -u'", &uidOut, &e, 8000)) {
-            bool okUid = false;
-            const int uid = uidOut.trimmed().toInt(&okUid);
-
-            if (okUid && uid > 0) {
-                const QString busCheck = QString("/bin/sh -lc 'test -S /run/user/%1/bus'").arg(uid);
-                caps.systemdUser = m_ssh->exec(busCheck, nullptr, nullptr, 8000);
-                caps.details += QString("systemdUser(bus /run/user/%1/bus)=%2\n")
-                                    .arg(uid)
-                                    .arg(caps.systemdUser ? "yes" : "no");
-            } else {
-                caps.details += QString("id -u invalid: '%1'\n").arg(uidOut.trimmed());
-            }
+        const QString uidOut = r[3].stdoutText.trimmed();
+        bool okUid = false;
+        const int uid = uidOut.toInt(&okUid);
+
+        if (r[3].exitStatus != 0) {
+            caps.details += QString("id -u failed: %1\n").arg(r[3].stderrText.trimmed());
+        } else if (okUid && uid > 0) {
+            caps.systemdUser = (r[4].exitStatus == 0);
+            caps.details += QString("systemdUser(bus /run/user/%1/bus)=%2\n")
+                                .arg(uid)
+                                .arg(caps.systemdUser ? "yes" : "no");
         } else {
-            caps.details += QString("id -u failed: %1\n").arg(e.trimmed());
+            caps.details += QString("id -u invalid: '%1'\n").arg(uidOut);
         }
     }
 
@@ -279,22 +340,20 @@ QString ScheduledJobsDialog::remoteHomeDir(QString* err) const
         return {};
     }
 
-    QString out, e;
-
     // 1) Primary: $HOME (fast, standard)
-    if (m_ssh->exec("/bin/sh -lc 'printf \"%s\" \"$HOME\"'", &out, &e, 8000)) {
-        out = out.trimmed();
-        if (!out.isEmpty())
-            return out;
-    }
-
     // 2) Fallback: getent passwd
-    out.clear();
-    e.clear();
-    if (m_ssh->exec("/bin/sh -lc 'getent passwd \"$(id -un)\" | cut -d: -f6'", &out, &e, 8000)) {
-        out = out.trimmed();
-        if (!out.isEmpty())
-            return out;
+    // Both asked in one round trip.
+    QVector<SshClient::BatchResult> r;
+    QString e;
+    if (execBatchLogin(m_ssh,
+                       { "printf \"%s\" \"$HOME\"",
+                         "getent passwd \"$(id -un)\" | cut -d: -f6" },
+                       &r, &e, 8000)) {
+        for (const auto& x : r) {
+            const QString out = x.stdoutText.trimmed();
+            if (x.exitStatus == 0 && !out.isEmpty())
+                return out;
+        }
     }
 
     if (err) {
@@ -496,7 +555,7 @@ bool ScheduledJobsDialog::installRemoteAt(const ScheduledJob& job, QString* err)
                 "/bin/sh -lc %1\n").arg(shQuote(job.command));
 
     QString e;
-    if (!m_ssh->exec(QString("/bin/sh -lc 'mkdir -p %1'").arg(shQuote(dir)), nullptr, &e, 8000)) {
+    if (!execBounded(m_ssh, QString("/bin/sh -lc 'mkdir -p %1'").arg(shQuote(dir)), nullptr, &e, 8000)) {
         if (err) *err = e;
         return false;
     }
@@ -514,7 +573,7 @@ bool ScheduledJobsDialog::installRemoteAt(const ScheduledJob& job, QString* err)
         QString("/bin/sh -lc 'at -t %1 -f %2'")
             .arg(atTime, shQuote(scriptPath));
 
-    if (!m_ssh->exec(enqueue, nullptr, &e, 12000)) {
+    if (!execBounded(m_ssh, enqueue, nullptr, &e, 12000)) {
         if (err) *err = e.isEmpty() ? tr("Failed to enqueue at job.") : e;
         return false;
     }
@@ -594,14 +653,18 @@ bool ScheduledJobsDialog::cancelRemote(const ScheduledJob& job, QString* err)
     const QString svcPath = userDir + "/" + base + ".service";
     const QString tmrPath = userDir + "/" + base + ".timer";
 
-    // Determine uid (for user bus path)
-    const QString uidCmd = "/bin/sh -lc 'id -u'";
-    QString uidOut;
-    if (!m_ssh->exec(uidCmd, &uidOut, &e, 8000)) {
+    // Determine uid (for user bus path) and probe the user bus: one round trip.
+    QVector<SshClient::BatchResult> probe;
+    if (!execBatchLogin(m_ssh, { "id -u", "test -S \"/run/user/$(id -u)/bus\"" }, &probe, &e, 8000)) {
         if (err) *err = e.isEmpty() ? tr("Could not determine remote uid.") : e;
         return false;
     }
+    if (probe[0].exitStatus != 0) {
+        if (err) *err = tr("Could not determine remote uid.");
+        return false;
+    }
 
+    const QString uidOut = probe[0].stdoutText;
     bool okUid = false;
     const int uid = uidOut.trimmed().toInt(&okUid);
     if (!okUid || uid <= 0) {
@@ -609,11 +672,7 @@ bool ScheduledJobsDialog::cancelRemote(const ScheduledJob& job, QString* err)
         return false;
     }
 
-    // Probe user bus
-    const QString busCheck =
-        QString("/bin/sh -lc 'test -S /run/user/%1/bus'").arg(uid);
-
-    if (!m_ssh->exec(busCheck, nullptr, &e, 8000)) {
+    if (probe[1].exitStatus != 0) {
         if (err) {
             *err =
                 tr("This server does not have a user systemd/DBus session available for this SSH login.\n\n"
@@ -629,24 +688,26 @@ bool ScheduledJobsDialog::cancelRemote(const ScheduledJob& job, QString* err)
         return false;
     }
 
-    // systemctl --user env wrapper (works for non-interactive SSH exec if bus exists)
-    const QString sysctlUser =
-        QString("/bin/sh -lc 'XDG_RUNTIME_DIR=/run/user/%1 "
-                "DBUS_SESSION_BUS_ADDRESS=unix:path=/run/user/%1/bus "
-                "systemctl --user ")
-            .arg(uid);
-
-    // Best-effort stop/disable + remove files
-    m_ssh->exec(sysctlUser + QString("disable --now %1.timer'").arg(base), nullptr, nullptr, 8000);
-    m_ssh->exec(QString("/bin/sh -lc 'rm -f %1 %2'")
-                    .arg(shQuote(svcPath), shQuote(tmrPath)),
-                nullptr, nullptr, 8000);
-
-    // Always try reload; this is the one we treat as "real" failure
-    if (!m_ssh->exec(sysctlUser + "daemon-reload'", nullptr, &e, 8000)) {
+    // Best-effort stop/disable + remove files, then reload: one round trip.
+    // Always try reload; this is the one we treat as "real" failure.
+    QVector<SshClient::BatchResult> r;
+    if (!execBatchLogin(m_ssh,
+                        { systemctlUserCmd(QString("disable --now %1.timer").arg(base)),
+                          QString("rm -f %1 %2").arg(shQuote(svcPath), shQuote(tmrPath)),
+                          systemctlUserCmd("daemon-reload") },
+                        &r, &e, 12000)) {
         if (err) *err = e;
         return false;
     }
+    if (r[2].exitStatus != 0) {
+        if (err) {
+            const QString se = r[2].stderrText.trimmed();
+            *err = se.isEmpty()
+                ? tr("Remote command failed (exit %1).").arg(r[2].exitStatus)
+                : tr("Remote command failed (exit %1): %2").arg(r[2].exitStatus).arg(se);
+        }
+        return false;
+    }
 
     return true;
 }
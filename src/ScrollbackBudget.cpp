@@ -0,0 +1,207 @@
+// ScrollbackBudget.cpp
+//
+// See header. The widget estimate uses ~12 bytes per character cell
+// (Konsole::Character) for history lines plus the visible screen; it is an
+// estimate, but the same one for every terminal, which is what LRU relief
+// needs.
+
+#include "ScrollbackBudget.h"
+#include "ScrollbackStore.h"
+#include "CpunkTermWidget.h"
+
+#include <QApplication>
+#include <QSettings>
+#include <QWidget>
+#include <QDebug>
+
+#include <algorithm>
+
+namespace {
+constexpr qint64 kCellBytes = 12;
+constexpr int    kCheckIntervalMs = 10000;
+
+// File-backed history may grow to this many times historyLines before it is
+// cut back (see enforce()).
+constexpr int    kFileHistorySlack = 2;
+}
+
+ScrollbackBudget* ScrollbackBudget::instance()
+{
+    static ScrollbackBudget* s = new ScrollbackBudget(qApp);
+    return s;
+}
+
+ScrollbackBudget::ScrollbackBudget(QObject* parent)
+    : QObject(parent)
+{
+    m_clock.start();
+
+    m_timer.setInterval(kCheckIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &ScrollbackBudget::enforce);
+    m_timer.start();
+
+    connect(qApp, &QApplication::focusChanged, this, &ScrollbackBudget::onFocusChanged);
+}
+
+qint64 ScrollbackBudget::budgetBytes() const
+{
+    const int mb = QSettings().value("terminal/scrollbackBudgetMB", 256).toInt();
+    return qint64(qMax(16, mb)) * 1024 * 1024;
+}
+
+// ------------------------------------------------------------
+// Registration
+// ------------------------------------------------------------
+void ScrollbackBudget::registerTerminal(CpunkTermWidget* term, int historyLines)
+{
+    if (!term || storeFor(term)) return;
+
+    auto* store = new ScrollbackStore(historyLines, term);
+    connect(term, &QTermWidget::receivedData, store, &ScrollbackStore::appendOutput);
+
+    Entry e;
+    e.term = term;
+    e.store = store;
+    e.historyLines = qMax(0, historyLines);
+    e.lastActiveMs = m_clock.elapsed();
+    m_entries.push_back(e);
+
+    connect(term, &QObject::destroyed, this, [this]() { prune(); });
+
+    emit terminalRegistered(term);
+}
+
+ScrollbackStore* ScrollbackBudget::storeFor(const CpunkTermWidget* term)
+{
+    return term ? term->findChild<ScrollbackStore*>(QString(), Qt::FindDirectChildrenOnly) : nullptr;
+}
+
+QVector<CpunkTermWidget*> ScrollbackBudget::terminals() const
+{
+    QVector<CpunkTermWidget*> out;
+    for (const Entry& e : m_entries)
+        if (e.term) out.push_back(e.term);
+    return out;
+}
+
+void ScrollbackBudget::prune()
+{
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                   [](const Entry& e) { return e.term.isNull(); }),
+                    m_entries.end());
+}
+
+ScrollbackBudget::Entry* ScrollbackBudget::entryFor(const QWidget* w)
+{
+    for (; w; w = w->parentWidget()) {
+        for (Entry& e : m_entries)
+            if (e.term == w) return &e;
+    }
+    return nullptr;
+}
+
+// ------------------------------------------------------------
+// Accounting
+// ------------------------------------------------------------
+qint64 ScrollbackBudget::widgetBytes(const Entry& e) const
+{
+    if (!e.term || e.fileBacked) return 0;
+    const qint64 lines = qint64(qMin(e.term->historyLinesCount(), e.historyLines))
+                         + e.term->screenLinesCount();
+    return lines * e.term->screenColumnsCount() * kCellBytes;
+}
+
+qint64 ScrollbackBudget::estimatedBytes() const
+{
+    qint64 total = 0;
+    for (const Entry& e : m_entries) {
+        if (!e.term) continue;
+        total += widgetBytes(e) + e.store->memoryBytes();
+    }
+    return total;
+}
+
+// ------------------------------------------------------------
+// Activity
+// ------------------------------------------------------------
+void ScrollbackBudget::onFocusChanged(QWidget* old, QWidget* now)
+{
+    Q_UNUSED(old);
+    if (Entry* e = entryFor(now)) {
+        e->lastActiveMs = m_clock.elapsed();
+        if (e->fileBacked) restore(*e);
+    }
+}
+
+void ScrollbackBudget::restore(Entry& e)
+{
+    if (!e.term || !e.fileBacked) return;
+    e.term->setHistorySize(e.historyLines);   // copies back the newest historyLines
+    e.fileBacked = false;
+}
+
+// ------------------------------------------------------------
+// enforce()
+// ------------------------------------------------------------
+void ScrollbackBudget::enforce()
+{
+    prune();
+
+    const qint64 now = m_clock.elapsed();
+    QVector<Entry*> inactive;
+    for (Entry& e : m_entries) {
+        if (e.term->isVisible()) {
+            e.lastActiveMs = now;
+            restore(e);
+        } else {
+            inactive.push_back(&e);
+        }
+    }
+
+    // qtermwidget's file history is unbounded: a busy background tab would
+    // grow it for as long as it runs. Cut it back to historyLines (copied
+    // through memory once, then a fresh file) when it is well past that; the
+    // ScrollbackStore keeps the same lines for search anyway.
+    for (Entry* e : inactive) {
+        if (!e->fileBacked) continue;
+        if (e->term->historyLinesCount() <= qint64(e->historyLines) * kFileHistorySlack) continue;
+
+        qInfo().noquote() << QString("[SCROLLBACK] trimming file history of inactive terminal (%1 -> %2 lines)")
+                                 .arg(e->term->historyLinesCount())
+                                 .arg(e->historyLines);
+        e->term->setHistorySize(e->historyLines);
+        e->term->setHistorySize(-1);
+    }
+
+    qint64 total = estimatedBytes();
+    const qint64 budget = budgetBytes();
+    if (total <= budget) return;
+
+    std::sort(inactive.begin(), inactive.end(),
+              [](const Entry* a, const Entry* b) { return a->lastActiveMs < b->lastActiveMs; });
+
+    // Pass 1: compressed store blocks to disk (cheap, invisible).
+    for (Entry* e : inactive) {
+        if (total <= budget) break;
+        total -= e->store->spillColdBlocks();
+    }
+
+    // Pass 2: widget history to qtermwidget's file-backed history.
+    for (Entry* e : inactive) {
+        if (total <= budget) break;
+        if (e->fileBacked || e->historyLines <= 0) continue;
+
+        const qint64 bytes = widgetBytes(*e);
+        e->term->setHistorySize(-1);
+        e->fileBacked = true;
+        total -= bytes;
+
+        qInfo().noquote() << QString("[SCROLLBACK] moved history of inactive terminal to disk (~%1 KiB)")
+                                 .arg(bytes / 1024);
+    }
+
+    if (total > budget) {
+        qInfo().noquote() << QString("[SCROLLBACK] still over budget: ~%1 MiB of %2 MiB (visible terminals)")
+                                 .arg(total / (1024 * 1024)).arg(budget / (1024 * 1024));
+    }
+}
@@ -0,0 +1,84 @@
+// ScrollbackBudget.h
+//
+// Purpose:
+//   One memory budget for the scrollback of all open terminals
+//   (terminal/scrollbackBudgetMB, default 256). Without it every tab keeps
+//   historyLines of qtermwidget character cells in RAM, and 30 tabs with
+//   large histories grow without bound.
+//
+// How:
+//   - Every SSH terminal is registered; a ScrollbackStore (compressed text
+//     copy of its scrollback) is attached and fed from receivedData().
+//   - Estimated use = qtermwidget history cells + store memory.
+//   - Over budget, inactive terminals are relieved least-recently-used first:
+//       1) their store's cold compressed blocks are spilled to the mmapped
+//          spill file
+//       2) the widget's history is switched to qtermwidget's file-backed
+//          history (setHistorySize(-1)); lines are copied over, scrolling
+//          still works and reads them from the file on demand. That history
+//          has no line limit, so once it holds more than twice historyLines
+//          it is cut back to historyLines (a short copy through memory)
+//   - When such a terminal is shown or focused again, its in-memory history
+//     (the profile's historyLines) is restored from the file copy.
+//
+// Threading:
+//   UI thread only.
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QTimer>
+
+class CpunkTermWidget;
+class ScrollbackStore;
+class QWidget;
+
+class ScrollbackBudget : public QObject
+{
+    Q_OBJECT
+public:
+    static ScrollbackBudget* instance();
+
+    // historyLines: what the widget was configured with (0 = no history).
+    // Creates the terminal's ScrollbackStore. Safe to call twice.
+    void registerTerminal(CpunkTermWidget* term, int historyLines);
+
+    static ScrollbackStore* storeFor(const CpunkTermWidget* term);
+
+    // Live registered terminals, oldest registration first.
+    QVector<CpunkTermWidget*> terminals() const;
+
+    qint64 budgetBytes() const;
+    qint64 estimatedBytes() const;
+
+public slots:
+    // Check the budget now (also runs periodically and on focus changes).
+    void enforce();
+
+signals:
+    void terminalRegistered(CpunkTermWidget* term);
+
+private:
+    explicit ScrollbackBudget(QObject* parent = nullptr);
+
+    struct Entry {
+        QPointer<CpunkTermWidget> term;
+        ScrollbackStore* store = nullptr;
+        int    historyLines = 0;
+        qint64 lastActiveMs = 0;
+        bool   fileBacked = false;
+    };
+
+    void onFocusChanged(QWidget* old, QWidget* now);
+    void prune();
+    void restore(Entry& e);
+    qint64 widgetBytes(const Entry& e) const;
+    Entry* entryFor(const QWidget* w);
+
+    QVector<Entry> m_entries;
+    QElapsedTimer  m_clock;
+    QTimer         m_timer;
+};
@@ -0,0 +1,297 @@
+// ScrollbackSearchDialog.cpp
+//
+// See header. Line mapping for jumps: the store's endLine() is the line the
+// cursor is on, and every store line above it takes ceil(len / columns)
+// widget rows (soft wrap). Alternate-screen output is in neither the store
+// nor the widget history. Double-width characters are counted as one column,
+// so very long CJK lines can land a row off.
+
+#include "ScrollbackSearchDialog.h"
+#include "ScrollbackBudget.h"
+#include "ScrollbackStore.h"
+#include "CpunkTermWidget.h"
+
+#include <QCheckBox>
+#include <QElapsedTimer>
+#include <QFontMetrics>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPlainTextEdit>
+#include <QScrollBar>
+#include <QSplitter>
+#include <QTabWidget>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include <QDebug>
+
+namespace {
+constexpr int kMaxHitsPerTerminal = 500;
+constexpr int kMaxHitsTotal = 2000;
+constexpr int kContextLines = 5;
+constexpr int kDebounceMs = 150;
+
+QWidget* findTerminalDisplay(QWidget* term)
+{
+    for (QWidget* w : term->findChildren<QWidget*>()) {
+        if (w->inherits("Konsole::TerminalDisplay"))
+            return w;
+    }
+    return nullptr;
+}
+}
+
+ScrollbackSearchDialog::ScrollbackSearchDialog(QWidget* parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Search all terminals"));
+    resize(900, 560);
+
+    auto* root = new QVBoxLayout(this);
+
+    auto* top = new QHBoxLayout();
+    m_query = new QLineEdit(this);
+    m_query->setPlaceholderText(tr("Search scrollback of all open terminals…"));
+    m_query->setClearButtonEnabled(true);
+    m_caseSensitive = new QCheckBox(tr("Match case"), this);
+    top->addWidget(m_query, 1);
+    top->addWidget(m_caseSensitive);
+    root->addLayout(top);
+
+    auto* split = new QSplitter(Qt::Vertical, this);
+
+    m_results = new QTreeWidget(split);
+    m_results->setColumnCount(3);
+    m_results->setHeaderLabels({tr("Session"), tr("Line"), tr("Text")});
+    m_results->setRootIsDecorated(false);
+    m_results->setUniformRowHeights(true);
+    m_results->setAlternatingRowColors(true);
+    m_results->header()->setStretchLastSection(true);
+    m_results->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    m_results->header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+
+    m_preview = new QPlainTextEdit(split);
+    m_preview->setReadOnly(true);
+    m_preview->setLineWrapMode(QPlainTextEdit::NoWrap);
+    QFont mono("Monospace");
+    mono.setStyleHint(QFont::TypeWriter);
+    m_preview->setFont(mono);
+
+    split->setStretchFactor(0, 3);
+    split->setStretchFactor(1, 1);
+    root->addWidget(split, 1);
+
+    m_status = new QLabel(this);
+    root->addWidget(m_status);
+
+    m_debounce.setSingleShot(true);
+    m_debounce.setInterval(kDebounceMs);
+    connect(&m_debounce, &QTimer::timeout, this, &ScrollbackSearchDialog::runSearch);
+    connect(m_query, &QLineEdit::textChanged, this, [this]() { m_debounce.start(); });
+    connect(m_query, &QLineEdit::returnPressed, this, &ScrollbackSearchDialog::runSearch);
+    connect(m_caseSensitive, &QCheckBox::toggled, this, &ScrollbackSearchDialog::runSearch);
+
+    connect(m_results, &QTreeWidget::currentItemChanged,
+            this, &ScrollbackSearchDialog::onCurrentItemChanged);
+    connect(m_results, &QTreeWidget::itemActivated,
+            this, &ScrollbackSearchDialog::onItemActivated);
+
+    m_query->setFocus();
+}
+
+void ScrollbackSearchDialog::setQuery(const QString& text)
+{
+    m_query->setText(text);
+    m_query->selectAll();
+    runSearch();
+}
+
+QString ScrollbackSearchDialog::sessionName(CpunkTermWidget* term)
+{
+    // Tab title when docked in a tab widget, else the terminal's window title.
+    for (QWidget* w = term; w; w = w->parentWidget()) {
+        QWidget* page = w;
+        QWidget* stack = page->parentWidget();
+        auto* tabs = stack ? qobject_cast<QTabWidget*>(stack->parentWidget()) : nullptr;
+        if (tabs) {
+            const int idx = tabs->indexOf(page);
+            if (idx >= 0) return tabs->tabText(idx);
+        }
+    }
+    const QString title = term->window()->windowTitle();
+    return title.isEmpty() ? tr("Terminal") : title;
+}
+
+// ------------------------------------------------------------
+// runSearch()
+// ------------------------------------------------------------
+void ScrollbackSearchDialog::runSearch()
+{
+    m_debounce.stop();
+    m_results->clear();
+    m_preview->clear();
+    m_hits.clear();
+
+    const QString needle = m_query->text();
+    if (needle.isEmpty()) {
+        m_status->clear();
+        return;
+    }
+
+    const Qt::CaseSensitivity cs =
+        m_caseSensitive->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    QElapsedTimer t;
+    t.start();
+
+    qint64 linesSearched = 0;
+    int terminals = 0;
+    bool truncated = false;
+    QList<QTreeWidgetItem*> items;
+
+    for (CpunkTermWidget* term : ScrollbackBudget::instance()->terminals()) {
+        ScrollbackStore* store = ScrollbackBudget::storeFor(term);
+        if (!store) continue;
+        ++terminals;
+        linesSearched += store->endLine() - store->firstLine();
+
+        const auto hits = store->search(needle, kMaxHitsPerTerminal, cs);
+        if (hits.size() >= kMaxHitsPerTerminal) truncated = true;
+
+        const QString name = sessionName(term);
+        for (const ScrollbackStore::Hit& h : hits) {
+            if (m_hits.size() >= kMaxHitsTotal) { truncated = true; break; }
+
+            Result r;
+            r.term = term;
+            r.line = h.line;
+            r.column = h.column;
+
+            auto* item = new QTreeWidgetItem();
+            item->setText(0, name);
+            item->setText(1, QString::number(h.line + 1));
+            item->setText(2, h.text.trimmed());
+            item->setToolTip(2, h.text);
+            item->setData(0, Qt::UserRole, m_hits.size());
+            items.push_back(item);
+            m_hits.push_back(r);
+        }
+    }
+
+    m_results->addTopLevelItems(items);
+
+    const qint64 ms = t.elapsed();
+    QString status = tr("%1 hits in %2 lines of %3 terminals (%4 ms)")
+                         .arg(m_hits.size()).arg(linesSearched).arg(terminals).arg(ms);
+    if (truncated) status += tr(" — showing the newest matches only");
+    m_status->setText(status);
+
+    qInfo().noquote() << QString("[SCROLLBACK] search: %1 hits, %2 lines, %3 ms")
+                             .arg(m_hits.size()).arg(linesSearched).arg(ms);
+}
+
+// ------------------------------------------------------------
+// Preview / jump
+// ------------------------------------------------------------
+void ScrollbackSearchDialog::onCurrentItemChanged(QTreeWidgetItem* current)
+{
+    m_preview->clear();
+    if (!current) return;
+
+    const int idx = current->data(0, Qt::UserRole).toInt();
+    if (idx < 0 || idx >= m_hits.size()) return;
+    const Result& r = m_hits[idx];
+    ScrollbackStore* store = ScrollbackBudget::storeFor(r.term);
+    if (!store) return;
+
+    const qint64 from = qMax(store->firstLine(), r.line - kContextLines);
+    const QStringList lines = store->lines(from, int(r.line - from) + kContextLines + 1);
+
+    QStringList shown;
+    for (int i = 0; i < lines.size(); ++i) {
+        const qint64 n = from + i;
+        shown << QString("%1 %2 %3")
+                     .arg(n + 1, 7)
+                     .arg(n == r.line ? QStringLiteral(">") : QStringLiteral(" "))
+                     .arg(lines[i]);
+    }
+    m_preview->setPlainText(shown.join('\n'));
+}
+
+void ScrollbackSearchDialog::onItemActivated(QTreeWidgetItem* item)
+{
+    if (!item) return;
+    const int idx = item->data(0, Qt::UserRole).toInt();
+    if (idx >= 0 && idx < m_hits.size())
+        jumpTo(m_hits[idx]);
+}
+
+void ScrollbackSearchDialog::jumpTo(const Result& r)
+{
+    CpunkTermWidget* term = r.term;
+    ScrollbackStore* store = ScrollbackBudget::storeFor(term);
+    if (!term || !store) {
+        m_status->setText(tr("That terminal has been closed."));
+        return;
+    }
+
+    // Bring the terminal to front: select its tab (walking out through nested
+    // tab widgets), then raise its window.
+    for (QWidget* w = term; w; w = w->parentWidget()) {
+        QWidget* stack = w->parentWidget();
+        auto* tabs = stack ? qobject_cast<QTabWidget*>(stack->parentWidget()) : nullptr;
+        if (tabs && tabs->indexOf(w) >= 0)
+            tabs->setCurrentWidget(w);
+    }
+    term->window()->show();
+    term->window()->raise();
+    term->window()->activateWindow();
+    term->setFocus();
+
+    QWidget* display = findTerminalDisplay(term);
+    if (!display) return;
+
+    // Cursor row on screen, from the display's input method cursor rect.
+    const int fontH = qMax(1, QFontMetrics(term->getTerminalFont()).height());
+    const QRect cur = display->inputMethodQuery(Qt::ImMicroFocus).toRect();
+    const int cursorRow = qBound(0, cur.y() / fontH, qMax(0, term->screenLinesCount() - 1));
+
+    // Store lines are logical lines; the widget wraps each one into
+    // ceil(len / cols) rows. Count the rows from the hit's line down to the
+    // cursor's (unterminated) line, which starts partialLength / cols rows
+    // above the cursor.
+    const int cols = qMax(1, term->screenColumnsCount());
+    auto rowsOf = [cols](int len) { return qMax(1, (len + cols - 1) / cols); };
+
+    const int rowsAvailable = term->historyLinesCount() + cursorRow;
+    const qint64 linesBelow = store->endLine() - r.line;
+    int widgetLine = -1;
+    if (linesBelow <= rowsAvailable) {
+        int rows = store->partialLength() / cols;
+        for (const QString& l : store->lines(r.line, int(linesBelow)))
+            rows += rowsOf(l.size());
+        widgetLine = rowsAvailable - rows;
+    }
+    if (widgetLine < 0) {
+        m_status->setText(tr("Line %1 is no longer in the terminal's history (shown in the preview only).")
+                              .arg(r.line + 1));
+        return;
+    }
+
+    // The match may sit on a continuation row of a wrapped line.
+    widgetLine += r.column / cols;
+    const int column = r.column % cols;
+
+    // Scroll so the line sits mid-screen, then select the match on it.
+    int top = qMax(0, widgetLine - term->screenLinesCount() / 2);
+    if (auto* bar = display->findChild<QScrollBar*>()) {
+        bar->setValue(top);
+        top = bar->value();
+    }
+
+    const int row = widgetLine - top;
+    const int len = qMax(1, m_query->text().size());
+    term->setSelectionStart(row, column);
+    term->setSelectionEnd(row, column + len - 1);
+}
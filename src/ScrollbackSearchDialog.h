@@ -0,0 +1,60 @@
+// ScrollbackSearchDialog.h
+//
+// Purpose:
+//   Search the scrollback of every open terminal at once. Queries run against
+//   each terminal's ScrollbackStore (compressed text copy with per-block
+//   trigram filters, fed from the output stream), so results come back in
+//   milliseconds even with millions of lines across tabs.
+//
+//   Double-clicking a hit brings its tab/window to front, scrolls the
+//   terminal to the line and selects the match. Lines that have already left
+//   the widget's own history are still shown in the context preview.
+
+#pragma once
+
+#include <QDialog>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+class CpunkTermWidget;
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QPlainTextEdit;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+class ScrollbackSearchDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit ScrollbackSearchDialog(QWidget* parent = nullptr);
+
+    // Start with a query (e.g. the current selection).
+    void setQuery(const QString& text);
+
+private slots:
+    void runSearch();
+    void onCurrentItemChanged(QTreeWidgetItem* current);
+    void onItemActivated(QTreeWidgetItem* item);
+
+private:
+    struct Result {
+        QPointer<CpunkTermWidget> term;
+        qint64 line = 0;
+        int    column = 0;
+    };
+
+    static QString sessionName(CpunkTermWidget* term);
+    void jumpTo(const Result& r);
+
+    QLineEdit*      m_query = nullptr;
+    QCheckBox*      m_caseSensitive = nullptr;
+    QTreeWidget*    m_results = nullptr;
+    QPlainTextEdit* m_preview = nullptr;
+    QLabel*         m_status = nullptr;
+    QTimer          m_debounce;
+
+    QVector<Result> m_hits;
+};
@@ -0,0 +1,423 @@
+// ScrollbackStore.cpp
+//
+// See header. Implementation notes:
+//   - qCompress (zlib, level 1) is used for blocks: it ships with Qt and on
+//     terminal text gets 4-8x at several hundred MB/s, close enough to LZ4
+//     for data that is compressed once and rarely read.
+//   - The spill file is shared by all stores and deleted on exit. Space of
+//     blocks dropped later is not reused; the file is capped by
+//     terminal/scrollbackSpillMaxMB (default 1024) and spilling simply stops
+//     at the cap (blocks stay compressed in memory).
+
+#include "ScrollbackStore.h"
+
+#include <QDir>
+#include <QSettings>
+#include <QTemporaryFile>
+#include <QTextCodec>
+#include <QTextDecoder>
+#include <QDebug>
+
+#include <algorithm>
+
+namespace {
+
+constexpr int kBlockBytes = 64 * 1024;
+constexpr int kBlockMaxLines = 2048;
+constexpr int kMaxLineChars = 4096;
+constexpr int kBloomHashes = 3;
+
+// ------------------------------------------------------------
+// Trigram Bloom filter
+// ------------------------------------------------------------
+quint64 mix64(quint64 x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Case-folded text in, one key per trigram.
+template <typename Fn>
+void forEachTrigram(const QString& folded, Fn fn)
+{
+    const int n = folded.size();
+    for (int i = 0; i + 2 < n; ++i) {
+        fn((quint64(folded[i].unicode()) << 32) |
+           (quint64(folded[i + 1].unicode()) << 16) |
+            quint64(folded[i + 2].unicode()));
+    }
+}
+
+void bloomAdd(QByteArray& bloom, quint64 key)
+{
+    const quint64 h = mix64(key);
+    const quint32 nbits = quint32(bloom.size()) * 8;
+    const quint32 h1 = quint32(h), h2 = quint32(h >> 32) | 1;
+    for (int k = 0; k < kBloomHashes; ++k) {
+        const quint32 bit = (h1 + quint32(k) * h2) % nbits;
+        bloom.data()[bit >> 3] |= char(1u << (bit & 7));
+    }
+}
+
+bool bloomHas(const QByteArray& bloom, quint64 key)
+{
+    if (bloom.isEmpty()) return true;
+    const quint64 h = mix64(key);
+    const quint32 nbits = quint32(bloom.size()) * 8;
+    const quint32 h1 = quint32(h), h2 = quint32(h >> 32) | 1;
+    for (int k = 0; k < kBloomHashes; ++k) {
+        const quint32 bit = (h1 + quint32(k) * h2) % nbits;
+        if (!(uchar(bloom.constData()[bit >> 3]) & (1u << (bit & 7))))
+            return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// Shared spill file
+// ------------------------------------------------------------
+class SpillFile
+{
+public:
+    static SpillFile& instance()
+    {
+        static SpillFile f;
+        return f;
+    }
+
+    // Appends data; returns its offset or -1 (cap reached / I/O error).
+    qint64 append(const QByteArray& data)
+    {
+        if (!ensureOpen()) return -1;
+
+        const qint64 capBytes =
+            qint64(QSettings().value("terminal/scrollbackSpillMaxMB", 1024).toInt()) * 1024 * 1024;
+        if (m_size + data.size() > capBytes) return -1;
+
+        if (!m_file.seek(m_size) || m_file.write(data) != data.size()) {
+            qWarning().noquote() << QString("[SCROLLBACK] spill write failed: %1").arg(m_file.errorString());
+            return -1;
+        }
+        m_file.flush();
+        const qint64 off = m_size;
+        m_size += data.size();
+        return off;
+    }
+
+    // Copies [offset, offset + size) out of a temporary mapping.
+    QByteArray read(qint64 offset, int size)
+    {
+        if (!m_file.isOpen() || size <= 0) return {};
+
+        uchar* p = m_file.map(offset, size);
+        if (!p) {
+            // Mapping can fail (e.g. address space); fall back to a read.
+            if (!m_file.seek(offset)) return {};
+            return m_file.read(size);
+        }
+        QByteArray out(reinterpret_cast<const char*>(p), size);
+        m_file.unmap(p);
+        return out;
+    }
+
+private:
+    bool ensureOpen()
+    {
+        if (m_file.isOpen()) return true;
+        m_file.setFileTemplate(QDir(QDir::tempPath()).filePath("pq-ssh-scrollback-XXXXXX"));
+        if (!m_file.open()) {
+            qWarning().noquote() << QString("[SCROLLBACK] cannot create spill file: %1").arg(m_file.errorString());
+            return false;
+        }
+        return true;
+    }
+
+    QTemporaryFile m_file;   // auto-removed
+    qint64         m_size = 0;
+};
+
+} // namespace
+
+ScrollbackStore::ScrollbackStore(int maxLines, QObject* parent)
+    : QObject(parent)
+    , m_maxLines(maxLines > 0 ? maxLines : kDefaultMaxLines)
+    , m_utf8(QTextCodec::codecForName("UTF-8")->makeDecoder())
+{
+}
+
+ScrollbackStore::~ScrollbackStore() = default;
+
+// ------------------------------------------------------------
+// appendOutput()
+// ------------------------------------------------------------
+void ScrollbackStore::appendOutput(const QString& text)
+{
+    // Back to bytes, then UTF-8 (a partial sequence waits for the next chunk).
+    const QString decoded = m_utf8->toUnicode(text.toLatin1());
+
+    for (const QChar c : decoded) {
+        const ushort u = c.unicode();
+
+        switch (m_parse) {
+        case Parse::Text:
+            break;
+        case Parse::Esc:
+            if (c == QLatin1Char('['))      { m_parse = Parse::Csi; m_csi.clear(); }
+            else if (c == QLatin1Char(']')) m_parse = Parse::Osc;
+            else if (c == QLatin1Char('(') || c == QLatin1Char(')')) m_parse = Parse::Charset;
+            else                            m_parse = Parse::Text;
+            continue;
+        case Parse::Csi:
+            if (u >= 0x40 && u <= 0x7e) {
+                m_parse = Parse::Text;
+                onCsi(c);
+            } else if (m_csi.size() < 32) {
+                m_csi += c;
+            }
+            continue;
+        case Parse::Osc:
+            if (u == 0x07) m_parse = Parse::Text;
+            else if (u == 0x1b) m_parse = Parse::OscEsc;
+            continue;
+        case Parse::OscEsc:
+        case Parse::Charset:
+            m_parse = Parse::Text;
+            continue;
+        }
+
+        if (u == 0x1b) { m_parse = Parse::Esc; continue; }
+        if (m_altScreen) continue;   // full-screen apps: never part of the history
+        if (u == '\n') { commitLine(); continue; }
+        if (u == '\r') { m_crPending = true; continue; }
+        if (u == 0x08) { if (!m_partial.isEmpty()) m_partial.chop(1); continue; }
+        if (u < 0x20 && u != '\t') continue;
+
+        // Bare CR followed by text: the line is being redrawn (progress bars).
+        if (m_crPending) {
+            m_partial.clear();
+            m_crPending = false;
+        }
+        if (m_partial.size() < kMaxLineChars)
+            m_partial += c;
+    }
+}
+
+// Alternate screen on/off (vim, less, htop): the widget keeps none of it in
+// its history, so neither does the store, and line numbers stay in step.
+void ScrollbackStore::onCsi(QChar fin)
+{
+    if ((fin != QLatin1Char('h') && fin != QLatin1Char('l')) || !m_csi.startsWith(QLatin1Char('?')))
+        return;
+    const QStringList modes = m_csi.mid(1).split(QLatin1Char(';'));
+    if (modes.contains("1049") || modes.contains("1047") || modes.contains("47"))
+        m_altScreen = (fin == QLatin1Char('h'));
+}
+
+void ScrollbackStore::commitLine()
+{
+    m_crPending = false;
+    m_open.push_back(m_partial);
+    m_openBytes += m_partial.size() + 1;
+    m_partial.clear();
+    ++m_nextLine;
+
+    if (m_openBytes >= kBlockBytes || m_open.size() >= kBlockMaxLines)
+        sealOpenBlock();
+}
+
+void ScrollbackStore::sealOpenBlock()
+{
+    if (m_open.isEmpty()) return;
+
+    const QByteArray raw = m_open.join(QLatin1Char('\n')).toUtf8();
+
+    Block b;
+    b.firstLine = m_nextLine - m_open.size();
+    b.lineCount = m_open.size();
+    b.rawBytes  = raw.size();
+    b.packed    = qCompress(raw, 1);
+
+    // ~2 bits per text byte (power of two, >= 1 Ki bits). Distinct trigrams
+    // are well below the byte count, which keeps false positives at a few %.
+    int bloomBytes = 128;
+    while (bloomBytes * 4 < raw.size()) bloomBytes *= 2;
+    b.bloom = QByteArray(bloomBytes, '\0');
+    for (const QString& line : m_open)
+        forEachTrigram(line.toCaseFolded(), [&b](quint64 key) { bloomAdd(b.bloom, key); });
+
+    m_blocks.push_back(b);
+
+    m_open.clear();
+    m_openBytes = 0;
+
+    emit blockSealed(b.firstLine, b.lineCount);
+    trimToMaxLines();
+}
+
+void ScrollbackStore::trimToMaxLines()
+{
+    int drop = 0;
+    qint64 kept = m_nextLine - firstLine();
+    while (drop < m_blocks.size() && kept - m_blocks[drop].lineCount >= m_maxLines) {
+        kept -= m_blocks[drop].lineCount;
+        if (m_blocks[drop].spillOffset >= 0)
+            m_spilledBytes -= m_blocks[drop].spillSize;
+        ++drop;
+    }
+    if (drop == 0) return;
+
+    m_blocks.remove(0, drop);
+    m_cacheIndex = -1;
+    emit linesDropped(firstLine());
+}
+
+// ------------------------------------------------------------
+// Reading
+// ------------------------------------------------------------
+qint64 ScrollbackStore::firstLine() const
+{
+    return m_blocks.isEmpty() ? openFirstLine() : m_blocks.first().firstLine;
+}
+
+QByteArray ScrollbackStore::packedData(const Block& b) const
+{
+    if (!b.packed.isEmpty()) return b.packed;
+    if (b.spillOffset < 0)   return {};
+    return SpillFile::instance().read(b.spillOffset, b.spillSize);
+}
+
+QStringList ScrollbackStore::blockLines(int i) const
+{
+    if (i < 0 || i >= m_blocks.size()) return {};
+
+    const Block& b = m_blocks[i];
+    if (m_cacheIndex == i && m_cacheFirstLine == b.firstLine)
+        return m_cacheLines;
+
+    const QByteArray raw = qUncompress(packedData(b));
+    QStringList out = QString::fromUtf8(raw).split(QLatin1Char('\n'));
+    // join/split round trip: an empty block yields one empty string
+    while (out.size() > b.lineCount) out.removeLast();
+    while (out.size() < b.lineCount) out.push_back(QString());
+
+    m_cacheIndex = i;
+    m_cacheFirstLine = b.firstLine;
+    m_cacheLines = out;
+    return out;
+}
+
+QStringList ScrollbackStore::lines(qint64 from, int count) const
+{
+    QStringList out;
+    if (count <= 0) return out;
+
+    from = qMax(from, firstLine());
+    const qint64 to = qMin(from + count, m_nextLine);
+
+    // Sealed blocks: binary search for the first one that overlaps.
+    int lo = 0, hi = m_blocks.size();
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (m_blocks[mid].firstLine + m_blocks[mid].lineCount <= from) lo = mid + 1;
+        else hi = mid;
+    }
+
+    qint64 line = from;
+    for (int i = lo; i < m_blocks.size() && line < to; ++i) {
+        const Block& b = m_blocks[i];
+        const QStringList bl = blockLines(i);
+        for (qint64 l = line; l < to && l < b.firstLine + b.lineCount; ++l)
+            out.push_back(bl[int(l - b.firstLine)]);
+        line = b.firstLine + b.lineCount;
+    }
+
+    const qint64 openFirst = openFirstLine();
+    for (qint64 l = qMax(line, openFirst); l < to; ++l)
+        out.push_back(m_open[int(l - openFirst)]);
+
+    return out;
+}
+
+// ------------------------------------------------------------
+// Memory
+// ------------------------------------------------------------
+qint64 ScrollbackStore::memoryBytes() const
+{
+    qint64 total = qint64(m_openBytes) * 2 + m_partial.size() * 2;
+    for (const Block& b : m_blocks)
+        total += b.packed.size() + b.bloom.size();
+    for (const QString& s : m_cacheLines)
+        total += s.size() * 2;
+    return total;
+}
+
+qint64 ScrollbackStore::spillColdBlocks(int keepHot)
+{
+    qint64 freed = 0;
+    const int last = m_blocks.size() - qMax(0, keepHot);
+
+    for (int i = 0; i < last; ++i) {
+        Block& b = m_blocks[i];
+        if (b.packed.isEmpty()) continue;
+
+        const qint64 off = SpillFile::instance().append(b.packed);
+        if (off < 0) break;                     // cap reached: keep the rest in RAM
+
+        b.spillOffset = off;
+        b.spillSize = b.packed.size();
+        freed += b.packed.size();
+        m_spilledBytes += b.spillSize;
+        b.packed = QByteArray();
+    }
+
+    // The decoded cache is the only other big allocation.
+    if (freed > 0) {
+        m_cacheIndex = -1;
+        m_cacheLines.clear();
+    }
+    return freed;
+}
+
+// ------------------------------------------------------------
+// search()
+// ------------------------------------------------------------
+QVector<ScrollbackStore::Hit> ScrollbackStore::search(const QString& needle, int maxHits,
+                                                      Qt::CaseSensitivity cs) const
+{
+    QVector<Hit> hits;
+    if (needle.isEmpty() || maxHits <= 0) return hits;
+
+    QVector<quint64> keys;
+    forEachTrigram(needle.toCaseFolded(), [&keys](quint64 key) {
+        if (!keys.contains(key)) keys.push_back(key);
+    });
+
+    // Newest first, so the scan can stop as soon as maxHits are found.
+    auto scan = [&](const QStringList& lines, qint64 first) {
+        for (int j = lines.size() - 1; j >= 0 && hits.size() < maxHits; --j) {
+            const int col = lines[j].indexOf(needle, 0, cs);
+            if (col < 0) continue;
+            Hit h;
+            h.line = first + j;
+            h.column = col;
+            h.text = lines[j];
+            hits.push_back(h);
+        }
+    };
+
+    scan(m_open, openFirstLine());
+    for (int i = m_blocks.size() - 1; i >= 0 && hits.size() < maxHits; --i) {
+        const Block& b = m_blocks[i];
+        bool maybe = true;
+        for (quint64 key : keys) {
+            if (!bloomHas(b.bloom, key)) { maybe = false; break; }
+        }
+        if (maybe)
+            scan(blockLines(i), b.firstLine);
+    }
+
+    std::reverse(hits.begin(), hits.end());
+    return hits;
+}
@@ -0,0 +1,144 @@
+// ScrollbackStore.h
+//
+// Purpose:
+//   Compact, text-only copy of one terminal's scrollback, fed from the
+//   terminal output stream (QTermWidget::receivedData). qtermwidget keeps its
+//   history as character cells (~12 bytes per column); this keeps the same
+//   lines as compressed text blocks, a few percent of that, so scrollback of
+//   many tabs can be kept, searched and shown without holding every tab's
+//   cell buffer in RAM (see ScrollbackBudget).
+//
+// Layout:
+//   - output arrives as raw bytes (qtermwidget decodes them as Latin-1) and
+//     is decoded as UTF-8 here, statefully, since a character can span two
+//     chunks
+//   - output is reduced to plain lines (escape sequences dropped, CR/BS
+//     applied) and appended to an open block; alternate-screen output
+//     (CSI ?1049h ... ?1049l) is skipped, as the widget's history skips it
+//   - every ~64 KiB the open block is sealed: joined, UTF-8, qCompress'd
+//   - cold sealed blocks can be spilled to one shared temp file; reads map
+//     the block's range of that file (QFile::map) only while decoding it
+//   - lines are addressed by an absolute, ever-increasing line number;
+//     the oldest blocks are dropped beyond maxLines
+//
+// Search index:
+//   Each sealed block carries a Bloom filter of its case-folded character
+//   trigrams (~2 bits per text byte, built while sealing). search() tests a
+//   query's trigrams against every filter and only decompresses blocks that
+//   may contain it, so a query over millions of lines touches a handful of
+//   blocks. Queries shorter than three characters scan every block.
+//
+// Threading:
+//   UI thread only.
+
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+
+class QTextDecoder;
+
+class ScrollbackStore : public QObject
+{
+    Q_OBJECT
+public:
+    struct Hit {
+        qint64  line = 0;      // absolute line number
+        int     column = 0;
+        QString text;          // the whole line
+    };
+
+    // maxLines <= 0 means kDefaultMaxLines.
+    explicit ScrollbackStore(int maxLines, QObject* parent = nullptr);
+    ~ScrollbackStore() override;
+
+    static constexpr int kDefaultMaxLines = 10000;
+
+    // Raw terminal output as delivered by QTermWidget::receivedData(): one
+    // QChar per byte (may contain escape sequences and partial lines).
+    void appendOutput(const QString& text);
+
+    // Absolute line numbers: [firstLine(), endLine()) are available.
+    qint64 firstLine() const;
+    qint64 endLine() const { return m_nextLine; }
+
+    // Lines [from, from + count), decompressing blocks on demand.
+    QStringList lines(qint64 from, int count) const;
+
+    // Number of sealed blocks and their line ranges (for indexing/search).
+    int    blockCount() const { return m_blocks.size(); }
+    qint64 blockFirstLine(int i) const { return m_blocks[i].firstLine; }
+    int    blockLineCount(int i) const { return m_blocks[i].lineCount; }
+    QStringList blockLines(int i) const;
+
+    // Lines not yet sealed into a block (the most recent output).
+    QStringList openLines() const { return m_open; }
+    qint64 openFirstLine() const { return m_nextLine - m_open.size(); }
+
+    // Characters of the unterminated line at endLine() (where the cursor is).
+    int partialLength() const { return m_partial.size(); }
+
+    // Lines containing needle, oldest first, at most maxHits: the scan runs
+    // newest first and stops there.
+    QVector<Hit> search(const QString& needle, int maxHits,
+                        Qt::CaseSensitivity cs = Qt::CaseInsensitive) const;
+
+    // Memory accounting (heap only; spilled blocks count as 0).
+    qint64 memoryBytes() const;
+    qint64 spilledBytes() const { return m_spilledBytes; }
+
+    // Spill sealed blocks to disk, keeping the newest keepHot in memory.
+    // Returns heap bytes freed.
+    qint64 spillColdBlocks(int keepHot = 2);
+
+signals:
+    // A block was sealed (index valid until blocks are dropped).
+    void blockSealed(qint64 firstLine, int lineCount);
+
+    // Oldest lines dropped: everything below firstLine is gone.
+    void linesDropped(qint64 firstLine);
+
+private:
+    struct Block {
+        qint64     firstLine = 0;
+        int        lineCount = 0;
+        int        rawBytes = 0;
+        QByteArray packed;           // empty once spilled
+        qint64     spillOffset = -1;
+        int        spillSize = 0;
+        QByteArray bloom;            // trigram filter (always in memory)
+    };
+
+    void onCsi(QChar fin);
+    void commitLine();
+    void sealOpenBlock();
+    void trimToMaxLines();
+    QByteArray packedData(const Block& b) const;
+
+    int m_maxLines = kDefaultMaxLines;
+    std::unique_ptr<QTextDecoder> m_utf8;
+
+    QVector<Block> m_blocks;
+    QStringList    m_open;
+    int            m_openBytes = 0;
+    QString        m_partial;
+    bool           m_crPending = false;
+    qint64         m_nextLine = 0;
+    qint64         m_spilledBytes = 0;
+
+    // Escape sequence parser state
+    enum class Parse { Text, Esc, Csi, Osc, OscEsc, Charset };
+    Parse m_parse = Parse::Text;
+    QString m_csi;                   // parameters of the CSI being parsed
+    bool m_altScreen = false;
+
+    // One decoded block kept for sequential reads (scrolling, search hits).
+    mutable int         m_cacheIndex = -1;
+    mutable qint64      m_cacheFirstLine = -1;
+    mutable QStringList m_cacheLines;
+};
@@ -15,6 +15,7 @@
 #include <QUrl>
 #include <QStandardPaths>
 #include <QCheckBox>
+#include <QSpinBox>
 #include <QPushButton>
 #include <QLabel>
 #include <QMessageBox>
@@ -209,6 +210,89 @@ void SettingsDialog::buildUi()
         });
     }
 
+    // -------------------------
+    // Connections
+    // -------------------------
+    // Stores:
+    // - ssh/speculativePreconnect (bool, default off)
+    // - ssh/keepaliveIntervalSec  (int seconds, default 15, 0 = off)
+    // - ssh/autoReconnect         (bool, default on)
+    // - ssh/cipherAutoTune        (bool, default on)
+    //
+    // When on, selecting/hovering a profile starts DNS + TCP + key exchange in
+    // the background so Connect only has to authenticate.
+    // Keepalive applies to the SFTP/exec session: a dead link is detected after
+    // three missed keepalives and reconnected with backoff; interrupted Files
+    // transfers resume afterwards.
+    {
+        m_preconnectCheck = new QCheckBox(tr("Pre-connect selected profile in the background"), this);
+        m_preconnectCheck->setToolTip(
+            tr("Speculatively resolve, connect and run key exchange (no authentication)\n"
+               "for the selected or hovered profile, so Connect completes faster.\n"
+               "Unused connections are closed after a few seconds."));
+        form->addRow(tr("Connections:"), m_preconnectCheck);
+
+        auto* row = new QWidget(this);
+        auto* h = new QHBoxLayout(row);
+        h->setContentsMargins(0,0,0,0);
+        h->setSpacing(8);
+
+        m_keepaliveSpin = new QSpinBox(row);
+        m_keepaliveSpin->setRange(0, 300);
+        m_keepaliveSpin->setSuffix(tr(" s"));
+        m_keepaliveSpin->setSpecialValueText(tr("Off"));
+        m_keepaliveSpin->setToolTip(tr("Keepalive interval for the SFTP session (0 = off)."));
+
+        m_autoReconnectCheck = new QCheckBox(tr("Reconnect automatically"), row);
+        m_autoReconnectCheck->setToolTip(
+            tr("When the SFTP connection drops, reconnect with increasing delays\n"
+               "and resume interrupted transfers."));
+
+        h->addWidget(m_keepaliveSpin, 0);
+        h->addWidget(m_autoReconnectCheck, 1);
+
+        form->addRow(tr("Keepalive:"), row);
+
+        m_cipherTuneCheck = new QCheckBox(tr("Order SFTP ciphers by speed on this CPU"), this);
+        m_cipherTuneCheck->setToolTip(
+            tr("Benchmark the allowed ciphers once and offer the fastest first\n"
+               "(AES-GCM with AES hardware support, ChaCha20-Poly1305 without).\n"
+               "Only AEAD and AES-CTR ciphers with SHA-2 MACs are ever offered."));
+        form->addRow(tr("Ciphers:"), m_cipherTuneCheck);
+    }
+
+    // -------------------------
+    // Terminal
+    // -------------------------
+    // Stores:
+    // - terminal/predictiveEcho     ("adaptive" default, "always", "off")
+    // - terminal/scrollbackBudgetMB (int MiB, default 256)
+    //
+    // Local echo applies to terminals opened after the change; the budget is
+    // re-checked within a few seconds.
+    {
+        m_predictiveEchoCombo = new QComboBox(this);
+        m_predictiveEchoCombo->addItem(tr("On slow links (adaptive)"), "adaptive");
+        m_predictiveEchoCombo->addItem(tr("Always"), "always");
+        m_predictiveEchoCombo->addItem(tr("Off"), "off");
+        m_predictiveEchoCombo->setToolTip(
+            tr("Show typed characters immediately (underlined) instead of waiting\n"
+               "for the server's echo. Predictions are corrected when the echo\n"
+               "arrives and are switched off in full-screen apps and at prompts\n"
+               "that do not echo (passwords)."));
+        form->addRow(tr("Local echo:"), m_predictiveEchoCombo);
+
+        m_scrollbackBudgetSpin = new QSpinBox(this);
+        m_scrollbackBudgetSpin->setRange(16, 8192);
+        m_scrollbackBudgetSpin->setSingleStep(64);
+        m_scrollbackBudgetSpin->setSuffix(tr(" MiB"));
+        m_scrollbackBudgetSpin->setToolTip(
+            tr("Memory for the scrollback of all open terminals together.\n"
+               "Above it, the history of tabs not in use is moved to disk;\n"
+               "it is still scrollable and comes back when the tab is used."));
+        form->addRow(tr("Scrollback budget:"), m_scrollbackBudgetSpin);
+    }
+
     outer->addLayout(form);
 
     // Buttons: OK applies + closes, Apply applies without closing, Cancel closes.
@@ -295,6 +379,25 @@ void SettingsDialog::loadFromSettings()
 
     if (m_disableAppLockBtn)
         m_disableAppLockBtn->setEnabled(enabled);
+
+    // Connections
+    if (m_preconnectCheck)
+        m_preconnectCheck->setChecked(s.value("ssh/speculativePreconnect", false).toBool());
+    if (m_keepaliveSpin)
+        m_keepaliveSpin->setValue(s.value("ssh/keepaliveIntervalSec", 15).toInt());
+    if (m_autoReconnectCheck)
+        m_autoReconnectCheck->setChecked(s.value("ssh/autoReconnect", true).toBool());
+    if (m_cipherTuneCheck)
+        m_cipherTuneCheck->setChecked(s.value("ssh/cipherAutoTune", true).toBool());
+
+    // Terminal
+    if (m_predictiveEchoCombo) {
+        const QString echo = s.value("terminal/predictiveEcho", "adaptive").toString();
+        const int idx = m_predictiveEchoCombo->findData(echo);
+        m_predictiveEchoCombo->setCurrentIndex(idx >= 0 ? idx : 0);
+    }
+    if (m_scrollbackBudgetSpin)
+        m_scrollbackBudgetSpin->setValue(s.value("terminal/scrollbackBudgetMB", 256).toInt());
 }
 
 // Write current UI values into QSettings.
@@ -315,6 +418,14 @@ void SettingsDialog::saveToSettings()
     // App lock enabled flag only (hash is written by Set/Disable buttons)
     const bool enabled = (m_appLockCheck && m_appLockCheck->isChecked());
     s.setValue("appLock/enabled", enabled);
+
+    s.setValue("ssh/speculativePreconnect", m_preconnectCheck && m_preconnectCheck->isChecked());
+    s.setValue("ssh/keepaliveIntervalSec", m_keepaliveSpin ? m_keepaliveSpin->value() : 15);
+    s.setValue("ssh/autoReconnect", !m_autoReconnectCheck || m_autoReconnectCheck->isChecked());
+    s.setValue("ssh/cipherAutoTune", !m_cipherTuneCheck || m_cipherTuneCheck->isChecked());
+    s.setValue("terminal/predictiveEcho",
+               m_predictiveEchoCombo ? m_predictiveEchoCombo->currentData().toString() : "adaptive");
+    s.setValue("terminal/scrollbackBudgetMB", m_scrollbackBudgetSpin ? m_scrollbackBudgetSpin->value() : 256);
 }
 
 // OK button handler: apply settings and close dialog.
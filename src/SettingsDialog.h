@@ -10,6 +10,7 @@ class QComboBox;
 class QDialogButtonBox;
 class QLineEdit;
 class QToolButton;
+class QSpinBox;
 
 class SettingsDialog : public QDialog
 {
@@ -61,6 +62,16 @@ private:
     QLabel*      m_appLockStatus = nullptr;
 
     QComboBox* m_languageCombo = nullptr;
+
+    // Connections
+    QCheckBox* m_preconnectCheck = nullptr;
+    QSpinBox*  m_keepaliveSpin = nullptr;
+    QCheckBox* m_autoReconnectCheck = nullptr;
+    QCheckBox* m_cipherTuneCheck = nullptr;
+
+    // Terminal
+    QComboBox* m_predictiveEchoCombo = nullptr;
+    QSpinBox*  m_scrollbackBudgetSpin = nullptr;
     bool applySettings();          // <-- add this
     bool m_restartWarned = false;  // <-- add this
 };
@@ -8,6 +8,8 @@
 #include <QRect>
 
 #include "CpunkTermWidget.h"
+#include "PredictiveEcho.h"
+#include "ScrollbackBudget.h"
 #include "SshProfile.h"   // ✅ use the shared profile header (NOT MainWindow.h)
 #include <QStringList>
 #include "CpunkTermWidget.h"
@@ -106,6 +108,9 @@ CpunkTermWidget* ShellManager::createTerminal(const SshProfile &p, QWidget *pare
     auto *term = new CpunkTermWidget(0, parent);
     applyTerminalProfile(term, p);
 
+    // Widget history is off here (0); the budget still keeps a compressed copy.
+    ScrollbackBudget::instance()->registerTerminal(term, 0);
+
     // Bubble file drop events up to the ShellManager consumer.
     connect(term, &CpunkTermWidget::fileDropped,
             this, &ShellManager::fileDropped);
@@ -154,6 +159,10 @@ void ShellManager::startSshInTerminal(CpunkTermWidget *term, const QString &targ
     term->setArgs(args);
     term->startShellProgram();
 
+    // Speculative local echo (terminal/predictiveEcho); owned by term.
+    if (!term->findChild<PredictiveEcho*>())
+        PredictiveEcho::attach(term);
+
     setActive(term);
 
     // Focus after show/activate (critical for "type without clicking")
@@ -0,0 +1,175 @@
+#include "ShellOutputBuffer.h"
+#include "SshShellWorker.h"
+
+#include <QMutexLocker>
+#include <QTimer>
+
+#include <cstring>
+
+/*
+ * ShellOutputBuffer / ShellOutputPump
+ * -----------------------------------
+ * See header. The ring is a plain circular buffer; a write or read wraps at
+ * most once, so both are at most two memcpy calls under the mutex.
+ */
+
+// ===========================================================================
+// ShellOutputBuffer
+// ===========================================================================
+
+ShellOutputBuffer::ShellOutputBuffer(int capacity)
+    : m_buf(qMax(4096, capacity), Qt::Uninitialized)
+{
+}
+
+int ShellOutputBuffer::write(const char *data, int len, bool *wasEmpty)
+{
+    QMutexLocker lock(&m_mutex);
+
+    if (wasEmpty) *wasEmpty = (m_used == 0);
+    if (!data || len <= 0) return 0;
+
+    const int cap = m_buf.size();
+    const int n = qMin(len, cap - m_used);
+    if (n <= 0) return 0;
+
+    const int tail  = (m_head + m_used) % cap;
+    const int first = qMin(n, cap - tail);
+    char *dst = m_buf.data();
+
+    std::memcpy(dst + tail, data, size_t(first));
+    if (n > first)
+        std::memcpy(dst, data + first, size_t(n - first));
+
+    m_used += n;
+    return n;
+}
+
+int ShellOutputBuffer::read(QByteArray *out, int maxBytes)
+{
+    if (!out || maxBytes <= 0) return 0;
+
+    QMutexLocker lock(&m_mutex);
+
+    const int n = qMin(maxBytes, m_used);
+    if (n <= 0) return 0;
+
+    const int cap   = m_buf.size();
+    const int first = qMin(n, cap - m_head);
+    const char *src = m_buf.constData();
+
+    out->append(src + m_head, first);
+    if (n > first)
+        out->append(src, n - first);
+
+    m_head = (m_head + n) % cap;
+    m_used -= n;
+    if (m_used == 0) m_head = 0;
+    return n;
+}
+
+int ShellOutputBuffer::size() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_used;
+}
+
+int ShellOutputBuffer::freeSpace() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_buf.size() - m_used;
+}
+
+// ===========================================================================
+// ShellOutputPump
+// ===========================================================================
+
+ShellOutputPump::ShellOutputPump(SshShellWorker *worker, QObject *parent)
+    : QObject(parent)
+    , m_worker(worker)
+    , m_ring(worker ? worker->outputBuffer() : nullptr)
+    , m_workerBacked(true)
+{
+    initTimer();
+
+    if (worker) {
+        QPointer<SshShellWorker> w(worker);
+        m_onDrained = [w]() {
+            // Room again: let a paused worker pull the rest from the channel.
+            if (w) w->resumeReading();
+        };
+
+        // Queued: the worker emits from its own thread.
+        connect(worker, &SshShellWorker::outputAvailable,
+                this, &ShellOutputPump::scheduleFrame, Qt::QueuedConnection);
+    }
+}
+
+ShellOutputPump::ShellOutputPump(ShellOutputBuffer *ring,
+                                 std::function<void()> onDrained,
+                                 QObject *parent)
+    : QObject(parent)
+    , m_ring(ring)
+    , m_onDrained(std::move(onDrained))
+{
+    initTimer();
+}
+
+void ShellOutputPump::initTimer()
+{
+    m_frame = new QTimer(this);
+    m_frame->setSingleShot(true);
+    m_frame->setTimerType(Qt::PreciseTimer);
+    m_frame->setInterval(m_frameMs);
+    connect(m_frame, &QTimer::timeout, this, &ShellOutputPump::onFrame);
+}
+
+void ShellOutputPump::setFrameIntervalMs(int ms)
+{
+    m_frameMs = qBound(1, ms, 100);
+    m_frame->setInterval(m_frameMs);
+}
+
+void ShellOutputPump::setMaxBytesPerFrame(int bytes)
+{
+    m_maxPerFrame = qMax(4096, bytes);
+}
+
+/*
+ * scheduleFrame
+ * -------------
+ * First bytes after an idle period: arm the frame timer (if not already).
+ * Everything that arrives until it fires goes out in one outputReady().
+ */
+void ShellOutputPump::scheduleFrame()
+{
+    if (!m_frame->isActive())
+        m_frame->start();
+}
+
+void ShellOutputPump::onFrame()
+{
+    // Worker-backed pump: the ring dies with the worker.
+    if (m_workerBacked && !m_worker)
+        return;
+    if (!m_ring)
+        return;
+
+    // Qt5's resize(0) keeps the allocation only once reserve() has marked
+    // it reserved, and only while the last frame's receivers no longer
+    // share it; reserve() is a no-op in that case and re-reserves otherwise
+    // (first frame, new setMaxBytesPerFrame(), still-shared buffer).
+    m_scratch.resize(0);
+    m_scratch.reserve(m_maxPerFrame);
+    m_ring->read(&m_scratch, m_maxPerFrame);
+
+    if (m_onDrained)
+        m_onDrained();
+
+    if (!m_scratch.isEmpty())
+        emit outputReady(m_scratch);
+
+    // More than one frame's worth queued: continue next frame.
+    if (m_ring->size() > 0)
+        m_frame->start();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QMutex>
+#include <QPointer>
+
+#include <functional>
+
+class QTimer;
+class SshShellWorker;
+
+/**
+ * ShellOutputBuffer
+ *
+ * Purpose:
+ *  Fixed-capacity byte ring between SshShellWorker (producer, worker thread)
+ *  and the terminal view (consumer, UI thread).
+ *
+ * Design:
+ *  - Storage is allocated once; no per-chunk heap allocation
+ *  - write() accepts only what fits: the worker stops taking bytes from the
+ *    SSH channel when the ring is full, which stops the SSH window from
+ *    growing (backpressure reaches the remote side)
+ *  - Thread-safe (one mutex, held only for memcpy-sized work)
+ */
+class ShellOutputBuffer
+{
+public:
+    explicit ShellOutputBuffer(int capacity = 1024 * 1024);
+
+    /**
+     * Copies up to len bytes in. Returns bytes accepted (0 when full).
+     * wasEmpty (optional) tells whether the ring was empty before.
+     */
+    int write(const char *data, int len, bool *wasEmpty = nullptr);
+
+    /**
+     * Appends up to maxBytes to *out (out's capacity is reused).
+     * Returns bytes moved.
+     */
+    int read(QByteArray *out, int maxBytes);
+
+    int size() const;
+    int freeSpace() const;
+    int capacity() const { return m_buf.size(); }
+
+private:
+    mutable QMutex m_mutex;
+    QByteArray     m_buf;
+    int            m_head = 0;   // next read position
+    int            m_used = 0;
+};
+
+/**
+ * ShellOutputPump
+ *
+ * Purpose:
+ *  UI-thread side of ShellOutputBuffer: coalesces everything the worker
+ *  produced into at most one outputReady() per display frame, instead of
+ *  one queued signal per 4 KiB read.
+ *
+ * Behavior:
+ *  - SshShellWorker::outputAvailable() (sent only when the ring goes from
+ *    empty to non-empty) arms a frame timer
+ *  - each frame drains up to maxBytesPerFrame() and emits outputReady()
+ *  - after draining, the worker is told to resume reading if it paused
+ *  - a lagging view therefore slows the remote side instead of growing memory
+ *
+ * The second constructor drives any producer with the same contract
+ * (used by the terminal benchmark, bench/TermBench.cpp).
+ */
+class ShellOutputPump : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ShellOutputPump(SshShellWorker *worker, QObject *parent = nullptr);
+
+    /**
+     * ring:      buffer to drain (must outlive the pump)
+     * onDrained: called on the UI thread after every drain (producer resume)
+     * The producer calls scheduleFrame() when the ring turns non-empty.
+     */
+    ShellOutputPump(ShellOutputBuffer *ring,
+                    std::function<void()> onDrained,
+                    QObject *parent = nullptr);
+
+    void setFrameIntervalMs(int ms);          // default 16 (~60 fps)
+    void setMaxBytesPerFrame(int bytes);      // default 256 KiB
+
+    int frameIntervalMs() const { return m_frameMs; }
+    int maxBytesPerFrame() const { return m_maxPerFrame; }
+
+signals:
+    /**
+     * Coalesced remote output for this frame.
+     */
+    void outputReady(const QByteArray &data);
+
+public slots:
+    /**
+     * Arms the frame timer (no-op if already armed). Connect the producer's
+     * "ring became non-empty" notification here (queued).
+     */
+    void scheduleFrame();
+
+private slots:
+    void onFrame();
+
+private:
+    void initTimer();
+
+    QPointer<SshShellWorker> m_worker;     // set by the worker constructor only
+    ShellOutputBuffer       *m_ring = nullptr;
+    bool                     m_workerBacked = false;
+    std::function<void()>    m_onDrained;
+    QTimer    *m_frame = nullptr;
+    QByteArray m_scratch;           // reused between frames (reserved m_maxPerFrame)
+
+    int m_frameMs     = 16;
+    int m_maxPerFrame = 256 * 1024;
+};
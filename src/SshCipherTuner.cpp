@@ -0,0 +1,374 @@
+// SshCipherTuner.cpp
+//
+// See header for the overall idea. Implementation notes:
+//   - Each cipher is timed the way SSH uses it: one key, a fresh nonce per
+//     packet, 32 KiB packets (SFTP write size), AAD + tag for AEAD modes.
+//   - CTR modes are scored together with the faster SHA-2 HMAC, since an
+//     aes*-ctr session always pays for both.
+//   - Timing runs until ~40 ms per candidate have elapsed, so the whole
+//     benchmark stays well under half a second even on slow CPUs.
+
+#include "SshCipherTuner.h"
+
+#include <QSettings>
+#include <QSysInfo>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+
+#include <libssh/libssh.h>
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/crypto.h>
+
+#include <algorithm>
+
+namespace {
+
+// Bump when the benchmark or allowlist changes so cached orders are redone.
+constexpr int kBenchRevision = 1;
+
+constexpr int    kPacketBytes = 32 * 1024;
+constexpr qint64 kMinNs       = 40LL * 1000 * 1000;
+constexpr int    kMinPackets  = 8;
+
+// Security allowlist (SSH names). Default order = libssh's own preference,
+// used as the tie-breaker and for entries the benchmark could not time.
+const char* const kCipherAllowlist[] = {
+    "chacha20-poly1305@openssh.com",
+    "aes256-gcm@openssh.com",
+    "aes128-gcm@openssh.com",
+    "aes256-ctr",
+    "aes192-ctr",
+    "aes128-ctr",
+};
+
+const char* const kMacAllowlist[] = {
+    "hmac-sha2-256-etm@openssh.com",
+    "hmac-sha2-512-etm@openssh.com",
+};
+
+// Non-ETM fallbacks, offered last for servers without the ETM variants.
+const char* const kMacFallbacks[] = {
+    "hmac-sha2-256",
+    "hmac-sha2-512",
+};
+
+const EVP_CIPHER* evpFor(const QString& sshName)
+{
+    if (sshName == "aes256-gcm@openssh.com") return EVP_aes_256_gcm();
+    if (sshName == "aes128-gcm@openssh.com") return EVP_aes_128_gcm();
+    if (sshName == "aes256-ctr")             return EVP_aes_256_ctr();
+    if (sshName == "aes192-ctr")             return EVP_aes_192_ctr();
+    if (sshName == "aes128-ctr")             return EVP_aes_128_ctr();
+#if !defined(OPENSSL_NO_CHACHA) && !defined(OPENSSL_NO_POLY1305)
+    if (sshName == "chacha20-poly1305@openssh.com") return EVP_chacha20_poly1305();
+#endif
+    return nullptr;
+}
+
+double toMibPerSec(qint64 bytes, qint64 ns)
+{
+    if (ns <= 0) return 0.0;
+    return (double(bytes) / (1024.0 * 1024.0)) / (double(ns) / 1e9);
+}
+
+// Encrypt kPacketBytes packets until kMinNs elapsed. 0 on any EVP failure.
+double timeCipher(const EVP_CIPHER* cipher, bool aead)
+{
+    if (!cipher) return 0.0;
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) return 0.0;
+
+    QByteArray in(kPacketBytes, '\x5a');
+    QByteArray out(kPacketBytes + 64, '\0');
+    unsigned char key[64] = {0};
+    unsigned char iv[16]  = {0};
+    unsigned char aad[4]  = {0, 0, 0x80, 0};
+    unsigned char tag[16];
+
+    auto* outp = reinterpret_cast<unsigned char*>(out.data());
+    const auto* inp = reinterpret_cast<const unsigned char*>(in.constData());
+
+    bool ok = EVP_EncryptInit_ex(ctx, cipher, nullptr, key, iv) == 1;
+
+    QElapsedTimer t;
+    t.start();
+    qint64 bytes = 0;
+    int packets = 0;
+
+    while (ok && (packets < kMinPackets || t.nsecsElapsed() < kMinNs)) {
+        int outl = 0;
+        if (aead) {
+            // New nonce per packet, as the SSH transport does.
+            iv[11] = static_cast<unsigned char>(packets);
+            ok = EVP_EncryptInit_ex(ctx, nullptr, nullptr, nullptr, iv) == 1
+              && EVP_EncryptUpdate(ctx, nullptr, &outl, aad, sizeof(aad)) == 1;
+        }
+        ok = ok && EVP_EncryptUpdate(ctx, outp, &outl, inp, kPacketBytes) == 1;
+        if (aead) {
+            int finl = 0;
+            ok = ok && EVP_EncryptFinal_ex(ctx, outp + outl, &finl) == 1
+                    && EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, sizeof(tag), tag) == 1;
+        }
+        bytes += kPacketBytes;
+        ++packets;
+    }
+
+    const qint64 ns = t.nsecsElapsed();
+    EVP_CIPHER_CTX_free(ctx);
+    return ok ? toMibPerSec(bytes, ns) : 0.0;
+}
+
+double timeHmac(const EVP_MD* md)
+{
+    if (!md) return 0.0;
+
+    QByteArray in(kPacketBytes, '\x5a');
+    unsigned char key[64] = {0};
+    unsigned char mac[EVP_MAX_MD_SIZE];
+
+    QElapsedTimer t;
+    t.start();
+    qint64 bytes = 0;
+    int packets = 0;
+
+    while (packets < kMinPackets || t.nsecsElapsed() < kMinNs) {
+        unsigned int macLen = 0;
+        if (!HMAC(md, key, EVP_MD_size(md),
+                  reinterpret_cast<const unsigned char*>(in.constData()), size_t(kPacketBytes),
+                  mac, &macLen))
+            return 0.0;
+        bytes += kPacketBytes;
+        ++packets;
+    }
+    return toMibPerSec(bytes, t.nsecsElapsed());
+}
+
+QString cpuModel()
+{
+    QFile f(QStringLiteral("/proc/cpuinfo"));
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QString();
+
+    // x86: "model name"; ARM: "Hardware" / "CPU part" (no model name on many kernels).
+    QString hw, part;
+    while (!f.atEnd()) {
+        const QString line = QString::fromUtf8(f.readLine());
+        const int colon = line.indexOf(':');
+        if (colon < 0) continue;
+        const QString k = line.left(colon).trimmed();
+        const QString v = line.mid(colon + 1).trimmed();
+        if (k == "model name") return v;
+        if (k == "Hardware" && hw.isEmpty()) hw = v;
+        if (k == "CPU part" && part.isEmpty()) part = v;
+    }
+    return hw.isEmpty() ? part : hw;
+}
+
+// Order `allow` by score (desc), keeping allowlist order for ties/unknowns.
+QStringList orderByScore(const QStringList& allow, const QVector<SshCipherTuner::Result>& results)
+{
+    QStringList out = allow;
+    auto score = [&](const QString& n) {
+        for (const auto& r : results)
+            if (r.name == n) return r.mibPerSec;
+        return 0.0;
+    };
+    std::stable_sort(out.begin(), out.end(), [&](const QString& a, const QString& b) {
+        return score(a) > score(b);
+    });
+    return out;
+}
+
+QStringList toList(const char* const* names, int n)
+{
+    QStringList out;
+    for (int i = 0; i < n; ++i) out << QString::fromLatin1(names[i]);
+    return out;
+}
+
+QStringList cipherAllowlist()
+{
+    return toList(kCipherAllowlist, int(sizeof(kCipherAllowlist) / sizeof(kCipherAllowlist[0])));
+}
+
+QStringList macAllowlist()
+{
+    return toList(kMacAllowlist, int(sizeof(kMacAllowlist) / sizeof(kMacAllowlist[0])));
+}
+
+// Keep only allowlisted names from a cached string (hand-edited config etc.).
+QStringList filtered(const QString& cached, const QStringList& allow)
+{
+    QStringList out;
+    for (const QString& n : cached.split(',', Qt::SkipEmptyParts)) {
+        const QString t = n.trimmed();
+        if (allow.contains(t) && !out.contains(t)) out << t;
+    }
+    // Never offer less than the allowlist: anything missing goes last.
+    for (const QString& n : allow)
+        if (!out.contains(n)) out << n;
+    return out;
+}
+
+QMutex g_benchMutex;
+
+} // namespace
+
+// ------------------------------------------------------------
+// isEnabled()
+// ------------------------------------------------------------
+bool SshCipherTuner::isEnabled()
+{
+    return QSettings().value("ssh/cipherAutoTune", true).toBool();
+}
+
+// ------------------------------------------------------------
+// fingerprint()
+// ------------------------------------------------------------
+// What the cached order depends on. Computed once per process.
+QString SshCipherTuner::fingerprint()
+{
+    static const QString fp = QString("r%1|%2|%3|%4|libssh %5")
+                                  .arg(kBenchRevision)
+                                  .arg(QSysInfo::currentCpuArchitecture(),
+                                       cpuModel(),
+                                       QString::fromLatin1(OpenSSL_version(OPENSSL_VERSION)),
+                                       QString::fromLatin1(ssh_version(0)));
+    return fp;
+}
+
+// ------------------------------------------------------------
+// runCipherBenchmark() / runMacBenchmark()
+// ------------------------------------------------------------
+QVector<SshCipherTuner::Result> SshCipherTuner::runMacBenchmark()
+{
+    QVector<Result> out;
+    out.push_back({ QStringLiteral("hmac-sha2-256-etm@openssh.com"), timeHmac(EVP_sha256()) });
+    out.push_back({ QStringLiteral("hmac-sha2-512-etm@openssh.com"), timeHmac(EVP_sha512()) });
+    return out;
+}
+
+QVector<SshCipherTuner::Result> SshCipherTuner::runCipherBenchmark(const QVector<Result>& macs)
+{
+    double bestMac = 0.0;
+    for (const auto& m : macs) bestMac = qMax(bestMac, m.mibPerSec);
+
+    QVector<Result> out;
+    for (const QString& name : cipherAllowlist()) {
+        const bool aead = !name.endsWith("-ctr");
+        double rate = timeCipher(evpFor(name), aead);
+
+        // CTR pays for encryption and the MAC over the same bytes.
+        if (!aead && rate > 0.0 && bestMac > 0.0)
+            rate = 1.0 / (1.0 / rate + 1.0 / bestMac);
+
+        out.push_back({ name, rate });
+    }
+    return out;
+}
+
+// ------------------------------------------------------------
+// ensureBenchmarked()
+// ------------------------------------------------------------
+void SshCipherTuner::ensureBenchmarked()
+{
+    if (!isEnabled()) return;
+
+    // Two callers racing at startup: the second just finds a fresh cache.
+    QMutexLocker lock(&g_benchMutex);
+
+    QSettings s;
+    const QString fp = fingerprint();
+    if (s.value("ssh/cipherBench/fingerprint").toString() == fp &&
+        !s.value("ssh/cipherBench/ciphers").toString().isEmpty())
+        return;
+
+    QElapsedTimer t;
+    t.start();
+
+    const QVector<Result> macs    = runMacBenchmark();
+    const QVector<Result> ciphers = runCipherBenchmark(macs);
+
+    const QStringList cipherOrder = orderByScore(cipherAllowlist(), ciphers);
+    const QStringList macOrder    = orderByScore(macAllowlist(), macs);
+
+    QStringList results;
+    for (const auto& r : ciphers + macs)
+        results << QString("%1=%2").arg(r.name).arg(r.mibPerSec, 0, 'f', 1);
+
+    s.setValue("ssh/cipherBench/fingerprint", fp);
+    s.setValue("ssh/cipherBench/ciphers", cipherOrder.join(','));
+    s.setValue("ssh/cipherBench/macs", macOrder.join(','));
+    s.setValue("ssh/cipherBench/results", results);
+
+    qInfo().noquote() << QString("[CIPHER] benchmark done in %1 ms: %2")
+                         .arg(t.elapsed())
+                         .arg(results.join(", "));
+    qInfo().noquote() << QString("[CIPHER] order: %1 | mac: %2")
+                         .arg(cipherOrder.join(','), macOrder.join(','));
+}
+
+void SshCipherTuner::startBackgroundBenchmark()
+{
+    if (!isEnabled()) return;
+    QtConcurrent::run([]() { SshCipherTuner::ensureBenchmarked(); });
+}
+
+// ------------------------------------------------------------
+// preferredCiphers() / preferredMacs()
+// ------------------------------------------------------------
+QString SshCipherTuner::preferredCiphers()
+{
+    if (!isEnabled()) return QString();
+
+    QSettings s;
+    if (s.value("ssh/cipherBench/fingerprint").toString() != fingerprint())
+        return QString();
+
+    const QString cached = s.value("ssh/cipherBench/ciphers").toString();
+    if (cached.isEmpty()) return QString();
+
+    return filtered(cached, cipherAllowlist()).join(',');
+}
+
+QString SshCipherTuner::preferredMacs()
+{
+    if (!isEnabled()) return QString();
+
+    QSettings s;
+    if (s.value("ssh/cipherBench/fingerprint").toString() != fingerprint())
+        return QString();
+
+    const QString cached = s.value("ssh/cipherBench/macs").toString();
+    if (cached.isEmpty()) return QString();
+
+    QStringList out = filtered(cached, macAllowlist());
+    out << toList(kMacFallbacks, int(sizeof(kMacFallbacks) / sizeof(kMacFallbacks[0])));
+    return out.join(',');
+}
+
+// ------------------------------------------------------------
+// cachedResults()
+// ------------------------------------------------------------
+QVector<SshCipherTuner::Result> SshCipherTuner::cachedResults()
+{
+    QVector<Result> out;
+    const QStringList raw = QSettings().value("ssh/cipherBench/results").toStringList();
+    for (const QString& e : raw) {
+        const int eq = e.lastIndexOf('=');
+        if (eq <= 0) continue;
+        out.push_back({ e.left(eq), e.mid(eq + 1).toDouble() });
+    }
+    std::stable_sort(out.begin(), out.end(), [](const Result& a, const Result& b) {
+        return a.mibPerSec > b.mibPerSec;
+    });
+    return out;
+}
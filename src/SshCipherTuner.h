@@ -0,0 +1,63 @@
+// SshCipherTuner.h
+//
+// Purpose:
+//   Pick the cipher/MAC order for libssh sessions (SFTP, exec, Fleet) by what
+//   is actually fastest on this CPU. libssh's default order is fixed, but the
+//   fastest safe cipher is not: with AES-NI/PMULL aes*-gcm wins by a wide
+//   margin, without it chacha20-poly1305 does.
+//
+// How:
+//   - A short microbenchmark (~0.3 s total) encrypts SSH-packet-sized buffers
+//     with every allowlisted cipher (and both SHA-2 HMACs for the CTR modes).
+//   - The resulting order is cached in QSettings ("ssh/cipherBench/...")
+//     together with a fingerprint of CPU model, OpenSSL and libssh versions;
+//     the benchmark only runs again when that fingerprint changes.
+//   - SshClient::connectTransport() sets SSH_OPTIONS_CIPHERS_C_S/S_C and
+//     SSH_OPTIONS_HMAC_C_S/S_C from the cached order.
+//
+// Security allowlist:
+//   Only AEAD ciphers and AES-CTR with SHA-2 MACs are ever offered. CBC, 3DES,
+//   arcfour, hmac-sha1 and hmac-md5 are never added, whatever the benchmark
+//   says. Without a cached result nothing is set and libssh keeps its defaults.
+//
+// Notes:
+//   - The benchmark uses OpenSSL EVP, which is also libssh's usual crypto
+//     backend; with a libgcrypt/mbedTLS libssh the order is still a good hint.
+//   - The interactive terminal (OpenSSH) is not affected.
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+class SshCipherTuner
+{
+public:
+    struct Result {
+        QString name;              // SSH algorithm name, e.g. "aes256-gcm@openssh.com"
+        double  mibPerSec = 0.0;   // 0 = not available in this OpenSSL build
+    };
+
+    // ssh/cipherAutoTune (default on). Off = libssh default order.
+    static bool isEnabled();
+
+    // Run the benchmark if the cache is missing or stale. Blocking (a few
+    // hundred ms of CPU); call from a worker thread.
+    static void ensureBenchmarked();
+
+    // Fire-and-forget ensureBenchmarked() on the thread pool (app startup).
+    static void startBackgroundBenchmark();
+
+    // Comma-separated lists for libssh, fastest first. Empty when tuning is
+    // off or no benchmark result is cached yet (caller keeps libssh defaults).
+    static QString preferredCiphers();
+    static QString preferredMacs();
+
+    // Last cached benchmark (for logs / diagnostics), fastest first.
+    static QVector<Result> cachedResults();
+
+private:
+    static QString fingerprint();
+    static QVector<Result> runMacBenchmark();
+    static QVector<Result> runCipherBenchmark(const QVector<Result>& macs);
+};
@@ -4,7 +4,9 @@
 //   Central SSH/SFTP utility layer for pq-ssh.
 //   - Creates and owns a libssh session (for SFTP + small exec helpers)
 //   - Authenticates with agent/public key (OpenSSH-compatible today)
-//   - Provides SFTP upload/download helpers (streaming, cancelable, safe temp + replace)
+//   - Provides SFTP upload/download helpers (streaming, cancelable, safe temp + replace,
+//     resumable from a leftover .pqssh.part after a dropped link)
+//   - Link health helpers (keepalive probe, stall detection) for SshLinkMonitor
 //   - Provides SFTP directory listing/stat helpers (file manager UI)
 //   - Implements idempotent authorized_keys installation (with backups)
 //
@@ -17,6 +19,11 @@
 //     is stored as a member (m_cb) and not as a local/static variable.
 
 #include "SshClient.h"
+#include "SshJumpHost.h"
+#include "SshCipherTuner.h"
+#include "SshTcpConnect.h"
+#include "SshExecCapture.h"
+#include "SshSessionSetup.h"
 
 #include <QFile>
 #include <QFileInfo>
@@ -27,6 +34,9 @@
 #include <QCryptographicHash>
 #include <QElapsedTimer>
 #include <QObject>
+#include <QSettings>
+#include <QStringList>
+#include <QRandomGenerator>
 
 #include <libssh/libssh.h>
 #include <libssh/sftp.h>
@@ -34,6 +44,9 @@
 
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/socket.h>  // shutdown() in abortLink()
+#include <unistd.h>      // close()
+#include <cerrno>
 
 #include <sodium.h>
 #include <cstring>   // memset, memcpy
@@ -77,6 +90,64 @@ static bool openSftp(ssh_session session, sftp_session *out, QString *err)
     return true;
 }
 
+// ------------------------------------------------------------
+// Resume stamps (<dest>.pqssh.part.src)
+// ------------------------------------------------------------
+// A .pqssh.part is only resumed when the stamp next to it still names the
+// same source (size + mtime). Without it a part left by a transfer of an
+// older version of the file would be continued and spliced.
+static QByteArray resumeStamp(quint64 size, qint64 mtime)
+{
+    return QByteArray("pqssh-resume 1 ") + QByteArray::number(size) + ' '
+           + QByteArray::number(mtime) + '\n';
+}
+
+// Small remote file -> bytes (at most 256). Empty when missing/unreadable.
+static QByteArray readRemoteStamp(sftp_session sftp, const QString& path)
+{
+    sftp_file f = sftp_open(sftp, path.toUtf8().constData(), O_RDONLY, 0);
+    if (!f) return {};
+    QByteArray buf(256, Qt::Uninitialized);
+    const ssize_t n = sftp_read(f, buf.data(), buf.size());
+    sftp_close(f);
+    return n > 0 ? buf.left(int(n)) : QByteArray();
+}
+
+static bool writeRemoteStamp(sftp_session sftp, const QString& path, const QByteArray& stamp)
+{
+    sftp_file f = sftp_open(sftp, path.toUtf8().constData(),
+                            O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (!f) return false;
+    const bool ok = sftp_write(f, stamp.constData(), size_t(stamp.size())) == ssize_t(stamp.size());
+    sftp_close(f);
+    return ok;
+}
+
+// ------------------------------------------------------------
+// SshClient::IoScope
+// ------------------------------------------------------------
+// Held for the duration of any operation that uses m_session.
+// Serialises libssh access and marks the client busy so probeAlive()
+// stays off the wire; the activity clock starts when the operation does.
+class SshClient::IoScope
+{
+public:
+    explicit IoScope(const SshClient* c) : m_c(c)
+    {
+        m_c->m_ioMutex.lock();
+        m_c->m_ioDepth.fetch_add(1);
+        m_c->touchActivity();
+    }
+    ~IoScope()
+    {
+        m_c->m_ioDepth.fetch_sub(1);
+        m_c->m_ioMutex.unlock();
+    }
+
+private:
+    const SshClient* m_c;
+};
+
 SshClient::SshClient(QObject *parent) : QObject(parent) {}
 
 SshClient::~SshClient()
@@ -168,12 +239,35 @@ QString SshClient::requestPassphrase(const QString& keyFile, bool *ok)
 //
 // Notes:
 // - This does NOT provide an interactive terminal (OpenSSH+qtermwidget does that).
-// - Tries agent first, then publickey_auto.
+// - Runs connectTransport() (DNS + TCP + KEX) followed by authenticate().
+// - Callers that pre-connect speculatively run the two phases separately.
+bool SshClient::connectProfile(const SshProfile& profile, QString* err)
+{
+    // One lock across both phases: nothing may use the session in between.
+    IoScope io(this);
+    if (!connectTransport(profile, err))
+        return false;
+    return authenticate(err);
+}
+
+// ------------------------------------------------------------
+// connectTransport()
+// ------------------------------------------------------------
+// Phase 1 of connectProfile(): create the libssh session, apply options,
+// resolve + TCP connect (SshTcpConnect) and run ssh_connect() (key exchange).
+// Each step is timed; see lastConnectTimings().
+//
+// On success the session is kept in m_session but is NOT authenticated yet:
+// isConnected() stays false until authenticate() succeeds.
+//
+// Notes:
 // - Optionally sets a preferred KEX list to favor hybrid PQ where supported.
 // - Passphrase callback must outlive the session -> stored in member m_cb (see header).
-bool SshClient::connectProfile(const SshProfile& profile, QString* err)
+bool SshClient::connectTransport(const SshProfile& profile, QString* err)
 {
+    IoScope io(this);
     if (err) err->clear();
+    m_connectFailure = ConnectFailure{ConnectFailure::Phase::Config, 0};
 
     const QString host = profile.host.trimmed();
     const QString user = profile.user.trimmed();
@@ -217,6 +311,7 @@ bool SshClient::connectProfile(const SshProfile& profile, QString* err)
         qInfo().noquote() << "[SSH] existing session present -> disconnecting before reconnect";
     }
     disconnect();
+    m_connectTimings = ConnectTimings();
 
     ssh_session s = ssh_new();
     if (!s) {
@@ -232,6 +327,7 @@ bool SshClient::connectProfile(const SshProfile& profile, QString* err)
         qWarning().noquote() << QString("[SSH] connectProfile FAILED user='%1' host='%2': %3")
                                 .arg(user, host, msg);
         ssh_free(s);
+        m_jump.reset();
         return false;
     };
 
@@ -287,6 +383,59 @@ bool SshClient::connectProfile(const SshProfile& profile, QString* err)
 #endif
     }
 
+    // Jump hosts: ride a direct-tcpip channel of a shared bastion session
+    // instead of connecting directly (host/port above still name the target,
+    // for host key checks and logging).
+    if (!parseProxyJump(profile.proxyJump).isEmpty()) {
+        QSharedPointer<SshJumpHost> jump;
+        int tunnelFd = -1;
+        QString jerr;
+        QElapsedTimer tunnelTimer;
+        tunnelTimer.start();
+        if (!SshJumpHost::openTunnelFor(profile, m_passphraseProvider, &jump, &tunnelFd, &jerr)) {
+            m_connectFailure.phase = ConnectFailure::Phase::Tunnel;
+            return failAndFree(jerr);
+        }
+        m_connectTimings.tcpMs = tunnelTimer.elapsed();
+
+        socket_t fd = tunnelFd;
+        if (!optSet(SSH_OPTIONS_FD, &fd, "FD")) {
+            ::close(tunnelFd);
+            return failAndFree(tr("Failed to attach jump host tunnel."));
+        }
+
+        qInfo().noquote() << QString("[SSH] connecting via jump host chain '%1'").arg(jump->key());
+        m_jump = jump;
+    } else {
+        // Resolve + TCP connect here rather than inside ssh_connect(), so
+        // DNS, TCP and key exchange are timed separately (same 8 s budget).
+        // ~/.ssh/config decides where to connect (Hostname, Port); a proxy
+        // there leaves the whole connect to ssh_connect().
+        QString connectHost = host;
+        int connectPort = port;
+        if (SshTcpConnect::configuredTarget(s, &connectHost, &connectPort)) {
+            QString terr;
+            SshTcpConnect::Failure why;
+            const int fd = SshTcpConnect::connectBlocking(connectHost, connectPort, 8 * 1000,
+                                                          &m_connectTimings.dnsMs,
+                                                          &m_connectTimings.tcpMs, &terr, &why);
+            if (fd < 0) {
+                m_connectFailure = ConnectFailure{why.dns ? ConnectFailure::Phase::Resolve
+                                                          : ConnectFailure::Phase::Connect,
+                                                  why.code};
+                return failAndFree(tr("ssh_connect failed: %1").arg(terr));
+            }
+
+            socket_t sfd = fd;
+            if (!optSet(SSH_OPTIONS_FD, &sfd, "FD")) {
+                ::close(fd);
+                return failAndFree(tr("Failed to attach socket."));
+            }
+        } else {
+            qInfo().noquote() << QString("[SSH] ssh config sets a proxy for '%1'; libssh connects").arg(host);
+        }
+    }
+
     // Optional explicit key identity file
     if (hasIdentity) {
         const QByteArray p = QFile::encodeName(profile.keyFile.trimmed());
@@ -294,65 +443,28 @@ bool SshClient::connectProfile(const SshProfile& profile, QString* err)
             return failAndFree(tr("Failed to set SSH identity file."));
     }
 
-    // --- Prefer PQ hybrid KEX when available (libssh 0.11.x+) ---
-    // Must be set BEFORE ssh_connect(). Best-effort (older libssh may reject).
-    const char *kexPref =
-        "sntrup761x25519-sha512@openssh.com,"
-        "curve25519-sha256";
-
-    const int kexRc = ssh_options_set(s, SSH_OPTIONS_KEY_EXCHANGE, kexPref);
-    if (kexRc == SSH_OK) {
-        qInfo().noquote() << QString("[SSH] KEX preference set: %1").arg(kexPref);
-    } else {
-        qInfo().noquote() << QString("[SSH] KEX preference not applied: %1").arg(libsshError(s));
-    }
+    // KEX (hybrid PQ first), cipher and MAC order; shared with the fleet
+    // event engine.
+    SshSessionSetup::applyAlgorithms(s, true);
 
     // Passphrase callback (UI supplies passphrase)
     // IMPORTANT: callbacks must outlive the session -> store in member m_cb.
-    std::memset(&m_cb, 0, sizeof(m_cb));
-#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0,9,0)
-    ssh_callbacks_init(&m_cb);
-#endif
-    m_cb.userdata = this;
-
-    m_cb.auth_function = [](const char *prompt,
-                            char *buf,
-                            size_t len,
-                            int echo,
-                            int verify,
-                            void *userdata) -> int
-    {
-        Q_UNUSED(prompt);
-        Q_UNUSED(echo);
-        Q_UNUSED(verify);
-
-        auto *self = static_cast<SshClient*>(userdata);
-        if (!self) return SSH_AUTH_DENIED;
-        if (!self->m_passphraseProvider) return SSH_AUTH_DENIED;
-        if (len == 0) return SSH_AUTH_DENIED;
-
-        bool ok = false;
-        // NOTE: key path is unknown here; pass empty (UI may show generic prompt)
-        const QString pass = self->m_passphraseProvider(QString(), &ok);
-        if (!ok) return SSH_AUTH_DENIED;
-
-        const QByteArray utf8 = pass.toUtf8();
-        const size_t n = std::min(len - 1, static_cast<size_t>(utf8.size()));
-        std::memcpy(buf, utf8.constData(), n);
-        buf[n] = '\0';
-        return SSH_AUTH_SUCCESS;
-    };
-
-    ssh_set_callbacks(s, &m_cb);
+    installCallbacks(s);
 
-    // Network connect
+    // Banner + key exchange (the socket is already connected)
+    QElapsedTimer kexTimer;
+    kexTimer.start();
     int rc = ssh_connect(s);
+    m_connectTimings.kexMs = kexTimer.elapsed();
     if (rc != SSH_OK) {
         const QString e = libsshError(s);
+        m_connectFailure = ConnectFailure{ConnectFailure::Phase::Kex, ssh_get_error_code(s)};
         return failAndFree(tr("ssh_connect failed: %1").arg(e));
     }
 
-    qInfo().noquote() << QString("[SSH] ssh_connect OK host='%1' port=%2").arg(host).arg(port);
+    qInfo().noquote() << QString("[SSH] ssh_connect OK host='%1' port=%2 dns=%3 ms tcp=%4 ms kex=%5 ms")
+                         .arg(host).arg(port)
+                         .arg(m_connectTimings.dnsMs).arg(m_connectTimings.tcpMs).arg(m_connectTimings.kexMs);
 
     // Negotiated algorithms (now valid post-connect)
     const char *kexAlgoC    = ssh_get_kex_algo(s);
@@ -367,70 +479,317 @@ bool SshClient::connectProfile(const SshProfile& profile, QString* err)
                               cipherInC ? cipherInC : "?",
                               cipherOutC ? cipherOutC : "?");
 
+    // Transport is up; authentication is still pending.
+    m_session       = s;
+    m_authenticated = false;
+    m_user          = user;
+    m_host          = host;
+    m_port          = port;
+    m_kexPretty     = pretty;
+    m_kexRaw        = rawKex;
+    m_profileKey    = SshSessionSetup::authProfileKey(profile);
+    m_connectFailure = ConnectFailure();
+
     // Inform UI about negotiated key exchange algorithm
     emit kexNegotiated(pretty, rawKex);
 
-    // Authentication strategy:
-    // 1) agent (ssh-agent)
-    // 2) publickey_auto (auto-discover keys)
-    rc = ssh_userauth_agent(s, nullptr);
-    if (rc == SSH_AUTH_SUCCESS) {
-        qInfo().noquote() << QString("[SSH] auth OK via agent user='%1' host='%2'").arg(user, host);
-    }
+    return true;
+}
 
-    if (rc != SSH_AUTH_SUCCESS) {
-        qInfo().noquote() << QString("[SSH] auth via agent failed -> trying publickey_auto user='%1' host='%2'")
-                             .arg(user, host);
+// ------------------------------------------------------------
+// authenticate()
+// ------------------------------------------------------------
+// Phase 2 of connectProfile(): authenticate the session opened by
+// connectTransport(). On failure the session is torn down.
+//
+// Authentication strategy (SshSessionSetup::Authenticator): the method that
+// worked last time, then the agent, then publickey_auto.
+//
+// Every attempt is timed; see lastAuthAttempts()/lastAuthSummary().
+bool SshClient::authenticate(QString* err)
+{
+    IoScope io(this);
+    if (err) err->clear();
+    m_authAttempts.clear();
 
-        rc = ssh_userauth_publickey_auto(s, nullptr, nullptr);
-        if (rc == SSH_AUTH_SUCCESS) {
-            qInfo().noquote() << QString("[SSH] auth OK via publickey_auto user='%1' host='%2'").arg(user, host);
-        }
+    if (!m_session) {
+        if (err) *err = tr("Not connected.");
+        m_connectFailure = ConnectFailure{ConnectFailure::Phase::Config, 0};
+        return false;
     }
+    if (m_authenticated)
+        return true;
+
+    ssh_session s = m_session;
+    const QString user = m_user;
+    const QString host = m_host;
+
+    QElapsedTimer authTimer;
+    authTimer.start();
+
+    // Strategy and auth method cache: see SshSessionSetup::Authenticator
+    // (shared with the fleet event engine).
+    SshSessionSetup::Authenticator auth(s, m_profileKey,
+                                        QString("user='%1' host='%2'").arg(user, host), &m_cb);
+    int rc;
+    do {
+        rc = auth.step();   // blocking session: SSH_AUTH_AGAIN is not expected
+    } while (rc == SSH_AUTH_AGAIN);
+    m_authAttempts = auth.attempts();
+
+    m_connectTimings.authMs = authTimer.elapsed();
+    qInfo().noquote() << QString("[SSH] auth timing user='%1' host='%2': %3")
+                         .arg(user, host, lastAuthSummary());
 
     if (rc != SSH_AUTH_SUCCESS) {
         const QString e = libsshError(s);
         if (err) *err = tr("Public-key auth failed: %1").arg(e);
+        m_connectFailure = ConnectFailure{ConnectFailure::Phase::Auth, ssh_get_error_code(s)};
 
         qWarning().noquote() << QString("[SSH] auth FAILED user='%1' host='%2' err='%3'")
                                 .arg(user, host, e);
 
-        ssh_disconnect(s);
-        ssh_free(s);
+        disconnect();
         return false;
     }
 
     // Success: keep session
-    m_session = s;
+    m_authenticated = true;
 
     qInfo().noquote() << QString("[SSH] connectProfile OK user='%1' host='%2' port=%3")
                          .arg(user, host)
-                         .arg(port);
+                         .arg(m_port);
+
+    return true;
+}
+
+// ------------------------------------------------------------
+// lastAuthSummary()
+// ------------------------------------------------------------
+// One-line, log-safe summary of the last authenticate() run, e.g.
+//   "publickey=OK 41 ms" or "agent=DENIED 612 ms, publickey_auto=OK 88 ms".
+// Never contains key paths.
+QString SshClient::lastAuthSummary() const
+{
+    auto rcText = [](int rc) -> QString {
+        switch (rc) {
+            case SSH_AUTH_SUCCESS: return QStringLiteral("OK");
+            case SSH_AUTH_DENIED:  return QStringLiteral("DENIED");
+            case SSH_AUTH_PARTIAL: return QStringLiteral("PARTIAL");
+            case SSH_AUTH_AGAIN:   return QStringLiteral("AGAIN");
+            default:               return QStringLiteral("ERROR");
+        }
+    };
+
+    QStringList parts;
+    for (const AuthAttempt& a : m_authAttempts)
+        parts << QString("%1=%2 %3 ms").arg(a.method, rcText(a.rc)).arg(a.ms);
+    return parts.isEmpty() ? QStringLiteral("(none)") : parts.join(", ");
+}
+
+// ------------------------------------------------------------
+// adoptSession()
+// ------------------------------------------------------------
+// Take over the libssh session held by another client (typically a speculative
+// pre-connect). Any session currently held by this client is closed first.
+// The callbacks are re-registered so libssh calls back into *this* client
+// (passphrase provider) from now on. Re-emits kexNegotiated() for the UI.
+bool SshClient::adoptSession(SshClient& other)
+{
+    if (&other == this)
+        return false;
 
+    // Both sessions change hands: hold both I/O locks.
+    IoScope io(this);
+    IoScope otherIo(&other);
+
+    if (!other.m_session)
+        return false;
+
+    // The server may have dropped an idle, unauthenticated transport.
+    if (!ssh_is_connected(other.m_session)) {
+        qInfo().noquote() << "[SSH] adoptSession: pre-connected session is no longer alive";
+        other.disconnect();
+        return false;
+    }
+
+    disconnect();
+
+    m_session       = other.m_session;
+    m_authenticated = other.m_authenticated;
+    m_user          = other.m_user;
+    m_host          = other.m_host;
+    m_port          = other.m_port;
+    m_kexPretty     = other.m_kexPretty;
+    m_kexRaw        = other.m_kexRaw;
+    m_profileKey    = other.m_profileKey;
+    m_connectTimings = other.m_connectTimings;
+    m_connectFailure = ConnectFailure();
+    m_jump          = other.m_jump;
+
+    other.m_jump.reset();
+    other.m_session       = nullptr;
+    other.m_authenticated = false;
+
+    installCallbacks(m_session);
+
+    qInfo().noquote() << QString("[SSH] adopted pre-connected session user='%1' host='%2' port=%3%4")
+                         .arg(m_user, m_host)
+                         .arg(m_port)
+                         .arg(m_authenticated ? "" : " (auth pending)");
+
+    emit kexNegotiated(m_kexPretty, m_kexRaw);
     return true;
 }
 
+// ------------------------------------------------------------
+// installCallbacks()
+// ------------------------------------------------------------
+// (Re)build m_cb for this client and register it on session s.
+// libssh keeps a pointer to the struct, so it must be a member.
+void SshClient::installCallbacks(ssh_session s)
+{
+    SshSessionSetup::installPassphraseCallback(s, &m_cb, &m_passphraseProvider);
+}
+
 // ------------------------------------------------------------
 // disconnect()
 // ------------------------------------------------------------
 // Disconnect and free current session. Safe to call multiple times.
+// An operation still running on another thread holds the session: it is
+// cancelled and its socket shut down (see abortLink()) so it fails fast, and
+// the session is freed once it has let go.
 void SshClient::disconnect()
 {
+    const bool idle = m_ioMutex.tryLock();
+    if (!idle) {
+        m_cancelRequested.store(true);
+        abortLink(QStringLiteral("disconnect requested"));
+    }
+    IoScope io(this);
+    if (idle) m_ioMutex.unlock(); // recursive: io keeps it held
+
     if (m_session) {
         qInfo().noquote() << "[SSH] disconnect (ssh_disconnect + free)";
         ssh_disconnect(m_session);
         ssh_free(m_session);
         m_session = nullptr;
     }
+    m_authenticated = false;
+    m_linkLost.store(false);
+
+    // Our tunnel fd was closed by ssh_free(); release the shared bastion.
+    m_jump.reset();
 }
 
 // ------------------------------------------------------------
 // isConnected()
 // ------------------------------------------------------------
-// Returns true if a live libssh session is currently held by this client.
+// Returns true if a live, authenticated libssh session is held by this client.
+// A session that only finished connectTransport() does not count.
 bool SshClient::isConnected() const
 {
-    return m_session != nullptr;
+    return m_session != nullptr && m_authenticated && !m_linkLost.load();
+}
+
+// ------------------------------------------------------------
+// Link health: touchActivity() / msSinceActivity()
+// ------------------------------------------------------------
+// Streaming loops call touchActivity() whenever bytes move. A busy client whose
+// clock stops advancing is stuck on a dead peer (libssh blocks in read/write).
+void SshClient::touchActivity() const
+{
+    m_lastActivityMs.store(QDateTime::currentMSecsSinceEpoch());
+}
+
+qint64 SshClient::msSinceActivity() const
+{
+    const qint64 last = m_lastActivityMs.load();
+    if (last <= 0) return 0;
+    return QDateTime::currentMSecsSinceEpoch() - last;
+}
+
+// ------------------------------------------------------------
+// probeAlive()
+// ------------------------------------------------------------
+// Keepalive + dead-peer check for an idle session:
+//   1) ssh_send_keepalive() keeps NAT/firewall state fresh
+//   2) a session channel open/close forces a real round trip; on a dead peer
+//      it fails after the session timeout (SSH_OPTIONS_TIMEOUT, 8 s)
+// If another operation holds the session we skip: that operation is already
+// exercising the link, and its progress is watched via msSinceActivity().
+bool SshClient::probeAlive(QString* err)
+{
+    if (err) err->clear();
+
+    if (!m_session || !m_authenticated) {
+        if (err) *err = tr("Not connected.");
+        return false;
+    }
+    if (m_linkLost.load()) {
+        if (err) *err = tr("Connection lost.");
+        return false;
+    }
+
+    if (!m_ioMutex.tryLock())
+        return true; // busy: real I/O in flight
+    m_ioDepth.fetch_add(1);
+    touchActivity();
+
+    (void)ssh_send_keepalive(m_session);
+
+    bool ok = false;
+    ssh_channel ch = ssh_channel_new(m_session);
+    if (ch) {
+        ok = (ssh_channel_open_session(ch) == SSH_OK);
+        if (ok) ssh_channel_close(ch);
+        ssh_channel_free(ch);
+    }
+
+    if (!ok || !ssh_is_connected(m_session)) {
+        ok = false;
+        if (err) *err = tr("Keepalive failed: %1").arg(libsshError(m_session));
+    }
+
+    m_ioDepth.fetch_sub(1);
+    m_ioMutex.unlock();
+    return ok;
+}
+
+// ------------------------------------------------------------
+// abortLink()
+// ------------------------------------------------------------
+// Called by the link monitor when the peer is considered dead.
+// shutdown() (not close) on libssh's socket is safe while another thread is
+// blocked in it: the blocked read/write returns, libssh marks the session
+// broken, and the operation fails instead of hanging forever.
+void SshClient::abortLink(const QString& reason)
+{
+    if (m_linkLost.exchange(true)) return;
+
+    qWarning().noquote() << QString("[SSH] link lost host='%1': %2").arg(m_host, reason);
+
+    ssh_session s = m_session;
+    if (!s) return;
+
+    const socket_t fd = ssh_get_fd(s);
+    if (fd != SSH_INVALID_SOCKET)
+        ::shutdown(fd, SHUT_RDWR);
+}
+
+// ------------------------------------------------------------
+// isLinkLost()
+// ------------------------------------------------------------
+bool SshClient::isLinkLost() const
+{
+    if (!m_session) return false;
+    if (m_linkLost.load()) return true;
+
+    // Only ask libssh when nobody else is using the session.
+    if (!m_ioMutex.tryLock()) return false;
+    const bool lost = m_authenticated && !ssh_is_connected(m_session);
+    m_ioMutex.unlock();
+    return lost;
 }
 
 // ------------------------------------------------------------
@@ -439,9 +798,10 @@ bool SshClient::isConnected() const
 // Convenience helper: run `pwd` over a short-lived channel and return stdout.
 QString SshClient::remotePwd(QString* err) const
 {
+    IoScope io(this);
     if (err) err->clear();
 
-    if (!m_session) {
+    if (!isConnected()) {
         if (err) *err = tr("Not connected.");
         return QString();
     }
@@ -492,10 +852,11 @@ bool SshClient::listRemoteDir(const QString& remotePath,
                               QVector<RemoteEntry>* outItems,
                               QString* err)
 {
+    IoScope io(this);
     if (err) err->clear();
     if (outItems) outItems->clear();
 
-    if (!m_session) {
+    if (!isConnected()) {
         if (err) *err = tr("Not connected.");
         return false;
     }
@@ -556,11 +917,12 @@ bool SshClient::statRemotePath(const QString& remotePath,
                                RemoteEntry* outInfo,
                                QString* err)
 {
+    IoScope io(this);
     if (err) err->clear();
     if (!outInfo) { if (err) *err = tr("statRemotePath: outInfo is null."); return false; }
     *outInfo = RemoteEntry{};
 
-    if (!m_session) {
+    if (!isConnected()) {
         if (err) *err = tr("Not connected.");
         return false;
     }
@@ -618,6 +980,10 @@ bool SshClient::statRemotePath(const QString& remotePath,
 //    3) if rename fails, try unlink final and retry rename
 //    4) if step 2/3 fails AND we made a backup, try to restore backup
 // - on cancel/error, remove temp file
+// - on a dropped link, keep the temp file: the next uploadFile() for the same
+//   destination resumes from its size, but only when <remote>.pqssh.part.src
+//   still matches the local file's size + mtime; a resumed temp file is
+//   SHA-256 checked against the local file before the rename
 //
 // Notes:
 // - Remote "rename" semantics vary; some servers don't overwrite on rename.
@@ -627,10 +993,11 @@ bool SshClient::uploadFile(const QString& localPath,
                            QString* err,
                            ProgressCb progress)
 {
+    IoScope io(this);
     if (err) err->clear();
     m_cancelRequested.store(false);
 
-    if (!m_session) {
+    if (!isConnected()) {
         if (err) *err = tr("Not connected.");
         return false;
     }
@@ -655,11 +1022,14 @@ bool SshClient::uploadFile(const QString& localPath,
     if (!openSftp(m_session, &sftp, err)) return false;
 
     const QString tmpPath    = rpath + ".pqssh.part";
+    const QString stampPath  = tmpPath + ".src";
     const QString backupPath = rpath + ".pqssh.bak";
+    const QByteArray stamp   = resumeStamp(totalSize, QFileInfo(lpath).lastModified().toMSecsSinceEpoch());
 
     // Helper: best-effort temp cleanup (ignore errors)
     auto cleanupTemp = [&]() {
         sftp_unlink(sftp, tmpPath.toUtf8().constData());
+        sftp_unlink(sftp, stampPath.toUtf8().constData());
     };
 
     // Helper: attempt rename src->dst, optionally unlink dst then retry.
@@ -676,11 +1046,24 @@ bool SshClient::uploadFile(const QString& localPath,
         return false;
     };
 
+    // Resume: a temp file left by an interrupted upload is continued when it is
+    // not larger than the source and its stamp names this source.
+    quint64 resumeFrom = 0;
+    if (auto *st = sftp_stat(sftp, tmpPath.toUtf8().constData())) {
+        if (st->size > 0 && (quint64)st->size <= totalSize)
+            resumeFrom = (quint64)st->size;
+        sftp_attributes_free(st);
+    }
+    if (resumeFrom > 0 && readRemoteStamp(sftp, stampPath) != stamp) {
+        qInfo().noquote() << QString("[SSH] uploadFile: discarding stale '%1' (source changed)").arg(tmpPath);
+        resumeFrom = 0;
+    }
+
     // Open remote temp for write
     sftp_file f = sftp_open(
         sftp,
         tmpPath.toUtf8().constData(),
-        O_WRONLY | O_CREAT | O_TRUNC,
+        resumeFrom > 0 ? O_WRONLY : (O_WRONLY | O_CREAT | O_TRUNC),
         S_IRUSR | S_IWUSR
     );
 
@@ -694,6 +1077,33 @@ bool SshClient::uploadFile(const QString& localPath,
     QByteArray buf(64 * 1024, Qt::Uninitialized);
     quint64 sent = 0;
 
+    if (resumeFrom > 0) {
+        if (sftp_seek64(f, resumeFrom) == 0 && in.seek((qint64)resumeFrom)) {
+            sent = resumeFrom;
+            qInfo().noquote() << QString("[SSH] uploadFile: resuming '%1' at %2 of %3 bytes")
+                                 .arg(tmpPath).arg(resumeFrom).arg(totalSize);
+            if (progress) progress(sent, totalSize);
+        } else {
+            // Could not position: start over.
+            sftp_close(f);
+            f = sftp_open(sftp, tmpPath.toUtf8().constData(),
+                          O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+            in.seek(0);
+            resumeFrom = 0;
+            if (!f) {
+                if (err) *err = tr("Cannot open remote temp file '%1': %2")
+                                    .arg(tmpPath, libsshError(m_session));
+                sftp_free(sftp);
+                return false;
+            }
+        }
+    }
+
+    // Fresh temp file: stamp it so a later resume can tell it belongs to this
+    // source (best-effort; without a stamp it is simply never resumed).
+    if (resumeFrom == 0)
+        writeRemoteStamp(sftp, stampPath, stamp);
+
     while (!in.atEnd()) {
         if (m_cancelRequested.load()) {
             sftp_close(f);
@@ -717,17 +1127,32 @@ bool SshClient::uploadFile(const QString& localPath,
         if (w < 0) {
             if (err) *err = tr("SFTP write failed: %1").arg(libsshError(m_session));
             sftp_close(f);
-            cleanupTemp();
+            // Dropped link: keep the temp file so the upload can resume.
+            if (!m_linkLost.load() && ssh_is_connected(m_session))
+                cleanupTemp();
             sftp_free(sftp);
             return false;
         }
 
         sent += (quint64)w;
+        touchActivity();
         if (progress) progress(sent, totalSize);
     }
 
     sftp_close(f);
 
+    // A resumed temp file is two transfers glued together: check it against
+    // the source before it replaces anything.
+    if (resumeFrom > 0) {
+        QString verr;
+        if (!verifyLocalVsRemoteSha256(lpath, tmpPath, &verr)) {
+            cleanupTemp();
+            sftp_free(sftp);
+            if (err) *err = tr("Resumed upload failed verification, temp file removed: %1").arg(verr);
+            return false;
+        }
+    }
+
     // ---- Safe replace phase ----
 
     // 1) Try to create/refresh backup if destination exists.
@@ -775,6 +1200,140 @@ bool SshClient::uploadFile(const QString& localPath,
     if (backupMade) {
         sftp_unlink(sftp, backupPath.toUtf8().constData());
     }
+    sftp_unlink(sftp, stampPath.toUtf8().constData());
+
+    sftp_free(sftp);
+    return true;
+}
+
+// ------------------------------------------------------------
+// writeRemoteChunks()
+// ------------------------------------------------------------
+// Pipelined SFTP write of chunks from readChunk: up to kSftpWritesInFlight
+// write requests are outstanding, acknowledgements are collected in order
+// (each request carries a copy of its bytes, so only the current chunk is
+// held here). On error/cancel the partial remote file is removed.
+bool SshClient::writeRemoteChunks(int chunkCount,
+                                  quint64 totalSize,
+                                  const ChunkReader& readChunk,
+                                  const QString& remotePath,
+                                  int permsOctal,
+                                  QString* err,
+                                  ProgressCb progress)
+{
+    IoScope io(this);
+    if (err) err->clear();
+    m_cancelRequested.store(false);
+
+    if (!isConnected()) {
+        if (err) *err = tr("Not connected.");
+        return false;
+    }
+
+    const QString rpath = remotePath.trimmed();
+    if (rpath.isEmpty()) {
+        if (err) *err = tr("writeRemoteChunks: remotePath empty.");
+        return false;
+    }
+
+    sftp_session sftp = nullptr;
+    if (!openSftp(m_session, &sftp, err)) return false;
+
+    const QByteArray rpathUtf8 = rpath.toUtf8();
+    sftp_file f = sftp_open(sftp, rpathUtf8.constData(),
+                            O_WRONLY | O_CREAT | O_TRUNC, (mode_t)(permsOctal & 0777));
+    if (!f) {
+        if (err) *err = tr("Cannot open remote file '%1': %2").arg(rpath, libsshError(m_session));
+        sftp_free(sftp);
+        return false;
+    }
+
+    constexpr size_t kRequestBytes = 32 * 1024;   // accepted by every server
+    quint64 sent = 0;
+    QString failure;
+
+#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0,11,0)
+    constexpr int kSftpWritesInFlight = 16;
+    QVector<sftp_aio> pending;   // FIFO: acknowledgements come in order
+
+    auto waitOldest = [&]() -> bool {
+        sftp_aio a = pending.takeFirst();
+        const ssize_t w = sftp_aio_wait_write(&a);   // frees a
+        if (w < 0) {
+            failure = tr("SFTP write failed: %1").arg(libsshError(m_session));
+            return false;
+        }
+        sent += (quint64)w;
+        touchActivity();
+        if (progress) progress(sent, totalSize);
+        return true;
+    };
+
+    for (int i = 0; i < chunkCount && failure.isEmpty(); ++i) {
+        QString rerr;
+        const QByteArray c = readChunk(i, &rerr);
+        if (c.isEmpty()) {
+            failure = rerr.isEmpty() ? tr("Read failed") : rerr;
+            break;
+        }
+        for (qint64 off = 0; off < c.size() && failure.isEmpty();) {
+            if (m_cancelRequested.load()) {
+                failure = tr("Cancelled by user");
+                break;
+            }
+            if (pending.size() >= kSftpWritesInFlight && !waitOldest())
+                break;
+
+            const size_t len = std::min<size_t>(kRequestBytes, size_t(c.size() - off));
+            sftp_aio a = nullptr;
+            if (sftp_aio_begin_write(f, c.constData() + off, len, &a) < 0) {
+                failure = tr("SFTP write failed: %1").arg(libsshError(m_session));
+                break;
+            }
+            pending.push_back(a);
+            off += qint64(len);
+        }
+        if (!failure.isEmpty()) break;
+    }
+    while (failure.isEmpty() && !pending.isEmpty())
+        waitOldest();
+    for (sftp_aio& a : pending)
+        sftp_aio_free(a);
+#else
+    for (int i = 0; i < chunkCount && failure.isEmpty(); ++i) {
+        QString rerr;
+        const QByteArray c = readChunk(i, &rerr);
+        if (c.isEmpty()) {
+            failure = rerr.isEmpty() ? tr("Read failed") : rerr;
+            break;
+        }
+        for (qint64 off = 0; off < c.size();) {
+            if (m_cancelRequested.load()) {
+                failure = tr("Cancelled by user");
+                break;
+            }
+            const size_t len = std::min<size_t>(kRequestBytes, size_t(c.size() - off));
+            const ssize_t w = sftp_write(f, c.constData() + off, len);
+            if (w < 0) {
+                failure = tr("SFTP write failed: %1").arg(libsshError(m_session));
+                break;
+            }
+            off += w;
+            sent += (quint64)w;
+            touchActivity();
+            if (progress) progress(sent, totalSize);
+        }
+        if (!failure.isEmpty()) break;
+    }
+#endif
+
+    sftp_close(f);
+    if (!failure.isEmpty()) {
+        sftp_unlink(sftp, rpathUtf8.constData());
+        sftp_free(sftp);
+        if (err) *err = failure;
+        return false;
+    }
 
     sftp_free(sftp);
     return true;
@@ -793,6 +1352,10 @@ bool SshClient::uploadFile(const QString& localPath,
 //    2) move/copy temp into place
 //    3) if step 2 fails, restore backup
 // - on cancel/error, remove temp file
+// - on a dropped link, keep the temp file: the next downloadFile() for the same
+//   destination resumes from its size, but only when <local>.pqssh.part.src
+//   still matches the remote file's size + mtime; a resumed temp file is
+//   SHA-256 checked against the remote file before it is moved into place
 //
 // Notes:
 // - Uses moveOrCopy() so it survives cross-device rename failures (EXDEV).
@@ -801,10 +1364,11 @@ bool SshClient::downloadFile(const QString& remotePath,
                              QString* err,
                              std::function<void(quint64 done, quint64 total)> progressCb)
 {
+    IoScope io(this);
     if (err) err->clear();
     m_cancelRequested.store(false);
 
-    if (!m_session) {
+    if (!isConnected()) {
         if (err) *err = tr("Not connected.");
         return false;
     }
@@ -859,31 +1423,70 @@ bool SshClient::downloadFile(const QString& remotePath,
         return false;
     }
 
-    // Best-effort total size
+    // Best-effort total size (+ mtime for the resume stamp)
     quint64 total = 0;
+    qint64 remoteMtime = 0;
     if (auto *st = sftp_stat(sftp, rpath.toUtf8().constData())) {
         total = (quint64)st->size;
+        remoteMtime = (qint64)st->mtime;
         sftp_attributes_free(st);
     }
 
     const QString tmpLocal    = absLocal + ".pqssh.part";
+    const QString stampLocal  = tmpLocal + ".src";
     const QString backupLocal = absLocal + ".pqssh.bak";
+    const QByteArray stamp    = resumeStamp(total, remoteMtime);
+
+    // Resume: a temp file left by an interrupted download is continued when it
+    // is not larger than the remote file and its stamp names this remote file.
+    quint64 resumeFrom = 0;
+    {
+        const QFileInfo partFi(tmpLocal);
+        if (partFi.exists() && partFi.size() > 0 && total > 0 && (quint64)partFi.size() <= total)
+            resumeFrom = (quint64)partFi.size();
+    }
+    if (resumeFrom > 0) {
+        QFile sf(stampLocal);
+        if (!sf.open(QIODevice::ReadOnly) || sf.read(256) != stamp) {
+            qInfo().noquote() << QString("[SSH] downloadFile: discarding stale '%1' (source changed)").arg(tmpLocal);
+            resumeFrom = 0;
+        }
+    }
+    if (resumeFrom > 0 && sftp_seek64(f, resumeFrom) != 0)
+        resumeFrom = 0;
 
     QFile out(tmpLocal);
-    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    const QIODevice::OpenMode mode = resumeFrom > 0
+        ? (QIODevice::WriteOnly | QIODevice::Append)
+        : (QIODevice::WriteOnly | QIODevice::Truncate);
+    if (!out.open(mode)) {
         if (err) *err = out.errorString();
         sftp_close(f);
         sftp_free(sftp);
         return false;
     }
 
+    // Fresh temp file: stamp it (best-effort, see uploadFile()).
+    if (resumeFrom == 0) {
+        QFile sf(stampLocal);
+        if (sf.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            sf.write(stamp);
+    }
+
     QByteArray buf(64 * 1024, Qt::Uninitialized);
-    quint64 done = 0;
+    quint64 done = resumeFrom;
+
+    if (resumeFrom > 0) {
+        qInfo().noquote() << QString("[SSH] downloadFile: resuming '%1' at %2 of %3 bytes")
+                             .arg(tmpLocal).arg(resumeFrom).arg(total);
+        if (progressCb) progressCb(done, total);
+    }
 
     while (true) {
         if (m_cancelRequested.load()) {
             out.close();
             out.remove();
+            QFile::remove(stampLocal);
             sftp_close(f);
             sftp_free(sftp);
             if (err) *err = tr("Cancelled by user");
@@ -896,7 +1499,11 @@ bool SshClient::downloadFile(const QString& remotePath,
         if (n < 0) {
             if (err) *err = tr("SFTP read failed: %1").arg(libsshError(m_session));
             out.close();
-            out.remove();
+            // Dropped link: keep the temp file so the download can resume.
+            if (!m_linkLost.load() && ssh_is_connected(m_session)) {
+                out.remove();
+                QFile::remove(stampLocal);
+            }
             sftp_close(f);
             sftp_free(sftp);
             return false;
@@ -907,12 +1514,14 @@ bool SshClient::downloadFile(const QString& remotePath,
             if (err) *err = tr("Local write failed: %1").arg(out.errorString());
             out.close();
             out.remove();
+            QFile::remove(stampLocal);
             sftp_close(f);
             sftp_free(sftp);
             return false;
         }
 
         done += (quint64)n;
+        touchActivity();
         if (progressCb) progressCb(done, total);
     }
 
@@ -920,6 +1529,19 @@ bool SshClient::downloadFile(const QString& remotePath,
     sftp_close(f);
     sftp_free(sftp);
 
+    // A resumed temp file is two transfers glued together: check it against
+    // the remote file before it replaces anything.
+    if (resumeFrom > 0) {
+        QString verr;
+        if (!verifyRemoteVsLocalSha256(rpath, tmpLocal, &verr)) {
+            QFile::remove(tmpLocal);
+            QFile::remove(stampLocal);
+            if (err) *err = tr("Resumed download failed verification, temp file removed: %1").arg(verr);
+            return false;
+        }
+    }
+    QFile::remove(stampLocal);
+
     // Safer replace:
     // 1) if destination exists, move it aside to backup
     // 2) move temp into place
@@ -960,9 +1582,10 @@ bool SshClient::downloadFile(const QString& remotePath,
 // Intended for small/medium buffers (config files, authorized_keys, etc.).
 bool SshClient::uploadBytes(const QString& remotePath, const QByteArray& data, QString* err)
 {
+    IoScope io(this);
     if (err) err->clear();
 
-    if (!m_session) {
+    if (!isConnected()) {
         if (err) *err = tr("Not connected.");
         return false;
     }
@@ -1013,9 +1636,10 @@ bool SshClient::uploadBytes(const QString& remotePath, const QByteArray& data, Q
 // NOTE: reads whole file into memory -> intended for small files.
 bool SshClient::downloadToFile(const QString& remotePath, const QString& localPath, QString* err)
 {
+    IoScope io(this);
     if (err) err->clear();
 
-    if (!m_session) {
+    if (!isConnected()) {
         if (err) *err = tr("Not connected.");
         return false;
     }
@@ -1114,9 +1738,10 @@ QByteArray SshClient::sha256LocalFile(const QString& localPath, QString* err) co
 // Returns 32-byte digest on success, empty on error/cancel.
 QByteArray SshClient::sha256RemoteFile(const QString& remotePath, QString* err)
 {
+    IoScope io(this);
     if (err) err->clear();
 
-    if (!m_session) {
+    if (!isConnected()) {
         if (err) *err = tr("Not connected.");
         return {};
     }
@@ -1255,10 +1880,111 @@ bool SshClient::exec(const QString& command, QString* out, QString* err)
 
 bool SshClient::exec(const QString& command, QString* out, QString* err, int timeoutMs)
 {
+    ExecOptions opt;
+    opt.timeoutMs = timeoutMs;
+    return exec(command, out, err, opt, nullptr);
+}
+
+namespace {
+
+// State shared with the libssh channel callbacks of one exec() call.
+struct ExecCtx
+{
+    const SshClient::ExecOptions* opt = nullptr;
+    SshClient::ExecResult* res = nullptr;
+
+    QByteArray outBuf;
+    QByteArray errBuf;
+    qint64     captured = 0;
+
+    int  events = 0;             // channel callbacks run (link is alive)
+    bool gotEof = false;
+    bool gotClose = false;
+    bool gotExit = false;
+    bool overflow = false;
+};
+
+int execOnData(ssh_session, ssh_channel, void* data, uint32_t len, int isStderr, void* userdata)
+{
+    auto* c = static_cast<ExecCtx*>(userdata);
+    const char* p = static_cast<const char*>(data);
+    ++c->events;
+
+    if (isStderr) c->res->stderrBytes += len;
+    else          c->res->stdoutBytes += len;
+
+    const qint64 cap = c->opt->maxOutputBytes;
+    qint64 keep = len;
+    if (cap > 0 && c->captured + keep > cap) {
+        keep = qMax<qint64>(0, cap - c->captured);
+        c->overflow = true;
+    }
+
+    if (keep > 0) {
+        if (c->opt->captureOutput) {
+            if (isStderr) c->errBuf.append(p, int(keep));
+            else          c->outBuf.append(p, int(keep));
+        }
+        if (c->opt->onOutput)
+            c->opt->onOutput(QByteArray(p, int(keep)), isStderr != 0);
+        c->captured += keep;
+    }
+
+    // Always consume everything: bytes past the cap are dropped, not queued.
+    return int(len);
+}
+
+void execOnEof(ssh_session, ssh_channel, void* userdata)
+{
+    auto* c = static_cast<ExecCtx*>(userdata);
+    ++c->events;
+    c->gotEof = true;
+}
+
+void execOnClose(ssh_session, ssh_channel, void* userdata)
+{
+    auto* c = static_cast<ExecCtx*>(userdata);
+    ++c->events;
+    c->gotClose = true;
+}
+
+void execOnExitStatus(ssh_session, ssh_channel, int status, void* userdata)
+{
+    auto* c = static_cast<ExecCtx*>(userdata);
+    ++c->events;
+    c->res->exitStatus = status;
+    c->gotExit = true;
+}
+
+void execOnExitSignal(ssh_session, ssh_channel, const char* signal, int, const char*, const char*, void* userdata)
+{
+    auto* c = static_cast<ExecCtx*>(userdata);
+    ++c->events;
+    c->res->exitSignal = QString::fromLatin1(signal ? signal : "");
+    c->gotExit = true;
+}
+
+} // namespace
+
+// Event-driven: stdout/stderr/exit-status are delivered by channel callbacks
+// while ssh_event_dopoll() sleeps on the socket, so a command that finishes in
+// 2 ms returns after ~2 ms (the old loop polled in 50 ms steps).
+//
+// Activity (for SshLinkMonitor) is only what the server sends. A quiet
+// command gets a keepalive request every kExecKeepaliveMs; its reply counts,
+// so only a dead peer stops the clock and the monitor can abort the link.
+bool SshClient::exec(const QString& command, QString* out, QString* err,
+                     const ExecOptions& opt, ExecResult* result)
+{
+    IoScope io(this);
     if (out) out->clear();
     if (err) err->clear();
 
-    if (!m_session) {
+    ExecResult localRes;
+    ExecResult& res = result ? *result : localRes;
+    res = ExecResult();
+
+    if (!isConnected()) {
         if (err) *err = tr("Not connected.");
         return false;
     }
@@ -1269,9 +1995,30 @@ bool SshClient::exec(const QString& command, QString* out, QString* err, int tim
         return false;
     }
 
-    // Ensure we always close/free the channel on all paths.
+    ExecCtx ctx;
+    ctx.opt = &opt;
+    ctx.res = &res;
+
+    ssh_channel_callbacks_struct cb{};
+    cb.userdata = &ctx;
+    cb.channel_data_function        = execOnData;
+    cb.channel_eof_function         = execOnEof;
+    cb.channel_close_function       = execOnClose;
+    cb.channel_exit_status_function = execOnExitStatus;
+    cb.channel_exit_signal_function = execOnExitSignal;
+    ssh_callbacks_init(&cb);
+
+    ssh_event ev = nullptr;
+
+    // Ensure we always detach callbacks and close/free the channel on all paths.
     auto cleanup = [&]() {
+        if (ev) {
+            ssh_event_remove_session(ev, m_session);
+            ssh_event_free(ev);
+            ev = nullptr;
+        }
         if (ch) {
+            ssh_remove_channel_callbacks(ch, &cb);
             if (ssh_channel_is_open(ch)) {
                 ssh_channel_send_eof(ch);
                 ssh_channel_close(ch);
@@ -1287,103 +2034,286 @@ bool SshClient::exec(const QString& command, QString* out, QString* err, int tim
         return false;
     };
 
+    if (ssh_set_channel_callbacks(ch, &cb) != SSH_OK)
+        return fail(tr("ssh_set_channel_callbacks failed: %1").arg(libsshError(m_session)));
+
+    QElapsedTimer channelTimer;
+    channelTimer.start();
+
     if (ssh_channel_open_session(ch) != SSH_OK)
         return fail(tr("ssh_channel_open_session failed: %1").arg(libsshError(m_session)));
 
     if (ssh_channel_request_exec(ch, command.toUtf8().constData()) != SSH_OK)
         return fail(tr("ssh_channel_request_exec failed: %1").arg(libsshError(m_session)));
 
-    QByteArray outBuf, errBuf;
-    char buf[4096];
+    res.channelMs = channelTimer.elapsed();
+
+    // Optional stdin (e.g. execBatch() script). Output arriving meanwhile is
+    // delivered to the callbacks by libssh while it waits for window space.
+    if (!opt.stdinData.isEmpty()) {
+        const char* p = opt.stdinData.constData();
+        qint64 left = opt.stdinData.size();
+        while (left > 0) {
+            const int n = ssh_channel_write(ch, p, uint32_t(qMin<qint64>(left, 32 * 1024)));
+            if (n == SSH_ERROR)
+                return fail(tr("ssh_channel_write(stdin) failed: %1").arg(libsshError(m_session)));
+            p += n;
+            left -= n;
+            touchActivity();
+        }
+        ssh_channel_send_eof(ch);
+    }
+
+    ev = ssh_event_new();
+    if (!ev || ssh_event_add_session(ev, m_session) != SSH_OK)
+        return fail(tr("ssh_event setup failed."));
 
     QElapsedTimer timer;
     timer.start();
 
-    // Drain any currently available data on stdout/stderr.
-    auto readAvailable = [&](int isStderr) -> bool {
-        while (true) {
-            const int n = ssh_channel_read(ch, buf, sizeof(buf), isStderr);
-            if (n == SSH_ERROR)
-                return false;
-            if (n <= 0)
-                break;
-
-            if (isStderr) errBuf.append(buf, n);
-            else          outBuf.append(buf, n);
+    constexpr qint64 kExecKeepaliveMs = 5000;
+    QElapsedTimer sinceKeepalive;
+    sinceKeepalive.start();
+
+    // Done once the server closed the channel, or sent EOF plus an exit
+    // status/signal (some servers delay the close).
+    while (!ctx.gotClose && !(ctx.gotEof && ctx.gotExit)) {
+        if (ctx.overflow) {
+            res.outputCapped = true;
+            res.elapsedMs = timer.elapsed();
+            if (out) *out = QString::fromUtf8(ctx.outBuf);
+            return fail(tr("Remote command output exceeded %1 bytes; command aborted.")
+                            .arg(opt.maxOutputBytes));
+        }
 
-            const int avail = ssh_channel_poll_timeout(ch, 0, isStderr);
-            if (avail == SSH_ERROR)
-                return false;
-            if (avail <= 0)
-                break;
+        int waitMs = 1000;
+        if (opt.timeoutMs > 0) {
+            const qint64 left = opt.timeoutMs - timer.elapsed();
+            if (left <= 0) {
+                res.timedOut = true;
+                res.elapsedMs = timer.elapsed();
+                if (out) *out = QString::fromUtf8(ctx.outBuf);
+                return fail(tr("Remote command timed out after %1 ms.").arg(opt.timeoutMs));
+            }
+            waitMs = int(qMin<qint64>(left, waitMs));
         }
-        return true;
-    };
 
-    // Poll loop with timeout support.
-    while (true) {
-        if (timeoutMs > 0 && timer.elapsed() > timeoutMs) {
-            if (err) *err = tr("Remote command timed out after %1 ms.").arg(timeoutMs);
-            cleanup();
-            return false;
+        if (msSinceActivity() >= kExecKeepaliveMs && sinceKeepalive.elapsed() >= kExecKeepaliveMs) {
+            // Non-blocking, so libssh does not wait here for the reply; it
+            // arrives through ssh_event_dopoll() below. (While an earlier
+            // reply is unclaimed, libssh only collects it instead of sending.)
+            ssh_set_blocking(m_session, 0);
+            (void)ssh_send_keepalive(m_session);
+            ssh_set_blocking(m_session, 1);
+            sinceKeepalive.restart();
         }
 
-        const int availOut = ssh_channel_poll_timeout(ch, /*timeoutMs*/ 50, /*is_stderr*/ 0);
-        if (availOut == SSH_ERROR)
-            return fail(tr("ssh_channel_poll_timeout(stdout) failed: %1").arg(libsshError(m_session)));
+        const int events = ctx.events;
+        const int rc = ssh_event_dopoll(ev, waitMs);
+        if (rc == SSH_ERROR)
+            return fail(tr("ssh_event_dopoll failed: %1").arg(libsshError(m_session)));
+        if (rc == SSH_OK || ctx.events != events)
+            touchActivity();   // the server sent something (output, keepalive reply)
+    }
 
-        if (availOut > 0) {
-            if (!readAvailable(/*isStderr*/0))
-                return fail(tr("ssh_channel_read(stdout) failed: %1").arg(libsshError(m_session)));
-        }
+    if (ctx.overflow) res.outputCapped = true;
+    res.elapsedMs = timer.elapsed();
+    cleanup();
 
-        const int availErr = ssh_channel_poll_timeout(ch, /*timeoutMs*/ 0, /*is_stderr*/ 1);
-        if (availErr == SSH_ERROR)
-            return fail(tr("ssh_channel_poll_timeout(stderr) failed: %1").arg(libsshError(m_session)));
+    if (out) *out = QString::fromUtf8(ctx.outBuf);
+
+    if (ctx.overflow) {
+        if (err) *err = tr("Remote command output exceeded %1 bytes; output truncated.")
+                            .arg(opt.maxOutputBytes);
+        return false;
+    }
 
-        if (availErr > 0) {
-            if (!readAvailable(/*isStderr*/1))
-                return fail(tr("ssh_channel_read(stderr) failed: %1").arg(libsshError(m_session)));
+    if (!res.exitSignal.isEmpty()) {
+        if (err) *err = tr("Remote command terminated by signal %1.").arg(res.exitSignal);
+        return false;
+    }
+
+    if (res.exitStatus != 0) {
+        if (err) {
+            const QString e = QString::fromUtf8(ctx.errBuf).trimmed();
+            *err = e.isEmpty()
+                ? tr("Remote command failed (exit %1).").arg(res.exitStatus)
+                : tr("Remote command failed (exit %1): %2").arg(res.exitStatus).arg(e);
         }
+        return false;
+    }
 
-        // On EOF, drain any remaining bytes and exit.
-        if (ssh_channel_is_eof(ch)) {
-            const int drainOut = ssh_channel_poll_timeout(ch, 0, 0);
-            const int drainErr = ssh_channel_poll_timeout(ch, 0, 1);
-            if (drainOut == SSH_ERROR)
-                return fail(tr("ssh_channel_poll_timeout(stdout/drain) failed: %1").arg(libsshError(m_session)));
-            if (drainErr == SSH_ERROR)
-                return fail(tr("ssh_channel_poll_timeout(stderr/drain) failed: %1").arg(libsshError(m_session)));
-
-            if (drainOut > 0) {
-                if (!readAvailable(0))
-                    return fail(tr("ssh_channel_read(stdout/drain) failed: %1").arg(libsshError(m_session)));
-            }
-            if (drainErr > 0) {
-                if (!readAvailable(1))
-                    return fail(tr("ssh_channel_read(stderr/drain) failed: %1").arg(libsshError(m_session)));
-            }
+    return true;
+}
 
-            if (drainOut <= 0 && drainErr <= 0)
-                break;
+// ------------------------------------------------------------
+// execCapture()
+// ------------------------------------------------------------
+bool SshClient::execCapture(const QString& command, SshExecCapture* capture, QString* err,
+                            const ExecOptions& opt, ExecResult* result)
+{
+    if (err) err->clear();
+    if (!capture) {
+        if (err) *err = tr("No output capture.");
+        return false;
+    }
+
+    ExecResult localRes;
+    ExecResult& res = result ? *result : localRes;
+
+    ExecOptions o = opt;
+    o.captureOutput = false;
+    o.onOutput = [capture, user = opt.onOutput](const QByteArray& chunk, bool isStderr) {
+        (isStderr ? capture->err() : capture->out()).append(chunk.constData(), chunk.size());
+        if (user) user(chunk, isStderr);
+    };
+
+    const bool ok = exec(command, nullptr, err, o, &res);
+
+    // exec() builds "failed (exit N): <stderr>" from its own buffer, which is
+    // empty here; use the captured stderr instead.
+    if (!ok && err && res.exitStatus > 0 && res.exitSignal.isEmpty() &&
+        !res.timedOut && !res.outputCapped) {
+        const QString e = capture->err().text().trimmed();
+        if (!e.isEmpty())
+            *err = tr("Remote command failed (exit %1): %2").arg(res.exitStatus).arg(e.left(2000));
+    }
+
+    return ok;
+}
+
+// ------------------------------------------------------------
+// execBatch()
+// ------------------------------------------------------------
+namespace {
+
+// Frames of command i in one stream:
+//   stdout: "<tag>:<i>:B\n" <output> "\n<tag>:<i>:E:<rc>\n"
+//   stderr: "<tag>:<i>:B\n" <output> "\n<tag>:<i>:E\n"
+// The "\n" before E is ours (the output may not end with a newline).
+struct BatchFrame
+{
+    QByteArray body;
+    int  rc = -1;
+    bool complete = false;
+};
+
+QVector<BatchFrame> parseBatchStream(const QByteArray& s, const QByteArray& tag, int count, bool withRc)
+{
+    QVector<BatchFrame> frames(count);
+    int pos = 0;
+
+    for (int i = 0; i < count; ++i) {
+        const QByteArray id = tag + ':' + QByteArray::number(i);
+        const QByteArray begin = id + ":B\n";
+        const QByteArray end = '\n' + id + ":E";
+
+        const int b = s.indexOf(begin, pos);
+        if (b < 0) break;
+        const int bodyStart = b + begin.size();
+
+        const int e = s.indexOf(end, bodyStart);
+        if (e < 0) break;
+
+        frames[i].body = s.mid(bodyStart, e - bodyStart);
+
+        int after = e + end.size();
+        const int nl = s.indexOf('\n', after);
+        if (nl < 0) break;
+
+        if (withRc) {
+            // ":<rc>"
+            bool ok = false;
+            const int rc = s.mid(after + 1, nl - after - 1).toInt(&ok);
+            frames[i].rc = ok ? rc : -1;
         }
+        frames[i].complete = true;
+        pos = nl + 1;
     }
+    return frames;
+}
 
-    ssh_channel_send_eof(ch);
-    ssh_channel_close(ch);
+} // namespace
 
-    const int status = ssh_channel_get_exit_status(ch); // deprecated in 0.11, but still works
-    ssh_channel_free(ch);
-    ch = nullptr;
+bool SshClient::execBatch(const QStringList& commands, QVector<BatchResult>* results,
+                          QString* err, const BatchOptions& opt)
+{
+    if (err) err->clear();
+    if (results) {
+        results->clear();
+        results->resize(commands.size());
+    }
+    if (commands.isEmpty()) return true;
+
+    // Random per-batch tag: command output cannot forge a frame boundary.
+    const QByteArray tag = "__PQSSH_"
+        + QByteArray::number(QRandomGenerator::global()->generate64(), 16);
+
+    QByteArray script;
+    for (int i = 0; i < commands.size(); ++i) {
+        const QByteArray id = tag + ':' + QByteArray::number(i);
+        script += "printf '%s\\n' '" + id + ":B'; printf '%s\\n' '" + id + ":B' >&2\n";
+        // Subshell: `exit` in a command ends only that command; stdin from
+        // /dev/null so nothing reads the rest of our script.
+        script += "(\n" + commands[i].toUtf8() + "\n) </dev/null\n";
+        script += "__pq_rc=$?\n";
+        script += "printf '\\n%s:%s\\n' '" + id + ":E' \"$__pq_rc\"; printf '\\n%s\\n' '" + id + ":E' >&2\n";
+        if (opt.stopOnError)
+            script += "[ \"$__pq_rc\" -eq 0 ] || exit 0\n";
+    }
+
+    QByteArray outBuf, errBuf;
+
+    ExecOptions o;
+    o.timeoutMs = opt.timeoutMs;
+    o.maxOutputBytes = 64LL * 1024 * 1024; // whole batch is buffered here
+    o.captureOutput = false;
+    o.stdinData = script;
+    o.onOutput = [&outBuf, &errBuf](const QByteArray& chunk, bool isStderr) {
+        (isStderr ? errBuf : outBuf).append(chunk);
+    };
+
+    ExecResult res;
+    QString e;
+    exec(opt.shell, nullptr, &e, o, &res);
+
+    // Transport error, timeout or cap: the frames we have are not trustworthy.
+    const bool transportFailed =
+        res.timedOut || res.outputCapped || (res.exitStatus < 0 && res.exitSignal.isEmpty());
+    if (transportFailed) {
+        if (err) *err = e;
+        return false;
+    }
+
+    const QVector<BatchFrame> outFrames = parseBatchStream(outBuf, tag, commands.size(), true);
+    const QVector<BatchFrame> errFrames = parseBatchStream(errBuf, tag, commands.size(), false);
+
+    int ran = 0;
+    int firstFailed = -1;
+    for (int i = 0; i < commands.size(); ++i) {
+        if (!outFrames[i].complete) break;
+        ++ran;
+        if (firstFailed < 0 && outFrames[i].rc != 0) firstFailed = i;
+        if (results) {
+            BatchResult& r = (*results)[i];
+            r.ran = true;
+            r.exitStatus = outFrames[i].rc;
+            r.stdoutText = QString::fromUtf8(outFrames[i].body);
+            r.stderrText = QString::fromUtf8(errFrames[i].body);
+        }
+    }
 
-    if (out) *out = QString::fromUtf8(outBuf);
+    qInfo().noquote() << QString("[SSH] execBatch: %1/%2 command(s) ran in %3 ms")
+                         .arg(ran).arg(commands.size()).arg(res.elapsedMs);
 
-    if (status != 0) {
+    // Missing frames are expected only after a failure with stopOnError.
+    const bool stoppedEarly = opt.stopOnError && firstFailed >= 0 && ran == firstFailed + 1;
+    if (ran < commands.size() && !stoppedEarly) {
         if (err) {
-            const QString e = QString::fromUtf8(errBuf).trimmed();
-            *err = e.isEmpty()
-                ? tr("Remote command failed (exit %1).").arg(status)
-                : tr("Remote command failed (exit %1): %2").arg(status).arg(e);
+            const QString se = QString::fromUtf8(errBuf).trimmed().right(400);
+            *err = tr("Remote shell stopped after %1 of %2 command(s).%3")
+                       .arg(ran).arg(commands.size())
+                       .arg(se.isEmpty() ? QString() : QString("\n") + se);
         }
         return false;
     }
@@ -1412,9 +2342,10 @@ bool SshClient::ensureRemoteDir(const QString& path, int permsOctal, QString* er
 // Intended for small files (authorized_keys, config snippets, etc.).
 bool SshClient::readRemoteTextFile(const QString& remotePath, QString* textOut, QString* err)
 {
+    IoScope io(this);
     if (textOut) textOut->clear();
     if (err) err->clear();
-    if (!m_session) { if (err) *err = tr("Not connected."); return false; }
+    if (!isConnected()) { if (err) *err = tr("Not connected."); return false; }
 
     sftp_session sftp = nullptr;
     if (!openSftp(m_session, &sftp, err)) return false;
@@ -1450,8 +2381,9 @@ bool SshClient::readRemoteTextFile(const QString& remotePath, QString* textOut,
 // - apply chmod afterwards (server may ignore create perms)
 bool SshClient::writeRemoteTextFileAtomic(const QString& remotePath, const QString& text, int permsOctal, QString* err)
 {
+    IoScope io(this);
     if (err) err->clear();
-    if (!m_session) { if (err) *err = tr("Not connected."); return false; }
+    if (!isConnected()) { if (err) *err = tr("Not connected."); return false; }
 
     const QString tmpPath = remotePath + ".pqssh.tmp";
 
@@ -1542,29 +2474,85 @@ static QString shQuote(const QString& s)
 // ------------------------------------------------------------
 // installAuthorizedKey()
 // ------------------------------------------------------------
-// Idempotent OpenSSH authorized_keys installer.
+// Idempotent OpenSSH authorized_keys installer, one exec / one round trip.
 //
-// Behavior:
-// - Validates input looks like a public key line
+// Behavior (all done by kInstallKeyScript on the remote):
+// - Validates input looks like a public key line (locally)
 // - Ensures ~/.ssh exists with 0700 perms
-// - Reads existing authorized_keys (if present) and checks for duplicate
-// - If existing file exists, makes a timestamped backup under ~/.ssh/pqssh_backups/
-// - Appends key with newline and writes atomically (temp + rename), chmod 0600
-// - On write failure, attempts to restore from backup (best-effort)
+// - Checks existing authorized_keys for the key (whitespace-normalized match)
+// - If the file exists, makes a timestamped backup under ~/.ssh/pqssh_backups/
+// - Appends key with newline and writes atomically (temp + rename), 0600;
+//   on failure the original file is untouched (nothing to roll back)
 //
 // Outputs:
 // - alreadyPresent: set true if key already existed
 // - backupPathOut: filled when a backup was made (existing file case)
+
+// $1 = normalized key line, $2 = UTC timestamp for the backup name.
+// Reports "pqssh:<name>=<value>" lines on stdout; exit 1 + pqssh:step on failure.
+static const char* const kInstallKeyScript = R"SH(
+set -u
+key=$1
+ts=$2
+umask 077
+say() { printf 'pqssh:%s\n' "$1"; }
+fail() { say "step=$1"; exit 1; }
+
+[ -n "${HOME:-}" ] || fail home
+d="$HOME/.ssh"
+ak="$d/authorized_keys"
+say "path=$ak"
+
+mkdir -p "$d" && chmod 700 "$d" || fail mkdir
+
+if [ -f "$ak" ]; then
+    if K="$key" awk '{ sub(/\r$/, ""); $1 = $1; if ($0 == ENVIRON["K"]) { f = 1; exit } } END { exit !f }' "$ak"; then
+        say status=already
+        exit 0
+    fi
+    b="$d/pqssh_backups"
+    bak="$b/authorized_keys.$ts.bak"
+    mkdir -p "$b" && chmod 700 "$b" && cp -f "$ak" "$bak" && chmod 600 "$bak" || fail backup
+    say "backup=$bak"
+fi
+
+tmp="$ak.pqssh-tmp.$$"
+{
+    if [ -s "$ak" ]; then
+        cat "$ak" && { [ -z "$(tail -c 1 "$ak")" ] || printf '\n'; }
+    fi && printf '%s\n' "$key"
+} > "$tmp" && chmod 600 "$tmp" && mv -f "$tmp" "$ak" || { rm -f "$tmp"; fail write; }
+
+say status=installed
+)SH";
+
 bool SshClient::installAuthorizedKey(const QString& pubKeyLine,
                                      QString* err,
                                      bool* alreadyPresent,
                                      QString* backupPathOut)
 {
-    if (err) err->clear();
     if (alreadyPresent) *alreadyPresent = false;
     if (backupPathOut) backupPathOut->clear();
 
-    if (!m_session) {
+    AuthorizedKeyResult r;
+    const bool ok = installAuthorizedKey(pubKeyLine, &r, err);
+
+    if (alreadyPresent) *alreadyPresent = r.alreadyPresent;
+    if (backupPathOut) *backupPathOut = r.backupPath;
+    return ok;
+}
+
+bool SshClient::installAuthorizedKey(const QString& pubKeyLine,
+                                     AuthorizedKeyResult* result,
+                                     QString* err)
+{
+    if (err) err->clear();
+
+    AuthorizedKeyResult localRes;
+    AuthorizedKeyResult& res = result ? *result : localRes;
+    res = AuthorizedKeyResult();
+
+    if (!isConnected()) {
         if (err) *err = tr("Not connected.");
         return false;
     }
@@ -1579,95 +2567,55 @@ bool SshClient::installAuthorizedKey(const QString& pubKeyLine,
         return false;
     }
 
-    // Resolve remote $HOME
-    QString homeOut, e;
-    if (!exec("printf %s \"$HOME\"", &homeOut, &e)) {
-        if (err) *err = tr("Failed to read remote $HOME: %1").arg(e);
-        return false;
-    }
-    const QString home = homeOut.trimmed();
-    if (home.isEmpty()) {
-        if (err) *err = tr("Remote $HOME is empty.");
-        return false;
-    }
-
-    const QString sshDir = home + "/.ssh";
-    const QString akPath = sshDir + "/authorized_keys";
-
-    // Ensure ~/.ssh exists and is 0700
-    if (!ensureRemoteDir(sshDir, 0700, &e)) {
-        if (err) *err = e;
-        return false;
-    }
-
-    // Read existing authorized_keys if present
-    QString existing, readErr;
-    const bool hasExisting = readRemoteTextFile(akPath, &existing, &readErr);
-
-    const QString normKey = normalizeKeyLine(key);
-
-    // Check for exact normalized match (idempotent)
-    if (hasExisting) {
-        const QStringList lines = existing.split('\n', Qt::SkipEmptyParts);
-        for (const QString& ln : lines) {
-            if (normalizeKeyLine(ln) == normKey) {
-                if (alreadyPresent) *alreadyPresent = true;
-                return true;
-            }
-        }
-    }
-
-    // Backup existing file (strict)
-    QString backupPath;
-    if (hasExisting) {
-        const QString backupDir = sshDir + "/pqssh_backups";
-        if (!ensureRemoteDir(backupDir, 0700, &e)) {
-            if (err) *err = tr("Failed to create backup dir: %1").arg(e);
-            return false;
-        }
-
-        const QString ts = QDateTime::currentDateTimeUtc().toString("yyyyMMdd-HHmmss");
-        backupPath = backupDir + "/authorized_keys." + ts + ".bak";
-
-        QString out, cpErr;
-        const QString cpCmd = QString("cp -f -- %1 %2")
-                                  .arg(shQuote(akPath), shQuote(backupPath));
-
-        if (!exec(cpCmd, &out, &cpErr)) {
-            const QString cpCmd2 = QString("cp -f %1 %2")
-                                       .arg(shQuote(akPath), shQuote(backupPath));
-            if (!exec(cpCmd2, &out, &cpErr)) {
-                if (err) *err = tr("Backup failed. Aborting install.\nTried:\n%1\n%2\nError: %3")
-                                    .arg(cpCmd, cpCmd2, cpErr);
-                return false;
-            }
-        }
-
-        exec(QString("chmod 600 %1").arg(shQuote(backupPath)), &out, nullptr);
-        if (backupPathOut) *backupPathOut = backupPath;
-    }
-
-    // Append key with newline
-    QString newText = existing;
-    if (!newText.isEmpty() && !newText.endsWith('\n'))
-        newText += "\n";
-    newText += key;
-    newText += "\n";
-
-    // Write atomically and chmod 600
-    if (!writeRemoteTextFileAtomic(akPath, newText, 0600, &e)) {
-        // Best-effort rollback: restore from backup if we made one.
-        if (!backupPath.isEmpty()) {
-            QString out;
-            exec(QString("cp -f %1 %2").arg(shQuote(backupPath), shQuote(akPath)), &out, nullptr);
-            exec(QString("chmod 600 %1").arg(shQuote(akPath)), &out, nullptr);
-        }
-        if (err) *err = e;
-        return false;
+    const QString ts = QDateTime::currentDateTimeUtc().toString("yyyyMMdd-HHmmss");
+    const QString cmd = QString("sh -c %1 pqssh-install-key %2 %3")
+                            .arg(shQuote(QString::fromLatin1(kInstallKeyScript)),
+                                 shQuote(key),
+                                 shQuote(ts));
+
+    ExecOptions opt;
+    opt.timeoutMs = 20 * 1000;
+    opt.maxOutputBytes = 64 * 1024;
+
+    QString out, e;
+    ExecResult xr;
+    exec(cmd, &out, &e, opt, &xr);
+
+    // Structured report: "pqssh:<name>=<value>" lines.
+    QString status;
+    for (const QString& ln : out.split('\n', Qt::SkipEmptyParts)) {
+        if (!ln.startsWith("pqssh:")) continue;
+        const QString kv = ln.mid(6);
+        const int eq = kv.indexOf('=');
+        if (eq <= 0) continue;
+        const QString k = kv.left(eq);
+        const QString v = kv.mid(eq + 1).trimmed();
+        if (k == "status")      status = v;
+        else if (k == "path")   res.authorizedKeysPath = v;
+        else if (k == "backup") res.backupPath = v;
+        else if (k == "step")   res.failedStep = v;
+    }
+
+    if (status == "already") {
+        res.alreadyPresent = true;
+        return true;
     }
+    if (status == "installed" && xr.exitStatus == 0)
+        return true;
 
-    QString out;
-    exec(QString("chmod 600 %1").arg(shQuote(akPath)), &out, nullptr);
-
-    return true;
+    if (err) {
+        // Remote stderr (if any) is in e after "Remote command failed (exit N): ".
+        const QString detail = e.trimmed();
+        if (res.failedStep == "home")
+            *err = tr("Remote $HOME is empty.");
+        else if (res.failedStep == "mkdir")
+            *err = tr("Failed to create remote ~/.ssh: %1").arg(detail);
+        else if (res.failedStep == "backup")
+            *err = tr("Backup failed. Aborting install.\nError: %1").arg(detail);
+        else if (res.failedStep == "write")
+            *err = tr("Failed to write %1: %2").arg(res.authorizedKeysPath, detail);
+        else
+            *err = detail.isEmpty() ? tr("authorized_keys install failed.") : detail;
+    }
+    return false;
 }
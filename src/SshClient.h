@@ -19,7 +19,10 @@
 #include <QString>
 #include <QByteArray>
 #include <QVector>
+#include <QStringList>
 #include <QtGlobal>      // for quint64/quint32/qint64
+#include <QMutex>
+#include <QSharedPointer>
 #include <functional>
 #include <atomic>
 #include <libssh/callbacks.h>
@@ -30,6 +33,9 @@
 struct ssh_session_struct;
 using ssh_session = ssh_session_struct*;
 
+class SshJumpHost;
+class SshExecCapture;
+
 class SshClient : public QObject
 {
     Q_OBJECT
@@ -45,6 +51,8 @@ public:
 
     // Optional progress callback for streaming transfers (done/total bytes).
     using ProgressCb = std::function<void(quint64 done, quint64 total)>;
+    // Chunk index -> bytes, for writeRemoteChunks(); empty + *err on failure.
+    using ChunkReader = std::function<QByteArray(int index, QString* err)>;
 
     // Remote file listing entry (minimal metadata for a file manager view).
     struct RemoteEntry
@@ -58,6 +66,84 @@ public:
         qint64  mtime = 0;  // seconds since epoch
     };
 
+    // One user-auth attempt made by authenticate() (connect latency reporting).
+    struct AuthAttempt
+    {
+        QString method;     // "agent", "publickey" (remembered key), "publickey_auto"
+        int     rc = 0;     // SSH_AUTH_* result
+        qint64  ms = 0;     // wall time of this attempt
+    };
+
+    // Wall time of each connectProfile() phase; -1 = phase not reached (or,
+    // for DNS, not ours to time: jump-host targets are resolved by the bastion).
+    struct ConnectTimings
+    {
+        qint64 dnsMs  = -1;   // name resolution
+        qint64 tcpMs  = -1;   // TCP connect (jump hosts: opening the tunnel)
+        qint64 kexMs  = -1;   // banner + key exchange (ssh_connect)
+        qint64 authMs = -1;   // all authenticate() attempts
+    };
+
+    // Where the last connectProfile() failed, for callers that must tell
+    // failures apart (err is translated display text).
+    struct ConnectFailure
+    {
+        enum class Phase { None, Config, Resolve, Connect, Tunnel, Kex, Auth };
+
+        Phase phase = Phase::None;
+        int   code  = 0;   // Resolve: EAI_*; Connect: errno; Kex/Auth: ssh_get_error_code()
+    };
+
+    // Streaming exec output: called on the exec() thread as soon as a chunk
+    // arrives (stdout or stderr). Must not call back into this SshClient.
+    using ExecOutputCb = std::function<void(const QByteArray& chunk, bool isStderr)>;
+
+    struct ExecOptions
+    {
+        int    timeoutMs = 0;                      // <= 0 = no timeout
+        qint64 maxOutputBytes = 0;                  // stdout+stderr; exceeded = command aborted; 0 = no cap
+        bool   captureOutput = true;                // false = only stream via onOutput
+        ExecOutputCb onOutput;                      // optional
+        QByteArray stdinData;                       // written to the command's stdin, then EOF
+    };
+
+    struct ExecResult
+    {
+        int    exitStatus = -1;    // -1 = none received (signal / aborted)
+        QString exitSignal;        // e.g. "KILL" when terminated by a signal
+        bool   timedOut = false;
+        bool   outputCapped = false;
+        qint64 stdoutBytes = 0;    // bytes received (including ones past the cap)
+        qint64 stderrBytes = 0;
+        qint64 elapsedMs = 0;      // exec request accepted -> command done
+        qint64 channelMs = -1;     // channel open + exec request
+    };
+
+    // Outcome of installAuthorizedKey() (one remote script run).
+    struct AuthorizedKeyResult
+    {
+        bool    alreadyPresent = false;
+        QString authorizedKeysPath;   // remote ~/.ssh/authorized_keys
+        QString backupPath;           // set when an existing file was backed up
+        QString failedStep;           // "", "home", "mkdir", "backup" or "write"
+    };
+
+    // One command of execBatch().
+    struct BatchResult
+    {
+        QString stdoutText;
+        QString stderrText;
+        int     exitStatus = -1;   // -1 = not run (stopOnError / batch aborted)
+        bool    ran = false;
+    };
+
+    struct BatchOptions
+    {
+        int     timeoutMs = 0;                       // whole batch; <= 0 = no timeout
+        bool    stopOnError = false;                 // skip the rest after the first non-zero exit
+        QString shell = QStringLiteral("sh -s");     // remote interpreter reading the script on stdin
+    };
+
 signals:
     // Emitted after a successful ssh_connect(), when we can read negotiated KEX.
     void kexNegotiated(const QString& prettyText, const QString& rawKex);
@@ -71,6 +157,31 @@ public:
     // On success, m_session becomes valid and SFTP/exec helpers can be used.
     bool connectProfile(const SshProfile& profile, QString* err = nullptr);
 
+    // The two phases of connectProfile(), usable separately (speculative pre-connect):
+    // - connectTransport(): DNS + TCP + KEX; session is kept but NOT authenticated
+    // - authenticate():     user authentication on the session opened above
+    bool connectTransport(const SshProfile& profile, QString* err = nullptr);
+    bool authenticate(QString* err = nullptr);
+
+    // True once connectTransport() succeeded (authenticated or not).
+    bool hasTransport() const { return m_session != nullptr; }
+
+    // Raw libssh session, for SshJumpHost (which opens direct-tcpip channels on
+    // a bastion's session). The caller must serialise all use of it.
+    ssh_session nativeSession() const { return m_session; }
+
+    // Attempts made by the last authenticate() call, in order, with timings.
+    QVector<AuthAttempt> lastAuthAttempts() const { return m_authAttempts; }
+    QString lastAuthSummary() const;   // e.g. "agent=DENIED 612 ms, publickey_auto=OK 88 ms"
+    // Phase timings of the session held now (last connectTransport()/authenticate()).
+    ConnectTimings lastConnectTimings() const { return m_connectTimings; }
+    // Cause of the last connectTransport()/authenticate() failure (Phase::None after success).
+    ConnectFailure lastConnectFailure() const { return m_connectFailure; }
+
+    // Move another client's session into this one (other ends up disconnected).
+    // Used to take over a pre-connected session from SshPreconnectPool.
+    bool adoptSession(SshClient& other);
+
     // Backwards-compatible helper: connect using "user@host" string.
     bool connectPublicKey(const QString& target, QString* err = nullptr);
 
@@ -80,9 +191,31 @@ public:
     // Close/free current libssh session (safe to call multiple times).
     void disconnect();
 
-    // True if a libssh session is active.
+    // True if an authenticated libssh session is active (and not marked lost).
     bool isConnected() const;
 
+    // ------------------------------------------------------------
+    // Link health (keepalive / dead-peer detection, see SshLinkMonitor)
+    // ------------------------------------------------------------
+    // Send a keepalive and do one round trip (channel open/close) on the idle
+    // session. Returns true without touching the network while other I/O is in
+    // flight (that I/O is watched via msSinceActivity()). Worker thread only.
+    bool probeAlive(QString* err = nullptr);
+
+    // True while an SFTP/exec operation is using the session.
+    bool isBusy() const { return m_ioDepth.load() > 0; }
+
+    // Time since the last byte moved for the current operation.
+    qint64 msSinceActivity() const;
+
+    // Dead peer: shut the socket down so blocked libssh I/O returns with an
+    // error, and mark the link lost. Safe to call from any thread.
+    void abortLink(const QString& reason);
+
+    // True when the session exists but its transport is gone
+    // (after abortLink(), or when libssh itself saw the connection drop).
+    bool isLinkLost() const;
+
     // Run remote `pwd` and return its trimmed output.
     QString remotePwd(QString* err = nullptr) const;
 
@@ -102,6 +235,20 @@ public:
                     QString* err = nullptr,
                     ProgressCb progress = nullptr);
 
+    // Write chunkCount chunks (totalSize bytes), fetched one at a time from
+    // readChunk (one shared source, many targets), to remotePath,
+    // created/truncated with permsOctal. SFTP writes are pipelined (several
+    // requests in flight, libssh >= 0.11), so throughput is not bound to one
+    // round trip per block. No temp file/rename: callers write a temp path
+    // and move it into place themselves.
+    bool writeRemoteChunks(int chunkCount,
+                           quint64 totalSize,
+                           const ChunkReader& readChunk,
+                           const QString& remotePath,
+                           int permsOctal,
+                           QString* err = nullptr,
+                           ProgressCb progress = nullptr);
+
     // --- Integrity / checksum (SHA-256) ---
     QByteArray sha256LocalFile(const QString& localPath, QString* err = nullptr) const;
     QByteArray sha256RemoteFile(const QString& remotePath, QString* err = nullptr);
@@ -128,6 +275,24 @@ public:
     bool exec(const QString& command, QString* out = nullptr, QString* err = nullptr);
     // New overload
     bool exec(const QString& command, QString* out, QString* err, int timeoutMs);
+    // Event-driven core of the overloads above (timeout, output cap, streaming).
+    // Returns false on transport error, timeout, cap overflow or exit status != 0.
+    bool exec(const QString& command, QString* out, QString* err,
+              const ExecOptions& opt, ExecResult* result = nullptr);
+    // Bounded-memory variant: output goes to capture's head/tail/spill
+    // (see SshExecCapture) instead of QStrings; opt.captureOutput is ignored.
+    // opt.maxOutputBytes still applies (0 = unlimited; memory stays bounded).
+    bool execCapture(const QString& command, SshExecCapture* capture, QString* err,
+                     const ExecOptions& opt, ExecResult* result = nullptr);
+
+    // Run many small commands over ONE channel and ONE remote shell (one round
+    // trip instead of one per command). The script is fed to opt.shell on
+    // stdin; each command runs in a subshell with stdin from /dev/null and is
+    // framed by random delimiters on stdout and stderr.
+    // *results gets one entry per command. Returns false only on transport,
+    // timeout or framing errors; check each BatchResult::exitStatus.
+    bool execBatch(const QStringList& commands, QVector<BatchResult>* results,
+                   QString* err, const BatchOptions& opt);
 
     bool readRemoteTextFile(const QString& remotePath, QString* textOut, QString* err = nullptr);
 
@@ -142,6 +307,10 @@ public:
                               QString* errOut,
                               bool* alreadyOut,
                               QString* backupPathOut = nullptr);
+    // Same, with the structured report of the single-exec installer.
+    bool installAuthorizedKey(const QString& pubKeyLine,
+                              AuthorizedKeyResult* result,
+                              QString* errOut);
 
     void requestCancelTransfer();
 
@@ -155,6 +324,42 @@ private:
     // Internal helper: call provider if installed.
     QString requestPassphrase(const QString& keyFile, bool *ok);
 
+    // Register m_cb (passphrase callback bound to this client) on session s.
+    void installCallbacks(ssh_session s);
+
+    // Set by authenticate(); connectTransport() alone leaves it false.
+    bool m_authenticated = false;
+
+    // Connection facts from connectTransport() (logging + adoptSession()).
+    QString m_user;
+    QString m_host;
+    int     m_port = 22;
+    QString m_kexPretty;
+    QString m_kexRaw;
+
+    // Profile identity for the auth-method cache (profile id, or user@host:port).
+    QString m_profileKey;
+
+    // Filled by authenticate().
+    QVector<AuthAttempt> m_authAttempts;
+    ConnectTimings m_connectTimings;
+    ConnectFailure m_connectFailure;
+
+    // Shared bastion this session is tunnelled through (profile.proxyJump);
+    // held until disconnect() so the bastion outlives our tunnel.
+    QSharedPointer<SshJumpHost> m_jump;
+
     std::atomic_bool m_cancelRequested{false};
     ssh_callbacks_struct m_cb{};
+
+    // libssh sessions are not thread-safe: every operation on m_session holds
+    // m_ioMutex (recursive: composite helpers call exec()/SFTP helpers), and so
+    // does every lifecycle step (connect, authenticate, adopt, disconnect).
+    // probeAlive() only tryLock()s, so keepalives never queue behind transfers.
+    class IoScope;
+    mutable QMutex         m_ioMutex{QMutex::Recursive};
+    mutable std::atomic_int m_ioDepth{0};
+    mutable std::atomic<qint64> m_lastActivityMs{0};
+    std::atomic_bool       m_linkLost{false};
+    void touchActivity() const;
 };
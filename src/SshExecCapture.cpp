@@ -0,0 +1,164 @@
+// SshExecCapture.cpp
+//
+// See header for the overall idea. Implementation notes:
+//   - Bytes fill the head first; everything after goes to the tail buffer,
+//     which is trimmed back to tailBytes once it reaches twice that (amortized,
+//     instead of a memmove per chunk).
+//   - Spilling starts the moment head + tail would first lose a byte, so at
+//     that point head + tail still hold the complete stream and are written
+//     out first; later chunks are appended as they arrive.
+
+#include "SshExecCapture.h"
+
+#include <QFile>
+#include <QTemporaryFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QIODevice>
+#include <QDebug>
+
+SshExecStream::SshExecStream(const Limits& limits)
+    : m_limits(limits)
+{
+    m_limits.headBytes = qMax(0, m_limits.headBytes);
+    m_limits.tailBytes = qMax(0, m_limits.tailBytes);
+}
+
+SshExecStream::~SshExecStream()
+{
+    if (m_spill) m_spill->close();
+    if (!m_spillPath.isEmpty() && !m_keepSpill)
+        QFile::remove(m_spillPath);
+}
+
+qint64 SshExecStream::omittedBytes() const
+{
+    return m_total - m_head.size() - qMin<qint64>(m_tail.size(), m_limits.tailBytes);
+}
+
+QByteArray SshExecStream::tail() const
+{
+    return m_tail.right(m_limits.tailBytes);
+}
+
+QString SshExecStream::text() const
+{
+    const qint64 omitted = omittedBytes();
+    if (omitted <= 0)
+        return QString::fromUtf8(m_head + tail());
+
+    QString s = QString::fromUtf8(m_head);
+    s += QString("\n[... %1 bytes omitted ...]\n").arg(omitted);
+    s += QString::fromUtf8(tail());
+    return s;
+}
+
+QString SshExecStream::keepSpill()
+{
+    m_keepSpill = true;
+    if (m_spill) m_spill->flush();
+    return m_spillPath;
+}
+
+// ------------------------------------------------------------
+// append()
+// ------------------------------------------------------------
+void SshExecStream::append(const char* data, qint64 len)
+{
+    if (!data || len <= 0) return;
+
+    m_total += len;
+
+    if (m_device)
+        m_device->write(data, len);
+
+    // Head first.
+    qint64 used = 0;
+    if (m_head.size() < m_limits.headBytes) {
+        used = qMin<qint64>(len, m_limits.headBytes - m_head.size());
+        m_head.append(data, int(used));
+    }
+    if (used < len)
+        m_tail.append(data + used, int(len - used));
+
+    // Spill: start as soon as memory alone no longer holds everything.
+    if (m_spill) {
+        writeSpill(data, len);
+    } else if (m_limits.spillToDisk && !m_spillFailed &&
+               m_tail.size() > m_limits.tailBytes) {
+        startSpill();
+    }
+
+    // Trim the tail (amortized).
+    if (m_tail.size() >= 2 * qMax(1, m_limits.tailBytes)) {
+        const int drop = m_tail.size() - m_limits.tailBytes;
+        m_tail.remove(0, drop);
+    }
+}
+
+void SshExecStream::startSpill()
+{
+    const QString dir = m_limits.spillDir.isEmpty() ? QDir::tempPath() : m_limits.spillDir;
+    QDir().mkpath(dir);
+
+    QTemporaryFile tmp(QDir(dir).filePath(m_limits.spillPrefix + "XXXXXX.log"));
+    tmp.setAutoRemove(false);
+    if (!tmp.open()) {
+        qWarning().noquote() << QString("[EXEC] cannot create spill file in '%1': %2")
+                                .arg(dir, tmp.errorString());
+        m_spillFailed = true;
+        return;
+    }
+    m_spillPath = tmp.fileName();
+    tmp.close();
+
+    m_spill.reset(new QFile(m_spillPath));
+    if (!m_spill->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_spillFailed = true;
+        m_spill.reset();
+        return;
+    }
+
+    // Nothing has been trimmed yet: head + tail is the whole stream so far.
+    writeSpill(m_head.constData(), m_head.size());
+    writeSpill(m_tail.constData(), m_tail.size());
+}
+
+void SshExecStream::writeSpill(const char* data, qint64 len)
+{
+    if (!m_spill || m_spillFailed) return;
+
+    const qint64 room = m_limits.maxSpillBytes - m_spillBytes;
+    const qint64 n = qMin(len, qMax<qint64>(0, room));
+
+    if (n > 0 && m_spill->write(data, n) != n) {
+        qWarning().noquote() << QString("[EXEC] spill write failed '%1': %2")
+                                .arg(m_spillPath, m_spill->errorString());
+        m_spillFailed = true;
+    }
+    m_spillBytes += qMax<qint64>(0, n);
+
+    // Over the disk budget: keep what we have, flag it as incomplete.
+    if (n < len) m_spillFailed = true;
+
+    if (m_spillFailed) m_spill->close();
+}
+
+// ------------------------------------------------------------
+// purgeOldSpills()
+// ------------------------------------------------------------
+void SshExecCapture::purgeOldSpills(const QString& dir, int maxAgeDays)
+{
+    if (dir.isEmpty() || !QDir(dir).exists()) return;
+
+    const QDateTime cutoff = QDateTime::currentDateTime().addDays(-qMax(0, maxAgeDays));
+
+    const QFileInfoList entries =
+        QDir(dir).entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QFileInfo& fi : entries) {
+        if (fi.lastModified() >= cutoff) continue;
+        if (fi.isDir()) QDir(fi.absoluteFilePath()).removeRecursively();
+        else            QFile::remove(fi.absoluteFilePath());
+    }
+}
@@ -0,0 +1,110 @@
+// SshExecCapture.h
+//
+// Purpose:
+//   Bounded-memory capture of remote command output (SshClient::execCapture()).
+//   A plain exec() keeps the whole stdout/stderr in memory; a `journalctl` or
+//   `find /` over a few hundred Fleet targets then costs gigabytes.
+//
+// Per stream (stdout / stderr):
+//   - head: the first headBytes are kept in memory
+//   - tail: the last tailBytes are kept in memory (the middle is counted, not kept)
+//   - spill: optionally, once head + tail overflow, the *complete* stream is
+//     written to a file (up to maxSpillBytes) so nothing is lost
+//   - exact byte counters, whatever was kept
+//   - optional QIODevice that receives every chunk as it arrives
+//
+// Lifetime:
+//   A spill file is removed with its stream unless keepSpill() was called
+//   (Fleet keeps them next to the job; see FleetExecutor).
+//
+// Threading:
+//   Filled on the exec() thread, read after exec returns. Not thread-safe.
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QScopedPointer>
+#include <QtGlobal>
+
+class QIODevice;
+class QFile;
+
+class SshExecStream
+{
+public:
+    struct Limits
+    {
+        int     headBytes = 64 * 1024;
+        int     tailBytes = 64 * 1024;
+        bool    spillToDisk = false;
+        qint64  maxSpillBytes = 256LL * 1024 * 1024;
+        QString spillDir;      // empty = QDir::tempPath()
+        QString spillPrefix;   // file name prefix, e.g. "web01-stdout-"
+    };
+
+    explicit SshExecStream(const Limits& limits = Limits());
+    ~SshExecStream();
+
+    SshExecStream(const SshExecStream&) = delete;
+    SshExecStream& operator=(const SshExecStream&) = delete;
+
+    // Also write every chunk to dev (not owned; must outlive the exec call).
+    void setDevice(QIODevice* dev) { m_device = dev; }
+
+    void append(const char* data, qint64 len);
+
+    qint64 totalBytes() const { return m_total; }
+    qint64 omittedBytes() const;            // received but not kept in memory
+    bool   isTruncated() const { return omittedBytes() > 0; }
+
+    QByteArray head() const { return m_head; }
+    QByteArray tail() const;
+
+    // head + "[... N bytes omitted ...]" + tail, decoded as UTF-8.
+    QString text() const;
+
+    // Spill file with the complete stream (empty if none was needed/enabled).
+    QString spillPath() const { return m_spillPath; }
+    bool    spillComplete() const { return !m_spillPath.isEmpty() && !m_spillFailed; }
+
+    // Keep the spill file after this stream is destroyed; returns its path.
+    QString keepSpill();
+
+private:
+    void startSpill();
+    void writeSpill(const char* data, qint64 len);
+
+    Limits     m_limits;
+    QByteArray m_head;
+    QByteArray m_tail;          // may hold up to 2 * tailBytes before trimming
+    qint64     m_total = 0;
+
+    QIODevice* m_device = nullptr;
+
+    QScopedPointer<QFile> m_spill;
+    QString m_spillPath;
+    qint64  m_spillBytes = 0;
+    bool    m_spillFailed = false;
+    bool    m_keepSpill = false;
+};
+
+class SshExecCapture
+{
+public:
+    explicit SshExecCapture(const SshExecStream::Limits& outLimits = SshExecStream::Limits(),
+                            const SshExecStream::Limits& errLimits = SshExecStream::Limits())
+        : m_out(outLimits), m_err(errLimits) {}
+
+    SshExecStream& out() { return m_out; }
+    SshExecStream& err() { return m_err; }
+    const SshExecStream& out() const { return m_out; }
+    const SshExecStream& err() const { return m_err; }
+
+    // Remove files/dirs under dir older than maxAgeDays (old Fleet spills).
+    static void purgeOldSpills(const QString& dir, int maxAgeDays);
+
+private:
+    SshExecStream m_out;
+    SshExecStream m_err;
+};
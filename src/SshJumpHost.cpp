@@ -0,0 +1,567 @@
+// SshJumpHost.cpp
+//
+// See header for the overall idea. Implementation notes:
+//   - Registry: key (canonical hop chain) -> Slot. The slot mutex serialises
+//     creation, so 100 fleet workers hitting the same bastion at once produce
+//     one bastion login; the other 99 wait and then share it.
+//   - After setup only the relay thread touches the outer session (libssh
+//     sessions are not thread-safe), and it runs it non-blocking: channel
+//     opens are stepped until they answer, writes go out up to the channel
+//     window and the rest waits in the tunnel's queue. m_mutex only guards
+//     the request hand-over, never network I/O.
+//   - The relay sleeps in poll() with no timeout (tunnels open) or until the
+//     linger / an open deadline expires; openTunnel() and stopRelay() wake it
+//     through a pipe.
+//   - Per-tunnel buffering is capped (kMaxPending) both ways: a slow inner
+//     session stops reads from its channel (the SSH window pushes back on the
+//     far end), a slow channel stops reads from the inner session's socket.
+
+#include "SshJumpHost.h"
+
+#include <QHash>
+#include <QDebug>
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include <libssh/libssh.h>
+
+#include <sys/socket.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+// A bastion with no tunnels stays up this long, so back-to-back targets share it.
+constexpr qint64 kLingerMs = 60 * 1000;
+
+// Max bytes buffered per tunnel and direction.
+constexpr int kMaxPending = 1024 * 1024;
+
+// A direct-tcpip open the bastion has not answered by then fails.
+constexpr qint64 kOpenTimeoutMs = 15 * 1000;
+
+struct Slot {
+    QMutex                      mutex;
+    QSharedPointer<SshJumpHost> host;
+};
+
+QMutex& registryMutex()
+{
+    static QMutex m;
+    return m;
+}
+
+QHash<QString, QSharedPointer<Slot>>& registry()
+{
+    static QHash<QString, QSharedPointer<Slot>> r;
+    return r;
+}
+
+} // namespace
+
+SshJumpHost::~SshJumpHost()
+{
+    stopRelay();
+
+    for (Tunnel* t : m_tunnels)
+        closeTunnel(t);
+    m_tunnels.clear();
+
+    delete m_client; // disconnects
+    m_client = nullptr;
+
+    for (int& fd : m_wake) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+}
+
+// ------------------------------------------------------------
+// openTunnelFor()
+// ------------------------------------------------------------
+bool SshJumpHost::openTunnelFor(const SshProfile& target,
+                                const SshClient::PassphraseProvider& passphraseProvider,
+                                QSharedPointer<SshJumpHost>* hostOut,
+                                int* fdOut,
+                                QString* err)
+{
+    if (err) err->clear();
+
+    QVector<JumpHop> hops = parseProxyJump(target.proxyJump);
+    if (hops.isEmpty()) {
+        if (err) *err = QObject::tr("Invalid jump host specification '%1'.").arg(target.proxyJump);
+        return false;
+    }
+
+    // Hops without a user inherit the target's (OpenSSH does the same with User).
+    for (JumpHop& h : hops) {
+        if (h.user.trimmed().isEmpty())
+            h.user = target.user.trimmed();
+    }
+
+    const QString key = proxyJumpToString(hops);
+    const int port = (target.port > 0) ? target.port : 22;
+
+    QSharedPointer<Slot> slot;
+    {
+        QMutexLocker lk(&registryMutex());
+        slot = registry().value(key);
+        if (!slot) {
+            slot = QSharedPointer<Slot>::create();
+            registry().insert(key, slot);
+        }
+    }
+
+    // Second round only if the shared bastion died between lookup and use.
+    for (int round = 0; round < 2; ++round) {
+        QSharedPointer<SshJumpHost> host;
+        {
+            QMutexLocker lk(&slot->mutex);
+            if (!slot->host || !slot->host->isAlive()) {
+                slot->host = create(hops, target, passphraseProvider, err);
+                if (!slot->host) return false;
+            }
+            host = slot->host;
+        }
+
+        int fd = -1;
+        if (host->openTunnel(target.host.trimmed(), port, &fd, err)) {
+            *hostOut = host;
+            *fdOut = fd;
+            return true;
+        }
+
+        if (host->isAlive())
+            return false; // bastion is fine; the target itself is unreachable
+    }
+
+    return false;
+}
+
+// ------------------------------------------------------------
+// shutdownAll()
+// ------------------------------------------------------------
+void SshJumpHost::shutdownAll()
+{
+    QHash<QString, QSharedPointer<Slot>> all;
+    {
+        QMutexLocker lk(&registryMutex());
+        all.swap(registry());
+    }
+
+    for (const auto& slot : all) {
+        QMutexLocker lk(&slot->mutex);
+        slot->host.reset();
+    }
+}
+
+// ------------------------------------------------------------
+// create()
+// ------------------------------------------------------------
+// Connect + authenticate to the last hop. Earlier hops are reached through
+// connectProfile() itself: the hop profile carries the remaining chain as its
+// proxyJump, which lands back in openTunnelFor() for the shorter prefix.
+// Bastions are offered the agent and the target profile's key.
+QSharedPointer<SshJumpHost> SshJumpHost::create(const QVector<JumpHop>& hops,
+                                                const SshProfile& target,
+                                                const SshClient::PassphraseProvider& passphraseProvider,
+                                                QString* err)
+{
+    QSharedPointer<SshJumpHost> host(new SshJumpHost());
+    host->m_key = proxyJumpToString(hops);
+
+    const JumpHop& last = hops.last();
+
+    SshProfile hp;
+    hp.name      = last.host;
+    hp.user      = last.user;
+    hp.host      = last.host;
+    hp.port      = last.port;
+    hp.keyFile   = target.keyFile;
+    hp.keyType   = target.keyType;
+    hp.proxyJump = proxyJumpToString(hops.mid(0, hops.size() - 1));
+
+    qInfo().noquote() << QString("[JUMP] connecting bastion %1@%2:%3 (chain '%4')")
+                         .arg(hp.user, hp.host)
+                         .arg(hp.port)
+                         .arg(host->m_key);
+
+    host->m_client = new SshClient();
+    host->m_client->setPassphraseProvider(passphraseProvider);
+
+    QString e;
+    if (!host->m_client->connectProfile(hp, &e)) {
+        if (err) *err = QObject::tr("Jump host %1: %2").arg(last.host, e);
+        return {};
+    }
+
+    if (::pipe2(host->m_wake, O_CLOEXEC | O_NONBLOCK) != 0) {
+        if (err) *err = QObject::tr("pipe failed: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return {};
+    }
+
+    host->m_alive.store(true);
+    SshJumpHost* raw = host.data();
+    host->m_relay = std::thread([raw]() { raw->relayLoop(); });
+
+    return host;
+}
+
+// ------------------------------------------------------------
+// openTunnel()
+// ------------------------------------------------------------
+// Any thread: queue the request for the relay and wait for its answer (the
+// relay answers every request, at the latest within kOpenTimeoutMs or when
+// it exits).
+bool SshJumpHost::openTunnel(const QString& host, int port, int* fdOut, QString* err)
+{
+    int sv[2] = { -1, -1 };
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) {
+        if (err) *err = QObject::tr("socketpair failed: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    ::fcntl(sv[0], F_SETFL, ::fcntl(sv[0], F_GETFL) | O_NONBLOCK);
+
+    auto* t = new Tunnel;
+    t->fd     = sv[0];
+    t->host   = host;
+    t->port   = port;
+    t->target = QString("%1:%2").arg(host).arg(port);
+    t->since.start();
+
+    QMutexLocker lk(&m_mutex);
+    if (!m_alive.load() || !m_client) {
+        lk.unlock();
+        ::close(sv[0]);
+        ::close(sv[1]);
+        delete t;
+        if (err) *err = QObject::tr("Jump host connection %1 is closed.").arg(m_key);
+        return false;
+    }
+    m_requests.push_back(t);
+    wake();
+
+    while (t->state == Tunnel::State::Opening)
+        m_answered.wait(&m_mutex);
+
+    if (t->state == Tunnel::State::Failed) {
+        // The relay dropped it (channel freed, relay end closed).
+        if (err) *err = t->error;
+        lk.unlock();
+        ::close(sv[1]);
+        delete t;
+        return false;
+    }
+
+    qInfo().noquote() << QString("[JUMP] tunnel via %1 -> %2 (%3 open)")
+                         .arg(m_key, t->target)
+                         .arg(m_tunnelCount.load());
+
+    *fdOut = sv[1];
+    return true;
+}
+
+// ------------------------------------------------------------
+// answer()
+// ------------------------------------------------------------
+// Relay: report an open request's outcome to the waiting openTunnel().
+// A failed tunnel must already be released by the relay (channel, fd).
+void SshJumpHost::answer(Tunnel* t, bool ok, const QString& error)
+{
+    QMutexLocker lk(&m_mutex);
+    t->state = ok ? Tunnel::State::Open : Tunnel::State::Failed;
+    t->error = error;
+    m_answered.wakeAll();
+}
+
+// ------------------------------------------------------------
+// stepOpen()
+// ------------------------------------------------------------
+// Relay: advance one non-blocking ssh_channel_open_forward(). Returns true
+// once the request was answered (moved to m_tunnels or failed).
+bool SshJumpHost::stepOpen(Tunnel* t)
+{
+    ssh_session s = m_client->nativeSession();
+
+    if (!t->ch) t->ch = ssh_channel_new(s);
+
+    int rc = SSH_ERROR;
+    QString e;
+    if (!t->ch) {
+        e = QObject::tr("ssh_channel_new failed on jump host %1.").arg(m_key);
+    } else {
+        rc = ssh_channel_open_forward(t->ch, t->host.toUtf8().constData(), t->port, "127.0.0.1", 0);
+        if (rc == SSH_AGAIN && t->since.elapsed() < kOpenTimeoutMs)
+            return false;
+        if (rc == SSH_AGAIN) {
+            e = QObject::tr("Jump host %1 cannot reach %2:%3: %4")
+                    .arg(m_key, t->host)
+                    .arg(t->port)
+                    .arg(QObject::tr("timed out"));
+        } else if (rc != SSH_OK) {
+            e = QObject::tr("Jump host %1 cannot reach %2:%3: %4")
+                    .arg(m_key, t->host)
+                    .arg(t->port)
+                    .arg(QString::fromLocal8Bit(ssh_get_error(s)));
+        }
+    }
+
+    if (rc == SSH_OK) {
+        m_tunnels.push_back(t);
+        m_tunnelCount.fetch_add(1);
+        answer(t, true, QString());
+        return true;
+    }
+
+    if (t->ch) {
+        ssh_channel_free(t->ch);
+        t->ch = nullptr;
+    }
+    ::close(t->fd);
+    t->fd = -1;
+    if (!ssh_is_connected(s)) m_alive.store(false);
+    answer(t, false, e);
+    return true;
+}
+
+// ------------------------------------------------------------
+// pumpTunnel()
+// ------------------------------------------------------------
+// Relay: move what can move without blocking, both ways. Returns false when
+// the tunnel is finished (either side closed or failed).
+bool SshJumpHost::pumpTunnel(Tunnel* t, QByteArray& buf, bool* moved)
+{
+    // channel -> inner session
+    if (t->toSock.size() < kMaxPending) {
+        const int n = ssh_channel_read_nonblocking(t->ch, buf.data(), buf.size(), 0);
+        if (n > 0) {
+            t->toSock.append(buf.constData(), n);
+            *moved = true;
+        } else if (n == SSH_ERROR) {
+            return false;
+        }
+    }
+    if (!t->toSock.isEmpty()) {
+        const ssize_t w = ::send(t->fd, t->toSock.constData(), (size_t)t->toSock.size(), MSG_NOSIGNAL);
+        if (w > 0) {
+            t->toSock.remove(0, (int)w);
+            *moved = true;
+        } else if (w < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+    }
+
+    // inner session -> channel
+    if (t->toChan.size() < kMaxPending) {
+        const ssize_t r = ::recv(t->fd, buf.data(), (size_t)buf.size(), 0);
+        if (r > 0) {
+            t->toChan.append(buf.constData(), (int)r);
+            *moved = true;
+        } else if (r == 0) {
+            return false; // inner session closed (ssh_free)
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+    }
+    if (!t->toChan.isEmpty()) {
+        // Only what the window takes: the rest waits for a window adjust.
+        const uint32_t n = qMin<uint32_t>(ssh_channel_window_size(t->ch), (uint32_t)t->toChan.size());
+        t->waitWindow = (n == 0);
+        if (n > 0) {
+            const int w = ssh_channel_write(t->ch, t->toChan.constData(), n);
+            if (w > 0) {
+                t->toChan.remove(0, w);
+                *moved = true;
+            } else if (w == SSH_ERROR) {
+                return false;
+            }
+        }
+    }
+
+    // Far end closed and everything it sent has been delivered.
+    if (t->toSock.isEmpty() && (ssh_channel_is_eof(t->ch) || ssh_channel_is_closed(t->ch)))
+        return false;
+
+    return true;
+}
+
+// ------------------------------------------------------------
+// relayLoop()
+// ------------------------------------------------------------
+// Pump bytes between every tunnel's channel and socket and step pending
+// channel opens. When nothing moved, sleep in poll() on the tunnel sockets,
+// the outer session's socket and the wake pipe.
+void SshJumpHost::relayLoop()
+{
+    ssh_session s = m_client->nativeSession();
+    ssh_set_blocking(s, 0);
+
+    QByteArray buf(32 * 1024, Qt::Uninitialized);
+    QElapsedTimer idle;
+    idle.start();
+
+    while (!m_stop.load()) {
+        // Drain the wake pipe, then pick up new open requests.
+        char drain[64];
+        while (::read(m_wake[0], drain, sizeof(drain)) > 0) {}
+        {
+            QMutexLocker lk(&m_mutex);
+            m_opening += m_requests;
+            m_requests.clear();
+        }
+
+        bool moved = false;
+        qint64 openDeadlineMs = -1;
+
+        for (int i = m_opening.size() - 1; i >= 0; --i) {
+            Tunnel* t = m_opening[i];
+            if (stepOpen(t)) {
+                m_opening.removeAt(i);
+                moved = true;
+            } else {
+                const qint64 left = qMax<qint64>(0, kOpenTimeoutMs - t->since.elapsed());
+                openDeadlineMs = openDeadlineMs < 0 ? left : qMin(openDeadlineMs, left);
+            }
+        }
+
+        QVector<pollfd> pfds;
+        for (int i = m_tunnels.size() - 1; i >= 0; --i) {
+            Tunnel* t = m_tunnels[i];
+            if (!pumpTunnel(t, buf, &moved)) {
+                closeTunnel(t);
+                m_tunnels.removeAt(i);
+                continue;
+            }
+
+            pollfd p{};
+            p.fd = t->fd;
+            p.events = (t->toChan.size() < kMaxPending ? POLLIN : 0) |
+                       (t->toSock.isEmpty() ? 0 : POLLOUT);
+            pfds.push_back(p);
+        }
+
+        // Packets for one channel are read while pumping another: data, EOF or
+        // a window adjust may already sit in libssh with the socket quiet.
+        for (int i = 0; i < m_tunnels.size() && !moved; ++i) {
+            Tunnel* t = m_tunnels[i];
+            const int avail = ssh_channel_poll(t->ch, 0);
+            if ((avail > 0 && t->toSock.size() < kMaxPending) ||
+                avail == SSH_ERROR ||
+                (avail == SSH_EOF && t->toSock.isEmpty()) ||
+                (t->waitWindow && ssh_channel_window_size(t->ch) > 0))
+                moved = true;
+        }
+
+        if (!ssh_is_connected(s)) {
+            qWarning().noquote() << QString("[JUMP] bastion session %1 lost: %2")
+                                    .arg(m_key, QString::fromLocal8Bit(ssh_get_error(s)));
+            m_alive.store(false);
+            break;
+        }
+
+        int timeoutMs = -1;
+        if (!m_tunnels.isEmpty() || !m_opening.isEmpty()) {
+            idle.restart();
+        } else {
+            QMutexLocker lk(&m_mutex);
+            if (m_requests.isEmpty() && idle.elapsed() >= kLingerMs) {
+                // Decided under m_mutex: openTunnel() sees !alive from now on.
+                qInfo().noquote() << QString("[JUMP] closing idle bastion session %1").arg(m_key);
+                m_alive.store(false);
+                break;
+            }
+            timeoutMs = int(kLingerMs - idle.elapsed());
+        }
+        if (openDeadlineMs >= 0)
+            timeoutMs = timeoutMs < 0 ? int(openDeadlineMs) : qMin(timeoutMs, int(openDeadlineMs));
+
+        pollfd ps{};
+        ps.fd = ssh_get_fd(s);
+        ps.events = POLLIN | ((ssh_get_poll_flags(s) & SSH_WRITE_PENDING) ? POLLOUT : 0);
+        pfds.push_back(ps);
+
+        pollfd pw{};
+        pw.fd = m_wake[0];
+        pw.events = POLLIN;
+        pfds.push_back(pw);
+
+        if (!moved)
+            ::poll(pfds.data(), (nfds_t)pfds.size(), timeoutMs);
+    }
+
+    // Answer whatever is still waiting, then close everything.
+    m_alive.store(false);
+    {
+        QMutexLocker lk(&m_mutex);
+        m_opening += m_requests;
+        m_requests.clear();
+    }
+    for (Tunnel* t : m_opening) {
+        if (t->ch) ssh_channel_free(t->ch);
+        t->ch = nullptr;
+        ::close(t->fd);
+        t->fd = -1;
+        answer(t, false, QObject::tr("Jump host connection %1 is closed.").arg(m_key));
+    }
+    m_opening.clear();
+
+    for (Tunnel* t : m_tunnels)
+        closeTunnel(t);
+    m_tunnels.clear();
+
+    ssh_set_blocking(s, 1);
+    if (m_client) m_client->disconnect();
+}
+
+// ------------------------------------------------------------
+// closeTunnel()
+// ------------------------------------------------------------
+// Relay thread (or the destructor, once the relay has stopped). Closing the
+// relay end makes the inner session see EOF; closing the channel tells the
+// bastion to drop the forwarded TCP connection.
+void SshJumpHost::closeTunnel(Tunnel* t)
+{
+    if (!t) return;
+
+    if (t->ch) {
+        if (ssh_channel_is_open(t->ch)) {
+            ssh_channel_send_eof(t->ch);
+            ssh_channel_close(t->ch);
+        }
+        ssh_channel_free(t->ch);
+        t->ch = nullptr;
+    }
+    if (t->fd >= 0) {
+        ::close(t->fd);
+        t->fd = -1;
+    }
+
+    m_tunnelCount.fetch_sub(1);
+    qInfo().noquote() << QString("[JUMP] tunnel closed via %1 -> %2 (%3 open)")
+                         .arg(m_key, t->target)
+                         .arg(m_tunnelCount.load());
+    delete t;
+}
+
+// ------------------------------------------------------------
+// stopRelay()
+// ------------------------------------------------------------
+void SshJumpHost::wake()
+{
+    if (m_wake[1] >= 0) {
+        const char c = 1;
+        (void)::write(m_wake[1], &c, 1); // full pipe = a wake-up is pending anyway
+    }
+}
+
+void SshJumpHost::stopRelay()
+{
+    m_stop.store(true);
+    wake();
+    if (m_relay.joinable())
+        m_relay.join();
+}
@@ -0,0 +1,118 @@
+// SshJumpHost.h
+//
+// Purpose:
+//   In-process ProxyJump for libssh-based features (Files, Fleet, Scheduled Jobs).
+//   One authenticated session to a bastion is shared by every inner session
+//   that goes through it: each inner session gets its own direct-tcpip channel
+//   on the shared outer session instead of a new TCP connect + KEX + auth to the
+//   bastion. A fleet run over 300 hosts behind one bastion costs one bastion
+//   login, not 300.
+//
+// How an inner session rides a channel:
+//   libssh can only run a session over a file descriptor (SSH_OPTIONS_FD), so
+//   openTunnelFor() creates a local socketpair: one end goes to the inner
+//   session, the other end is pumped to/from the channel by this host's relay
+//   thread. After setup the relay is the only thread that touches the outer
+//   session (non-blocking from then on); openTunnel() hands it a request and
+//   waits for the channel to open.
+//
+// Chains:
+//   "b1,b2" is handled recursively: the SshClient for b2 is itself a jumped
+//   connection through the shared host for "b1". Every prefix of a chain is
+//   shared.
+//
+// Lifetime:
+//   Hosts live in a process-wide registry keyed by the hop chain. An SshClient
+//   that connected through a host keeps a reference until disconnect(). A host
+//   with no open tunnels closes itself after a short linger, so back-to-back
+//   fleet targets still share the bastion. shutdownAll() runs at app exit.
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include <atomic>
+#include <thread>
+
+#include "SshProfile.h"
+#include "SshClient.h"
+
+struct ssh_channel_struct;
+using ssh_channel = ssh_channel_struct*;
+
+class SshJumpHost
+{
+public:
+    ~SshJumpHost();
+
+    // For a profile with jump hosts: get (or create) the shared host for
+    // target.proxyJump and open a tunnel to target.host:port.
+    // On success *fdOut is the inner session's end (hand to SSH_OPTIONS_FD;
+    // libssh closes it) and *hostOut keeps the shared host alive.
+    // Blocking (may connect/authenticate bastions); worker thread only.
+    static bool openTunnelFor(const SshProfile& target,
+                              const SshClient::PassphraseProvider& passphraseProvider,
+                              QSharedPointer<SshJumpHost>* hostOut,
+                              int* fdOut,
+                              QString* err);
+
+    // Close every shared bastion session (application shutdown).
+    static void shutdownAll();
+
+    QString key() const { return m_key; }
+    int tunnelCount() const { return m_tunnelCount.load(); }
+    bool isAlive() const { return m_alive.load(); }
+
+private:
+    SshJumpHost() = default;
+
+    struct Tunnel {
+        enum class State { Opening, Open, Failed };
+
+        ssh_channel ch = nullptr;
+        int         fd = -1;          // relay end of the socketpair
+        QByteArray  toSock;           // channel bytes not yet written to fd
+        QByteArray  toChan;           // fd bytes not yet written to the channel
+        bool        waitWindow = false; // toChan stuck on a zero channel window
+        QString     host;
+        int         port = 0;
+        QString     target;           // host:port (logging)
+        QElapsedTimer since;          // open requested
+
+        // Guarded by m_mutex until the request is answered.
+        State       state = State::Opening;
+        QString     error;
+    };
+
+    static QSharedPointer<SshJumpHost> create(const QVector<JumpHop>& hops,
+                                              const SshProfile& target,
+                                              const SshClient::PassphraseProvider& passphraseProvider,
+                                              QString* err);
+
+    bool openTunnel(const QString& host, int port, int* fdOut, QString* err);
+    void relayLoop();
+    bool stepOpen(Tunnel* t);      // relay: drive one channel open; true when answered
+    bool pumpTunnel(Tunnel* t, QByteArray& buf, bool* moved); // relay: false = tunnel done
+    void answer(Tunnel* t, bool ok, const QString& error);
+    void closeTunnel(Tunnel* t);
+    void wake();
+    void stopRelay();
+
+    QString m_key;                 // canonical hop chain, e.g. "ops@b1,b2:2222"
+    SshClient* m_client = nullptr; // authenticated session to the last hop
+
+    QMutex               m_mutex;  // guards m_requests (+ Tunnel::state/error)
+    QWaitCondition       m_answered;
+    QVector<Tunnel*>     m_requests; // open requests not yet seen by the relay
+    QVector<Tunnel*>     m_opening;  // relay only: channel opens in progress
+    QVector<Tunnel*>     m_tunnels;  // relay only: open tunnels
+    int                  m_wake[2] = { -1, -1 }; // pipe: wakes the relay's poll()
+    std::atomic_int      m_tunnelCount{0};
+    std::atomic_bool     m_alive{false};
+    std::atomic_bool     m_stop{false};
+    std::thread          m_relay;
+};
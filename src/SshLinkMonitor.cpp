@@ -0,0 +1,259 @@
+// SshLinkMonitor.cpp
+//
+// See header for the overall idea. Implementation notes:
+//   - One timer drives both checks. An idle client is probed on a worker
+//     thread; a busy client is only judged by its activity clock, because
+//     probing would have to wait for the very I/O that may be stuck.
+//   - Before reconnecting, the worker waits for the aborted operation to
+//     unwind (abortLink() makes it fail fast), so the old session is never
+//     freed under a running transfer.
+//   - Futures are tagged with m_generation; stop()/start() invalidate results
+//     that arrive late.
+
+#include "SshLinkMonitor.h"
+#include "SshClient.h"
+
+#include <QTimer>
+#include <QThread>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
+
+SshLinkMonitor::SshLinkMonitor(SshClient* ssh, QObject* parent)
+    : QObject(parent),
+      m_ssh(ssh)
+{
+    m_tick = new QTimer(this);
+    m_tick->setInterval(m_intervalSec * 1000);
+    connect(m_tick, &QTimer::timeout, this, &SshLinkMonitor::onTick);
+
+    m_reconnectTimer = new QTimer(this);
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &SshLinkMonitor::attemptReconnect);
+}
+
+SshLinkMonitor::~SshLinkMonitor()
+{
+    stop();
+    waitForFinished();
+}
+
+void SshLinkMonitor::setIntervalSec(int sec)
+{
+    m_intervalSec = (sec <= 0) ? 0 : qBound(5, sec, 300);
+
+    if (m_intervalSec == 0) {
+        m_tick->stop();
+        return;
+    }
+
+    m_tick->setInterval(m_intervalSec * 1000);
+    if (m_active && !m_reconnecting && !m_tick->isActive())
+        m_tick->start();
+}
+
+void SshLinkMonitor::setMaxMisses(int n)
+{
+    m_maxMisses = qBound(1, n, 10);
+}
+
+void SshLinkMonitor::setAutoReconnect(bool on)
+{
+    m_autoReconnect = on;
+    if (!on && m_reconnectTimer->isActive()) {
+        m_reconnectTimer->stop();
+        m_reconnecting = false;
+    }
+}
+
+void SshLinkMonitor::start(const SshProfile& p)
+{
+    ++m_generation;
+    m_profile      = p;
+    m_active       = true;
+    m_misses       = 0;
+    m_attempt      = 0;
+    m_reconnecting = false;
+    m_reconnectTimer->stop();
+
+    if (m_intervalSec > 0)
+        m_tick->start();
+
+    qInfo().noquote() << QString("[LINK] watching %1@%2 (keepalive %3 s, dead after %4 misses)")
+                         .arg(p.user, p.host)
+                         .arg(m_intervalSec)
+                         .arg(m_maxMisses);
+}
+
+void SshLinkMonitor::stop()
+{
+    ++m_generation;
+    m_active       = false;
+    m_reconnecting = false;
+    m_tick->stop();
+    m_reconnectTimer->stop();
+}
+
+void SshLinkMonitor::waitForFinished()
+{
+    m_probeFuture.waitForFinished();
+    m_reconnectFuture.waitForFinished();
+}
+
+void SshLinkMonitor::checkNow()
+{
+    onTick();
+}
+
+// ------------------------------------------------------------
+// onTick()
+// ------------------------------------------------------------
+void SshLinkMonitor::onTick()
+{
+    if (!m_active || m_reconnecting || !m_ssh) return;
+
+    if (!m_ssh->hasTransport()) {
+        // Somebody else disconnected the client; nothing to watch.
+        stop();
+        return;
+    }
+
+    // Our own probe keeps the client busy too; its result is handled above.
+    if (m_probeFuture.isRunning()) return;
+
+    const qint64 deadAfterMs = qint64(m_intervalSec) * 1000 * m_maxMisses;
+
+    if (m_ssh->isBusy()) {
+        m_misses = 0;
+        const qint64 quietMs = m_ssh->msSinceActivity();
+        if (quietMs >= deadAfterMs)
+            declareDead(tr("No data for %1 s during transfer").arg(quietMs / 1000));
+        return;
+    }
+
+    if (m_ssh->isLinkLost()) {
+        declareDead(tr("Connection closed"));
+        return;
+    }
+
+    const quint64 gen = m_generation;
+    SshClient* ssh = m_ssh;
+
+    auto* w = new QFutureWatcher<QPair<bool, QString>>(this);
+    connect(w, &QFutureWatcher<QPair<bool, QString>>::finished, this, [this, w, gen]() {
+        const auto res = w->result();
+        w->deleteLater();
+
+        if (gen != m_generation || !m_active || m_reconnecting) return;
+
+        if (res.first) {
+            m_misses = 0;
+            return;
+        }
+
+        ++m_misses;
+        qInfo().noquote() << QString("[LINK] keepalive miss %1/%2: %3")
+                             .arg(m_misses).arg(m_maxMisses).arg(res.second);
+
+        if (m_misses >= m_maxMisses || m_ssh->isLinkLost())
+            declareDead(res.second);
+    });
+
+    m_probeFuture = QtConcurrent::run([ssh]() -> QPair<bool, QString> {
+        QString e;
+        const bool ok = ssh->probeAlive(&e);
+        return qMakePair(ok, e);
+    });
+    w->setFuture(m_probeFuture);
+}
+
+// ------------------------------------------------------------
+// declareDead()
+// ------------------------------------------------------------
+void SshLinkMonitor::declareDead(const QString& reason)
+{
+    m_tick->stop();
+    m_misses = 0;
+
+    m_ssh->abortLink(reason);
+    emit linkLost(reason);
+
+    if (!m_autoReconnect) {
+        m_active = false;
+        return;
+    }
+
+    m_reconnecting = true;
+    m_attempt = 0;
+    scheduleReconnect();
+}
+
+// ------------------------------------------------------------
+// scheduleReconnect()
+// ------------------------------------------------------------
+// Exponential backoff: 1 s, 2 s, 4 s ... capped at 60 s.
+void SshLinkMonitor::scheduleReconnect()
+{
+    ++m_attempt;
+    const int shift   = qMin(m_attempt - 1, 6);
+    const int delayMs = qMin(1000 << shift, 60 * 1000);
+
+    qInfo().noquote() << QString("[LINK] reconnect attempt %1 in %2 ms").arg(m_attempt).arg(delayMs);
+    emit reconnectScheduled(m_attempt, delayMs);
+
+    m_reconnectTimer->start(delayMs);
+}
+
+// ------------------------------------------------------------
+// attemptReconnect()
+// ------------------------------------------------------------
+void SshLinkMonitor::attemptReconnect()
+{
+    if (!m_active || !m_reconnecting) return;
+    if (m_reconnectFuture.isRunning()) return;
+
+    const quint64 gen = m_generation;
+    const int attempt = m_attempt;
+    SshClient* ssh = m_ssh;
+    const SshProfile p = m_profile;
+
+    auto* w = new QFutureWatcher<QPair<bool, QString>>(this);
+    connect(w, &QFutureWatcher<QPair<bool, QString>>::finished, this, [this, w, gen, attempt]() {
+        const auto res = w->result();
+        w->deleteLater();
+
+        if (gen != m_generation || !m_active) return;
+
+        if (res.first) {
+            qInfo().noquote() << QString("[LINK] reconnected after %1 attempt(s)").arg(attempt);
+            m_reconnecting = false;
+            m_attempt = 0;
+            m_misses = 0;
+            if (m_intervalSec > 0) m_tick->start();
+            emit reconnected();
+            return;
+        }
+
+        qWarning().noquote() << QString("[LINK] reconnect attempt %1 failed: %2").arg(attempt).arg(res.second);
+        emit reconnectFailed(attempt, res.second);
+        scheduleReconnect();
+    });
+
+    m_reconnectFuture = QtConcurrent::run([ssh, p]() -> QPair<bool, QString> {
+        // Let the aborted operation unwind before the old session is freed.
+        // connectProfile() takes the client's I/O lock itself; waiting here
+        // only bounds how long a stuck operation can hold the reconnect up.
+        QElapsedTimer t;
+        t.start();
+        while (ssh->isBusy() && t.elapsed() < 30 * 1000)
+            QThread::msleep(50);
+        if (ssh->isBusy())
+            return qMakePair(false, SshLinkMonitor::tr("Previous operation is still running."));
+
+        QString e;
+        const bool ok = ssh->connectProfile(p, &e);
+        return qMakePair(ok, e);
+    });
+    w->setFuture(m_reconnectFuture);
+}
@@ -0,0 +1,97 @@
+// SshLinkMonitor.h
+//
+// Purpose:
+//   Keeps MainWindow's libssh session (SFTP + exec helpers) honest.
+//   Without it, a network blip leaves SshClient "connected" until the next
+//   operation fails, and an in-flight transfer can hang on a dead socket.
+//
+// What it does:
+//   - keepalive: every intervalSec() an idle session gets SshClient::probeAlive()
+//   - dead-peer detection:
+//       idle:  maxMisses() consecutive failed probes
+//       busy:  no bytes moved for intervalSec() * maxMisses() (stalled transfer)
+//     -> SshClient::abortLink() so blocked I/O fails fast, then linkLost()
+//   - auto-reconnect to the same profile with exponential backoff
+//     (1 s, 2 s, 4 s ... capped at 60 s) until it works or stop() is called
+//
+// Threading:
+//   Lives on the UI thread (timers). Probes and reconnects run via QtConcurrent,
+//   like MainWindow's regular libssh connect.
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QFuture>
+#include <QPair>
+
+#include "SshProfile.h"
+
+class QTimer;
+class SshClient;
+
+class SshLinkMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SshLinkMonitor(SshClient* ssh, QObject* parent = nullptr);
+    ~SshLinkMonitor() override;
+
+    void setIntervalSec(int sec);      // 0 = keepalive off; otherwise clamped 5..300
+    int  intervalSec() const { return m_intervalSec; }
+
+    void setMaxMisses(int n);          // default 3, clamped 1..10
+    int  maxMisses() const { return m_maxMisses; }
+
+    void setAutoReconnect(bool on);
+    bool autoReconnect() const { return m_autoReconnect; }
+
+    // Start watching after a successful connect of profile p.
+    void start(const SshProfile& p);
+
+    // Stop watching (user disconnect / new connect / shutdown).
+    // Does not block; results of a probe/reconnect still running are dropped.
+    void stop();
+
+    // Block until no probe/reconnect is using the SshClient. Call after stop()
+    // before touching the client from elsewhere (connect, disconnect, shutdown).
+    void waitForFinished();
+
+    // Run the health check now (e.g. right after an operation failed).
+    void checkNow();
+
+    bool isReconnecting() const { return m_reconnecting; }
+
+signals:
+    void linkLost(const QString& reason);
+    void reconnectScheduled(int attempt, int delayMs);
+    void reconnected();
+    void reconnectFailed(int attempt, const QString& err);
+
+private:
+    void onTick();
+    void declareDead(const QString& reason);
+    void scheduleReconnect();
+    void attemptReconnect();
+
+    SshClient* m_ssh = nullptr;
+    SshProfile m_profile;
+    bool       m_active = false;
+
+    int  m_intervalSec   = 15;
+    int  m_maxMisses     = 3;
+    bool m_autoReconnect = true;
+
+    QTimer* m_tick           = nullptr;
+    QTimer* m_reconnectTimer = nullptr;
+
+    QFuture<QPair<bool, QString>> m_probeFuture;
+    QFuture<QPair<bool, QString>> m_reconnectFuture;
+
+    int  m_misses       = 0;
+    bool m_reconnecting = false;
+    int  m_attempt      = 0;
+
+    // Bumped by start()/stop() so late results from a previous run are ignored.
+    quint64 m_generation = 0;
+};
@@ -0,0 +1,195 @@
+// SshPreconnectPool.cpp
+//
+// See header for the overall idea. Implementation notes:
+//   - Each entry owns its own SshClient; the speculative connect runs via
+//     QtConcurrent (same as MainWindow's regular libssh connect).
+//   - Disposal (ssh_disconnect) can block on a dead socket, so it is pushed
+//     to a worker thread as well; the UI thread never waits on the network.
+//   - An entry that is still connecting when it expires is disposed once its
+//     connect finishes (the disposal task waits for the future).
+
+#include "SshPreconnectPool.h"
+#include "SshClient.h"
+
+#include <QTimer>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+
+SshPreconnectPool::SshPreconnectPool(QObject* parent)
+    : QObject(parent)
+{
+    m_reaper = new QTimer(this);
+    m_reaper->setInterval(2000);
+    connect(m_reaper, &QTimer::timeout, this, &SshPreconnectPool::reap);
+}
+
+SshPreconnectPool::~SshPreconnectPool()
+{
+    // Shutdown: close synchronously so no worker outlives the pool.
+    for (const Claim& c : m_entries) {
+        if (!c) continue;
+        c->future.waitForFinished();
+        if (c->client) c->client->disconnect();
+    }
+    m_entries.clear();
+}
+
+void SshPreconnectPool::setEnabled(bool on)
+{
+    if (m_enabled == on) return;
+    m_enabled = on;
+
+    qInfo().noquote() << QString("[PRECONNECT] speculative pre-connect %1").arg(on ? "enabled" : "disabled");
+
+    if (!on) clear();
+}
+
+void SshPreconnectPool::setMaxEntries(int n)
+{
+    m_maxEntries = qBound(1, n, 8);
+}
+
+void SshPreconnectPool::setTtlMs(int ms)
+{
+    m_ttlMs = qBound(2000, ms, 60 * 1000);
+}
+
+QString SshPreconnectPool::keyFor(const SshProfile& p)
+{
+    const int port = (p.port > 0) ? p.port : 22;
+    const QString kt = p.keyType.trimmed().isEmpty() ? QStringLiteral("auto") : p.keyType.trimmed();
+
+    return QString("%1@%2:%3|%4|%5|%6")
+        .arg(p.user.trimmed(), p.host.trimmed())
+        .arg(port)
+        .arg(p.keyFile.trimmed(), kt, proxyJumpToString(parseProxyJump(p.proxyJump)));
+}
+
+void SshPreconnectPool::warm(const SshProfile& p)
+{
+    if (!m_enabled) return;
+    if (p.user.trimmed().isEmpty() || p.host.trimmed().isEmpty()) return;
+
+    // Same gate as connectTransport(): only key types libssh can authenticate.
+    const QString kt = p.keyType.trimmed().isEmpty() ? QStringLiteral("auto") : p.keyType.trimmed();
+    if (kt != "auto" && kt != "openssh") return;
+
+    const QString key = keyFor(p);
+
+    for (const Claim& c : m_entries) {
+        if (c && c->key == key && c->age.elapsed() < m_ttlMs)
+            return; // already warming / warm
+    }
+
+    // Make room: evict oldest entries first.
+    while (m_entries.size() >= m_maxEntries && !m_entries.isEmpty())
+        dispose(m_entries.takeFirst());
+
+    auto e = Claim::create();
+    e->key = key;
+    e->client = QSharedPointer<SshClient>::create();
+    e->age.start();
+
+    const QSharedPointer<SshClient> client = e->client;
+    const SshProfile snapshot = p;
+
+    e->future = QtConcurrent::run([client, snapshot]() -> bool {
+        QString err;
+        const bool ok = client->connectTransport(snapshot, &err);
+        if (!ok) {
+            qInfo().noquote() << QString("[PRECONNECT] speculative connect failed host='%1': %2")
+                                 .arg(snapshot.host, err);
+        }
+        return ok;
+    });
+
+    m_entries.push_back(e);
+
+    qInfo().noquote() << QString("[PRECONNECT] warming %1@%2 (%3/%4 slots)")
+                         .arg(p.user, p.host)
+                         .arg(m_entries.size())
+                         .arg(m_maxEntries);
+
+    if (!m_reaper->isActive())
+        m_reaper->start();
+}
+
+SshPreconnectPool::Claim SshPreconnectPool::claim(const SshProfile& p)
+{
+    const QString key = keyFor(p);
+
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const Claim c = m_entries[i];
+        if (!c || c->key != key) continue;
+
+        m_entries.removeAt(i);
+
+        if (c->age.elapsed() >= m_ttlMs) {
+            dispose(c);
+            return {};
+        }
+
+        qInfo().noquote() << QString("[PRECONNECT] claimed %1 (age %2 ms)")
+                             .arg(p.host)
+                             .arg(c->age.elapsed());
+        return c;
+    }
+
+    return {};
+}
+
+bool SshPreconnectPool::adoptInto(const Claim& c, SshClient* target)
+{
+    if (!c || !c->client || !target) return false;
+
+    c->future.waitForFinished();
+    if (!c->future.result())
+        return false;
+
+    if (!target->adoptSession(*c->client)) {
+        c->client->disconnect();
+        return false;
+    }
+    return true;
+}
+
+void SshPreconnectPool::clear()
+{
+    const QVector<Claim> all = m_entries;
+    m_entries.clear();
+
+    for (const Claim& c : all)
+        dispose(c);
+
+    if (m_reaper) m_reaper->stop();
+}
+
+void SshPreconnectPool::reap()
+{
+    for (int i = m_entries.size() - 1; i >= 0; --i) {
+        const Claim c = m_entries[i];
+        if (!c) { m_entries.removeAt(i); continue; }
+
+        const bool expired = c->age.elapsed() >= m_ttlMs;
+        const bool failed  = c->future.isFinished() && !c->future.result();
+
+        if (expired || failed) {
+            m_entries.removeAt(i);
+            dispose(c);
+        }
+    }
+
+    if (m_entries.isEmpty())
+        m_reaper->stop();
+}
+
+void SshPreconnectPool::dispose(const Claim& c)
+{
+    if (!c) return;
+
+    // Never block the UI thread on ssh_disconnect() or an in-flight connect.
+    QtConcurrent::run([c]() {
+        c->future.waitForFinished();
+        if (c->client) c->client->disconnect();
+    });
+}
@@ -0,0 +1,89 @@
+// SshPreconnectPool.h
+//
+// Purpose:
+//   Small, bounded pool of *speculative* libssh connections.
+//   When the user selects (or hovers) a profile, MainWindow asks the pool to
+//   "warm" it: DNS resolution, TCP connect and key exchange run in the
+//   background (SshClient::connectTransport), stopping right before user auth.
+//   When the user then clicks Connect, the warmed transport is claimed and
+//   adopted into the real client, so only authentication is left to do.
+//
+// Bounds:
+//   - at most maxEntries() speculative sessions at once (oldest is evicted)
+//   - each entry lives at most ttlMs(); a reaper timer closes stale ones
+//   - nothing happens unless setEnabled(true) (opt-in via Settings)
+//
+// Threading:
+//   warm()/claim() are called on the UI thread. adoptInto() blocks until the
+//   speculative connect finishes, so it must run on a worker thread
+//   (same rule as connectProfile()).
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include <QFuture>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+
+#include "SshProfile.h"
+
+class QTimer;
+class SshClient;
+
+class SshPreconnectPool : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SshPreconnectPool(QObject* parent = nullptr);
+    ~SshPreconnectPool() override;
+
+    // One speculative connection (owned by the pool until claimed).
+    struct Entry {
+        QString                   key;
+        QSharedPointer<SshClient> client;
+        QFuture<bool>             future;   // result of connectTransport()
+        QElapsedTimer             age;
+    };
+    using Claim = QSharedPointer<Entry>;
+
+    void setEnabled(bool on);
+    bool isEnabled() const { return m_enabled; }
+
+    void setMaxEntries(int n);   // default 2, clamped 1..8
+    int  maxEntries() const { return m_maxEntries; }
+
+    void setTtlMs(int ms);       // default 15 s, clamped 2..60 s
+    int  ttlMs() const { return m_ttlMs; }
+
+    // Start a speculative transport connect for p (no-op when disabled,
+    // when p is unusable, or when a fresh entry for p already exists).
+    void warm(const SshProfile& p);
+
+    // Remove and return the entry matching p (null if none / expired).
+    Claim claim(const SshProfile& p);
+
+    // Wait for a claimed entry and move its session into target.
+    // Returns false if the speculative connect failed or the session died;
+    // the caller should then fall back to a regular connectProfile().
+    // Worker thread only.
+    static bool adoptInto(const Claim& c, SshClient* target);
+
+    // Close all speculative sessions.
+    void clear();
+
+    // Identity of a profile's transport (user/host/port/key settings/jump hosts).
+    static QString keyFor(const SshProfile& p);
+
+private:
+    void reap();
+    void dispose(const Claim& c);
+
+    bool m_enabled    = false;
+    int  m_maxEntries = 2;
+    int  m_ttlMs      = 15 * 1000;
+
+    QVector<Claim> m_entries;
+    QTimer*        m_reaper = nullptr;
+};
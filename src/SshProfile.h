@@ -3,6 +3,7 @@
 #include <QString>
 #include <QVector>
 #include <QUuid>
+#include <QStringList>
 
 
 static inline QString newProfileId()
@@ -60,6 +61,80 @@ static inline PortForwardType portForwardTypeFromString(const QString &s)
     return PortForwardType::Local;
 }
 
+// -----------------------------
+// Jump hosts (ProxyJump)
+// -----------------------------
+// One hop of an OpenSSH-style ProxyJump chain: [user@]host[:port]
+// (IPv6 literals in brackets: [::1]:2222). Empty user = target profile's user.
+struct JumpHop {
+    QString user;
+    QString host;
+    int     port = 22;
+};
+
+// Parse "hop1,hop2,..." in OpenSSH ProxyJump syntax. "none"/empty -> no hops.
+// Malformed hops are skipped.
+static inline QVector<JumpHop> parseProxyJump(const QString &spec)
+{
+    QVector<JumpHop> out;
+    const QString v = spec.trimmed();
+    if (v.isEmpty() || v.compare("none", Qt::CaseInsensitive) == 0) return out;
+
+    const QStringList parts = v.split(',', Qt::SkipEmptyParts);
+    for (QString part : parts) {
+        part = part.trimmed();
+        if (part.startsWith("ssh://")) part = part.mid(6);
+
+        JumpHop h;
+        const int at = part.lastIndexOf('@');
+        if (at >= 0) {
+            h.user = part.left(at).trimmed();
+            part = part.mid(at + 1).trimmed();
+        }
+
+        QString portStr;
+        if (part.startsWith('[')) {
+            const int close = part.indexOf(']');
+            if (close < 0) continue;
+            h.host = part.mid(1, close - 1);
+            if (part.mid(close + 1).startsWith(':')) portStr = part.mid(close + 2);
+        } else {
+            const int colon = part.lastIndexOf(':');
+            if (colon >= 0 && part.indexOf(':') == colon) {
+                h.host = part.left(colon);
+                portStr = part.mid(colon + 1);
+            } else {
+                h.host = part;
+            }
+        }
+
+        if (!portStr.isEmpty()) {
+            bool ok = false;
+            const int p = portStr.toInt(&ok);
+            if (!ok || p <= 0 || p > 65535) continue;
+            h.port = p;
+        }
+
+        h.host = h.host.trimmed();
+        if (h.host.isEmpty()) continue;
+        out.push_back(h);
+    }
+    return out;
+}
+
+// Inverse of parseProxyJump() (canonical form, used for keys and ssh -J).
+static inline QString proxyJumpToString(const QVector<JumpHop> &hops)
+{
+    QStringList parts;
+    for (const JumpHop &h : hops) {
+        QString host = h.host.contains(':') ? QString("[%1]").arg(h.host) : h.host;
+        QString s = h.user.isEmpty() ? host : QString("%1@%2").arg(h.user, host);
+        if (h.port != 22) s += QString(":%1").arg(h.port);
+        parts << s;
+    }
+    return parts.join(',');
+}
+
 struct SshProfile {
 
     // Stable identity
@@ -86,6 +161,10 @@ struct SshProfile {
     QString keyFile;
     QString keyType = "auto";
 
+    // Jump hosts, OpenSSH ProxyJump syntax ("user@bastion:22,inner-bastion").
+    // Empty = direct connection.
+    QString proxyJump;
+
     // -----------------------------
     // Hotkey macros (NEW: multi)
     // -----------------------------
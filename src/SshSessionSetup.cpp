@@ -0,0 +1,646 @@
+// SshSessionSetup.cpp
+//
+// See header. Moved out of SshClient::connectTransport()/authenticate() so the
+// fleet event engine runs the same setup on its non-blocking sessions.
+
+#include "SshSessionSetup.h"
+#include "SshCipherTuner.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QObject>
+#include <QPair>
+#include <QSettings>
+#include <QtEndian>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+
+// ------------------------------------------------------------
+// applyAlgorithms()
+// ------------------------------------------------------------
+void SshSessionSetup::applyAlgorithms(ssh_session s, bool log)
+{
+    auto lastError = [s]() {
+        const char* e = ssh_get_error(s);
+        return (e && *e) ? QString::fromLocal8Bit(e) : QStringLiteral("unknown error");
+    };
+
+    // --- Prefer PQ hybrid KEX when available (libssh 0.11.x+) ---
+    // Must be set BEFORE ssh_connect(). Best-effort (older libssh may reject).
+    const char *kexPref =
+        "sntrup761x25519-sha512@openssh.com,"
+        "curve25519-sha256";
+
+    const int kexRc = ssh_options_set(s, SSH_OPTIONS_KEY_EXCHANGE, kexPref);
+    if (log) {
+        if (kexRc == SSH_OK)
+            qInfo().noquote() << QString("[SSH] KEX preference set: %1").arg(kexPref);
+        else
+            qInfo().noquote() << QString("[SSH] KEX preference not applied: %1").arg(lastError());
+    }
+
+    // --- Cipher/MAC order tuned for this CPU (see SshCipherTuner) ---
+    // Allowlisted algorithms only, fastest first. Empty = no benchmark cached
+    // yet or tuning disabled -> keep libssh defaults. Best-effort like KEX.
+    const QByteArray ciphers = SshCipherTuner::preferredCiphers().toLatin1();
+    if (!ciphers.isEmpty()) {
+        const bool ok =
+            ssh_options_set(s, SSH_OPTIONS_CIPHERS_C_S, ciphers.constData()) == SSH_OK &&
+            ssh_options_set(s, SSH_OPTIONS_CIPHERS_S_C, ciphers.constData()) == SSH_OK;
+        if (log && ok)
+            qInfo().noquote() << QString("[SSH] cipher preference set: %1").arg(QString::fromLatin1(ciphers));
+        else if (log)
+            qInfo().noquote() << QString("[SSH] cipher preference not applied: %1").arg(lastError());
+    }
+
+    const QByteArray macs = SshCipherTuner::preferredMacs().toLatin1();
+    if (!macs.isEmpty()) {
+        const bool ok =
+            ssh_options_set(s, SSH_OPTIONS_HMAC_C_S, macs.constData()) == SSH_OK &&
+            ssh_options_set(s, SSH_OPTIONS_HMAC_S_C, macs.constData()) == SSH_OK;
+        if (log && !ok)
+            qInfo().noquote() << QString("[SSH] MAC preference not applied: %1").arg(lastError());
+    }
+}
+
+// ------------------------------------------------------------
+// installPassphraseCallback()
+// ------------------------------------------------------------
+// libssh keeps a pointer to cb, so the caller owns it (SshClient::m_cb, one
+// per fleet engine session).
+void SshSessionSetup::installPassphraseCallback(ssh_session s, ssh_callbacks_struct* cb,
+                                                const SshClient::PassphraseProvider* provider)
+{
+    std::memset(cb, 0, sizeof(*cb));
+#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0,9,0)
+    ssh_callbacks_init(cb);
+#endif
+    cb->userdata = const_cast<SshClient::PassphraseProvider*>(provider);
+
+    cb->auth_function = [](const char *prompt,
+                           char *buf,
+                           size_t len,
+                           int echo,
+                           int verify,
+                           void *userdata) -> int
+    {
+        Q_UNUSED(prompt);
+        Q_UNUSED(echo);
+        Q_UNUSED(verify);
+
+        auto *provider = static_cast<const SshClient::PassphraseProvider*>(userdata);
+        if (!provider || !*provider) return SSH_AUTH_DENIED;
+        if (len == 0) return SSH_AUTH_DENIED;
+
+        bool ok = false;
+        // NOTE: key path is unknown here; pass empty (UI may show generic prompt)
+        const QString pass = (*provider)(QString(), &ok);
+        if (!ok) return SSH_AUTH_DENIED;
+
+        const QByteArray utf8 = pass.toUtf8();
+        const size_t n = std::min(len - 1, static_cast<size_t>(utf8.size()));
+        std::memcpy(buf, utf8.constData(), n);
+        buf[n] = '\0';
+        return SSH_AUTH_SUCCESS;
+    };
+
+    ssh_set_callbacks(s, cb);
+}
+
+QString SshSessionSetup::authProfileKey(const SshProfile& p)
+{
+    const QString id = p.id.trimmed();
+    if (!id.isEmpty()) return id;
+    const int port = (p.port > 0) ? p.port : 22;
+    return QString("%1@%2:%3").arg(p.user.trimmed(), p.host.trimmed()).arg(port);
+}
+
+// ------------------------------------------------------------
+// Auth method cache (QSettings "authCache/...")
+// ------------------------------------------------------------
+// Remembers which auth method succeeded for a profile on a given server
+// host key, so the next connect tries it first.
+//
+// Stored values:
+//   "agent:SHA256:<fp>"   -> ssh-agent worked with the key of this fingerprint
+//   "agent"               -> ssh-agent worked, key unknown (older entries,
+//                            or no AgentRelay)
+//   "publickey:<path>"    -> this private key file worked
+//
+// Keyed by profile identity + server host key fingerprint: if the host key
+// changes, the old entry simply stops matching.
+
+// serverHostKeyFingerprint()
+// SHA256 fingerprint of the server host key ("SHA256:..."), empty on failure.
+static QString serverHostKeyFingerprint(ssh_session s)
+{
+    if (!s) return QString();
+
+    ssh_key srvKey = nullptr;
+#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0,8,0)
+    if (ssh_get_server_publickey(s, &srvKey) != SSH_OK || !srvKey)
+        return QString();
+#else
+    if (ssh_get_publickey(s, &srvKey) != SSH_OK || !srvKey)
+        return QString();
+#endif
+
+    unsigned char *hash = nullptr;
+    size_t hlen = 0;
+    QString out;
+
+    if (ssh_get_publickey_hash(srvKey, SSH_PUBLICKEY_HASH_SHA256, &hash, &hlen) == SSH_OK && hash) {
+        char *fp = ssh_get_fingerprint_hash(SSH_PUBLICKEY_HASH_SHA256, hash, hlen);
+        if (fp) {
+            out = QString::fromLatin1(fp);
+            ssh_string_free_char(fp);
+        }
+        ssh_clean_pubkey_hash(&hash);
+    }
+
+    ssh_key_free(srvKey);
+    return out;
+}
+
+// authCacheKey()
+// QSettings key for (profile, host key). Empty if either part is unknown.
+static QString authCacheKey(const QString& profileKey, const QString& hostKeyFp)
+{
+    if (profileKey.isEmpty() || hostKeyFp.isEmpty()) return QString();
+
+    // Hash both parts: keeps QSettings keys short and free of '/' and ':'.
+    const QByteArray h = QCryptographicHash::hash((profileKey + "|" + hostKeyFp).toUtf8(),
+                                                  QCryptographicHash::Sha256).toHex();
+    return QStringLiteral("authCache/") + QString::fromLatin1(h.left(32));
+}
+
+static QString loadAuthCache(const QString& key)
+{
+    return QSettings().value(key).toString();
+}
+
+static void storeAuthCache(const QString& key, const QString& value)
+{
+    QSettings().setValue(key, value);
+}
+
+static void removeAuthCache(const QString& key)
+{
+    QSettings().remove(key);
+}
+
+// ------------------------------------------------------------
+// AgentRelay
+// ------------------------------------------------------------
+// ssh_userauth_agent() offers every agent key in agent order (a
+// try_publickey query, then a signature for an accepted key) and does not
+// say which key worked; libssh has no public call that signs with one
+// chosen agent key. So libssh reaches the agent through this relay
+// (ssh_set_agent_socket()): requests go to $SSH_AUTH_SOCK unchanged, except
+// that the identity list is cut down to the preferred key (or has it moved
+// first), and the key of the last signature request is noted. After a
+// successful ssh_userauth_agent() that is the key the server accepted.
+
+namespace {
+
+constexpr char kAgentRequestIdentities = 11;
+constexpr char kAgentIdentitiesAnswer  = 12;
+constexpr char kAgentSignRequest       = 13;
+constexpr quint32 kAgentMaxMessage     = 256 * 1024;
+
+bool readFull(int fd, char* p, size_t n)
+{
+    while (n > 0) {
+        const ssize_t r = ::read(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= size_t(r);
+    }
+    return true;
+}
+
+bool writeFull(int fd, const char* p, size_t n)
+{
+    while (n > 0) {
+        const ssize_t r = ::write(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= size_t(r);
+    }
+    return true;
+}
+
+// One agent protocol message: uint32 length, then the body (type first).
+bool readAgentMsg(int fd, QByteArray* body)
+{
+    char len[4];
+    if (!readFull(fd, len, sizeof len)) return false;
+    const quint32 n = qFromBigEndian<quint32>(len);
+    if (n == 0 || n > kAgentMaxMessage) return false;
+    body->resize(int(n));
+    return readFull(fd, body->data(), n);
+}
+
+bool writeAgentMsg(int fd, const QByteArray& body)
+{
+    char len[4];
+    qToBigEndian<quint32>(quint32(body.size()), len);
+    return writeFull(fd, len, sizeof len) && writeFull(fd, body.constData(), size_t(body.size()));
+}
+
+bool takeU32(const QByteArray& b, int* pos, quint32* v)
+{
+    if (*pos + 4 > b.size()) return false;
+    *v = qFromBigEndian<quint32>(b.constData() + *pos);
+    *pos += 4;
+    return true;
+}
+
+bool takeString(const QByteArray& b, int* pos, QByteArray* out)
+{
+    quint32 n = 0;
+    if (!takeU32(b, pos, &n) || n > quint32(b.size() - *pos)) return false;
+    *out = b.mid(*pos, int(n));
+    *pos += int(n);
+    return true;
+}
+
+void putString(QByteArray* b, const QByteArray& s)
+{
+    char len[4];
+    qToBigEndian<quint32>(quint32(s.size()), len);
+    b->append(len, 4);
+    b->append(s);
+}
+
+// "SHA256:<base64>" of a public key blob, as ssh-keygen -l prints it.
+QString keyBlobFingerprint(const QByteArray& blob)
+{
+    return QStringLiteral("SHA256:") +
+           QString::fromLatin1(QCryptographicHash::hash(blob, QCryptographicHash::Sha256)
+                                   .toBase64(QByteArray::OmitTrailingEquals));
+}
+
+} // namespace
+
+class SshSessionSetup::AgentRelay
+{
+public:
+    ~AgentRelay() { finish(); }
+
+    // Connects to $SSH_AUTH_SOCK and hands libssh its end of the relay.
+    // False: no agent, or libssh did not take the socket.
+    bool attach(ssh_session s)
+    {
+        const QByteArray path = qgetenv("SSH_AUTH_SOCK");
+        sockaddr_un addr{};
+        if (path.isEmpty() || size_t(path.size()) >= sizeof addr.sun_path) return false;
+        addr.sun_family = AF_UNIX;
+        memcpy(addr.sun_path, path.constData(), size_t(path.size()));
+
+        m_agent = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (m_agent < 0) return false;
+        if (::connect(m_agent, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0) {
+            closeAll();
+            return false;
+        }
+
+        int sv[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) {
+            closeAll();
+            return false;
+        }
+        m_relay = sv[1];
+        if (ssh_set_agent_socket(s, sv[0]) != SSH_OK) {
+            ::close(sv[0]);
+            closeAll();
+            return false;
+        }
+        // sv[0] belongs to the session now (closed by ssh_free()).
+
+        m_thread = std::thread([this]() { run(); });
+        return true;
+    }
+
+    // Identity list for the next ssh_userauth_agent(): fp first, or (only)
+    // fp alone. Empty fp: the agent's list as is.
+    void prefer(const QString& fp, bool only)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_preferFp = fp;
+        m_onlyPreferred = only;
+        m_signedFp.clear();
+    }
+
+    QString signedFp() const
+    {
+        QMutexLocker lock(&m_mutex);
+        return m_signedFp;
+    }
+
+    // Stops relaying; later agent requests from libssh fail.
+    void finish()
+    {
+        if (m_relay >= 0) ::shutdown(m_relay, SHUT_RDWR);
+        if (m_agent >= 0) ::shutdown(m_agent, SHUT_RDWR);
+        if (m_thread.joinable()) m_thread.join();
+        closeAll();
+    }
+
+private:
+    void closeAll()
+    {
+        if (m_relay >= 0) ::close(m_relay);
+        if (m_agent >= 0) ::close(m_agent);
+        m_relay = m_agent = -1;
+    }
+
+    void run()
+    {
+        QByteArray req, reply;
+        while (readAgentMsg(m_relay, &req)) {
+            if (req.at(0) == kAgentSignRequest) {
+                int pos = 1;
+                QByteArray blob;
+                if (takeString(req, &pos, &blob)) {
+                    QMutexLocker lock(&m_mutex);
+                    m_signedFp = keyBlobFingerprint(blob);
+                }
+            }
+
+            if (!writeAgentMsg(m_agent, req) || !readAgentMsg(m_agent, &reply))
+                break;
+            if (req.at(0) == kAgentRequestIdentities && reply.at(0) == kAgentIdentitiesAnswer)
+                reply = rewriteIdentities(reply);
+            if (!writeAgentMsg(m_relay, reply))
+                break;
+        }
+        ::shutdown(m_relay, SHUT_RDWR);   // libssh sees EOF instead of hanging
+    }
+
+    // Answer body: type, uint32 count, count x (string key blob, string comment).
+    QByteArray rewriteIdentities(const QByteArray& answer) const
+    {
+        QString fp;
+        bool only = false;
+        {
+            QMutexLocker lock(&m_mutex);
+            fp = m_preferFp;
+            only = m_onlyPreferred;
+        }
+        if (fp.isEmpty()) return answer;
+
+        int pos = 1;
+        quint32 n = 0;
+        if (!takeU32(answer, &pos, &n)) return answer;
+
+        QVector<QPair<QByteArray, QByteArray>> ids;
+        for (quint32 i = 0; i < n; ++i) {
+            QByteArray blob, comment;
+            if (!takeString(answer, &pos, &blob) || !takeString(answer, &pos, &comment))
+                return answer;
+            ids.push_back(qMakePair(blob, comment));
+        }
+
+        QVector<QPair<QByteArray, QByteArray>> out;
+        for (const auto& id : ids)
+            if (keyBlobFingerprint(id.first) == fp) out.push_back(id);
+        if (!only) {
+            for (const auto& id : ids)
+                if (keyBlobFingerprint(id.first) != fp) out.push_back(id);
+        }
+
+        QByteArray b(1, kAgentIdentitiesAnswer);
+        char cnt[4];
+        qToBigEndian<quint32>(quint32(out.size()), cnt);
+        b.append(cnt, 4);
+        for (const auto& id : out) {
+            putString(&b, id.first);
+            putString(&b, id.second);
+        }
+        return b;
+    }
+
+    int m_agent = -1;
+    int m_relay = -1;
+    std::thread m_thread;
+
+    mutable QMutex m_mutex;   // guards the fields below (relay thread vs. caller)
+    QString m_preferFp;
+    bool    m_onlyPreferred = false;
+    QString m_signedFp;
+};
+
+// ------------------------------------------------------------
+// Authenticator
+// ------------------------------------------------------------
+// Strategy:
+// 0) whatever succeeded last time for this profile + server host key
+//    (see auth cache helpers above), so we skip slow fallbacks and
+//    don't burn MaxAuthTries on agents holding many keys; for the agent
+//    that is the one remembered key, offered alone (see AgentRelay)
+// 1) agent (ssh-agent), every key
+// 2) publickey_auto (auto-discover keys)
+//
+// On a non-blocking session each libssh call may return SSH_AUTH_AGAIN; it
+// is then repeated with the same arguments on the next step() (libssh keeps
+// its state), so one-time work happens in run()'s begin.
+SshSessionSetup::Authenticator::Authenticator(ssh_session s, const QString& profileKey,
+                                              const QString& logTarget,
+                                              const ssh_callbacks_struct* cb)
+    : m_s(s)
+    , m_cb(cb)
+    , m_profileKey(profileKey)
+    , m_log(logTarget)
+{
+}
+
+SshSessionSetup::Authenticator::~Authenticator()
+{
+    if (m_key) ssh_key_free(m_key);
+}
+
+// Run one method, time it and record the attempt.
+int SshSessionSetup::Authenticator::run(const QString& method, const std::function<void()>& begin,
+                                        const std::function<int()>& call)
+{
+    if (!m_inCall) {
+        begin();
+        m_attemptTimer.start();
+        m_inCall = true;
+    }
+    const int rc = call();
+    if (rc == SSH_AUTH_AGAIN) return rc;
+
+    m_inCall = false;
+    m_attempts.push_back(SshClient::AuthAttempt{method, rc, m_attemptTimer.elapsed()});
+    return rc;
+}
+
+// onlyFp: offer just this key (needs the relay; without it, all keys).
+int SshSessionSetup::Authenticator::tryAgent(const QString& onlyFp)
+{
+    return run(QStringLiteral("agent"),
+               [&]() {
+                   m_agentTried = true;
+                   m_agentAllKeys = m_agentAllKeys || onlyFp.isEmpty() || !m_relayed;
+                   if (m_relayed) m_relay->prefer(onlyFp, !onlyFp.isEmpty());
+               },
+               [&]() { return ssh_userauth_agent(m_s, nullptr); });
+}
+
+int SshSessionSetup::Authenticator::tryIdentityFile(const QString& path)
+{
+    return run(QStringLiteral("publickey"),
+               [&]() {
+                   const QByteArray p = QFile::encodeName(path);
+                   if (ssh_pki_import_privkey_file(p.constData(), nullptr,
+                                                   m_cb ? m_cb->auth_function : nullptr,
+                                                   m_cb ? m_cb->userdata : nullptr, &m_key) != SSH_OK)
+                       m_key = nullptr;
+               },
+               [&]() -> int {
+                   if (!m_key) return SSH_AUTH_DENIED;
+                   const int rc = ssh_userauth_publickey(m_s, nullptr, m_key);
+                   if (rc != SSH_AUTH_AGAIN) {
+                       ssh_key_free(m_key);
+                       m_key = nullptr;
+                   }
+                   return rc;
+               });
+}
+
+int SshSessionSetup::Authenticator::tryAuto()
+{
+    return run(QStringLiteral("publickey_auto"),
+               [&]() {
+                   if (m_agentTried)
+                       qInfo().noquote() << QString("[SSH] auth via agent failed -> trying publickey_auto %1").arg(m_log);
+                   else
+                       qInfo().noquote() << QString("[SSH] no ssh-agent -> trying publickey_auto %1").arg(m_log);
+               },
+               [&]() -> int {
+                   const int rc = ssh_userauth_publickey_auto(m_s, nullptr, nullptr);
+#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0,10,0)
+                   if (rc == SSH_AUTH_SUCCESS) {
+                       char *ident = nullptr;
+                       if (ssh_userauth_publickey_auto_get_current_identity(m_s, &ident) == SSH_OK && ident) {
+                           m_usedIdentity = QFile::decodeName(ident);
+                           ssh_string_free_char(ident);
+                       }
+                   }
+#endif
+                   return rc;
+               });
+}
+
+// Done: remember the winner for next time (only when it is not already the
+// cached value).
+int SshSessionSetup::Authenticator::finish(int rc, const QString& winner)
+{
+    if (m_relay) m_relay->finish();
+    if (rc == SSH_AUTH_SUCCESS && !m_cacheKey.isEmpty() && !winner.isEmpty() && winner != m_cached)
+        storeAuthCache(m_cacheKey, winner);
+    m_stage = Stage::Done;
+    m_rc = rc;
+    return rc;
+}
+
+int SshSessionSetup::Authenticator::step()
+{
+    for (;;) {
+        switch (m_stage) {
+        case Stage::Start: {
+            const QString hostKeyFp = serverHostKeyFingerprint(m_s);
+            m_cacheKey = authCacheKey(m_profileKey, hostKeyFp);
+            m_cached   = m_cacheKey.isEmpty() ? QString() : loadAuthCache(m_cacheKey);
+
+            // The agent is reached through an AgentRelay when possible, which
+            // lets us offer the remembered key alone and learn which key worked.
+            m_relay.reset(new AgentRelay);
+            m_relayed = m_relay->attach(m_s);
+            m_haveAgent = m_relayed || !qEnvironmentVariableIsEmpty("SSH_AUTH_SOCK");
+            m_stage = Stage::Remembered;
+            continue;
+        }
+
+        case Stage::Remembered: {
+            int rc = SSH_AUTH_DENIED;
+            QString winner;
+            if (m_cached == QLatin1String("agent") && m_haveAgent) {
+                rc = tryAgent(QString());
+                if (rc == SSH_AUTH_SUCCESS) {
+                    // Older entry: now that the key is known, remember it instead.
+                    const QString fp = m_relayed ? m_relay->signedFp() : QString();
+                    winner = fp.isEmpty() ? m_cached : QStringLiteral("agent:") + fp;
+                }
+            } else if (m_cached.startsWith(QLatin1String("agent:")) && m_haveAgent) {
+                rc = tryAgent(m_cached.mid(QStringLiteral("agent:").size()));
+                if (rc == SSH_AUTH_SUCCESS) winner = m_cached;
+            } else if (m_cached.startsWith(QLatin1String("publickey:"))) {
+                const QString path = m_cached.mid(QStringLiteral("publickey:").size());
+                if (QFileInfo::exists(path)) {
+                    rc = tryIdentityFile(path);
+                    if (rc == SSH_AUTH_SUCCESS) winner = m_cached;
+                }
+            }
+            if (rc == SSH_AUTH_AGAIN) return rc;
+            if (rc == SSH_AUTH_SUCCESS) return finish(rc, winner);
+
+            if (!m_cached.isEmpty()) {
+                qInfo().noquote() << QString("[SSH] remembered auth method no longer works %1 -> full negotiation")
+                                     .arg(m_log);
+                removeAuthCache(m_cacheKey);
+            }
+            m_stage = Stage::Agent;
+            continue;
+        }
+
+        case Stage::Agent: {
+            // All agent keys (unless step 0 already offered them all).
+            if (m_haveAgent && !m_agentAllKeys) {
+                const int rc = tryAgent(QString());
+                if (rc == SSH_AUTH_AGAIN) return rc;
+                if (rc == SSH_AUTH_SUCCESS) {
+                    const QString fp = m_relayed ? m_relay->signedFp() : QString();
+                    qInfo().noquote() << QString("[SSH] auth OK via agent %1 key=%2")
+                                         .arg(m_log, fp.isEmpty() ? QStringLiteral("?") : fp);
+                    return finish(rc, fp.isEmpty() ? QStringLiteral("agent") : QStringLiteral("agent:") + fp);
+                }
+            }
+            // publickey_auto would offer the agent keys once more; with the
+            // relay closed its agent step fails fast and it goes on to the
+            // key files.
+            m_relay->finish();
+            m_stage = Stage::Auto;
+            continue;
+        }
+
+        case Stage::Auto: {
+            const int rc = tryAuto();
+            if (rc == SSH_AUTH_AGAIN) return rc;
+            if (rc == SSH_AUTH_SUCCESS) {
+                qInfo().noquote() << QString("[SSH] auth OK via publickey_auto %1").arg(m_log);
+                return finish(rc, m_usedIdentity.isEmpty() ? QString()
+                                                           : QStringLiteral("publickey:") + m_usedIdentity);
+            }
+            return finish(rc, QString());
+        }
+
+        case Stage::Done:
+            return m_rc;
+        }
+    }
+}
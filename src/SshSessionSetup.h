@@ -0,0 +1,105 @@
+// SshSessionSetup.h
+//
+// Purpose:
+//   Session setup shared by SshClient (one blocking session) and the fleet
+//   event engine (many non-blocking sessions), so a host gets the same
+//   algorithms and the same authentication on either path.
+//
+//   - applyAlgorithms(): KEX preference (hybrid PQ first) and the cipher/MAC
+//     order tuned for this CPU (SshCipherTuner)
+//   - installPassphraseCallback(): libssh auth callback backed by a
+//     SshClient::PassphraseProvider (encrypted keys)
+//   - Authenticator: the auth strategy (remembered method, ssh-agent through
+//     AgentRelay, publickey_auto) with the auth method cache; step() can be
+//     called again and again on a non-blocking session
+//
+// Threading:
+//   Per session: use from the thread that owns the ssh_session.
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QElapsedTimer>
+
+#include <functional>
+#include <memory>
+
+#include <libssh/libssh.h>
+#include <libssh/callbacks.h>
+
+#include "SshClient.h"
+#include "SshProfile.h"
+
+class SshSessionSetup
+{
+    class AgentRelay;
+
+public:
+    // KEX, cipher and MAC preferences; before ssh_connect(). Best-effort:
+    // what libssh rejects keeps its defaults. log: one line per setting.
+    static void applyAlgorithms(ssh_session s, bool log);
+
+    // Registers cb (which must outlive the session) on s; its auth_function
+    // asks *provider (none, or empty: encrypted keys are refused).
+    static void installPassphraseCallback(ssh_session s, ssh_callbacks_struct* cb,
+                                          const SshClient::PassphraseProvider* provider);
+
+    // Identity of a profile in the auth method cache: its id, or
+    // user@host:port for unsaved profiles.
+    static QString authProfileKey(const SshProfile& p);
+
+    class Authenticator
+    {
+    public:
+        // cb: the session's callbacks (passphrase for remembered key files),
+        // may be null. logTarget: "user='..' host='..'" for log lines.
+        Authenticator(ssh_session s, const QString& profileKey, const QString& logTarget,
+                      const ssh_callbacks_struct* cb);
+        ~Authenticator();
+
+        Authenticator(const Authenticator&) = delete;
+        Authenticator& operator=(const Authenticator&) = delete;
+
+        // SSH_AUTH_SUCCESS; SSH_AUTH_AGAIN on a non-blocking session (call
+        // again once the socket is readable); otherwise the last method's
+        // failure, every method having been tried.
+        int step();
+
+        const QVector<SshClient::AuthAttempt>& attempts() const { return m_attempts; }
+
+    private:
+        enum class Stage { Start, Remembered, Agent, Auto, Done };
+
+        int run(const QString& method, const std::function<void()>& begin,
+                const std::function<int()>& call);
+        int tryAgent(const QString& onlyFp);
+        int tryIdentityFile(const QString& path);
+        int tryAuto();
+        int finish(int rc, const QString& winner);
+
+        ssh_session m_s = nullptr;
+        const ssh_callbacks_struct* m_cb = nullptr;
+        QString m_profileKey;
+        QString m_log;
+        QString m_cacheKey;
+        QString m_cached;
+
+        Stage m_stage = Stage::Start;
+        int   m_rc = SSH_AUTH_DENIED;
+
+        std::unique_ptr<AgentRelay> m_relay;
+        bool m_relayed = false;
+        bool m_haveAgent = false;
+        bool m_agentTried = false;
+        bool m_agentAllKeys = false;   // every agent key has been offered
+
+        // Attempt in progress (a call that returned SSH_AUTH_AGAIN is repeated)
+        bool          m_inCall = false;
+        QElapsedTimer m_attemptTimer;
+        ssh_key       m_key = nullptr;   // remembered identity file
+        QString       m_usedIdentity;
+
+        QVector<SshClient::AuthAttempt> m_attempts;
+    };
+};
@@ -1,6 +1,12 @@
 #include "SshShellWorker.h"
 #include <QDebug>
-#include <QThread>
+#include <QMutexLocker>
+
+#include <libssh/callbacks.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
 
 /*
  * SshShellWorker
@@ -106,8 +112,10 @@ SshShellWorker::SshShellWorker(ssh_session session,
  *
  * Responsibilities:
  *  - Open PTY-backed shell channel
- *  - Continuously read remote output (non-blocking)
- *  - Emit outputReady() for UI consumption
+ *  - Sleep in ssh_event_dopoll() on the session socket + wake pipe
+ *  - Copy remote output into the ring from the channel data callback
+ *    (and pull libssh's backlog after a pause)
+ *  - Write input queued by sendInput() when woken
  *  - Detect remote EOF / close
  *  - Clean up channel resources
  *  - Emit shellClosed() with a human-readable reason
@@ -125,48 +133,111 @@ void SshShellWorker::startShell()
 
     qDebug() << "[SshShellWorker] openPtyShell OK, channel =" << m_channel;
 
-    m_running.storeRelaxed(true);
+    m_remoteEof    = false;
+    m_remoteClosed = false;
+    m_exitStatus   = -1;
+    m_readPaused.storeRelaxed(false);
+
+    // Channel callbacks: data and exit status are handled the moment
+    // ssh_event_dopoll() reads them off the socket.
+    ssh_channel_callbacks_struct cb{};
+    cb.userdata                     = this;
+    cb.channel_data_function        = &SshShellWorker::onChannelData;
+    cb.channel_eof_function         = &SshShellWorker::onChannelEof;
+    cb.channel_close_function       = &SshShellWorker::onChannelClose;
+    cb.channel_exit_status_function = &SshShellWorker::onChannelExitStatus;
+    ssh_callbacks_init(&cb);
+    ssh_set_channel_callbacks(m_channel, &cb);
+
+    // Self-pipe for sendInput()/stopShell() wakeups.
+    if (::pipe(m_wakeFds) == 0) {
+        for (int fd : m_wakeFds) {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    } else {
+        m_wakeFds[0] = m_wakeFds[1] = -1;
+    }
+
+    ssh_event ev = ssh_event_new();
+    const bool evOk = ev
+        && ssh_event_add_session(ev, m_session) == SSH_OK
+        && (m_wakeFds[0] < 0 ||
+            ssh_event_add_fd(ev, m_wakeFds[0], POLLIN, &SshShellWorker::onWakeFd, this) == SSH_OK);
 
-    char buf[4096];
+    m_running.storeRelaxed(evOk);
+
+    QString error;
+    if (!evOk)
+        error = QStringLiteral("Failed to set up shell event loop");
+
+    // Main I/O loop: blocks until the server sends something or we are woken.
+    // Without a wake pipe, fall back to a short timeout so input still flows.
+    const int waitMs = (m_wakeFds[0] >= 0) ? -1 : 20;
 
-    // Main I/O loop:
-    // - Non-blocking reads
-    // - Small sleep to avoid busy-spinning
     while (m_running.loadRelaxed()) {
 
-        int n = ssh_channel_read_nonblocking(m_channel, buf, sizeof(buf), 0);
-        if (n > 0) {
-            emit outputReady(QByteArray(buf, n));
+        if (!flushInput()) {
+            error = QStringLiteral("Write to shell failed");
+            break;
         }
 
-        // Remote side closed the channel or sent EOF
-        if (ssh_channel_is_eof(m_channel) || ssh_channel_is_closed(m_channel)) {
+        // Consumer made room: move what libssh held back into the ring.
+        if (m_readPaused.loadRelaxed() && !pullBacklog()) {
+            error = QString("Connection error: %1").arg(QString::fromUtf8(ssh_get_error(m_session)));
+            break;
+        }
+
+        // Remote side closed the channel or sent EOF (after EOF, keep going
+        // until the held-back output has reached the ring)
+        if ((m_remoteEof && !m_readPaused.loadRelaxed())
+            || m_remoteClosed || ssh_channel_is_closed(m_channel)) {
             qDebug() << "[SshShellWorker] channel EOF or closed";
             break;
         }
 
-        QThread::msleep(5);
+        if (ssh_event_dopoll(ev, waitMs) == SSH_ERROR) {
+            if (!m_remoteEof && !m_remoteClosed)
+                error = QString("Connection error: %1").arg(QString::fromUtf8(ssh_get_error(m_session)));
+            break;
+        }
     }
 
+    m_running.storeRelaxed(false);
+
     // -----------------------------------------------------------------------
     // Cleanup + exit reporting
     // -----------------------------------------------------------------------
 
-    int exitStatus = -1;
+    if (ev) {
+        if (m_wakeFds[0] >= 0) ssh_event_remove_fd(ev, m_wakeFds[0]);
+        ssh_event_remove_session(ev, m_session);
+        ssh_event_free(ev);
+    }
 
-    if (m_channel) {
-        // libssh contract:
-        // exit status is valid only AFTER channel is closed
-        exitStatus = ssh_channel_get_exit_status(m_channel);
+    const int exitStatus = m_exitStatus;
 
+    if (m_channel) {
+        ssh_remove_channel_callbacks(m_channel, &cb);
         ssh_channel_send_eof(m_channel);
         ssh_channel_close(m_channel);
         ssh_channel_free(m_channel);
         m_channel = nullptr;
     }
 
+    {
+        QMutexLocker lock(&m_inputMutex);
+        for (int& fd : m_wakeFds) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+        m_pendingInput.clear();
+    }
+
     QString reason;
-    if (exitStatus < 0) {
+    if (!error.isEmpty()) {
+        reason = error;
+    } else if (exitStatus < 0) {
         reason = QStringLiteral("Shell terminated");
     } else if (exitStatus == 0) {
         reason = QStringLiteral("Shell exited normally");
@@ -185,7 +256,7 @@ void SshShellWorker::startShell()
  *
  * This does NOT immediately close the channel.
  * Instead:
- *  - The read loop notices m_running == false
+ *  - The loop is woken and notices m_running == false
  *  - Cleanup happens in startShell()
  *
  * Safe to call from any thread.
@@ -194,6 +265,142 @@ void SshShellWorker::stopShell()
 {
     qDebug() << "[SshShellWorker] stopShell() called";
     m_running.storeRelaxed(false);
+    wake();
+}
+
+/*
+ * wake
+ * ----
+ * Interrupts ssh_event_dopoll() in the worker thread. One byte is enough;
+ * a full pipe already means a wakeup is pending.
+ */
+void SshShellWorker::wake()
+{
+    QMutexLocker lock(&m_inputMutex);
+    if (m_wakeFds[1] < 0)
+        return;
+    const char b = 1;
+    const ssize_t rc = ::write(m_wakeFds[1], &b, 1);
+    Q_UNUSED(rc);
+}
+
+/*
+ * resumeReading
+ * -------------
+ * Called by the consumer after draining the ring. The flag is set before
+ * the loop re-checks free space, so a drain that races with a pause is
+ * still seen by the loop on its next iteration.
+ */
+void SshShellWorker::resumeReading()
+{
+    if (m_readPaused.loadRelaxed())
+        wake();
+}
+
+// ===========================================================================
+// Output handling
+// ===========================================================================
+
+/*
+ * pushOutput
+ * ----------
+ * Copies as much as fits into the ring and returns that count.
+ * Notifies the consumer only on the empty → non-empty transition.
+ */
+int SshShellWorker::pushOutput(const char *data, int len)
+{
+    bool wasEmpty = false;
+    const int n = m_output.write(data, len, &wasEmpty);
+    if (n > 0 && wasEmpty)
+        emit outputAvailable();
+    if (n < len)
+        m_readPaused.storeRelaxed(true);
+    return n;
+}
+
+/*
+ * pullBacklog
+ * -----------
+ * While paused, libssh keeps unconsumed channel data in its own buffer and
+ * the callback is not called again until more data arrives - which will not
+ * happen once the window is exhausted. Read it out explicitly, never more
+ * than the ring can take. Reading also lets libssh re-open the window.
+ *
+ * Worker thread only. Returns false on a channel error.
+ */
+bool SshShellWorker::pullBacklog()
+{
+    char buf[16384];
+
+    for (;;) {
+        const int room = m_output.freeSpace();
+        if (room <= 0)
+            return true;                         // still full, stay paused
+
+        const int avail = ssh_channel_poll(m_channel, 0);
+        if (avail == SSH_ERROR)
+            return false;
+        if (avail <= 0) {                        // nothing held back (or EOF)
+            m_readPaused.storeRelaxed(false);
+            return true;
+        }
+
+        const int want = qMin(qMin(room, avail), int(sizeof(buf)));
+        const int rc = ssh_channel_read_nonblocking(m_channel, buf, uint32_t(want), 0);
+        if (rc == SSH_ERROR)
+            return false;
+        if (rc <= 0)
+            return true;
+
+        pushOutput(buf, rc);
+    }
+}
+
+// ===========================================================================
+// libssh callbacks (worker thread, inside ssh_event_dopoll)
+// ===========================================================================
+
+int SshShellWorker::onChannelData(ssh_session, ssh_channel, void *data, uint32_t len,
+                                  int isStderr, void *userdata)
+{
+    Q_UNUSED(isStderr); // PTY: stderr is merged by the remote side anyway
+    auto *self = static_cast<SshShellWorker*>(userdata);
+    if (len == 0)
+        return 0;
+
+    // Older bytes held back by libssh must go out first.
+    if (self->m_readPaused.loadRelaxed())
+        return 0;
+
+    // Returning less than len leaves the rest in libssh's channel buffer;
+    // that is the backpressure (see pullBacklog()).
+    return self->pushOutput(static_cast<const char*>(data), int(len));
+}
+
+void SshShellWorker::onChannelEof(ssh_session, ssh_channel, void *userdata)
+{
+    static_cast<SshShellWorker*>(userdata)->m_remoteEof = true;
+}
+
+void SshShellWorker::onChannelClose(ssh_session, ssh_channel, void *userdata)
+{
+    static_cast<SshShellWorker*>(userdata)->m_remoteClosed = true;
+}
+
+void SshShellWorker::onChannelExitStatus(ssh_session, ssh_channel, int status, void *userdata)
+{
+    static_cast<SshShellWorker*>(userdata)->m_exitStatus = status;
+}
+
+int SshShellWorker::onWakeFd(socket_t fd, int revents, void *userdata)
+{
+    Q_UNUSED(revents);
+    Q_UNUSED(userdata);
+
+    // Drain; the loop itself picks up queued input / the stop flag.
+    char buf[64];
+    while (::read(fd, buf, sizeof(buf)) > 0) {}
+    return 0;
 }
 
 // ===========================================================================
@@ -206,28 +413,58 @@ void SshShellWorker::stopShell()
  * Writes raw input bytes to the remote shell.
  *
  * Notes:
- *  - Called from UI thread via queued signal/slot
+ *  - Called from the UI thread directly (or Qt::DirectConnection): the
+ *    worker thread sits in startShell() and does not run queued slots
+ *  - Only queues the bytes and wakes the loop; the loop writes them
  *  - Performs minimal translation (CR -> CRLF)
  *  - Does nothing if the shell is not running
  */
 void SshShellWorker::sendInput(const QByteArray &data)
 {
-    if (!m_channel || !m_running.loadRelaxed()) {
-        qDebug() << "[SshShellWorker] sendInput: channel invalid or not running. m_channel ="
-                 << m_channel << " running =" << m_running.loadRelaxed();
+    if (!m_running.loadRelaxed()) {
+        if (m_inputDropLogged.testAndSetRelaxed(false, true))
+            qInfo().noquote() << "[SSH] shell not running; dropping terminal input";
         return;
     }
 
     if (data.isEmpty())
         return;
 
-    QByteArray toSend = data;
+    {
+        QMutexLocker lock(&m_inputMutex);
 
-    // Normalize Enter key for shells
-    if (toSend == "\r") {
-        toSend = "\r\n";
+        // Normalize Enter key for shells
+        if (data == "\r")
+            m_pendingInput += "\r\n";
+        else
+            m_pendingInput += data;
     }
 
-    int rc = ssh_channel_write(m_channel, toSend.constData(), toSend.size());
-    Q_UNUSED(rc);
+    wake();
+}
+
+/*
+ * flushInput
+ * ----------
+ * Writes everything queued by sendInput() to the channel.
+ * Worker thread only. Returns false on a channel write error.
+ */
+bool SshShellWorker::flushInput()
+{
+    QByteArray toSend;
+    {
+        QMutexLocker lock(&m_inputMutex);
+        toSend.swap(m_pendingInput);
+    }
+
+    const char *p = toSend.constData();
+    int left = toSend.size();
+    while (left > 0) {
+        const int rc = ssh_channel_write(m_channel, p, uint32_t(left));
+        if (rc == SSH_ERROR)
+            return false;
+        p += rc;
+        left -= rc;
+    }
+    return true;
 }
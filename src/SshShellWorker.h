@@ -3,9 +3,12 @@
 #include <QObject>
 #include <QAtomicInteger>
 #include <QByteArray>
+#include <QMutex>
 
 #include <libssh/libssh.h>
 
+#include "ShellOutputBuffer.h"
+
 /**
  * SshShellWorker
  *
@@ -25,12 +28,27 @@
  *  1) MainWindow / controller creates ssh_session via SshClient
  *  2) SshShellWorker is constructed with that session
  *  3) startShell() is invoked in a worker thread
- *  4) outputReady() emits data → UI terminal widget
+ *  4) remote output goes into outputBuffer(); a ShellOutputPump on the UI
+ *     thread drains it once per frame → UI terminal widget
  *  5) stopShell() stops the loop and closes the channel
  *
  * Threading model:
- *  - startShell() runs a blocking read loop
+ *  - startShell() runs an event loop on the session socket (ssh_event):
+ *    it sleeps until the server sends data or another thread wakes it,
+ *    so an idle shell costs no CPU and echo latency is network-bound
+ *  - sendInput() / stopShell() may be called from any thread: they queue
+ *    work and wake the loop through a self-pipe; only the worker thread
+ *    touches the libssh channel
  *  - Communication with UI is signal/slot based
+ *
+ * Output backpressure:
+ *  - remote output is copied into a fixed-size ring (outputBuffer()), not
+ *    emitted per read; outputAvailable() fires only when the ring goes from
+ *    empty to non-empty, so a flood costs one queued signal per frame
+ *  - when the ring is full the data callback stops consuming: libssh keeps
+ *    the rest and does not re-open the SSH window, so the server pauses
+ *  - resumeReading() (called by the consumer after draining) wakes the loop
+ *    to pull the backlog; memory stays bounded by ring + one SSH window
  */
 class SshShellWorker : public QObject
 {
@@ -64,7 +82,7 @@ public slots:
      *  - Blocks until shell exits or stopShell() is called
      *
      * Emits:
-     *  - outputReady() when remote data arrives
+     *  - outputAvailable() when remote data arrives in an empty ring
      *  - shellClosed() when the shell ends
      */
     void startShell();
@@ -82,19 +100,35 @@ public slots:
      *
      * Sends raw bytes to the remote shell.
      * Typically connected to a terminal widget's key input.
+     * Safe to call from any thread (bytes are written by the worker loop).
      *
      * @param data Raw byte stream (UTF-8, control chars, etc.)
      */
     void sendInput(const QByteArray &data);
 
+    /**
+     * resumeReading()
+     *
+     * Tells the loop that the consumer freed ring space. Wakes it only if
+     * reads are paused. Safe to call from any thread.
+     */
+    void resumeReading();
+
+public:
+    /**
+     * Output ring shared with the consumer (see ShellOutputPump).
+     * Lives as long as this worker.
+     */
+    ShellOutputBuffer *outputBuffer() { return &m_output; }
+
 signals:
     /**
-     * outputReady
+     * outputAvailable
      *
-     * Emitted when data is read from the SSH channel.
-     * UI layer is responsible for rendering.
+     * Emitted when the output ring goes from empty to non-empty.
+     * The consumer drains outputBuffer() (ShellOutputPump does it per frame).
      */
-    void outputReady(const QByteArray &data);
+    void outputAvailable();
 
     /**
      * shellClosed
@@ -129,4 +163,49 @@ private:
      * - false → exit loop and clean up
      */
     QAtomicInteger<bool>  m_running { false };
+
+    /**
+     * Set once sendInput() has logged dropping input (typing after exit
+     * would otherwise log every keystroke)
+     */
+    QAtomicInteger<bool>  m_inputDropLogged { false };
+
+    /**
+     * Self-pipe: [0] is polled by the loop, [1] is written by wake()
+     */
+    int                   m_wakeFds[2] = { -1, -1 };
+
+    /**
+     * Input queued by sendInput(), written by the loop thread
+     */
+    QMutex                m_inputMutex;
+    QByteArray            m_pendingInput;
+
+    /**
+     * Channel state reported by libssh callbacks (loop thread only)
+     */
+    bool                  m_remoteEof    = false;
+    bool                  m_remoteClosed = false;
+    int                   m_exitStatus   = -1;
+
+    /**
+     * Remote output → UI (see "Output backpressure" above)
+     *
+     * m_readPaused is set by the data callback when the ring is full and
+     * cleared by the loop once libssh's backlog has been moved into the ring.
+     */
+    ShellOutputBuffer     m_output;
+    QAtomicInteger<bool>  m_readPaused { false };
+
+    void wake();
+    bool flushInput();
+    bool pullBacklog();
+    int  pushOutput(const char *data, int len);
+
+    static int  onChannelData(ssh_session, ssh_channel, void *data, uint32_t len,
+                              int isStderr, void *userdata);
+    static void onChannelEof(ssh_session, ssh_channel, void *userdata);
+    static void onChannelClose(ssh_session, ssh_channel, void *userdata);
+    static void onChannelExitStatus(ssh_session, ssh_channel, int status, void *userdata);
+    static int  onWakeFd(socket_t fd, int revents, void *userdata);
 };
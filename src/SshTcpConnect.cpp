@@ -0,0 +1,215 @@
+// SshTcpConnect.cpp
+#include "SshTcpConnect.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+
+static QString T(const char* s)
+{
+    return QCoreApplication::translate("SshClient", s);
+}
+
+// ------------------------------------------------------------
+// configuredTarget()
+// ------------------------------------------------------------
+#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0,11,0)
+// libssh >= 0.11 follows a config ProxyJump itself and has no getter for it.
+// Conservative: any ProxyJump line in the user config counts (Include'd files
+// are not followed).
+static bool userConfigHasProxyJump()
+{
+    QFile f(QDir::homePath() + "/.ssh/config");
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine().trimmed().toLower();
+        if (line.startsWith("proxyjump")) return true;
+    }
+    return false;
+}
+#endif
+
+bool SshTcpConnect::configuredTarget(ssh_session s, QString* host, int* port)
+{
+    if (ssh_options_parse_config(s, nullptr) != SSH_OK)
+        qWarning().noquote() << QString("[SSH] ssh config not applied: %1")
+                                .arg(QString::fromLocal8Bit(ssh_get_error(s)));
+
+    char* v = nullptr;
+    if (ssh_options_get(s, SSH_OPTIONS_PROXYCOMMAND, &v) == SSH_OK && v) {
+        const QString pc = QString::fromUtf8(v).trimmed();
+        ssh_string_free_char(v);
+        if (!pc.isEmpty() && pc.compare("none", Qt::CaseInsensitive) != 0)
+            return false;
+    }
+#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0,11,0)
+    if (userConfigHasProxyJump())
+        return false;
+#endif
+
+    v = nullptr;
+    if (ssh_options_get(s, SSH_OPTIONS_HOST, &v) == SSH_OK && v) {
+        *host = QString::fromUtf8(v);
+        ssh_string_free_char(v);
+    }
+    unsigned int p = 0;
+    if (ssh_options_get_port(s, &p) == SSH_OK && p > 0)
+        *port = int(p);
+    return true;
+}
+
+// ------------------------------------------------------------
+// resolve()
+// ------------------------------------------------------------
+bool SshTcpConnect::resolve(const QString& host, int port, QVector<Address>* out, QString* err,
+                            Failure* why)
+{
+    if (err) err->clear();
+    out->clear();
+
+    addrinfo hints {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_ADDRCONFIG;
+
+    // IPv6 literals may come bracketed from user input.
+    QString h = host.trimmed();
+    if (h.startsWith('[') && h.endsWith(']')) h = h.mid(1, h.size() - 2);
+
+    addrinfo* res = nullptr;
+    const QByteArray node = h.toUtf8();
+    const QByteArray service = QByteArray::number(port);
+    const int rc = ::getaddrinfo(node.constData(), service.constData(), &hints, &res);
+    if (rc != 0 || !res) {
+        if (why) *why = Failure{true, rc != 0 ? rc : EAI_NONAME};
+        if (err) *err = T("Could not resolve host '%1': %2").arg(h, QString::fromLocal8Bit(gai_strerror(rc)));
+        return false;
+    }
+
+    for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+        if (ai->ai_addrlen > sizeof(sockaddr_storage)) continue;
+        Address a;
+        std::memcpy(&a.addr, ai->ai_addr, ai->ai_addrlen);
+        a.len = socklen_t(ai->ai_addrlen);
+        out->push_back(a);
+    }
+    ::freeaddrinfo(res);
+
+    if (out->isEmpty()) {
+        if (why) *why = Failure{true, EAI_NONAME};
+        if (err) *err = T("Could not resolve host '%1'").arg(h);
+        return false;
+    }
+    return true;
+}
+
+// ------------------------------------------------------------
+// startConnect() / pollConnect()
+// ------------------------------------------------------------
+int SshTcpConnect::startConnect(const Address& a, QString* err, Failure* why)
+{
+    if (err) err->clear();
+
+    const int fd = ::socket(a.addr.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) {
+        const int e = errno;
+        if (why) *why = Failure{false, e};
+        if (err) *err = T("socket() failed: %1").arg(QString::fromLocal8Bit(std::strerror(e)));
+        return -1;
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&a.addr), a.len) != 0 && errno != EINPROGRESS) {
+        const int e = errno;
+        if (why) *why = Failure{false, e};
+        if (err) *err = T("Connection failed: %1").arg(QString::fromLocal8Bit(std::strerror(e)));
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int SshTcpConnect::pollConnect(int fd, int waitMs, QString* err, bool keepNonBlocking, Failure* why)
+{
+    pollfd p {};
+    p.fd = fd;
+    p.events = POLLOUT;
+
+    int n;
+    do {
+        n = ::poll(&p, 1, qMax(0, waitMs));
+    } while (n < 0 && errno == EINTR);
+    if (n == 0) return 0;
+
+    int soErr = 0;
+    socklen_t len = sizeof(soErr);
+    if (n < 0 || ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &soErr, &len) != 0)
+        soErr = errno;
+
+    if (soErr != 0) {
+        if (why) *why = Failure{false, soErr};
+        if (err) *err = T("Connection failed: %1").arg(QString::fromLocal8Bit(std::strerror(soErr)));
+        ::close(fd);
+        return -1;
+    }
+
+    if (!keepNonBlocking)
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);
+    return 1;
+}
+
+// ------------------------------------------------------------
+// connectBlocking()
+// ------------------------------------------------------------
+int SshTcpConnect::connectBlocking(const QString& host, int port, int timeoutMs,
+                                   qint64* dnsMs, qint64* tcpMs, QString* err, Failure* why)
+{
+    QElapsedTimer t;
+    t.start();
+
+    QVector<Address> addrs;
+    const bool resolved = resolve(host, port, &addrs, err, why);
+    if (dnsMs) *dnsMs = t.elapsed();
+    if (!resolved) return -1;
+
+    t.restart();
+    QString lastErr;
+    Failure lastWhy{false, ETIMEDOUT};
+    for (const Address& a : addrs) {
+        const qint64 left = timeoutMs - t.elapsed();
+        if (left <= 0) break;
+
+        const int fd = startConnect(a, &lastErr, &lastWhy);
+        if (fd < 0) continue;
+
+        const int rc = pollConnect(fd, int(left), &lastErr, false, &lastWhy);
+        if (rc == 1) {
+            if (tcpMs) *tcpMs = t.elapsed();
+            return fd;
+        }
+        if (rc == 0) {
+            ::close(fd);
+            lastWhy = Failure{false, ETIMEDOUT};
+            lastErr = T("Connection to %1 port %2 timed out after %3 ms").arg(host).arg(port).arg(timeoutMs);
+        }
+    }
+
+    if (tcpMs) *tcpMs = t.elapsed();
+    if (why) *why = lastErr.isEmpty() ? Failure{false, ETIMEDOUT} : lastWhy;
+    if (err) {
+        *err = lastErr.isEmpty()
+                   ? T("Connection to %1 port %2 timed out after %3 ms").arg(host).arg(port).arg(timeoutMs)
+                   : lastErr;
+    }
+    return -1;
+}
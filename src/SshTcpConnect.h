@@ -0,0 +1,74 @@
+// SshTcpConnect.h
+//
+// Purpose:
+//   Name resolution and TCP connect for libssh sessions, done here instead of
+//   inside ssh_connect() so each phase can be timed on its own (DNS vs. TCP
+//   vs. key exchange). The connected socket is handed to libssh with
+//   SSH_OPTIONS_FD, the same way jump-host tunnels are; libssh closes it in
+//   ssh_free().
+//
+//   - configuredTarget(): host/port after ~/.ssh/config, or "let libssh
+//     connect" when the config routes the host through a proxy
+//   - connectBlocking(): resolve + connect with one timeout (SshClient)
+//   - resolve() / startConnect() / pollConnect(): the same steps split up for
+//     the non-blocking fleet event engine
+//
+// Notes:
+//   - Every resolved address is tried in order (IPv6 and IPv4), like libssh.
+//   - Sockets are close-on-exec and blocking again once connected (the
+//     event engine keeps them non-blocking).
+//   - A ProxyCommand (or, with libssh >= 0.11, any ProxyJump) in the user's
+//     ssh config disables the pre-connect: ssh_connect() does it all, and
+//     DNS + TCP time is counted as key exchange.
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+#include <sys/socket.h>
+
+#include <libssh/libssh.h>
+
+class SshTcpConnect
+{
+public:
+    struct Address {
+        sockaddr_storage addr {};
+        socklen_t len = 0;
+    };
+
+    // Why a step failed, for callers that classify failures (err is
+    // translated display text): dns = getaddrinfo() failed, code = its EAI_*
+    // value; otherwise code = errno of socket()/connect() (ETIMEDOUT when our
+    // own timeout ran out).
+    struct Failure {
+        bool dns = false;
+        int  code = 0;
+    };
+
+    // Parse ~/.ssh/config into s (as ssh_connect() would; it is not parsed
+    // again there) and read back the effective host + port (Hostname, Port).
+    // false when the config sets a proxy: connect with plain ssh_connect().
+    static bool configuredTarget(ssh_session s, QString* host, int* port);
+
+    // Blocking getaddrinfo(). false (and err) when nothing resolved.
+    static bool resolve(const QString& host, int port, QVector<Address>* out, QString* err = nullptr,
+                        Failure* why = nullptr);
+
+    // Non-blocking connect() to one address. Returns the socket (connect in
+    // progress or done) or -1 (err).
+    static int startConnect(const Address& a, QString* err = nullptr, Failure* why = nullptr);
+
+    // 1 = connected, 0 = still pending after waitMs, -1 = failed (err; the
+    // socket is closed). A connected socket is made blocking again unless
+    // keepNonBlocking (a non-blocking libssh session must not block in send()).
+    static int pollConnect(int fd, int waitMs, QString* err = nullptr, bool keepNonBlocking = false,
+                           Failure* why = nullptr);
+
+    // Resolve + connect, trying each address until timeoutMs is spent.
+    // Returns the connected socket or -1; dnsMs/tcpMs get the phase times.
+    static int connectBlocking(const QString& host, int port, int timeoutMs,
+                               qint64* dnsMs, qint64* tcpMs, QString* err = nullptr,
+                               Failure* why = nullptr);
+};
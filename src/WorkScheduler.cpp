@@ -0,0 +1,63 @@
+// WorkScheduler.cpp
+//
+// See header.
+
+#include "WorkScheduler.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QSettings>
+#include <QDebug>
+
+WorkScheduler* WorkScheduler::instance()
+{
+    static WorkScheduler* s = new WorkScheduler(qApp);
+    return s;
+}
+
+WorkScheduler::WorkScheduler(QObject* parent)
+    : QObject(parent)
+{
+    const int maxThreads = QSettings().value("fleet/maxThreads", 32).toInt();
+    m_fleetPool.setMaxThreadCount(qBound(1, maxThreads, 256));
+    m_fleetPool.setExpiryTimeout(30 * 1000);
+}
+
+void WorkScheduler::beginInteractive()
+{
+    m_interactive.ref();
+}
+
+void WorkScheduler::endInteractive()
+{
+    if (!m_interactive.deref()) {
+        QMutexLocker lock(&m_mutex);
+        m_idle.wakeAll();
+    }
+}
+
+// ------------------------------------------------------------
+// yieldToInteractive()
+// ------------------------------------------------------------
+qint64 WorkScheduler::yieldToInteractive(int maxWaitMs)
+{
+    if (m_interactive.loadAcquire() == 0) return 0;
+
+    QElapsedTimer t;
+    t.start();
+
+    QMutexLocker lock(&m_mutex);
+    while (m_interactive.loadAcquire() > 0) {
+        const qint64 left = maxWaitMs - t.elapsed();
+        if (left <= 0) break;
+        m_idle.wait(&m_mutex, (unsigned long)left);
+    }
+
+    const qint64 waited = t.elapsed();
+    if (waited >= 100) {
+        qInfo().noquote() << QString("[SCHED] fleet task yielded %1 ms to interactive work")
+                                 .arg(waited);
+    }
+    return waited;
+}
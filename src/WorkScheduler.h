@@ -0,0 +1,91 @@
+// WorkScheduler.h
+//
+// Purpose:
+//   Small app-wide scheduler for blocking background work, in two lanes:
+//
+//   - Interactive: work the user is waiting on (connect, file browsing and
+//     transfers). Runs on QThreadPool::globalInstance(), as before.
+//   - Fleet: bulk fleet jobs. Runs on a pool of its own
+//     (fleet/maxThreads, default 32) with low thread priority, so a fleet
+//     job never resizes or fills the global pool.
+//
+//   Interactive work preempts fleet work: a fleet task waits before it
+//   starts while any interactive task is queued or running (at most
+//   kMaxYieldMs each time, so a long transfer delays a fleet job but does not
+//   stall it). Running fleet tasks are not interrupted; they can call
+//   yieldToInteractive() between steps.
+//
+// Threading:
+//   run() and the accessors are thread-safe.
+
+#pragma once
+
+#include <QObject>
+#include <QAtomicInteger>
+#include <QFuture>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtConcurrent/QtConcurrent>
+
+class WorkScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Lane { Interactive, Fleet };
+
+    static constexpr int kMaxYieldMs = 2000;
+
+    static WorkScheduler* instance();
+
+    // Run fn on the lane's pool; like QtConcurrent::run.
+    template <typename Fn>
+    auto run(Lane lane, Fn fn) -> QFuture<decltype(fn())>;
+
+    QThreadPool* fleetPool() { return &m_fleetPool; }
+
+    // Interactive tasks queued or running.
+    int interactivePending() const { return m_interactive.loadAcquire(); }
+
+    // Block (on a worker thread) while interactive work is pending, at most
+    // maxWaitMs. Returns the time waited in ms.
+    qint64 yieldToInteractive(int maxWaitMs = kMaxYieldMs);
+
+private:
+    explicit WorkScheduler(QObject* parent = nullptr);
+
+    void beginInteractive();
+    void endInteractive();
+
+    struct InteractiveScope {
+        explicit InteractiveScope(WorkScheduler* s) : s(s) {}
+        ~InteractiveScope() { s->endInteractive(); }
+        WorkScheduler* s;
+    };
+
+    QThreadPool         m_fleetPool;
+    QAtomicInteger<int> m_interactive { 0 };
+    QMutex              m_mutex;
+    QWaitCondition      m_idle;
+};
+
+template <typename Fn>
+auto WorkScheduler::run(Lane lane, Fn fn) -> QFuture<decltype(fn())>
+{
+    if (lane == Lane::Interactive) {
+        // Counted from submission, so queued interactive work already holds
+        // fleet tasks back.
+        beginInteractive();
+        return QtConcurrent::run(QThreadPool::globalInstance(), [this, fn]() mutable {
+            InteractiveScope scope(this);
+            return fn();
+        });
+    }
+
+    return QtConcurrent::run(&m_fleetPool, [this, fn]() mutable {
+        QThread::currentThread()->setPriority(QThread::LowPriority);
+        yieldToInteractive();
+        return fn();
+    });
+}